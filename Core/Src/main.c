@@ -30,6 +30,10 @@
 #include "foc_core.h"
 #include "vofa.h"
 #include "usb_vcp.h"
+#include "foc_perf.h"
+#include "foc_scope.h"
+#include "foc_link.h"
+#include "foc_param.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -63,12 +67,14 @@ void SystemClock_Config(void);
 /* USER CODE BEGIN 0 */
 
 /**
- * @brief  SPI DMA 传输完成回调 (编码器读取)
+ * @brief  SPI DMA 传输完成回调 (编码器读取, 按 SPI 句柄分发到对应轴)
  */
 void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
 {
-    if (hspi->Instance == SPI1) {
-        FOC_EncoderCallback(&g_Motor);
+    int8_t axis = MotorHW_AxisFromSPI(hspi);
+    
+    if (axis >= 0) {
+        FOC_EncoderCallback(&g_Motors[axis]);
     }
 }
 
@@ -112,8 +118,22 @@ int main(void)
   MX_SPI1_Init();
   /* USER CODE BEGIN 2 */
 
-    /*--- 初始化 FOC 控制器 ---*/
-    FOC_Init(&g_Motor);
+    /*--- 初始化 USB 发送队列和命令链路 ---*/
+    VCP_Init();
+    FOC_Link_Init();
+    
+    /*--- 初始化运行时参数表 (写入队列/订阅, 挂载参数存储) ---*/
+    FOC_Param_Init();
+    
+    /*--- 初始化 FOC 控制器 (每轴一个, 加载已保存的参数) ---*/
+    for (uint8_t axis = 0; axis < HW_AXIS_COUNT; axis++) {
+        FOC_Init(&g_Motors[axis], axis);
+    }
+    
+#if FOC_PERF_ENABLE
+    /*--- 初始化性能剖析 (DWT 周期计数) ---*/
+    FOC_Perf_Init(HAL_RCC_GetHCLKFreq());
+#endif
     
     /*--- 启动 PWM ---*/
     __HAL_TIM_ENABLE(&htim1);
@@ -136,9 +156,11 @@ int main(void)
     /*--- 使能电机驱动 ---*/
     FOC_Start(&g_Motor);
     
-    /*--- 设置控制模式和目标 ---*/
-    FOC_SetMode(&g_Motor, FOC_MODE_POSITION);
-    FOC_SetTargetPosition(&g_Motor, 3.14f);     // 目标位置: π rad
+    /*--- 设置控制模式和目标 (同一条命令, 同时生效) ---*/
+    FOC_Command_t cmd;
+    cmd.Mode = FOC_MODE_POSITION;
+    cmd.TargetPosCnt = FOC_PosRadToCnt(3.14f);  // 目标位置: π rad
+    FOC_SetCommand(&g_Motor, FOC_CMD_MODE | FOC_CMD_POS, &cmd);
     
   /* USER CODE END 2 */
 
@@ -146,13 +168,24 @@ int main(void)
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-        /*--- 发送 VOFA 调试数据 ---*/
-        VOFA_Send_JustFloat(vofa_data, 23);
+        /*--- 处理上位机命令 (模式/目标值/参数/数据流控制) ---*/
+        FOC_Link_Poll();
+        
+#if FOC_SCOPE_ENABLE
+        /*--- 上传示波器采集 (上传期间暂停实时数据) ---*/
+        if (FOC_Scope_Poll()) continue;
+#endif
+        
+        /*--- 发送实时数据 (默认 VOFA JustFloat, 可切换为紧凑遥测) ---*/
+        FOC_Link_Telemetry(HAL_GetTick());
         
         /*--- 可在此处添加用户控制逻辑 ---*/
-        // 例如: 根据USB接收的命令修改目标值
+        // 目标值/参数也可由上位机经 USB 命令修改 (见 foc_proto.h), 例如:
         // FOC_SetTargetSpeed(&g_Motor, new_speed);
         // FOC_SetTargetPosition(&g_Motor, new_position);
+        // 
+        // 采集 Iq 阶跃响应: 布防后下发新的 Iq 目标即触发
+        // FOC_ScopeConfig_t scope; FOC_Scope_DefaultConfig(&scope); FOC_Scope_Arm(&scope);
         
     /* USER CODE END WHILE */
 
@@ -218,7 +251,9 @@ void Error_Handler(void)
 {
   /* USER CODE BEGIN Error_Handler_Debug */
   /* User can add his own implementation to report the HAL error return state */
-    FOC_EmergencyStop(&g_Motor);
+    for (uint8_t axis = 0; axis < HW_AXIS_COUNT; axis++) {
+        FOC_EmergencyStop(&g_Motors[axis]);
+    }
   __disable_irq();
   while (1)
   {
@@ -0,0 +1,63 @@
+/**
+ * @file    foc_bench.c
+ * @brief   主机基准: 仿真闭环运行 FOC_ControlLoop, 按流水线阶段打印耗时统计
+ * @note    链接 foc_host_perf (FOC_PERF_ENABLE = 1), 周期计数为主机 ns
+ *          主机计时含 clock_gettime 开销 (约数十 ns), 各阶段数值仅作相对比较
+ *          用法: foc_bench [ticks]
+ */
+
+#include "foc_core.h"
+#include "foc_perf.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_TICKS_DEFAULT     200000u     // 10s 仿真时间 @ 20kHz
+#define BENCH_SETTLE_TICKS      20000u      // 加速到目标转速后再开始统计
+#define BENCH_SPEED_RPM         1000.0f
+
+int main(int argc, char **argv)
+{
+    uint32_t ticks = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_TICKS_DEFAULT;
+    FOC_PerfReport_t rep;
+    FOC_PerfSinCos_t sc;
+    FOC_PerfSVPWM_t sv;
+    FOC_PerfEncoder_t enc;
+
+    MotorHW_Sim_Init(&g_MotorHW[0], NULL, HW_ENCODER_ZERO_OFFSET, 1);
+    FOC_Init(&g_Motor, 0);
+    FOC_Start(&g_Motor);
+    FOC_SetMode(&g_Motor, FOC_MODE_SPEED);
+    FOC_SetTargetSpeed(&g_Motor, BENCH_SPEED_RPM);
+    for (uint32_t i = 0; i < BENCH_SETTLE_TICKS; i++) {
+        FOC_SimTick(&g_Motor);
+    }
+
+    FOC_Perf_Init(1000000000u);
+    for (uint32_t i = 0; i < ticks; i++) {
+        FOC_SimTick(&g_Motor);
+    }
+
+    printf("control loop, %u ticks @ %.0f rpm (ns)\n", (unsigned)ticks, (double)g_Motor.ActualRPM);
+    printf("%-8s %10s %9s %9s %9s %9s %8s\n", "stage", "count", "ns/iter", "p50", "p99", "max", "overflow");
+    for (uint32_t s = 0; s < FOC_PERF_STAGE_CNT; s++) {
+        FOC_Perf_GetReport((FOC_PerfStage_t)s, &rep);
+        printf("%-8s %10u %9.1f %9.1f %9.1f %9.1f %8u\n", FOC_Perf_StageName((FOC_PerfStage_t)s),
+               (unsigned)rep.Count, (double)rep.AvgNs, (double)rep.P50Ns,
+               (double)rep.P99Ns, (double)rep.MaxNs, (unsigned)rep.Overflow);
+    }
+
+    FOC_Perf_BenchSinCos(&sc);
+    printf("\nsincos  libm %.1f ns  table %.1f ns  max err sin %.2e cos %.2e\n",
+           (double)sc.CmsisCycles, (double)sc.TableCycles,
+           (double)sc.MaxErrSin, (double)sc.MaxErrCos);
+
+    FOC_Perf_BenchSVPWM(&sv);
+    printf("svpwm   sector %.1f ns  minmax %.1f ns  max ccr diff %u\n",
+           (double)sv.SectorCycles, (double)sv.MinMaxCycles, (unsigned)sv.MaxCcrDiff);
+
+    FOC_Perf_BenchEncoder(&enc);
+    printf("encoder fmodf %.1f ns  integer %.1f ns  max elec err %.2e rad\n",
+           (double)enc.FmodfCycles, (double)enc.IntCycles, (double)enc.MaxErrElec);
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file    foc_sim.c
+ * @brief   主机闭环仿真: 速度阶跃与位置移动场景
+ * @note    调度与硬件一致 (FOC_SimTick), 每个场景检查终值并打印仿真吞吐 (ticks/s)
+ *          用法: foc_sim [speed|position]   (缺省运行全部场景, 任一失败返回非零)
+ */
+
+#include "foc_core.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define SIM_TICK_HZ             20000.0f
+#define SIM_SPEED_STEP_RPM      1000.0f
+#define SIM_SPEED_TICKS         40000u      // 2s
+#define SIM_SPEED_TOL_RPM       20.0f       // 终值误差上限
+#define SIM_POS_MOVE_RAD        20.0f       // 约 3.2 圈
+#define SIM_POS_TICKS           60000u      // 3s
+#define SIM_POS_TOL_RAD         0.01f       // 终值误差上限 (位置环死区 0.002 rad + 库仑摩擦下的静差)
+
+/**
+ * @brief  单调时钟 (s)
+ */
+static double Sim_Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief  初始化仿真轴并启动电机 (含电流偏移校准)
+ */
+static void Sim_Setup(void)
+{
+    memset(&g_Motor, 0, sizeof(g_Motor));
+    MotorHW_Sim_Init(&g_MotorHW[0], NULL, HW_ENCODER_ZERO_OFFSET, 1);
+    FOC_Init(&g_Motor, 0);
+    FOC_Start(&g_Motor);
+}
+
+/**
+ * @brief  推进 n 个节拍, 返回耗时 (s)
+ */
+static double Sim_Run(uint32_t n)
+{
+    double t0 = Sim_Now();
+
+    for (uint32_t i = 0; i < n; i++) {
+        FOC_SimTick(&g_Motor);
+    }
+    return Sim_Now() - t0;
+}
+
+/**
+ * @brief  速度阶跃: 0 → SIM_SPEED_STEP_RPM, 统计上升时间与终值误差
+ */
+static int Sim_SpeedStep(void)
+{
+    const MotorSim_t *plant;
+    uint32_t rise = 0;
+    double elapsed = 0.0;
+
+    Sim_Setup();
+    FOC_SetMode(&g_Motor, FOC_MODE_SPEED);
+    FOC_SetTargetSpeed(&g_Motor, SIM_SPEED_STEP_RPM);
+    plant = MotorHW_Sim_GetPlant(g_Motor.HW);
+
+    for (uint32_t i = 0; i < SIM_SPEED_TICKS; i += 100u) {
+        elapsed += Sim_Run(100u);
+        if (rise == 0 && g_Motor.ActualRPM >= 0.9f * SIM_SPEED_STEP_RPM) {
+            rise = i + 100u;
+        }
+    }
+
+    float rpm_est = g_Motor.ActualRPM;
+    float rpm_true = plant->OmegaMech * (60.0f / FOC_2PI);
+    int ok = (fabsf(rpm_true - SIM_SPEED_STEP_RPM) < SIM_SPEED_TOL_RPM) &&
+             (fabsf(rpm_est - rpm_true) < SIM_SPEED_TOL_RPM) && (rise != 0);
+
+    printf("speed    step %.0f rpm: rise(90%%) %.1f ms, final est %.1f / plant %.1f rpm, "
+           "%.2f Mticks/s  %s\n", (double)SIM_SPEED_STEP_RPM, (double)(rise / SIM_TICK_HZ * 1e3f),
+           (double)rpm_est, (double)rpm_true, SIM_SPEED_TICKS / elapsed * 1e-6, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+/**
+ * @brief  位置移动: 当前位置 + SIM_POS_MOVE_RAD, 检查终值计数误差与残余转速
+ */
+static int Sim_PositionMove(void)
+{
+    const MotorSim_t *plant;
+    uint32_t settle = 0;
+    double elapsed;
+
+    Sim_Setup();
+    FOC_SetMode(&g_Motor, FOC_MODE_POSITION);
+    elapsed = Sim_Run(2000u);       // 电流偏移校准 + 位置环锁定当前位置
+
+    const int64_t tol = FOC_PosRadToCnt(SIM_POS_TOL_RAD);
+    int64_t start = g_Motor.Encoder.PosCnt;
+    int64_t target = start + FOC_PosRadToCnt(SIM_POS_MOVE_RAD);
+    FOC_SetTargetPositionCnt(&g_Motor, target);
+    plant = MotorHW_Sim_GetPlant(g_Motor.HW);
+
+    for (uint32_t i = 0; i < SIM_POS_TICKS; i += 100u) {
+        elapsed += Sim_Run(100u);
+        int64_t err = g_Motor.Encoder.PosCnt - target;
+        if (err > tol || err < -tol) {
+            settle = 0;
+        } else if (settle == 0) {
+            settle = i + 100u;
+        }
+    }
+
+    int64_t err = g_Motor.Encoder.PosCnt - target;
+    float rpm_true = plant->OmegaMech * (60.0f / FOC_2PI);
+    int ok = (settle != 0) && (fabsf(rpm_true) < 5.0f);
+
+    printf("position move %.1f rad (%lld cnt): settle %.1f ms, final err %lld cnt, plant %.2f rpm, "
+           "%.2f Mticks/s  %s\n", (double)SIM_POS_MOVE_RAD, (long long)(target - start),
+           (double)(settle / SIM_TICK_HZ * 1e3f), (long long)err, (double)rpm_true,
+           (SIM_POS_TICKS + 2000u) / elapsed * 1e-6, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    const char *which = (argc > 1) ? argv[1] : "all";
+    int ok = 1;
+
+    if (!strcmp(which, "all") || !strcmp(which, "speed"))    ok &= Sim_SpeedStep();
+    if (!strcmp(which, "all") || !strcmp(which, "position")) ok &= Sim_PositionMove();
+
+    return ok ? 0 : 1;
+}
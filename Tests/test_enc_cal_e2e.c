@@ -0,0 +1,103 @@
+/**
+ * @file    test_enc_cal_e2e.c
+ * @brief   编码器校准端到端仿真测试: 随机安装偏移 / 方向 / 极对数 / 初始转子角
+ * @note    每轮以随机参数初始化仿真电机 (奇数轮加大库仑摩擦, 扫描中产生随转向反号的滞后, 由正反扫描抵消), 上电 (极对数为缺省的 HW_MOTOR_POLE_PAIRS) 后执行
+ *          FOC_StartEncoderCalib, 检查:
+ *          - 测得的方向与极对数与对象模型一致, 并已写入 Encoder.PolePairs 与参数 enc.poles
+ *          - 零点误差 (折算为电角度) 小于 ENC_E2E_TOL_DEG
+ *          - 以校准结果闭环速度控制可达目标转速 (电角度换算使用运行时极对数)
+ *          另检查参数 enc.poles 的上下限
+ */
+
+#include "foc_core.h"
+#include "foc_param.h"
+#include "test_util.h"
+#include <math.h>
+#include <string.h>
+
+#define ENC_E2E_TRIALS      12u
+#define ENC_E2E_TOL_DEG     3.0f        // 零点误差上限 (电角度)
+#define ENC_E2E_RPM         1000.0f
+#define ENC_E2E_RPM_TOL     20.0f
+#define ENC_E2E_FRICTION    0.01f       // 奇数轮的库仑摩擦 (N·m)
+
+static const uint8_t e2e_poles[] = { 7, 4, 11, 14, 21, 2 };
+static uint32_t rng = 0xC0FFEEu;
+
+static float Rand_Unit(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (float)(rng >> 8) * (1.0f / 16777216.0f);
+}
+
+int main(void)
+{
+    float max_err = 0.0f;
+    float v;
+
+    for (uint32_t k = 0; k < ENC_E2E_TRIALS; k++) {
+        MotorSim_Params_t p;
+        float offset = Rand_Unit() * FOC_2PI;
+        int8_t dir = (Rand_Unit() < 0.5f) ? -1 : 1;
+
+        MotorSim_DefaultParams(&p);
+        p.PolePairs = e2e_poles[k % (sizeof(e2e_poles) / sizeof(e2e_poles[0]))];
+        if (k & 1u) p.CoulombFriction = ENC_E2E_FRICTION;
+
+        memset(&g_Motor, 0, sizeof(g_Motor));
+        MotorHW_Sim_Init(&g_MotorHW[0], &p, offset, dir);
+        MotorHW_Sim_GetPlant(&g_MotorHW[0])->ThetaMech = Rand_Unit() * FOC_2PI;
+        FOC_Param_Init();
+        FOC_Init(&g_Motor, 0);
+        TEST_CHECK(g_Motor.Encoder.PolePairs == HW_MOTOR_POLE_PAIRS);
+
+        for (uint32_t i = 0; i < 2000u; i++) FOC_SimTick(&g_Motor);     // 电流偏移校准
+        TEST_CHECK(FOC_StartEncoderCalib(&g_Motor) == 1);
+        uint32_t ticks = 0;
+        while (g_Motor.State == MOTOR_STATE_CALIBRATING && ticks < 100000u) {
+            FOC_SimTick(&g_Motor);
+            ticks++;
+        }
+
+        /* 零点误差: 按极距取模后折算为电角度 */
+        float pitch = FOC_2PI / (float)p.PolePairs;
+        float e = fmodf(g_Motor.Encoder.ZeroOffset - offset + 10.0f * FOC_2PI, pitch);
+        if (e > 0.5f * pitch) e -= pitch;
+        float err_deg = fabsf(e) * (float)p.PolePairs * (180.0f / FOC_PI);
+
+        /* 闭环速度 */
+        FOC_Start(&g_Motor);
+        FOC_SetMode(&g_Motor, FOC_MODE_SPEED);
+        FOC_SetTargetSpeed(&g_Motor, ENC_E2E_RPM);
+        for (uint32_t i = 0; i < 40000u; i++) FOC_SimTick(&g_Motor);
+        float rpm_true = MotorHW_Sim_GetPlant(g_Motor.HW)->OmegaMech * (60.0f / FOC_2PI);
+        FOC_Stop(&g_Motor);
+
+        printf("pp %2u dir %+d fric %.3f offset %.4f -> status %u pp %2u dir %+d, err %.3f deg(e), %.2f s, "
+               "%.1f rpm\n", (unsigned)p.PolePairs, (int)dir,
+               (double)p.CoulombFriction, (double)offset,
+               (unsigned)g_Motor.EncCal.Status, (unsigned)g_Motor.Encoder.PolePairs,
+               (int)g_Motor.Encoder.Direction, (double)err_deg, ticks * 50e-6, (double)rpm_true);
+        TEST_CHECK(g_Motor.EncCal.Status == ENC_CAL_DONE);
+        TEST_CHECK(g_Motor.Encoder.PolePairs == p.PolePairs && g_Motor.EncLin.PolePairs == p.PolePairs);
+        TEST_CHECK(g_Motor.Encoder.Direction == dir);
+        TEST_CHECK(FOC_Param_Get(&g_Motor, FOC_PARAM_ENC_POLES, &v) == FOC_PARAM_OK &&
+                   v == (float)p.PolePairs);
+        TEST_CHECK(err_deg < ENC_E2E_TOL_DEG);
+        TEST_CHECK(fabsf(rpm_true - ENC_E2E_RPM) < ENC_E2E_RPM_TOL);
+        if (err_deg > max_err) max_err = err_deg;
+    }
+    printf("max zero offset error %.2f deg(e)\n", (double)max_err);
+
+    /*--- enc.poles 上下限 ---*/
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ENC_POLES, 0.0f) == FOC_PARAM_ERR_RANGE);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ENC_POLES, (float)(ENC_CAL_MAX_POLE_PAIRS + 1)) ==
+               FOC_PARAM_ERR_RANGE);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ENC_POLES, 5.0f) == FOC_PARAM_OK);
+    FOC_SimTick(&g_Motor);
+    TEST_CHECK(g_Motor.Encoder.PolePairs == 5u && g_Motor.EncLin.PolePairs == 5u);
+
+    return Test_Result("test_enc_cal_e2e");
+}
@@ -0,0 +1,173 @@
+/**
+ * @file    test_enc_lin.c
+ * @brief   编码器非线性补偿测试: 偏心编码器上补偿前后的转速 / 电流纹波与单周期开销
+ * @note    仿真编码器叠加 1 次 (偏心) 与 2 次谐波角度误差, 先不补偿做零点校准并测量
+ *          300 / 1500 rpm 下的 PLL 转速、真实转速、Iq 标准差与电角度误差;
+ *          再执行 FOC_StartEncoderLin 标定 + 重新校准零点后同样测量, 检查:
+ *          - 电角度误差 RMS 降到 ENC_LIN_TEST_ERR_DEG 以下, 转速与 Iq 纹波至少降低 ENC_LIN_TEST_GAIN 倍
+ *          - 补偿表随参数保存, 重新 FOC_Init 后恢复并生效
+ *          另打印单次 EncLin_Apply 与编码器处理 (有 / 无补偿) 的主机耗时
+ */
+
+#include "foc_core.h"
+#include "foc_flash.h"
+#include "foc_param.h"
+#include "test_util.h"
+#include <math.h>
+#include <string.h>
+
+#define ENC_LIN_TEST_A1         0.02f       // 1 次谐波幅值 (rad, 机械角)
+#define ENC_LIN_TEST_SETTLE     40000u
+#define ENC_LIN_TEST_SAMPLES    40000u
+#define ENC_LIN_TEST_ERR_DEG    0.5f        // 补偿后电角度误差 RMS 上限
+#define ENC_LIN_TEST_GAIN       3.0f        // 纹波最小改善倍数 (低速 Iq 受电流噪声底限制)
+#define ENC_LIN_TEST_BENCH      10000000u
+
+typedef struct {
+    float PllStd;           // PLL 转速标准差 (rpm)
+    float TrueStd;          // 真实转速标准差 (rpm)
+    float IqStd;            // Iq 标准差 (A)
+    float ErrRms;           // 电角度误差 RMS (deg)
+} Ripple_t;
+
+static void Run_Calib(uint8_t lin)
+{
+    uint32_t n = 0;
+
+    TEST_CHECK((lin ? FOC_StartEncoderLin(&g_Motor) : FOC_StartEncoderCalib(&g_Motor)) == 1);
+    while (g_Motor.State == MOTOR_STATE_CALIBRATING && n < 200000u) {
+        FOC_SimTick(&g_Motor);
+        n++;
+    }
+    TEST_CHECK(lin ? g_Motor.EncLin.Status == ENC_LIN_DONE : g_Motor.EncCal.Status == ENC_CAL_DONE);
+}
+
+static double Std(double s, double s2, uint32_t n)
+{
+    double var = s2 / n - (s / n) * (s / n);
+    return (var > 0.0) ? sqrt(var) : 0.0;
+}
+
+/**
+ * @brief  速度闭环稳定后统计纹波
+ */
+static Ripple_t Measure(const char *tag, float rpm)
+{
+    MotorSim_t *plant = MotorHW_Sim_GetPlant(g_Motor.HW);
+    double s = 0, s2 = 0, t = 0, t2 = 0, q = 0, q2 = 0, e2 = 0;
+    Ripple_t r;
+
+    FOC_Start(&g_Motor);
+    FOC_SetMode(&g_Motor, FOC_MODE_SPEED);
+    FOC_SetTargetSpeed(&g_Motor, rpm);
+    for (uint32_t i = 0; i < ENC_LIN_TEST_SETTLE; i++) FOC_SimTick(&g_Motor);
+    for (uint32_t i = 0; i < ENC_LIN_TEST_SAMPLES; i++) {
+        FOC_SimTick(&g_Motor);
+        double v = g_Motor.ActualRPM;
+        double w = plant->OmegaMech * (60.0 / FOC_2PI);
+        double iq = g_Motor.ActualIq;
+        double e = fmod(g_Motor.Encoder.ElecAngle - MotorSim_GetElecAngle(plant) + 3.0 * FOC_PI,
+                        FOC_2PI) - FOC_PI;
+        s += v;
+        s2 += v * v;
+        t += w;
+        t2 += w * w;
+        q += iq;
+        q2 += iq * iq;
+        e2 += e * e;
+    }
+    FOC_Stop(&g_Motor);
+    for (uint32_t i = 0; i < 20000u; i++) FOC_SimTick(&g_Motor);
+
+    r.PllStd = (float)Std(s, s2, ENC_LIN_TEST_SAMPLES);
+    r.TrueStd = (float)Std(t, t2, ENC_LIN_TEST_SAMPLES);
+    r.IqStd = (float)Std(q, q2, ENC_LIN_TEST_SAMPLES);
+    r.ErrRms = (float)(sqrt(e2 / ENC_LIN_TEST_SAMPLES) * (180.0 / FOC_PI));
+    printf("%-7s %4.0f rpm: pll rpm std %6.2f, true rpm std %6.2f, iq std %.4f A, "
+           "elec angle err rms %.2f deg\n", tag, (double)rpm, (double)r.PllStd, (double)r.TrueStd,
+           (double)r.IqStd, (double)r.ErrRms);
+    return r;
+}
+
+static void Check_Gain(const Ripple_t *before, const Ripple_t *after)
+{
+    TEST_CHECK(after->ErrRms < ENC_LIN_TEST_ERR_DEG);
+    TEST_CHECK(before->PllStd > ENC_LIN_TEST_GAIN * after->PllStd);
+    TEST_CHECK(before->TrueStd > ENC_LIN_TEST_GAIN * after->TrueStd);
+    TEST_CHECK(before->IqStd > ENC_LIN_TEST_GAIN * after->IqStd);
+}
+
+/**
+ * @brief  单周期开销: 补偿查表本身, 以及编码器处理有 / 无补偿的差值
+ */
+static void Bench(void)
+{
+    volatile uint32_t acc = 0;
+    uint64_t t0 = Test_NowNs();
+
+    for (uint32_t i = 0; i < ENC_LIN_TEST_BENCH; i++) {
+        acc += EncLin_Apply(g_Motor.EncLin.Table, (uint16_t)((i * 2654435761u) >> 18));
+    }
+    double apply = (double)(Test_NowNs() - t0) / ENC_LIN_TEST_BENCH;
+
+    const int16_t *lin = g_Motor.Encoder.Lin;
+    double proc[2];
+    for (uint32_t k = 0; k < 2u; k++) {
+        g_Motor.Encoder.Lin = k ? lin : NULL;
+        t0 = Test_NowNs();
+        for (uint32_t i = 0; i < ENC_LIN_TEST_BENCH / 10u; i++) {
+            MotorHW_ProcessEncoderData(g_Motor.HW, &g_Motor.Encoder);
+        }
+        proc[k] = (double)(Test_NowNs() - t0) / (ENC_LIN_TEST_BENCH / 10u);
+    }
+    g_Motor.Encoder.Lin = lin;
+    printf("cost (host): EncLin_Apply %.2f ns, encoder processing %.2f ns without / %.2f ns with table\n",
+           apply, proc[0], proc[1]);
+    (void)acc;
+}
+
+int main(void)
+{
+    Ripple_t before[2], after[2], reload;
+    const float rpm[2] = { 300.0f, 1500.0f };
+
+    MotorHW_Sim_Init(&g_MotorHW[0], NULL, 2.1f, 1);
+    MotorHW_Sim_SetEncoderError(&g_MotorHW[0], 1, ENC_LIN_TEST_A1, 0.7f);
+    MotorHW_Sim_SetEncoderError(&g_MotorHW[0], 2, 0.25f * ENC_LIN_TEST_A1, -1.3f);
+    FOC_FlashSim_Reset();
+    FOC_Param_Init();
+    FOC_Init(&g_Motor, 0);
+    for (uint32_t i = 0; i < 2000u; i++) FOC_SimTick(&g_Motor);     // 电流偏移校准
+
+    /*--- 不补偿 ---*/
+    Run_Calib(0);
+    TEST_CHECK(g_Motor.Encoder.Lin == NULL);
+    for (uint32_t k = 0; k < 2u; k++) before[k] = Measure("before", rpm[k]);
+
+    /*--- 标定补偿表, 重新校准零点 ---*/
+    Run_Calib(1);
+    Run_Calib(0);
+    printf("table peak %.4f rad (injected %.4f + %.4f)\n", (double)g_Motor.EncLin.Peak,
+           (double)ENC_LIN_TEST_A1, (double)(0.25f * ENC_LIN_TEST_A1));
+    TEST_CHECK(g_Motor.EncLin.Valid && g_Motor.Encoder.Lin == g_Motor.EncLin.Table);
+    for (uint32_t k = 0; k < 2u; k++) {
+        after[k] = Measure("after", rpm[k]);
+        Check_Gain(&before[k], &after[k]);
+    }
+
+    /*--- 保存后重新上电 ---*/
+    TEST_CHECK(FOC_Param_Save() == FOC_PARAM_OK);
+    int16_t table[ENC_LIN_SIZE + 1];
+    memcpy(table, g_Motor.EncLin.Table, sizeof(table));
+    memset(&g_Motor, 0, sizeof(g_Motor));
+    FOC_Param_Init();
+    FOC_Init(&g_Motor, 0);
+    TEST_CHECK(g_Motor.EncLin.Valid && g_Motor.Encoder.Lin == g_Motor.EncLin.Table);
+    TEST_CHECK(memcmp(table, g_Motor.EncLin.Table, sizeof(table)) == 0);
+    for (uint32_t i = 0; i < 2000u; i++) FOC_SimTick(&g_Motor);
+    reload = Measure("reload", rpm[1]);
+    Check_Gain(&before[1], &reload);
+
+    Bench();
+    return Test_Result("test_enc_lin");
+}
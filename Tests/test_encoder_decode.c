@@ -0,0 +1,127 @@
+/**
+ * @file    test_encoder_decode.c
+ * @brief   编码器整数相位解码: 精度 (对双精度参考) 与耗时 (对浮点 + fmodf 解码)
+ * @note    1. 全部 14-bit 读数 × 两个方向 × 多组极对数与零点, 机械角 / 电角度与双精度参考
+ *             按圆周取差不超过 DEC_MAX_ERR (电角度按极对数放大), 且严格落在 [0, 2π); ElecPhase 与电角度一致
+ *          2. PLL 角度归一化: 任意转速下 AngleEst 保持在 [0, 2π)
+ *          3. 打印批量解码的单次耗时, 以及 FOC_Perf_BenchEncoder 的逐次计时结果
+ */
+
+#include "foc_core.h"
+#include "foc_perf.h"
+#include "test_util.h"
+#include <math.h>
+
+#define DEC_MAX_ERR         1e-6        // 机械角误差上限: 高 24 位转浮点 2π/2^24 ≈ 3.7e-7, 另加单精度舍入
+                                        // 电角度上限为 (1 + Pp) 倍 (零点的单精度舍入随 Pp 放大)
+#define DEC_BENCH_ROUNDS    200u
+#define DEC_DT              (1.0f / (float)HW_PWM_FREQ_HZ)
+
+static const uint8_t dec_poles[] = { 1, 2, 7, 14, 21, 32 };
+static const float dec_offsets[] = { 0.0f, 0.386563f, 3.14159f, 6.28f };
+
+/**
+ * @brief  浮点 + fmodf 解码 (整数相位解码之前的实现, 耗时参考)
+ */
+static void Decode_Fmodf(EncoderData_t *encoder, uint16_t raw_angle)
+{
+    float mech = (float)encoder->Direction * (float)raw_angle * (FOC_2PI / (float)HW_ENCODER_CPR);
+    mech = fmodf(mech + FOC_2PI, FOC_2PI);
+
+    encoder->RawAngle = raw_angle;
+    encoder->MechAngle = mech;
+    encoder->ElecAngle = fmodf((mech - encoder->ZeroOffset) * (float)encoder->PolePairs + FOC_2PI, FOC_2PI);
+}
+
+static double Circ_Err(double a, double b)
+{
+    double e = fmod(fabs(a - b), 2.0 * M_PI);
+    return (e > M_PI) ? 2.0 * M_PI - e : e;
+}
+
+int main(void)
+{
+    EncoderData_t enc = {0};
+    double max_mech = 0.0, max_elec = 0.0, max_phase = 0.0;
+    uint32_t range_bad = 0, err_bad = 0;
+
+    /*--- 精度 ---*/
+    for (uint32_t p = 0; p < sizeof(dec_poles); p++) {
+        for (uint32_t o = 0; o < sizeof(dec_offsets) / sizeof(dec_offsets[0]); o++) {
+            enc.PolePairs = dec_poles[p];
+            MotorHW_SetEncoderOffset(&enc, dec_offsets[o]);
+            for (int8_t dir = -1; dir <= 1; dir += 2) {
+                enc.Direction = dir;
+                for (uint32_t raw = 0; raw < HW_ENCODER_CPR; raw++) {
+                    MotorHW_DecodeEncoder(&enc, (uint16_t)raw);
+                    double mech = fmod(dir * (double)raw * (2.0 * M_PI / HW_ENCODER_CPR) + 2.0 * M_PI,
+                                       2.0 * M_PI);
+                    double elec = (mech - (double)enc.ZeroOffset) * dec_poles[p];
+                    double em = Circ_Err(enc.MechAngle, mech);
+                    double ee = Circ_Err(enc.ElecAngle, elec);
+                    double ep = Circ_Err(enc.ElecPhase * (2.0 * M_PI / 65536.0), enc.ElecAngle);
+
+                    if (em > DEC_MAX_ERR || ee > DEC_MAX_ERR * (1.0 + dec_poles[p])) err_bad++;
+                    if (em > max_mech) max_mech = em;
+                    if (ee > max_elec) max_elec = ee;
+                    if (ep > max_phase) max_phase = ep;
+                    if (enc.MechAngle < 0.0f || enc.MechAngle >= FOC_2PI ||
+                        enc.ElecAngle < 0.0f || enc.ElecAngle >= FOC_2PI) range_bad++;
+                }
+            }
+        }
+    }
+    printf("decode max err mech %.2e elec %.2e rad, phase vs angle %.2e rad, out of range %u\n",
+           max_mech, max_elec, max_phase, (unsigned)range_bad);
+    TEST_CHECK(err_bad == 0);
+    TEST_CHECK(max_phase <= 2.0 * M_PI / 65536.0);              // 截断到 Q16
+    TEST_CHECK(range_bad == 0);
+
+    /*--- PLL 角度归一化 ---*/
+    uint32_t pll_bad = 0;
+    for (uint32_t k = 0; k < 8u; k++) {
+        PLL_t pll;
+        float omega = (float)k * 900.0f - 3000.0f;             // -3000 ~ 3300 rad/s, 每周期最多约 0.17 rad
+        float theta = 0.0f;
+
+        PLL_Init(&pll, 200.0f, 20000.0f);
+        for (uint32_t i = 0; i < 100000u; i++) {
+            theta = fmodf(theta + omega * DEC_DT + FOC_2PI, FOC_2PI);
+            PLL_Update(&pll, theta, DEC_DT);
+            if (pll.AngleEst < 0.0f || pll.AngleEst >= FOC_2PI) pll_bad++;
+        }
+        TEST_CHECK(fabsf(pll.SpeedRadS - omega) < 1e-2f * (1.0f + fabsf(omega)));
+    }
+    TEST_CHECK(pll_bad == 0);
+
+    /*--- 耗时 (仅打印) ---*/
+    EncoderData_t a = {0};
+    volatile float sink = 0.0f;
+    uint64_t t[2];
+
+    a.PolePairs = HW_MOTOR_POLE_PAIRS;
+    a.Direction = -1;
+    MotorHW_SetEncoderOffset(&a, HW_ENCODER_ZERO_OFFSET);
+    for (uint32_t k = 0; k < 2u; k++) {
+        uint64_t t0 = Test_NowNs();
+        for (uint32_t r = 0; r < DEC_BENCH_ROUNDS; r++) {
+            for (uint32_t raw = 0; raw < HW_ENCODER_CPR; raw++) {
+                if (k == 0) Decode_Fmodf(&a, (uint16_t)raw);
+                else        MotorHW_DecodeEncoder(&a, (uint16_t)raw);
+                sink += a.ElecAngle;
+            }
+        }
+        t[k] = Test_NowNs() - t0;
+    }
+    (void)sink;
+
+    FOC_PerfEncoder_t perf;
+    FOC_Perf_BenchEncoder(&perf);
+    printf("batch: fmodf %.2f ns, integer %.2f ns per sample (host)\n",
+           (double)t[0] / (DEC_BENCH_ROUNDS * HW_ENCODER_CPR), (double)t[1] / (DEC_BENCH_ROUNDS * HW_ENCODER_CPR));
+    printf("FOC_Perf_BenchEncoder: fmodf %.1f, integer %.1f (incl. timer overhead), max elec err %.2e rad\n",
+           (double)perf.FmodfCycles, (double)perf.IntCycles, (double)perf.MaxErrElec);
+    TEST_CHECK(perf.MaxErrElec < 1e-4f);                        // 参考实现为单精度, 误差随 Pp 放大
+
+    return Test_Result("test_encoder_decode");
+}
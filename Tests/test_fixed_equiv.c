@@ -0,0 +1,133 @@
+/**
+ * @file    test_fixed_equiv.c
+ * @brief   定点 (Q15) 与浮点电流环流水线等价性: 相同输入下 Id/Iq、PI 输出、CCR 的偏差上限
+ * @note    电流路径: ADC 码值 + 编码器读数 → Clarke → Park
+ *          电压路径: Vd/Vq + 同一电角度 → 逆 Park → SVPWM (线性区)
+ *          PI: 同一误差序列逐周期比较输出电压
+ */
+
+#include "foc_fixed.h"
+#include "foc_math.h"
+#include "svpwm.h"
+#include "motor_hw.h"
+#include "test_util.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define EQ_SAMPLES          200000u
+#define EQ_VDC              12.0f
+#define EQ_OFFSET_U         2051.3f     // ADC 零点 (LSB)
+#define EQ_OFFSET_V         2046.7f
+#define EQ_KP               0.07037f    // 与 foc_core.c 默认电流环增益一致
+#define EQ_KI               0.01423f
+
+/* 偏差上限 */
+#define EQ_MAX_I_LSB        0.5f        // Id/Iq (ADC LSB): Q15 量化 + 正弦表误差
+#define EQ_MAX_V            0.02f       // PI 输出 (V)
+#define EQ_MAX_CCR          1u          // CCR (计数, 取整差)
+
+static uint32_t Rand_U32(void)
+{
+    static uint32_t x = 0x12345678u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+static float Rand_Sym(float amp)
+{
+    return ((float)(Rand_U32() & 0xFFFFu) / 32768.0f - 1.0f) * amp;
+}
+
+int main(void)
+{
+    PID_Controller_t pid_d, pid_q;
+    FOC_Fixed_t fx;
+    const float current_fs = 2048.0f * HW_CURRENT_SCALE;
+    float max_i = 0.0f, max_v = 0.0f;
+    uint32_t max_ccr = 0;
+
+    PID_Init(&pid_d, EQ_KP, EQ_KI, 0.0f, EQ_VDC, -EQ_VDC);
+    PID_Init(&pid_q, EQ_KP, EQ_KI, 0.0f, EQ_VDC, -EQ_VDC);
+    FOC_Fixed_Init(&fx, &pid_d, &pid_q, current_fs, EQ_VDC);
+    FOC_Fixed_SetOffset(&fx, EQ_OFFSET_U, EQ_OFFSET_V);
+
+    EncoderData_t enc = {0};
+    enc.PolePairs = HW_MOTOR_POLE_PAIRS;
+    MotorHW_SetEncoderOffset(&enc, HW_ENCODER_ZERO_OFFSET);
+
+    for (uint32_t n = 0; n < EQ_SAMPLES; n++) {
+        /*--- 电流路径 (幅值限制在 Q15 不饱和范围内) ---*/
+        uint32_t adc_u = 2048u + (uint32_t)(int32_t)Rand_Sym(600.0f);
+        uint32_t adc_v = 2048u + (uint32_t)(int32_t)Rand_Sym(600.0f);
+        enc.Direction = (n & 1u) ? 1 : -1;
+        MotorHW_DecodeEncoder(&enc, (uint16_t)(Rand_U32() & (HW_ENCODER_CPR - 1u)));
+
+        SinCos_t sc;
+        Clarke_t clarke = {0};
+        Park_t park = {0};
+        clarke.Ia = ((float)adc_u - EQ_OFFSET_U) * HW_CURRENT_SCALE;
+        clarke.Ib = ((float)adc_v - EQ_OFFSET_V) * HW_CURRENT_SCALE;
+        clarke.Ic = -clarke.Ia - clarke.Ib;
+        Clarke_Calc(&clarke);
+        FOC_SinCos(enc.ElecAngle, &sc);
+        park.Alpha = clarke.Alpha;
+        park.Beta = clarke.Beta;
+        Park_CalcSinCos(&park, &sc);
+
+        int32_t s_q15, c_q15;
+        FOC_Fixed_Sample(&fx, adc_u, adc_v);
+        Clarke_Q15(&fx);
+        SinCos_Q15(enc.ElecPhase, &s_q15, &c_q15);
+        Park_Q15(&fx, s_q15, c_q15);
+
+        float di = fmaxf(fabsf(FOC_Fixed_ToAmps(&fx, fx.Id) - park.D),
+                         fabsf(FOC_Fixed_ToAmps(&fx, fx.Iq) - park.Q));
+        if (di > max_i) max_i = di;
+
+        /*--- 电压路径 (线性区 |V| ≤ Udc/√3) ---*/
+        float mag = (float)(Rand_U32() & 0xFFFFu) / 65536.0f * EQ_VDC * FOC_ONE_BY_SQRT3 * 0.98f;
+        float ang = (float)(Rand_U32() & 0xFFFFu) / 65536.0f * FOC_2PI;
+        InvPark_t ip = {0};
+        SVPWM_t sv;
+        ip.D = mag * cosf(ang);
+        ip.Q = mag * sinf(ang);
+        InvPark_CalcSinCos(&ip, &sc);
+        SVPWM_Init(&sv, EQ_VDC, HW_PWM_PERIOD);
+        sv.Alpha = ip.Alpha;
+        sv.Beta = ip.Beta;
+        SVPWM_Calc(&sv);
+
+        fx.Vd = (int32_t)lrintf(ip.D / EQ_VDC * 32768.0f);
+        fx.Vq = (int32_t)lrintf(ip.Q / EQ_VDC * 32768.0f);
+        InvPark_Q15(&fx, s_q15, c_q15);
+        SVPWM_Q15(&fx, HW_PWM_PERIOD);
+
+        uint32_t d1 = (uint32_t)abs((int32_t)fx.CCR1 - (int32_t)sv.CCR1);
+        uint32_t d2 = (uint32_t)abs((int32_t)fx.CCR2 - (int32_t)sv.CCR2);
+        uint32_t d3 = (uint32_t)abs((int32_t)fx.CCR3 - (int32_t)sv.CCR3);
+        if (d1 > max_ccr) max_ccr = d1;
+        if (d2 > max_ccr) max_ccr = d2;
+        if (d3 > max_ccr) max_ccr = d3;
+    }
+
+    /*--- PI: 同一误差序列 (含进入限幅的大误差段) ---*/
+    PI_Q15_Reset(&fx.PI_D);
+    PID_Init(&pid_d, EQ_KP, EQ_KI, 0.0f, EQ_VDC, -EQ_VDC);
+    for (uint32_t n = 0; n < 20000u; n++) {
+        float ref = (n % 4000u < 2000u) ? 2.0f : -1.0f;
+        float fdb = ref * (float)(n % 2000u) / 2000.0f + Rand_Sym(0.05f);
+        float vf = PI_Calc(&pid_d, ref, fdb);
+        int32_t vq15 = PI_Q15_Calc(&fx.PI_D, FOC_Fixed_FromAmps(&fx, ref), FOC_Fixed_FromAmps(&fx, fdb));
+        float dv = fabsf(FOC_Fixed_ToVolts(vq15, EQ_VDC) - vf);
+        if (dv > max_v) max_v = dv;
+    }
+
+    printf("max deviation: Id/Iq %.4f A (%.2f LSB), PI out %.4f V, CCR %u counts\n",
+           (double)max_i, (double)(max_i / HW_CURRENT_SCALE), (double)max_v, (unsigned)max_ccr);
+    TEST_CHECK(max_i < EQ_MAX_I_LSB * HW_CURRENT_SCALE);
+    TEST_CHECK(max_v < EQ_MAX_V);
+    TEST_CHECK(max_ccr <= EQ_MAX_CCR);
+    return Test_Result("test_fixed_equiv");
+}
@@ -0,0 +1,88 @@
+/**
+ * @file    test_fixed_loop.c
+ * @brief   定点构建 (FOC_USE_FIXED_POINT = 1) 闭环仿真: 速度跟踪与调试输出通道
+ * @note    检查 FOC_UpdateDebugValues 由 Q15 结果换算的 InvPark / SVPWM.Alpha/Beta / Currents / Clarke
+ *          与 Q15 流水线输出一致 (VOFA_UpdateFromMotor 先换算再读取这些字段);
+ *          控制循环本身不写这些字段;
+ *          SVPWM_Q15 只有连续调制与六边形缩放, 其他调制算法 / 过调制策略在设置时被拒绝
+ */
+
+#include "foc_core.h"
+#include "test_util.h"
+#include <math.h>
+
+#define LOOP_SPEED_RPM      1000.0f
+#define LOOP_TICKS          40000u
+
+int main(void)
+{
+    const Motor_t *m = &g_Motor;
+    uint32_t bad_ccr = 0, bad_v = 0, bad_i = 0, stale = 0;
+
+    MotorHW_Sim_Init(&g_MotorHW[0], NULL, HW_ENCODER_ZERO_OFFSET, 1);
+    FOC_Init(&g_Motor, 0);
+
+    TEST_CHECK(FOC_SetPwmMode(&g_Motor, SVPWM_MODE_DPWM1) == 0);
+    TEST_CHECK(FOC_SetPwmMode(&g_Motor, SVPWM_MODE_AUTO) == 0);
+    TEST_CHECK(FOC_SetPwmMode(&g_Motor, SVPWM_MODE_MINMAX) == 1 && m->SVPWM.Mode == SVPWM_MODE_MINMAX);
+    TEST_CHECK(FOC_SetOvermodulation(&g_Motor, SVPWM_OVM_TWO_ZONE, 1.0f) == 0);
+    TEST_CHECK(FOC_SetOvermodulation(&g_Motor, SVPWM_OVM_SIX_STEP, 1.0f) == 0);
+    TEST_CHECK(m->SVPWM.Ovm == SVPWM_OVM_MIN_PHASE);
+    TEST_CHECK(FOC_SetOvermodulation(&g_Motor, SVPWM_OVM_MIN_PHASE, 1.0f) == 1);
+
+    FOC_Start(&g_Motor);
+    FOC_SetMode(&g_Motor, FOC_MODE_SPEED);
+    FOC_SetTargetSpeed(&g_Motor, LOOP_SPEED_RPM);
+
+    for (uint32_t i = 0; i < LOOP_TICKS; i++) {
+        FOC_SimTick(&g_Motor);
+        if (i < 2000u) continue;
+        if (i == 2000u) {
+            /* 未调用换算前调试字段保持初始值 */
+            TEST_CHECK(m->InvPark.D == 0.0f && m->Currents.Iu == 0.0f && m->SVPWM.Alpha == 0.0f);
+        }
+        FOC_UpdateDebugValues(&g_Motor);
+
+        /* 由换算后的 αβ 电压重算浮点 SVPWM, CCR 与定点输出相差不超过 1 计数 */
+        SVPWM_t sv;
+        SVPWM_Init(&sv, m->Vdc, m->PwmPeriod);
+        sv.Alpha = m->SVPWM.Alpha;
+        sv.Beta = m->SVPWM.Beta;
+        SVPWM_Calc(&sv);
+        if (fabsf((float)sv.CCR1 - (float)m->SVPWM.CCR1) > 1.0f ||
+            fabsf((float)sv.CCR2 - (float)m->SVPWM.CCR2) > 1.0f ||
+            fabsf((float)sv.CCR3 - (float)m->SVPWM.CCR3) > 1.0f) {
+            bad_ccr++;
+        }
+
+        /* dq 与 αβ 电压幅值一致 (逆 Park 保幅) */
+        float vdq = sqrtf(m->InvPark.D * m->InvPark.D + m->InvPark.Q * m->InvPark.Q);
+        float vab = sqrtf(m->InvPark.Alpha * m->InvPark.Alpha + m->InvPark.Beta * m->InvPark.Beta);
+        if (fabsf(vdq - vab) > 0.01f) bad_v++;
+
+        /* Clarke 输出与相电流一致 */
+        if (fabsf(m->Clarke.Alpha - m->Currents.Iu) > 1e-6f) bad_i++;
+
+        /* 本周期的 Q15 结果 (非上一周期或初始化时的残留值) */
+        if (m->InvPark.D != FOC_Fixed_ToVolts(m->Fixed.Vd, m->Vdc) ||
+            m->SVPWM.Beta != FOC_Fixed_ToVolts(m->Fixed.VBeta, m->Vdc) ||
+            m->Currents.Iv != FOC_Fixed_ToAmps(&m->Fixed, m->Fixed.Iv)) {
+            stale++;
+        }
+    }
+
+    float rpm_true = MotorHW_Sim_GetPlant(g_Motor.HW)->OmegaMech * (60.0f / FOC_2PI);
+    printf("fixed-point loop: %.1f rpm (plant %.1f), |Vdq| %.3f V, ccr mismatch %u, "
+           "|V| mismatch %u, clarke mismatch %u, stale %u / %u\n",
+           (double)m->ActualRPM, (double)rpm_true,
+           (double)sqrtf(m->InvPark.D * m->InvPark.D + m->InvPark.Q * m->InvPark.Q),
+           (unsigned)bad_ccr, (unsigned)bad_v, (unsigned)bad_i, (unsigned)stale,
+           (unsigned)(LOOP_TICKS - 2000u));
+
+    TEST_CHECK(fabsf(rpm_true - LOOP_SPEED_RPM) < 20.0f);
+    TEST_CHECK(bad_ccr == 0);
+    TEST_CHECK(bad_v == 0);
+    TEST_CHECK(bad_i == 0);
+    TEST_CHECK(stale == 0);
+    return Test_Result("test_fixed_loop");
+}
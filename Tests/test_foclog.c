@@ -0,0 +1,388 @@
+/**
+ * @file    test_foclog.c
+ * @brief   上位机记录工具 (Tools/foclog) 测试: 数据流失步重同步、日志断尾恢复、按时间定位
+ * @note    1. 解帧: 实时数据帧 / 遥测帧 / 示波器帧交错, 起始与中途夹杂垃圾字节,
+ *             每段垃圾最多损失其后的一个实时数据帧, 其余帧内容完整、顺序不变;
+ *             整块输入与随机长度分块输入的解帧结果一致
+ *          2. 断尾: 末块只写了一部分 (异常退出) 时映射只取完整块, 重新打开写入截掉残块,
+ *             追加的记录接在最后完整块之后, 整个文件 CRC 校验通过; 损坏块之后的块在校验映射时被截止
+ *          3. 定位: 多块、节拍号有重复与间隔时, FOC_Log_Seek 返回节拍号不小于目标的第一条记录,
+ *             与参考数组的二分结果逐一比对 (块边界、首尾、越界)
+ */
+
+#include "foc_stream.h"
+#include "foc_log.h"
+#include "test_util.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define FL_PATH             "test_foclog.tmp"
+#define FL_FRAMES           20000u
+#define FL_BURST_EVERY      97u         // 每多少个实时数据帧插入一段垃圾
+#define FL_ROWS             60000u
+#define FL_ROWS_PER_CHUNK   7001u       // 手动写出块的间隔 (不是索引间隔的整数倍)
+#define FL_SEEKS            200000u
+
+static uint32_t fl_rng = 0x2545F491u;
+
+static uint32_t Fl_Rand(void)
+{
+    fl_rng ^= fl_rng << 13;
+    fl_rng ^= fl_rng >> 17;
+    fl_rng ^= fl_rng << 5;
+    return fl_rng;
+}
+
+/*============================================================================*/
+/*                              解帧                                           */
+/*============================================================================*/
+
+/* 序号 seq 的实时数据帧通道 c 的值 (单精度可精确表示) */
+static float Fl_Value(uint32_t seq, uint32_t c)
+{
+    return (float)((seq * 7u + c * 131u) & 0xFFFFu) - 1000.0f;
+}
+
+typedef struct {
+    uint32_t Vofa;              // 实时数据帧
+    uint32_t Scope;             // 示波器帧 (5 通道)
+    uint32_t Proto;             // 遥测帧
+    uint32_t Bad;               // 内容错误或乱序的帧
+    uint32_t Bogus;             // 其他通道数的 JustFloat (垃圾与下一帧拼成)
+    int64_t LastSeq;
+    uint64_t Sum;               // 帧序号与类别的累加 (比较分块输入)
+} FlParse_t;
+
+static void Fl_OnFrame(const FOC_StreamFrame_t *f, void *user)
+{
+    FlParse_t *p = user;
+
+    switch (f->Kind) {
+        case FOC_STREAM_VOFA: {
+            uint32_t seq = (uint32_t)f->Values[FOC_LINK_VOFA_CH + 1];
+            for (uint32_t c = 0; c < FOC_LINK_VOFA_CH; c++) {
+                if (f->Values[c] != Fl_Value(seq, c)) {
+                    p->Bad++;
+                    break;
+                }
+            }
+            if ((int64_t)seq <= p->LastSeq) p->Bad++;
+            p->LastSeq = seq;
+            p->Vofa++;
+            p->Sum += seq;
+            break;
+        }
+        case FOC_STREAM_SCOPE:
+            if (f->Count == 5 && f->Values[0] == 0.5f && f->Values[4] == 4.0f) {
+                p->Scope++;
+            } else {
+                p->Bogus++;
+            }
+            p->Sum += 1000003u * f->Count;
+            break;
+        case FOC_STREAM_PROTO:
+            /* 紧跟在序号为 5 的倍数的实时数据帧之后 (该帧可能被垃圾吞掉) */
+            if (f->Proto.Type != PROTO_MSG_TELEM || f->Proto.Len != 8 ||
+                Proto_GetU32(&f->Proto.Payload[0]) % 5u != 0 ||
+                (int64_t)Proto_GetU32(&f->Proto.Payload[0]) < p->LastSeq) {
+                p->Bad++;
+            }
+            p->Proto++;
+            p->Sum += 7u * f->Proto.Seq;
+            break;
+    }
+}
+
+/**
+ * @brief  生成数据流, 返回长度
+ */
+static uint64_t Fl_Generate(uint8_t *buf, uint32_t *bursts, uint32_t *protos, uint32_t *scopes)
+{
+    static const uint8_t tail[4] = { 0x00, 0x00, 0x80, 0x7F };
+    uint64_t n = 0;
+
+    *bursts = 0;
+    *protos = 0;
+    *scopes = 0;
+
+    /* 接在中途: 先是半个帧与若干垃圾 */
+    for (uint32_t i = 0; i < 61u; i++) buf[n++] = (uint8_t)(Fl_Rand() % 0x7Fu);
+
+    for (uint32_t seq = 0; seq < FL_FRAMES; seq++) {
+        float v[FOC_LINK_VOFA_CH + 2];
+
+        if (seq % FL_BURST_EVERY == 50u) {
+            uint32_t len = 1u + Fl_Rand() % 60u;
+            for (uint32_t i = 0; i < len; i++) buf[n++] = (uint8_t)(Fl_Rand() % 0x7Fu);   // 不含帧尾字节
+            if (seq % 3u == 0) buf[n - len] = PROTO_SYNC;                                  // 伪协议帧头
+            (*bursts)++;
+        }
+
+        for (uint32_t c = 0; c < FOC_LINK_VOFA_CH; c++) v[c] = Fl_Value(seq, c);
+        v[FOC_LINK_VOFA_CH] = (float)(seq * 2u);
+        v[FOC_LINK_VOFA_CH + 1] = (float)seq;
+        memcpy(&buf[n], v, sizeof(v));
+        memcpy(&buf[n + sizeof(v)], tail, sizeof(tail));
+        n += sizeof(v) + sizeof(tail);
+
+        if (seq % 5u == 0) {
+            uint8_t payload[8];
+            Proto_PutU32(&payload[0], seq);
+            Proto_PutU32(&payload[4], 0);
+            n += Proto_Encode(&buf[n], PROTO_MSG_TELEM, (uint8_t)seq, payload, sizeof(payload));
+            (*protos)++;
+        }
+        if (seq % 37u == 0) {
+            float s[5] = { 0.5f, 1.0f, 2.0f, 3.0f, 4.0f };
+            memcpy(&buf[n], s, sizeof(s));
+            memcpy(&buf[n + sizeof(s)], tail, sizeof(tail));
+            n += sizeof(s) + sizeof(tail);
+            (*scopes)++;
+        }
+    }
+    return n;
+}
+
+static void Test_Resync(void)
+{
+    static FOC_Stream_t s1, s2;
+    uint8_t *buf = malloc(FL_FRAMES * 256u);
+    uint32_t bursts, protos, scopes;
+    FlParse_t a, b;
+
+    uint64_t len = Fl_Generate(buf, &bursts, &protos, &scopes);
+
+    /* 整块 */
+    memset(&a, 0, sizeof(a));
+    a.LastSeq = -1;
+    FOC_Stream_Init(&s1);
+    FOC_Stream_Feed(&s1, buf, len, Fl_OnFrame, &a);
+
+    /* 随机长度分块 (含 1 字节) */
+    memset(&b, 0, sizeof(b));
+    b.LastSeq = -1;
+    FOC_Stream_Init(&s2);
+    for (uint64_t i = 0; i < len;) {
+        uint64_t n = 1u + Fl_Rand() % 300u;
+        if (n > len - i) n = len - i;
+        FOC_Stream_Feed(&s2, &buf[i], n, Fl_OnFrame, &b);
+        i += n;
+    }
+
+    printf("stream %llu bytes, %u bursts: vofa %u/%u scope %u/%u proto %u/%u, bogus %u, resyncs %u, "
+           "skipped %llu bytes\n", (unsigned long long)len, bursts, a.Vofa, FL_FRAMES, a.Scope, scopes,
+           a.Proto, protos, a.Bogus, s1.Resyncs, (unsigned long long)s1.SkippedBytes);
+
+    TEST_CHECK(a.Bad == 0);
+    TEST_CHECK(a.Vofa + bursts + 1u >= FL_FRAMES);      // 每段垃圾最多损失一帧, 起始失步丢掉第一帧
+    TEST_CHECK(a.Vofa < FL_FRAMES);                     // 垃圾确实造成了失步
+    TEST_CHECK(a.Proto == protos);                      // 垃圾只插在实时数据帧之前
+    TEST_CHECK(a.Scope == scopes);
+    TEST_CHECK(s1.Resyncs > 0 && s1.Resyncs <= bursts);
+    TEST_CHECK(s1.SkippedBytes >= 61u);
+
+    TEST_CHECK(b.Bad == 0);
+    TEST_CHECK(b.Vofa == a.Vofa && b.Scope == a.Scope && b.Proto == a.Proto && b.Bogus == a.Bogus);
+    TEST_CHECK(b.Sum == a.Sum);
+    TEST_CHECK(s2.Resyncs == s1.Resyncs && s2.SkippedBytes == s1.SkippedBytes);
+    free(buf);
+}
+
+/*============================================================================*/
+/*                              日志                                           */
+/*============================================================================*/
+
+/* 第 row 条记录的数据 (记录号 + 节拍号, 长度随记录号变化) */
+static uint32_t Fl_RowData(uint32_t row, uint64_t tick, uint32_t *d)
+{
+    uint32_t n = 2u + row % 7u;
+
+    for (uint32_t i = 0; i < n; i++) d[i] = row * 2654435761u + i;
+    d[0] = row;
+    d[1] = (uint32_t)tick;
+    return n * (uint32_t)sizeof(uint32_t);
+}
+
+static int Fl_Write(FOC_LogWriter_t *w, uint32_t row, uint64_t tick)
+{
+    uint32_t d[16];
+    uint32_t len = Fl_RowData(row, tick, d);
+
+    return FOC_Log_Append(w, (uint8_t)(row % 3u), 0, row, tick, d, len);
+}
+
+/**
+ * @brief  顺序读全部记录, 检查内容并返回记录数 (出错计入 bad)
+ */
+static uint64_t Fl_Verify(const FOC_LogReader_t *r, const uint64_t *ticks, uint32_t *bad)
+{
+    FOC_LogCursor_t c;
+    const FOC_LogRow_t *row;
+    const void *data;
+    uint64_t n = 0;
+
+    if (FOC_Log_Seek(r, 0, &c) != 0) return 0;
+    while ((row = FOC_Log_Next(r, &c, &data)) != NULL) {
+        uint32_t d[16];
+        uint32_t len = Fl_RowData((uint32_t)n, ticks[n], d);
+        if (row->Tick != ticks[n] || row->Len != len || row->Mask != n || memcmp(data, d, len) != 0) {
+            (*bad)++;
+        }
+        n++;
+    }
+    return n;
+}
+
+static void Test_TornTail(const uint64_t *ticks)
+{
+    FOC_LogWriter_t w;
+    FOC_LogReader_t r;
+    uint32_t bad = 0;
+    uint32_t row = 0;
+
+    unlink(FL_PATH);
+    TEST_CHECK(FOC_Log_Open(&w, FL_PATH, 20000u) == 0);
+    for (; row < 3u * FL_ROWS_PER_CHUNK; row++) {
+        TEST_CHECK(Fl_Write(&w, row, ticks[row]) == 0);
+        if ((row + 1u) % FL_ROWS_PER_CHUNK == 0) TEST_CHECK(FOC_Log_Flush(&w) == 0);
+    }
+    TEST_CHECK(FOC_Log_Close(&w) == 0);
+    TEST_CHECK(FOC_Log_Map(&r, FL_PATH, 1) == 0);
+    uint64_t good = (uint64_t)((const uint8_t *)r.Chunks[2] - r.Base);      // 前两块的结尾
+    uint32_t chunk_size = r.Chunks[2]->Size;
+    FOC_Log_Unmap(&r);
+
+    /* 最后一块只写出一半 */
+    TEST_CHECK(truncate(FL_PATH, (off_t)(good + chunk_size / 2u)) == 0);
+    TEST_CHECK(FOC_Log_Map(&r, FL_PATH, 0) == 0);
+    TEST_CHECK(r.ChunkCnt == 2u && r.Size == good && r.MapSize == good + chunk_size / 2u);
+    TEST_CHECK(r.Rows == 2u * FL_ROWS_PER_CHUNK);
+    FOC_Log_Unmap(&r);
+
+    /* 重新打开: 截掉残块, 接着最后完整块写 */
+    TEST_CHECK(FOC_Log_Open(&w, FL_PATH, 0) == 0);
+    TEST_CHECK(w.CtrlHz == 20000u);
+    TEST_CHECK(w.BaseTick == ticks[2u * FL_ROWS_PER_CHUNK - 1u] + 1u);
+    TEST_CHECK((uint64_t)ftello(w.File) == good);
+    for (row = 2u * FL_ROWS_PER_CHUNK; row < FL_ROWS; row++) {
+        TEST_CHECK(Fl_Write(&w, row, ticks[row]) == 0);
+        if ((row + 1u) % FL_ROWS_PER_CHUNK == 0) TEST_CHECK(FOC_Log_Flush(&w) == 0);
+    }
+    TEST_CHECK(FOC_Log_Close(&w) == 0);
+
+    TEST_CHECK(FOC_Log_Map(&r, FL_PATH, 1) == 0);
+    TEST_CHECK(r.Size == r.MapSize);
+    TEST_CHECK(r.Rows == FL_ROWS);
+    TEST_CHECK(r.ChunkCnt == (FL_ROWS + FL_ROWS_PER_CHUNK - 1u) / FL_ROWS_PER_CHUNK);
+    TEST_CHECK(Fl_Verify(&r, ticks, &bad) == FL_ROWS);
+    TEST_CHECK(bad == 0);
+    uint64_t corrupt = (uint64_t)((const uint8_t *)r.Chunks[4] - r.Base) + sizeof(FOC_LogChunk_t) + 100u;
+    printf("torn tail: kept %llu of %llu bytes, reopened at tick %llu, %u chunks / %llu rows after append\n",
+           (unsigned long long)good, (unsigned long long)(good + chunk_size / 2u),
+           (unsigned long long)ticks[2u * FL_ROWS_PER_CHUNK - 1u] + 1u, r.ChunkCnt,
+           (unsigned long long)r.Rows);
+    FOC_Log_Unmap(&r);
+
+    /* 块内容损坏: 校验映射截止在损坏块之前, 不校验时仍按块头读出全部块 */
+    FILE *f = fopen(FL_PATH, "r+b");
+    TEST_CHECK(f != NULL);
+    if (f != NULL) {
+        fseeko(f, (off_t)corrupt, SEEK_SET);
+        int ch = fgetc(f);
+        fseeko(f, (off_t)corrupt, SEEK_SET);
+        fputc(ch ^ 0x5A, f);
+        fclose(f);
+    }
+    TEST_CHECK(FOC_Log_Map(&r, FL_PATH, 1) == 0);
+    TEST_CHECK(r.ChunkCnt == 4u);
+    FOC_Log_Unmap(&r);
+    TEST_CHECK(FOC_Log_Map(&r, FL_PATH, 0) == 0);
+    TEST_CHECK(r.Rows == FL_ROWS);
+    FOC_Log_Unmap(&r);
+}
+
+/**
+ * @brief  参考: 第一个不小于 tick 的下标 (FL_ROWS 表示没有)
+ */
+static uint32_t Fl_LowerBound(const uint64_t *ticks, uint64_t tick)
+{
+    uint32_t lo = 0, hi = FL_ROWS;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2u;
+        if (ticks[mid] < tick) lo = mid + 1u; else hi = mid;
+    }
+    return lo;
+}
+
+static void Test_Seek(const uint64_t *ticks)
+{
+    FOC_LogWriter_t w;
+    FOC_LogReader_t r;
+    FOC_LogCursor_t c;
+    const void *data;
+    uint32_t bad = 0, miss = 0;
+    uint64_t edges[4];
+
+    unlink(FL_PATH);
+    TEST_CHECK(FOC_Log_Open(&w, FL_PATH, 20000u) == 0);
+    for (uint32_t row = 0; row < FL_ROWS; row++) {
+        TEST_CHECK(Fl_Write(&w, row, ticks[row]) == 0);
+        if ((row + 1u) % FL_ROWS_PER_CHUNK == 0) TEST_CHECK(FOC_Log_Flush(&w) == 0);
+    }
+    TEST_CHECK(FOC_Log_Close(&w) == 0);
+    TEST_CHECK(FOC_Log_Map(&r, FL_PATH, 1) == 0);
+    TEST_CHECK(r.Rows == FL_ROWS && r.ChunkCnt > 2u);
+
+    uint64_t last = ticks[FL_ROWS - 1u];
+    edges[0] = 0;
+    edges[1] = ticks[0];
+    edges[2] = last;
+    edges[3] = last + 1u;
+    uint64_t t0 = Test_NowNs();
+    for (uint32_t i = 0; i < FL_SEEKS + 2u * r.ChunkCnt + 4u; i++) {
+        uint64_t want;
+
+        /* 随机目标, 另加首尾、越界与每个块边界 */
+        if (i < FL_SEEKS)                       want = ((uint64_t)Fl_Rand() << 8 ^ Fl_Rand()) % (last + 3u);
+        else if (i < FL_SEEKS + r.ChunkCnt)     want = r.Chunks[i - FL_SEEKS]->FirstTick;
+        else if (i < FL_SEEKS + 2u * r.ChunkCnt) want = r.Chunks[i - FL_SEEKS - r.ChunkCnt]->LastTick + 1u;
+        else                                    want = edges[i - FL_SEEKS - 2u * r.ChunkCnt];
+
+        uint32_t expect = Fl_LowerBound(ticks, want);
+        if (FOC_Log_Seek(&r, want, &c) != 0) {
+            if (expect != FL_ROWS) miss++;
+            continue;
+        }
+        const FOC_LogRow_t *row = FOC_Log_Next(&r, &c, &data);
+        if (expect == FL_ROWS || row == NULL || row->Mask != expect || row->Tick != ticks[expect]) bad++;
+    }
+    double ns = (double)(Test_NowNs() - t0) / FL_SEEKS;
+
+    printf("seek: %u chunks, %llu rows, ticks 0..%llu, %.0f ns per seek+read (host), %u wrong, %u missed\n",
+           r.ChunkCnt, (unsigned long long)r.Rows, (unsigned long long)last, ns, bad, miss);
+    TEST_CHECK(bad == 0);
+    TEST_CHECK(miss == 0);
+    TEST_CHECK(FOC_Log_Seek(&r, last + 1u, &c) == -1);
+    FOC_Log_Unmap(&r);
+}
+
+int main(void)
+{
+    static uint64_t ticks[FL_ROWS];
+    uint64_t t = 5;
+
+    /* 节拍号单调不减: 间隔 0 (同一节拍多条) ~ 3, 偶有长间隔 */
+    for (uint32_t i = 0; i < FL_ROWS; i++) {
+        uint32_t r = Fl_Rand() % 100u;
+        t += (r < 20u) ? 0u : (r < 99u) ? 1u + r % 3u : 5000u;
+        ticks[i] = t;
+    }
+
+    Test_Resync();
+    Test_TornTail(ticks);
+    Test_Seek(ticks);
+    unlink(FL_PATH);
+    return Test_Result("test_foclog");
+}
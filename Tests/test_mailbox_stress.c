@@ -0,0 +1,177 @@
+/**
+ * @file    test_mailbox_stress.c
+ * @brief   命令邮箱多线程压力测试 (foc_atomic.h 仿真 __atomic 路径)
+ * @note    两个写线程持续发布自洽命令 (各字段由同一计数 k 推出, 64 位位置高低字都随 k 变化),
+ *          读线程模拟控制中断反复取用; 检查: 取到的命令从不混合新旧字段,
+ *          同一写端的 k 单调不减; 另检查按字段合并发布的语义
+ *          停机锁存: 写端持锁被打断时 FOC_Stop / FOC_EmergencyStop 发布失败,
+ *          该写端随后完成的运行模式命令在 FOC_Start 之前不得使电机重新运行
+ */
+
+#include "foc_core.h"
+#include "test_util.h"
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define MBX_WRITERS         2
+#define MBX_PUBLISHES       200000u     // 每个写线程的发布次数
+
+static FOC_Mailbox_t mbx;
+static int mbx_done = 0;
+static uint32_t pub_ok[MBX_WRITERS + 1], pub_try[MBX_WRITERS + 1];
+
+/* 由计数 k 与写端号 w 构造自洽命令 */
+static void Mbx_Make(FOC_Command_t *c, uint32_t w, uint32_t k)
+{
+    c->Mode = (uint8_t)w;
+    c->TargetId = (float)k;
+    c->TargetIq = -(float)k;
+    c->TargetRPM = 2.0f * (float)k;
+    c->TargetPosCnt = ((int64_t)k << 32) | (int64_t)(k ^ 0x5A5A5A5Au);
+}
+
+static int Mbx_Consistent(const FOC_Command_t *c, uint32_t *k)
+{
+    FOC_Command_t ref;
+
+    if (c->Mode < 1 || c->Mode > MBX_WRITERS) return 0;
+    *k = (uint32_t)(c->TargetPosCnt >> 32);
+    Mbx_Make(&ref, c->Mode, *k);
+    return c->TargetId == ref.TargetId && c->TargetIq == ref.TargetIq &&
+           c->TargetRPM == ref.TargetRPM && c->TargetPosCnt == ref.TargetPosCnt;
+}
+
+static void *Mbx_Writer(void *arg)
+{
+    uint32_t w = (uint32_t)(uintptr_t)arg;
+    FOC_Command_t c;
+
+    for (uint32_t k = 1; k <= MBX_PUBLISHES; k++) {
+        Mbx_Make(&c, w, k);
+        pub_try[w]++;
+        if (FOC_Mailbox_Publish(&mbx, FOC_CMD_ALL, &c)) {
+            pub_ok[w]++;
+        }
+        if ((k & 63u) == 0) sched_yield();
+    }
+    __atomic_add_fetch(&mbx_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/**
+ * @brief  模拟停机时邮箱正被打断的写端占用: 停机命令发布失败, 写端恢复后发布的是运行模式
+ */
+static void Test_StopLatch(uint8_t emergency)
+{
+    const MotorSim_t *plant;
+    uint32_t driven = 0;
+
+    MotorHW_Sim_Init(&g_MotorHW[0], NULL, HW_ENCODER_ZERO_OFFSET, 1);
+    FOC_Init(&g_Motor, 0);
+    plant = MotorHW_Sim_GetPlant(g_Motor.HW);
+    FOC_Start(&g_Motor);
+    FOC_SetMode(&g_Motor, FOC_MODE_SPEED);
+    FOC_SetTargetSpeed(&g_Motor, 1000.0f);
+    for (uint32_t i = 0; i < 20000u; i++) FOC_SimTick(&g_Motor);
+    TEST_CHECK(g_Motor.Mode == FOC_MODE_SPEED);
+
+    uint32_t busy = g_Motor.Cmd.Busy;
+    g_Motor.Cmd.Lock = 1;                                   // 写端持锁时被打断
+    if (emergency) FOC_EmergencyStop(&g_Motor);
+    else           FOC_Stop(&g_Motor);
+    TEST_CHECK(g_Motor.Cmd.Busy == busy + 1u);              // 停机命令未能发布
+    FOC_SimTick(&g_Motor);
+    TEST_CHECK(g_Motor.Mode == FOC_MODE_IDLE);
+
+    g_Motor.Cmd.Lock = 0;                                   // 写端恢复, 完成其运行命令
+    TEST_CHECK(FOC_SetMode(&g_Motor, FOC_MODE_SPEED) == 1);
+    TEST_CHECK(FOC_SetTargetSpeed(&g_Motor, 1500.0f) == 1);
+    for (uint32_t i = 0; i < 4000u; i++) {
+        FOC_SimTick(&g_Motor);
+        if (g_Motor.Mode != FOC_MODE_IDLE || g_Motor.InvPark.D != 0.0f || g_Motor.InvPark.Q != 0.0f) {
+            driven++;
+        }
+    }
+    printf("%s with mailbox held: driven ticks %u, mode %u, target %.0f rpm, speed %.0f rpm\n",
+           emergency ? "emergency stop" : "stop", (unsigned)driven, (unsigned)g_Motor.Mode,
+           (double)g_Motor.TargetRPM, (double)(plant->OmegaMech * (60.0f / FOC_2PI)));
+    TEST_CHECK(driven == 0);
+    TEST_CHECK(g_Motor.TargetRPM == 1500.0f);               // 目标值照常更新
+
+    /* FOC_Start 清除锁存后新的模式命令生效 */
+    FOC_Start(&g_Motor);
+    FOC_SetMode(&g_Motor, FOC_MODE_SPEED);
+    for (uint32_t i = 0; i < 40000u; i++) FOC_SimTick(&g_Motor);
+    TEST_CHECK(g_Motor.Mode == FOC_MODE_SPEED);
+    TEST_CHECK(fabsf(g_Motor.ActualRPM - 1500.0f) < 30.0f);
+    FOC_Stop(&g_Motor);
+}
+
+int main(void)
+{
+    FOC_Command_t init, c;
+    pthread_t th[MBX_WRITERS];
+    uint32_t reads = 0, fetched = 0, bad = 0, backwards = 0;
+    uint32_t last_k[MBX_WRITERS + 1] = { 0 };
+
+    Mbx_Make(&init, 1, 0);
+    FOC_Mailbox_Init(&mbx, &init);
+    for (uint32_t w = 1; w <= MBX_WRITERS; w++) {
+        pthread_create(&th[w - 1], NULL, Mbx_Writer, (void *)(uintptr_t)w);
+    }
+
+    /* 读端持续取用直到两个写线程都结束, 单核主机上靠时间片抢占制造交错 */
+    while (__atomic_load_n(&mbx_done, __ATOMIC_ACQUIRE) < MBX_WRITERS) {
+        reads++;
+        if ((reads & 255u) == 0) sched_yield();
+        if (FOC_Mailbox_Fetch(&mbx, &c)) {
+            uint32_t k;
+            fetched++;
+            if (!Mbx_Consistent(&c, &k)) {
+                if (bad++ < 5) {
+                    printf("torn command: mode %u id %.0f iq %.0f rpm %.0f pos %016llx\n", c.Mode,
+                           (double)c.TargetId, (double)c.TargetIq, (double)c.TargetRPM,
+                           (unsigned long long)c.TargetPosCnt);
+                }
+            } else {
+                if (k < last_k[c.Mode]) backwards++;
+                last_k[c.Mode] = k;
+            }
+        }
+    }
+
+    for (uint32_t w = 0; w < MBX_WRITERS; w++) {
+        pthread_join(th[w], NULL);
+    }
+
+    printf("reads %u, fetched %u, read retries %u, torn %u, out-of-order %u\n", (unsigned)reads,
+           (unsigned)fetched, (unsigned)mbx.Torn, (unsigned)bad, (unsigned)backwards);
+    printf("published %u + %u of %u + %u attempts (busy %u)\n", (unsigned)pub_ok[1],
+           (unsigned)pub_ok[2], (unsigned)pub_try[1], (unsigned)pub_try[2], (unsigned)mbx.Busy);
+    TEST_CHECK(bad == 0);
+    TEST_CHECK(backwards == 0);
+    TEST_CHECK(fetched > 0);
+    TEST_CHECK(pub_ok[1] > 0 && pub_ok[2] > 0);
+    TEST_CHECK(pub_ok[1] + pub_ok[2] + mbx.Busy == pub_try[1] + pub_try[2]);
+
+    /*--- 按字段合并: 未选中的字段沿用上一条命令 ---*/
+    Mbx_Make(&init, 1, 7);
+    FOC_Mailbox_Init(&mbx, &init);
+    c = init;
+    c.TargetRPM = 100.0f;
+    FOC_Mailbox_Publish(&mbx, FOC_CMD_RPM, &c);
+    c.TargetRPM = -1.0f;
+    c.TargetPosCnt = -123456789012345LL;
+    FOC_Mailbox_Publish(&mbx, FOC_CMD_POS, &c);
+    TEST_CHECK(FOC_Mailbox_Fetch(&mbx, &c) == 1);
+    TEST_CHECK(c.TargetRPM == 100.0f && c.TargetPosCnt == -123456789012345LL);
+    TEST_CHECK(c.TargetId == init.TargetId && c.Mode == init.Mode);
+    TEST_CHECK(FOC_Mailbox_Fetch(&mbx, &c) == 0);
+
+    /*--- 停机锁存 ---*/
+    Test_StopLatch(0);
+    Test_StopLatch(1);
+
+    return Test_Result("test_mailbox_stress");
+}
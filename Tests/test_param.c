@@ -0,0 +1,181 @@
+/**
+ * @file    test_param.c
+ * @brief   运行时参数表测试: 写入校验、写入队列与生效上下文、同步函数
+ * @note    同一源码分别链接 foc_host (浮点) 与 foc_host_fixed (Q15 流水线):
+ *          1. 只读 / 参数号无效 / 超出上下限 / NaN / ±Inf 的写入被拒绝且不入队
+ *          2. 每轴每上下文最多 FOC_PARAM_QUEUE_LEN 个待生效写入, 满时返回 FOC_PARAM_ERR_BUSY;
+ *             写入在对应上下文调用 FOC_Param_Apply 之前不可见, 另一上下文的 Apply 不会取出
+ *          3. 同步: cur.v_limit 镜像到 d/q 轴输出与积分限幅并收回积分器 (定点构建同时换算 Q15 限幅),
+ *             spd.iq_limit 同理; enc.poles 更新非线性标定极对数, 定点构建重新换算外推系数
+ */
+
+#include "foc_core.h"
+#include "foc_flash.h"
+#include "foc_param.h"
+#include "test_util.h"
+#include <math.h>
+#include <stdlib.h>
+
+static float Get(uint16_t id)
+{
+    float v = -12345.0f;
+
+    TEST_CHECK(FOC_Param_Get(&g_Motor, id, &v) == FOC_PARAM_OK);
+    return v;
+}
+
+static void Test_Reject(void)
+{
+    float before[FOC_PARAM_COUNT];
+
+    for (uint16_t id = 0; id < FOC_PARAM_COUNT; id++) before[id] = Get(id);
+
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_COUNT, 1.0f) == FOC_PARAM_ERR_ID);
+    TEST_CHECK(FOC_Param_Set(NULL, FOC_PARAM_ID_KP, 1.0f) == FOC_PARAM_ERR_ID);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ACT_IQ, 1.0f) == FOC_PARAM_ERR_ACCESS);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_CAL_STATUS, 0.0f) == FOC_PARAM_ERR_ACCESS);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ID_KP, -0.001f) == FOC_PARAM_ERR_RANGE);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ID_KP, 10.001f) == FOC_PARAM_ERR_RANGE);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ID_KP, NAN) == FOC_PARAM_ERR_RANGE);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_SPD_KP, -NAN) == FOC_PARAM_ERR_RANGE);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_VDC, INFINITY) == FOC_PARAM_ERR_RANGE);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_VDC, 5.9f) == FOC_PARAM_ERR_RANGE);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ENC_DIR, 2.0f) == FOC_PARAM_ERR_RANGE);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ENC_POLES, 0.0f) == FOC_PARAM_ERR_RANGE);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_MAX_MOD, 0.5f) == FOC_PARAM_ERR_RANGE);
+
+    /* 被拒绝的写入没有入队 */
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_CURRENT);
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_OUTER);
+    uint32_t changed = 0;
+    for (uint16_t id = 0; id < FOC_PARAM_COUNT; id++) {
+        if (Get(id) != before[id]) changed++;
+    }
+    TEST_CHECK(changed == 0);
+
+    /* 上下限本身可写 */
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ID_KP, 10.0f) == FOC_PARAM_OK);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ID_KP, before[FOC_PARAM_ID_KP]) == FOC_PARAM_OK);
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_CURRENT);
+    TEST_CHECK(Get(FOC_PARAM_ID_KP) == before[FOC_PARAM_ID_KP]);
+}
+
+static void Test_Queue(void)
+{
+    float ki = Get(FOC_PARAM_ID_KI);
+    float spd_kp = Get(FOC_PARAM_SPD_KP);
+
+    /* 填满电流环上下文的队列 */
+    for (uint32_t i = 0; i < FOC_PARAM_QUEUE_LEN; i++) {
+        TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ID_KI, 0.1f * (float)(i + 1u)) == FOC_PARAM_OK);
+    }
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ID_KI, 5.0f) == FOC_PARAM_ERR_BUSY);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_PLL_KP, 100.0f) == FOC_PARAM_ERR_BUSY);
+
+    /* 外环上下文的队列独立 */
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_SPD_KP, 0.5f) == FOC_PARAM_OK);
+    TEST_CHECK(Get(FOC_PARAM_ID_KI) == ki && Get(FOC_PARAM_SPD_KP) == spd_kp);
+
+    /* 外环 Apply 只取出外环的写入 */
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_OUTER);
+    TEST_CHECK(Get(FOC_PARAM_SPD_KP) == 0.5f);
+    TEST_CHECK(Get(FOC_PARAM_ID_KI) == ki);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ID_KI, 5.0f) == FOC_PARAM_ERR_BUSY);
+
+    /* 电流环 Apply 按顺序全部生效, 释放队列 */
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_CURRENT);
+    TEST_CHECK(Get(FOC_PARAM_ID_KI) == 0.1f * (float)FOC_PARAM_QUEUE_LEN);
+    TEST_CHECK(g_Motor.PID_Id.Ki == 0.1f * (float)FOC_PARAM_QUEUE_LEN);
+    for (uint32_t i = 0; i < FOC_PARAM_QUEUE_LEN; i++) {
+        TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ID_KI, ki) == FOC_PARAM_OK);
+    }
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_CURRENT);
+    TEST_CHECK(Get(FOC_PARAM_ID_KI) == ki);
+
+    /* 整型字段四舍五入 */
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ENC_DIR, -0.6f) == FOC_PARAM_OK);
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_CURRENT);
+    TEST_CHECK(g_Motor.Encoder.Direction == -1);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ENC_DIR, 0.0f) == FOC_PARAM_OK);
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_CURRENT);
+    TEST_CHECK(g_Motor.Encoder.Direction == 1);                     // 同步函数只允许 ±1
+}
+
+static void Test_Sync(void)
+{
+    /*--- 电压限幅: d/q 轴输出与积分限幅, 积分器收回 ---*/
+    g_Motor.PID_Id.Integral = 10.0f;
+    g_Motor.PID_Iq.Integral = -11.0f;
+#if FOC_USE_FIXED_POINT
+    int32_t q_max = g_Motor.Fixed.PI_Q.IntegralMax;
+    g_Motor.Fixed.PI_Q.IntegralMin = -q_max;
+    g_Motor.Fixed.PI_Q.Integral = -q_max;
+#endif
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_VOLT_LIMIT, 3.0f) == FOC_PARAM_OK);
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_OUTER);
+    TEST_CHECK(g_Motor.PID_Iq.OutMax != 3.0f);                      // 外环 Apply 不取出
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_CURRENT);
+
+    TEST_CHECK(g_Motor.PID_Id.OutMax == 3.0f && g_Motor.PID_Id.OutMin == -3.0f);
+    TEST_CHECK(g_Motor.PID_Iq.OutMax == 3.0f && g_Motor.PID_Iq.OutMin == -3.0f);
+    TEST_CHECK(g_Motor.PID_Id.IntegralMax == 3.0f && g_Motor.PID_Id.IntegralMin == -3.0f);
+    TEST_CHECK(g_Motor.PID_Iq.IntegralMax == 3.0f && g_Motor.PID_Iq.IntegralMin == -3.0f);
+    TEST_CHECK(g_Motor.PID_Id.Integral == 3.0f);
+    TEST_CHECK(g_Motor.PID_Iq.Integral == -3.0f);
+    TEST_CHECK(Get(FOC_PARAM_ID_INTEGRAL) == 3.0f && Get(FOC_PARAM_IQ_INTEGRAL) == -3.0f);
+#if FOC_USE_FIXED_POINT
+    int32_t q_lim = (int32_t)(3.0f / g_Motor.Vdc * 32768.0f) * 32768;
+    printf("fixed integral limit %d -> %d (Q30)\n", (int)q_max, (int)g_Motor.Fixed.PI_Q.IntegralMax);
+    TEST_CHECK(abs(g_Motor.Fixed.PI_Q.IntegralMax - q_lim) <= 32768);
+    TEST_CHECK(g_Motor.Fixed.PI_Q.IntegralMin == -g_Motor.Fixed.PI_Q.IntegralMax);
+    TEST_CHECK(g_Motor.Fixed.PI_Q.Integral == g_Motor.Fixed.PI_Q.IntegralMin);
+    TEST_CHECK(g_Motor.Fixed.PI_D.IntegralMax == g_Motor.Fixed.PI_Q.IntegralMax);
+#endif
+
+    /* 放宽限幅时积分器不变 */
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_VOLT_LIMIT, 12.0f) == FOC_PARAM_OK);
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_CURRENT);
+    TEST_CHECK(g_Motor.PID_Iq.IntegralMin == -12.0f && g_Motor.PID_Iq.Integral == -3.0f);
+
+    /*--- 电流限幅: 速度环, 外环上下文 ---*/
+    g_Motor.PID_Speed.Integral = 2.5f;
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_IQ_LIMIT, 1.5f) == FOC_PARAM_OK);
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_CURRENT);
+    TEST_CHECK(g_Motor.PID_Speed.OutMax != 1.5f);
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_OUTER);
+    TEST_CHECK(g_Motor.PID_Speed.OutMax == 1.5f && g_Motor.PID_Speed.OutMin == -1.5f);
+    TEST_CHECK(g_Motor.PID_Speed.IntegralMax == 1.5f && g_Motor.PID_Speed.IntegralMin == -1.5f);
+    TEST_CHECK(g_Motor.PID_Speed.Integral == 1.5f);
+
+    /*--- 极对数: 非线性标定与外推系数 ---*/
+    uint8_t pp = g_Motor.Encoder.PolePairs;
+#if FOC_USE_FIXED_POINT
+    float gain = g_Motor.Fixed.StepGain;
+#endif
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ENC_POLES, 2.0f * pp + 0.4f) == FOC_PARAM_OK);
+    TEST_CHECK(g_Motor.Encoder.PolePairs == pp);
+    FOC_Param_Apply(&g_Motor, FOC_PARAM_CTX_CURRENT);
+    TEST_CHECK(g_Motor.Encoder.PolePairs == 2u * pp);
+    TEST_CHECK(g_Motor.EncLin.PolePairs == 2u * pp);
+#if FOC_USE_FIXED_POINT
+    TEST_CHECK(fabsf(g_Motor.Fixed.StepGain - 2.0f * gain) <= 1e-6f * gain);
+    float expect = (float)(2u * pp) / (float)HW_PWM_FREQ_HZ * (1048576.0f / 6.2831853f);
+    TEST_CHECK(fabsf(g_Motor.Fixed.StepGain - expect) <= 1e-5f * expect);
+    FOC_Fixed_SetSpeed(&g_Motor.Fixed, 100.0f);
+    TEST_CHECK(g_Motor.Fixed.PhaseStep == (int32_t)(100.0f * g_Motor.Fixed.StepGain));
+#endif
+}
+
+int main(void)
+{
+    printf("%s build\n", FOC_USE_FIXED_POINT ? "fixed-point" : "float");
+    MotorHW_Sim_Init(&g_MotorHW[0], NULL, HW_ENCODER_ZERO_OFFSET, 1);
+    FOC_FlashSim_Reset();
+    FOC_Param_Init();
+    FOC_Init(&g_Motor, 0);
+
+    Test_Reject();
+    Test_Queue();
+    Test_Sync();
+    return Test_Result(FOC_USE_FIXED_POINT ? "test_param (fixed)" : "test_param");
+}
@@ -0,0 +1,111 @@
+/**
+ * @file    test_pos_multiturn.c
+ * @brief   多圈位置累加测试: 10^6 圈连续旋转下 PosCnt 逐拍精确, 远离原点的位置闭环精度不变
+ * @note    1. 按恒定计数步长 (周期性减小 3 计数模拟转速波动) 推进原始读数 10^6 圈,
+ *             每拍调用 MotorHW_DecodeEncoder, PosCnt 与真实累计计数逐拍相等;
+ *             步长覆盖常规转速与紧贴半圈 (CPR/2 - 1) 的极限, 两个方向
+ *          2. 对照: 旧的单精度 "圈数 × 2π + 机械角" 累加在 10^6 圈处的分辨率 (仅打印)
+ *          3. 位置闭环: 在原点与已累计 10^6 圈处分别走 20 rad, 终点误差一致且在死区内
+ */
+
+#include "foc_core.h"
+#include "test_util.h"
+#include <math.h>
+#include <string.h>
+
+#define MT_TURNS            1000000LL
+#define MT_MOVE_RAD         20.0f
+#define MT_MOVE_TICKS       80000u      // 4 s
+#define MT_MAX_ERR_RAD      0.003f      // 位置环死区 0.002 rad, 另加 1 计数
+
+typedef struct {
+    int32_t Step;           // 每拍计数步长 (符号为方向)
+    int8_t Direction;       // 编码器方向
+} MtCase_t;
+
+static const MtCase_t mt_cases[] = {
+    {   82,  1 },           // 6000 rpm @ 20 kHz
+    { -200, -1 },
+    { (int32_t)(HW_ENCODER_CPR / 2u) - 1,  1 },     // 紧贴半圈
+    { 1 - (int32_t)(HW_ENCODER_CPR / 2u), -1 },
+};
+
+/**
+ * @brief  连续旋转 MT_TURNS 圈, 返回 PosCnt 与真实计数不一致的拍数
+ */
+static uint32_t Run_Turns(const MtCase_t *c)
+{
+    EncoderData_t e = {0};
+    int64_t truth = 0;
+    uint32_t raw = 0, bad = 0, tick = 0;
+    int64_t target = MT_TURNS * (int64_t)HW_ENCODER_CPR;
+
+    e.PolePairs = HW_MOTOR_POLE_PAIRS;
+    e.Direction = c->Direction;
+    MotorHW_SetEncoderOffset(&e, HW_ENCODER_ZERO_OFFSET);
+    MotorHW_DecodeEncoder(&e, 0);
+    while (truth < target && truth > -target) {
+        int32_t step = c->Step;
+        if (tick++ % 7u == 0) step -= (step > 0) ? 3 : -3;
+        truth += step;
+        raw += (uint32_t)(c->Direction * step);                // 读数按编码器方向反映转动
+        MotorHW_DecodeEncoder(&e, (uint16_t)(raw & (HW_ENCODER_CPR - 1u)));
+        if (e.PosCnt != truth) bad++;
+    }
+    printf("step %+6d dir %+d: %.0f turns in %u ticks, PosCnt - truth %lld, mismatched ticks %u\n",
+           (int)c->Step, (int)c->Direction, (double)truth / HW_ENCODER_CPR, (unsigned)tick,
+           (long long)(e.PosCnt - truth), (unsigned)bad);
+    return bad;
+}
+
+/**
+ * @brief  从当前位置 (累计计数再加 base) 闭环移动 MT_MOVE_RAD, 返回终点误差 (计数)
+ */
+static int64_t Run_Move(int64_t base)
+{
+    FOC_Command_t cmd;
+
+    memset(&g_Motor, 0, sizeof(g_Motor));
+    MotorHW_Sim_Init(&g_MotorHW[0], NULL, HW_ENCODER_ZERO_OFFSET, 1);
+    FOC_Init(&g_Motor, 0);
+    for (uint32_t i = 0; i < 1200u; i++) FOC_SimTick(&g_Motor);     // 电流偏移校准
+    g_Motor.Encoder.PosCnt += base;
+
+    int64_t target = g_Motor.Encoder.PosCnt + FOC_PosRadToCnt(MT_MOVE_RAD);
+    FOC_Start(&g_Motor);
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.Mode = FOC_MODE_POSITION;
+    cmd.TargetPosCnt = target;
+    FOC_SetCommand(&g_Motor, FOC_CMD_MODE | FOC_CMD_POS, &cmd);
+    for (uint32_t i = 0; i < MT_MOVE_TICKS; i++) FOC_SimTick(&g_Motor);
+    FOC_Stop(&g_Motor);
+
+    int64_t err = target - g_Motor.Encoder.PosCnt;
+    printf("move %.0f rad from %.0f turns: error %lld counts (%.4f rad), ActualPos %.1f rad\n",
+           (double)MT_MOVE_RAD, (double)base / HW_ENCODER_CPR, (long long)err,
+           (double)FOC_PosCntToRad(err), (double)g_Motor.ActualPos);
+    return err;
+}
+
+int main(void)
+{
+    /*--- 10^6 圈连续旋转 ---*/
+    for (uint32_t k = 0; k < sizeof(mt_cases) / sizeof(mt_cases[0]); k++) {
+        TEST_CHECK(Run_Turns(&mt_cases[k]) == 0);
+    }
+
+    /*--- 对照: 单精度累加在 10^6 圈处的分辨率 ---*/
+    float old_pos = (float)MT_TURNS * FOC_2PI;
+    float ulp = nextafterf(old_pos, INFINITY) - old_pos;
+    printf("float turns*2pi at %lld turns: ulp %.3f rad = %.0f counts\n", (long long)MT_TURNS,
+           (double)ulp, (double)ulp * HW_ENCODER_CPR / FOC_2PI);
+
+    /*--- 远离原点的位置闭环 ---*/
+    int64_t e0 = Run_Move(0);
+    int64_t e1 = Run_Move(MT_TURNS * (int64_t)HW_ENCODER_CPR);
+    TEST_CHECK(fabsf(FOC_PosCntToRad(e0)) < MT_MAX_ERR_RAD);
+    TEST_CHECK(fabsf(FOC_PosCntToRad(e1)) < MT_MAX_ERR_RAD);
+    TEST_CHECK(e0 == e1);                               // 位置环只用计数差, 与原点距离无关
+
+    return Test_Result("test_pos_multiturn");
+}
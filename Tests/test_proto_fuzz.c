@@ -0,0 +1,182 @@
+/**
+ * @file    test_proto_fuzz.c
+ * @brief   协议流式解析模糊测试: 随机分包、插入垃圾字节与比特翻转
+ * @note    每帧以 (类型, 序号, 负载首字节) 编码其发送序号, 回调据此对账:
+ *          未被破坏的帧须恰好交付一次、负载一致, 被破坏的帧不得交付;
+ *          垃圾字节中的伪帧头有 2^-16 的概率通过 CRC16, 这类伪帧 (unknown) 会吞掉其覆盖的真帧,
+ *          因此含垃圾的流只要求丢失数不超过伪帧数, 且伪帧数与 CRC 失败次数 / 65536 同量级;
+ *          另以 CRC 逐位参考实现校验查表 CRC, 并打印 64 字节分包下的解析吞吐
+ */
+
+#include "foc_proto.h"
+#include "test_util.h"
+#include <string.h>
+
+#define FUZZ_FRAMES         200000u
+#define FUZZ_MAX_STREAM     (FUZZ_FRAMES * (PROTO_MAX_FRAME + 24u))
+#define FUZZ_PACKET         64u         // 全速 USB 包长
+
+static uint8_t stream[FUZZ_MAX_STREAM];
+static uint32_t stream_len;
+static uint32_t sent_sum[FUZZ_FRAMES];
+static uint8_t sent_ok[FUZZ_FRAMES];    // 1=未被破坏, 应被交付
+static uint8_t delivered[FUZZ_FRAMES];
+static uint32_t unknown = 0;
+static uint32_t rng;
+
+static uint32_t Rand_U32(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+/* 逐位 CRC16-CCITT 参考实现 */
+static uint16_t Crc16_Bitwise(uint16_t crc, const uint8_t *data, uint32_t len)
+{
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (uint32_t k = 0; k < 8u; k++) {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint32_t Payload_Sum(const uint8_t *p, uint32_t len)
+{
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < len; i++) sum = sum * 31u + p[i];
+    return sum;
+}
+
+/* 发送序号 i 编码为: 类型 = 低 7 位, 序号 = 中 8 位, 负载首字节 = 高位 */
+static uint32_t Frame_Index(const Proto_Frame_t *f)
+{
+    return (uint32_t)f->Type | ((uint32_t)f->Seq << 7) | ((uint32_t)f->Payload[0] << 15);
+}
+
+static void Fuzz_Handler(const Proto_Frame_t *f, void *user)
+{
+    (void)user;
+    uint32_t idx = (f->Len > 0) ? Frame_Index(f) : FUZZ_FRAMES;
+
+    if (idx >= FUZZ_FRAMES || sent_sum[idx] != Payload_Sum(f->Payload, f->Len)) {
+        unknown++;
+        return;
+    }
+    if (delivered[idx] < 255u) delivered[idx]++;
+}
+
+/**
+ * @brief  生成帧流
+ * @param  noisy: 1=帧间随机插入垃圾 (含同步字节), 并随机翻转帧内一位
+ * @param  fixed_len: 非 0 时负载长度固定 (吞吐测试)
+ * @return 被破坏的帧数
+ */
+static uint32_t Fuzz_BuildStream(uint32_t seed, int noisy, uint32_t fixed_len)
+{
+    uint8_t pl[PROTO_MAX_PAYLOAD];
+    uint32_t corrupted = 0;
+
+    rng = seed;
+    stream_len = 0;
+    for (uint32_t i = 0; i < FUZZ_FRAMES; i++) {
+        uint32_t len = fixed_len ? fixed_len : 1u + Rand_U32() % PROTO_MAX_PAYLOAD;
+
+        for (uint32_t k = 0; k < len; k++) pl[k] = (uint8_t)Rand_U32();
+        pl[0] = (uint8_t)(i >> 15);
+        sent_sum[i] = Payload_Sum(pl, len);
+        sent_ok[i] = 1;
+
+        if (noisy && Rand_U32() % 8u == 0) {
+            for (uint32_t k = Rand_U32() % 20u; k > 0; k--) {
+                stream[stream_len++] = (Rand_U32() % 4u == 0) ? PROTO_SYNC : (uint8_t)Rand_U32();
+            }
+        }
+
+        uint32_t n = Proto_Encode(&stream[stream_len], (uint8_t)(i & 0x7Fu), (uint8_t)(i >> 7), pl, len);
+        if (noisy && Rand_U32() % 10u == 0) {
+            stream[stream_len + Rand_U32() % n] ^= (uint8_t)(1u << (Rand_U32() % 8u));
+            sent_ok[i] = 0;
+            corrupted++;
+        }
+        stream_len += n;
+    }
+    return corrupted;
+}
+
+/**
+ * @brief  以随机长度 (1 ~ max_chunk) 分段送入解析器并对账
+ */
+static void Fuzz_Run(const char *name, uint32_t corrupted, uint32_t max_chunk)
+{
+    Proto_Parser_t p;
+    uint32_t lost = 0, dup = 0, ghost = 0;
+
+    memset(delivered, 0, sizeof(delivered));
+    unknown = 0;
+    Proto_ParserInit(&p);
+    for (uint32_t off = 0; off < stream_len;) {
+        uint32_t n = 1u + Rand_U32() % max_chunk;
+        if (n > stream_len - off) n = stream_len - off;
+        Proto_Feed(&p, &stream[off], n, Fuzz_Handler, NULL);
+        off += n;
+    }
+
+    for (uint32_t i = 0; i < FUZZ_FRAMES; i++) {
+        if (sent_ok[i] && delivered[i] == 0) lost++;
+        if (delivered[i] > 1u) dup++;
+        if (!sent_ok[i] && delivered[i] != 0) ghost++;
+    }
+    printf("%-12s %u frames, %u corrupted | lost %u dup %u ghost %u unknown %u | "
+           "crc err %u skipped %u carried %u\n", name, (unsigned)FUZZ_FRAMES, (unsigned)corrupted,
+           (unsigned)lost, (unsigned)dup, (unsigned)ghost, (unsigned)unknown,
+           (unsigned)p.CrcErrors, (unsigned)p.SkippedBytes, (unsigned)p.CarriedFrames);
+    TEST_CHECK(dup == 0 && ghost == 0);
+    TEST_CHECK(lost <= unknown && unknown <= 1u + p.CrcErrors / 8192u);
+    TEST_CHECK(p.Frames == FUZZ_FRAMES - corrupted - lost + unknown);
+    if (corrupted == 0) {
+        TEST_CHECK(lost == 0 && unknown == 0);
+    }
+}
+
+int main(void)
+{
+    uint8_t buf[300];
+
+    /*--- 查表 CRC 与逐位实现一致 ---*/
+    rng = 0x13579BDFu;
+    for (uint32_t i = 0; i < sizeof(buf); i++) buf[i] = (uint8_t)Rand_U32();
+    for (uint32_t n = 0; n <= sizeof(buf); n++) {
+        TEST_CHECK(Proto_Crc16(0xFFFFu, buf, n) == Crc16_Bitwise(0xFFFFu, buf, n));
+    }
+    TEST_CHECK(Proto_Crc16(0xFFFFu, (const uint8_t *)"123456789", 9) == 0x29B1u);
+
+    /*--- 干净流 / 含垃圾与翻转的流, 随机分包 ---*/
+    Fuzz_Run("clean", Fuzz_BuildStream(12345u, 0, 0), FUZZ_PACKET);
+    Fuzz_Run("noisy", Fuzz_BuildStream(12346u, 1, 0), FUZZ_PACKET);
+    Fuzz_Run("noisy/1B", Fuzz_BuildStream(12347u, 1, 0), 1u);
+
+    /*--- 吞吐: 8 字节负载的短帧, 按 64 字节包送入 ---*/
+    Fuzz_BuildStream(7u, 0, 8u);
+    const uint32_t reps = 20u;
+    Proto_Parser_t p;
+    uint64_t t0 = Test_NowNs();
+    for (uint32_t r = 0; r < reps; r++) {
+        Proto_ParserInit(&p);
+        for (uint32_t off = 0; off < stream_len; off += FUZZ_PACKET) {
+            uint32_t n = (stream_len - off < FUZZ_PACKET) ? stream_len - off : FUZZ_PACKET;
+            Proto_Feed(&p, &stream[off], n, Fuzz_Handler, NULL);
+        }
+    }
+    double dt = (double)(Test_NowNs() - t0) * 1e-9;
+    printf("throughput   %.1f MB/s, %.2f Mframes/s (%u of %u frames carried across packets)\n",
+           reps * stream_len / dt * 1e-6, reps * (double)FUZZ_FRAMES / dt * 1e-6,
+           (unsigned)p.CarriedFrames, (unsigned)p.Frames);
+    TEST_CHECK(p.Frames == FUZZ_FRAMES);
+
+    return Test_Result("test_proto_fuzz");
+}
@@ -0,0 +1,223 @@
+/**
+ * @file    test_ring_buffer.c
+ * @brief   发送环形缓冲区测试: 模拟 USB IN 端点按传输取用, 覆盖两种丢弃策略与回绕
+ * @note    1. DROP_NEWEST: 单线程交替写帧/取用, 收到的字节流须恰为被接受帧的顺序拼接
+ *          2. DROP_OLDEST: 单线程, 覆盖量须恰为空间缺口, 保留的是最新数据
+ *          3. DROP_OLDEST + 并发消费者 (pthread, __atomic 路径): 生产者以比较交换推进读指针,
+ *             每次取出的数据须为流中连续的一段, 且收到 + 丢弃 = 写入
+ */
+
+#include "ring_buffer.h"
+#include "test_util.h"
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#define RB_SIZE             256u        // 小容量, 制造大量回绕
+#define RB_XFER             64u         // 模拟端点单次传输长度 (一个满包)
+#define RB_FRAMES           200000u
+#define RB_WORDS            2000000u    // 并发测试写入的 32 位字数
+
+static uint8_t rb_mem[RB_SIZE];
+static RingBuffer_t rb;
+static uint32_t rng = 0x2468ACE1u;
+
+static uint32_t Rand_U32(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+/* 帧内容: 第 i 字节 = seq * 7 + i, 长度由 seq 推出 */
+static uint32_t Frame_Len(uint32_t seq)
+{
+    return 1u + (seq * 2654435761u >> 25) % 120u;
+}
+
+static void Frame_Fill(uint8_t *buf, uint32_t seq, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) buf[i] = (uint8_t)(seq * 7u + i);
+}
+
+/*============================================================================*/
+/*                              DROP_NEWEST                                    */
+/*============================================================================*/
+
+static void Test_DropNewest(void)
+{
+    uint8_t frame[128], xfer[RB_XFER];
+    static uint32_t accepted[RB_FRAMES];
+    uint32_t n_acc = 0, dropped = 0, wraps = 0;
+    uint32_t rx_frame = 0, rx_off = 0, mismatch = 0;
+
+    RingBuffer_Init(&rb, rb_mem, RB_SIZE, RING_DROP_NEWEST);
+    for (uint32_t seq = 0; seq < RB_FRAMES; seq++) {
+        uint32_t len = Frame_Len(seq);
+        uint32_t head = rb.Head;
+
+        Frame_Fill(frame, seq, len);
+        uint32_t n = RingBuffer_Write(&rb, frame, len);
+        TEST_CHECK(n == 0 || n == len);
+        if (n == len) {
+            accepted[n_acc++] = seq;
+            if ((head & (RB_SIZE - 1u)) + len > RB_SIZE) wraps++;
+        } else {
+            dropped++;
+        }
+        TEST_CHECK(RingBuffer_Level(&rb) <= RB_SIZE);
+
+        /* 端点随机完成 0~2 次传输 */
+        for (uint32_t k = Rand_U32() % 3u; k > 0; k--) {
+            uint32_t got = RingBuffer_Read(&rb, xfer, RB_XFER);
+            for (uint32_t i = 0; i < got; i++) {
+                uint32_t s = accepted[rx_frame];
+                if (xfer[i] != (uint8_t)(s * 7u + rx_off)) mismatch++;
+                if (++rx_off == Frame_Len(s)) {
+                    rx_frame++;
+                    rx_off = 0;
+                }
+            }
+        }
+    }
+    while (RingBuffer_Level(&rb) > 0) {
+        uint32_t got = RingBuffer_Read(&rb, xfer, RB_XFER);
+        for (uint32_t i = 0; i < got; i++) {
+            uint32_t s = accepted[rx_frame];
+            if (xfer[i] != (uint8_t)(s * 7u + rx_off)) mismatch++;
+            if (++rx_off == Frame_Len(s)) {
+                rx_frame++;
+                rx_off = 0;
+            }
+        }
+    }
+
+    /* 超过容量的帧总被拒绝 */
+    uint8_t big[RB_SIZE + 1u];
+    memset(big, 0, sizeof(big));
+    TEST_CHECK(RingBuffer_Write(&rb, big, sizeof(big)) == 0);
+
+    printf("drop-newest: %u frames accepted (%u wrapped), %u dropped, high water %u\n",
+           (unsigned)n_acc, (unsigned)wraps, (unsigned)dropped, (unsigned)rb.HighWater);
+    TEST_CHECK(mismatch == 0);
+    TEST_CHECK(rx_frame == n_acc && rx_off == 0);
+    TEST_CHECK(dropped > 0 && wraps > 0);
+    TEST_CHECK(rb.DroppedFrames == dropped + 1u);
+    TEST_CHECK(rb.HighWater <= RB_SIZE);
+}
+
+/*============================================================================*/
+/*                              DROP_OLDEST                                    */
+/*============================================================================*/
+
+static void Test_DropOldest(void)
+{
+    uint8_t frame[128], out[RB_SIZE];
+    uint32_t stream = 0;            // 已写入流的总长度
+    uint32_t expect_drop = 0, bad = 0;
+
+    RingBuffer_Init(&rb, rb_mem, RB_SIZE, RING_DROP_OLDEST);
+    for (uint32_t seq = 0; seq < 20000u; seq++) {
+        uint32_t len = Frame_Len(seq);
+        uint32_t free = RingBuffer_Free(&rb);
+
+        /* 帧内容取流内绝对位置, 便于检查保留的是哪一段 */
+        for (uint32_t i = 0; i < len; i++) frame[i] = (uint8_t)((stream + i) * 13u);
+        TEST_CHECK(RingBuffer_Write(&rb, frame, len) == len);
+        if (len > free) expect_drop += len - free;
+        stream += len;
+
+        if (Rand_U32() % 4u == 0) {
+            uint32_t got = RingBuffer_Read(&rb, out, RB_XFER);
+            (void)got;
+        }
+    }
+
+    /* 队列内恰为流的最后 Level 个字节 */
+    uint32_t level = RingBuffer_Level(&rb);
+    uint32_t got = RingBuffer_Read(&rb, out, RB_SIZE);
+    TEST_CHECK(got == level);
+    for (uint32_t i = 0; i < got; i++) {
+        if (out[i] != (uint8_t)((stream - level + i) * 13u)) bad++;
+    }
+    printf("drop-oldest: %u bytes written, %u overwritten, final level %u\n",
+           (unsigned)stream, (unsigned)rb.DroppedBytes, (unsigned)level);
+    TEST_CHECK(bad == 0);
+    TEST_CHECK(rb.DroppedBytes == expect_drop && expect_drop > 0);
+    TEST_CHECK(rb.DroppedFrames == 0);
+}
+
+/*============================================================================*/
+/*                          DROP_OLDEST + 并发消费者                            */
+/*============================================================================*/
+
+/* 流由 32 位字组成, 每个字的值为其在流中的序号; 帧长、容量与传输长度均为 4 的倍数,
+   读写指针始终字对齐 */
+static int rb_prod_done = 0;
+static uint32_t rb_rx_bytes = 0, rb_rx_chunks = 0, rb_rx_bad = 0;
+
+static void *Ring_Consumer(void *arg)
+{
+    uint32_t buf[RB_XFER / 4u];
+    uint32_t next = 0;              // 下一个字序号的下限
+
+    (void)arg;
+    for (;;) {
+        int done = __atomic_load_n(&rb_prod_done, __ATOMIC_ACQUIRE);
+        uint32_t got = RingBuffer_Read(&rb, (uint8_t *)buf, RB_XFER);
+
+        if (got == 0) {
+            if (done) break;
+            sched_yield();
+            continue;
+        }
+        rb_rx_chunks++;
+        rb_rx_bytes += got;
+        if (got % 4u != 0 || buf[0] < next) rb_rx_bad++;
+        for (uint32_t i = 1; i < got / 4u; i++) {
+            if (buf[i] != buf[0] + i) rb_rx_bad++;
+        }
+        next = buf[got / 4u - 1u] + 1u;
+    }
+    return NULL;
+}
+
+static void Test_DropOldestConcurrent(void)
+{
+    uint32_t frame[32];
+    uint32_t word = 0, written = 0;
+    pthread_t th;
+
+    RingBuffer_Init(&rb, rb_mem, RB_SIZE, RING_DROP_OLDEST);
+    rb_prod_done = 0;
+    pthread_create(&th, NULL, Ring_Consumer, NULL);
+
+    uint64_t t0 = Test_NowNs();
+    while (word < RB_WORDS) {
+        uint32_t n = 1u + Rand_U32() % 32u;
+        for (uint32_t i = 0; i < n; i++) frame[i] = word + i;
+        TEST_CHECK(RingBuffer_Write(&rb, (const uint8_t *)frame, n * 4u) == n * 4u);
+        word += n;
+        written += n * 4u;
+        if ((word & 0x3FFu) < n) sched_yield();
+    }
+    __atomic_store_n(&rb_prod_done, 1, __ATOMIC_RELEASE);
+    pthread_join(th, NULL);
+    uint64_t t1 = Test_NowNs();
+
+    printf("drop-oldest concurrent: %u bytes written, %u received in %u transfers, "
+           "%u overwritten, %.1f MB/s\n", (unsigned)written, (unsigned)rb_rx_bytes,
+           (unsigned)rb_rx_chunks, (unsigned)rb.DroppedBytes, written / ((t1 - t0) * 1e-3));
+    TEST_CHECK(rb_rx_bad == 0);
+    TEST_CHECK(rb_rx_bytes + rb.DroppedBytes == written);
+    TEST_CHECK(rb.WrittenBytes == written);
+}
+
+int main(void)
+{
+    Test_DropNewest();
+    Test_DropOldest();
+    Test_DropOldestConcurrent();
+    return Test_Result("test_ring_buffer");
+}
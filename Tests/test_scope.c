@@ -0,0 +1,231 @@
+/**
+ * @file    test_scope.c
+ * @brief   示波器采集测试: 目标值命令触发与电平触发下的 Iq 阶跃捕获, 以及布防/停止/重新布防状态机
+ * @note    仿真电流环每周期按 VOFA_UpdateFromMotor 的方式填写并发布调试帧后调用 FOC_Scope_Sample:
+ *          1. SETPOINT: 预触发区未填满时的命令被忽略; 触发样本恰为新 Iq 目标的第一拍,
+ *             触发前样本数等于 PreTrigger, 总样本数等于深度, 上传后回到空闲
+ *          2. LEVEL (上升沿, 分频 2): 触发样本为 Iq 首次越过电平的样本, 时间轴按分频间隔,
+ *             上传后自动重新布防
+ *          3. 采集/上传期间拒绝布防, 停止后不再采样, 强制触发不等预触发区填满
+ */
+
+#include "foc_core.h"
+#include "foc_scope.h"
+#include "test_util.h"
+#include <math.h>
+#include <string.h>
+
+#define SC_IQ_LOW           1.0f
+#define SC_IQ_HIGH          2.0f
+#define SC_LEVEL            1.5f
+#define SC_DT               HW_CONTROL_PERIOD_S
+
+/**
+ * @brief  一个控制周期: 控制循环 + 调试帧 + 示波器采样 (与 ADC 中断的调用顺序一致)
+ */
+static void Sc_Tick(void)
+{
+    float *d;
+
+    FOC_SimTick(&g_Motor);
+    d = VOFA_BeginFrame();
+    memset(d, 0, VOFA_CHANNEL_CNT * sizeof(float));
+    d[VOFA_CH_VQ] = g_Motor.InvPark.Q;
+    d[VOFA_CH_ID] = g_Motor.ActualId;
+    d[VOFA_CH_IQ] = g_Motor.ActualIq;
+    d[VOFA_CH_ID_REF] = g_Motor.TargetId;
+    d[VOFA_CH_IQ_REF] = g_Motor.TargetIq;
+    VOFA_PublishFrame();
+    FOC_Scope_Sample(&g_Motor);
+}
+
+static void Sc_Ticks(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) Sc_Tick();
+}
+
+/**
+ * @brief  上传到结束, 返回 FOC_Scope_Poll 返回 1 的次数
+ */
+static uint32_t Sc_Drain(void)
+{
+    uint32_t polls = 0;
+
+    while (FOC_Scope_Poll()) {
+        TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_STREAMING);
+        if (++polls > 10000u) break;
+    }
+    return polls;
+}
+
+static void Test_Setpoint(void)
+{
+    FOC_ScopeConfig_t cfg;
+    float s[FOC_SCOPE_MAX_CH + 1];
+    uint32_t pre = 0, total;
+
+    FOC_Scope_DefaultConfig(&cfg);          // Iq / Iq参考 / Id / Vq, 目标值命令触发
+    uint32_t depth = FOC_SCOPE_BUF_SIZE / cfg.ChannelCnt;
+    TEST_CHECK(FOC_Scope_Arm(&cfg) == 1);
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_ARMED);
+
+    /* 预触发区未填满: 命令不触发 */
+    Sc_Ticks(cfg.PreTrigger / 2u);
+    FOC_SetTargetCurrent(&g_Motor, 0.0f, SC_IQ_LOW);
+    Sc_Ticks(cfg.PreTrigger);
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_ARMED);
+    TEST_CHECK(FOC_Scope_GetCapture(NULL) == 0);
+
+    /* Iq 阶跃 */
+    FOC_SetTargetCurrent(&g_Motor, 0.0f, SC_IQ_HIGH);
+    Sc_Tick();
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_TRIGGERED);
+    Sc_Ticks(depth - cfg.PreTrigger - 2u);
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_TRIGGERED);
+    Sc_Tick();
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_DONE);
+    Sc_Ticks(10u);                           // 冻结后不再写入
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_DONE);
+
+    total = FOC_Scope_GetCapture(&pre);
+    TEST_CHECK(pre == cfg.PreTrigger);
+    TEST_CHECK(total == depth);
+
+    /* 触发样本: 新目标的第一拍, 相对时刻 0; 前一样本仍为旧目标 */
+    TEST_CHECK(FOC_Scope_ReadSample(pre, s) == 1);
+    TEST_CHECK(s[0] == 0.0f && s[2] == SC_IQ_HIGH);
+    TEST_CHECK(FOC_Scope_ReadSample(pre - 1u, s) == 1);
+    TEST_CHECK(fabsf(s[0] + SC_DT) < 1e-9f && s[2] == SC_IQ_LOW);
+    TEST_CHECK(fabsf(s[1] - SC_IQ_LOW) < 0.1f);
+    TEST_CHECK(FOC_Scope_ReadSample(0, s) == 1);
+    TEST_CHECK(fabsf(s[0] + (float)pre * SC_DT) < 1e-6f);
+
+    /* 阶跃响应在采集窗口内建立 */
+    TEST_CHECK(FOC_Scope_ReadSample(total - 1u, s) == 1);
+    TEST_CHECK(fabsf(s[1] - SC_IQ_HIGH) < 0.1f);
+    TEST_CHECK(FOC_Scope_ReadSample(total, s) == 0);
+    printf("setpoint: pre %u, total %u, Iq %.3f A before / %.3f A at end of window\n",
+           (unsigned)pre, (unsigned)total, (double)SC_IQ_LOW, (double)s[1]);
+
+    /* 上传期间拒绝布防, 上传完成后回到空闲 */
+    TEST_CHECK(FOC_Scope_Poll() == 1);
+    TEST_CHECK(FOC_Scope_Arm(&cfg) == 0);
+    uint32_t polls = 1u + Sc_Drain() + 1u;  // 发完最后一批的那次返回 0
+    TEST_CHECK(polls == (total + FOC_SCOPE_STREAM_BURST - 1u) / FOC_SCOPE_STREAM_BURST);
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_IDLE);
+    TEST_CHECK(FOC_Scope_ReadSample(0, s) == 0);
+}
+
+static void Test_Level(void)
+{
+    FOC_ScopeConfig_t cfg;
+    float s[FOC_SCOPE_MAX_CH + 1];
+    uint32_t pre = 0, total, n = 0;
+
+    FOC_SetTargetCurrent(&g_Motor, 0.0f, SC_IQ_LOW);
+    Sc_Ticks(2000u);
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.Channels[0] = VOFA_CH_IQ;
+    cfg.Channels[1] = VOFA_CH_IQ_REF;
+    cfg.ChannelCnt = 2;
+    cfg.Decimation = 2;
+    cfg.Trigger = FOC_SCOPE_TRIG_LEVEL;
+    cfg.TrigChannel = VOFA_CH_IQ;
+    cfg.TrigEdge = FOC_SCOPE_EDGE_RISING;
+    cfg.TrigLevel = SC_LEVEL;
+    cfg.AutoRearm = 1;
+    cfg.PreTrigger = 100;
+    uint32_t depth = FOC_SCOPE_BUF_SIZE / cfg.ChannelCnt;
+    TEST_CHECK(FOC_Scope_Arm(&cfg) == 1);
+
+    /* 下降沿不触发 */
+    Sc_Ticks(2u * cfg.PreTrigger + 20u);
+    FOC_SetTargetCurrent(&g_Motor, 0.0f, 0.0f);
+    Sc_Ticks(400u);
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_ARMED);
+    FOC_SetTargetCurrent(&g_Motor, 0.0f, SC_IQ_LOW);
+    Sc_Ticks(400u);
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_ARMED);
+
+    /* Iq 阶跃越过电平 */
+    FOC_SetTargetCurrent(&g_Motor, 0.0f, SC_IQ_HIGH);
+    while (FOC_Scope_GetState() != FOC_SCOPE_DONE && n < 4u * depth) {
+        Sc_Tick();
+        n++;
+    }
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_DONE);
+
+    total = FOC_Scope_GetCapture(&pre);
+    TEST_CHECK(pre == cfg.PreTrigger);
+    TEST_CHECK(total == depth);
+    TEST_CHECK(FOC_Scope_ReadSample(pre, s) == 1);
+    TEST_CHECK(s[0] == 0.0f && s[1] >= SC_LEVEL && s[2] == SC_IQ_HIGH);
+    float trig_iq = s[1];
+    TEST_CHECK(FOC_Scope_ReadSample(pre - 1u, s) == 1);
+    TEST_CHECK(s[1] < SC_LEVEL);
+    TEST_CHECK(fabsf(s[0] + 2.0f * SC_DT) < 1e-9f);
+    TEST_CHECK(FOC_Scope_ReadSample(pre + 1u, s) == 1);
+    TEST_CHECK(fabsf(s[0] - 2.0f * SC_DT) < 1e-9f);
+    printf("level: pre %u, total %u, Iq %.3f A at trigger (level %.1f A, decimation %u)\n",
+           (unsigned)pre, (unsigned)total, (double)trig_iq, (double)SC_LEVEL, (unsigned)cfg.Decimation);
+
+    /* 上传完成后自动重新布防 */
+    Sc_Drain();
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_ARMED);
+    TEST_CHECK(FOC_Scope_Arm(&cfg) == 0);
+
+    /* 强制触发: 不等预触发区填满 */
+    Sc_Ticks(20u);                           // 分频 2: 10 个样本
+    FOC_Scope_ForceTrigger();
+    Sc_Ticks(2u);
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_TRIGGERED);
+
+    /* 采集中停止: 回到空闲, 之后的采样不改变状态 */
+    FOC_Scope_Stop();
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_IDLE);
+    Sc_Ticks(2u * depth);
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_IDLE);
+    TEST_CHECK(FOC_Scope_Poll() == 0);
+
+    /* 重新布防后强制触发, 触发前样本为实际采到的 10 个 */
+    cfg.AutoRearm = 0;
+    TEST_CHECK(FOC_Scope_Arm(&cfg) == 1);
+    Sc_Ticks(20u);
+    FOC_Scope_ForceTrigger();
+    Sc_Ticks(2u * depth);
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_DONE);
+    total = FOC_Scope_GetCapture(&pre);
+    TEST_CHECK(pre == 10u);
+    TEST_CHECK(total == pre + depth - cfg.PreTrigger);
+    FOC_Scope_Stop();
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_IDLE && FOC_Scope_GetCapture(NULL) == 0);
+}
+
+int main(void)
+{
+    FOC_ScopeConfig_t bad;
+
+    MotorHW_Sim_Init(&g_MotorHW[0], NULL, HW_ENCODER_ZERO_OFFSET, 1);
+    MotorHW_Sim_GetPlant(&g_MotorHW[0])->LoadTorque = 0.05f;
+    FOC_Init(&g_Motor, 0);
+    for (uint32_t i = 0; i < 1200u; i++) FOC_SimTick(&g_Motor);     // 电流偏移校准
+    FOC_Start(&g_Motor);
+    FOC_SetMode(&g_Motor, FOC_MODE_CURRENT);
+    Sc_Ticks(200u);
+
+    /* 无效配置 */
+    FOC_Scope_DefaultConfig(&bad);
+    bad.ChannelCnt = 0;
+    TEST_CHECK(FOC_Scope_Arm(&bad) == 0);
+    FOC_Scope_DefaultConfig(&bad);
+    bad.PreTrigger = FOC_SCOPE_BUF_SIZE / bad.ChannelCnt;
+    TEST_CHECK(FOC_Scope_Arm(&bad) == 0);
+    TEST_CHECK(FOC_Scope_GetState() == FOC_SCOPE_IDLE);
+
+    Test_Setpoint();
+    Test_Level();
+
+    FOC_Stop(&g_Motor);
+    return Test_Result("test_scope");
+}
@@ -0,0 +1,85 @@
+/**
+ * @file    test_sincos.c
+ * @brief   FOC_SinCos 查表正弦/余弦: 精度 (对 libm 双精度) 与耗时 (对 sinf + cosf)
+ * @note    同时检查 Park/逆 Park 的预计算 sin/cos 版本与逐次求值版本一致
+ */
+
+#include "foc_math.h"
+#include "test_util.h"
+#include <math.h>
+
+#define SC_SWEEP_POINTS     1000003u    // 与表格节点错开的质数点数
+#define SC_MAX_ERR          2.5e-5      // 512 点线性插值理论误差 (2π/512)²/8 ≈ 1.9e-5
+#define SC_MAX_PARK_ERR     2.0e-4      // 输入幅值 ≤ 3.6, 每个输出两项误差叠加
+#define SC_BENCH_ROUNDS     20u
+
+int main(void)
+{
+    double max_err = 0.0;
+    SinCos_t sc;
+
+    /*--- 精度: 覆盖 [-2π, 4π) (外推后的电角度范围) ---*/
+    for (uint32_t i = 0; i < SC_SWEEP_POINTS; i++) {
+        float theta = -FOC_2PI + 3.0f * FOC_2PI * (float)i / (float)SC_SWEEP_POINTS;
+        FOC_SinCos(theta, &sc);
+        double es = fabs((double)sc.Sin - sin((double)theta));
+        double ec = fabs((double)sc.Cos - cos((double)theta));
+        if (es > max_err) max_err = es;
+        if (ec > max_err) max_err = ec;
+    }
+    TEST_CHECK(max_err < SC_MAX_ERR);
+
+    /*--- Park / 逆 Park: 预计算 sin/cos 版本与 Theta 版本一致 ---*/
+    double max_park = 0.0;
+    for (uint32_t i = 0; i < 4096u; i++) {
+        Park_t p1 = {0}, p2 = {0};
+        InvPark_t ip1 = {0}, ip2 = {0};
+        float theta = FOC_2PI * (float)i / 4096.0f;
+
+        p1.Alpha = p2.Alpha = 3.0f * cosf(0.7f * (float)i);
+        p1.Beta = p2.Beta = -2.0f * sinf(1.3f * (float)i);
+        p1.Theta = theta;
+        Park_Calc(&p1);
+        FOC_SinCos(theta, &sc);
+        Park_CalcSinCos(&p2, &sc);
+
+        ip1.D = ip2.D = p1.D;
+        ip1.Q = ip2.Q = p1.Q;
+        ip1.Theta = theta;
+        InvPark_Calc(&ip1);
+        InvPark_CalcSinCos(&ip2, &sc);
+
+        double e = fmax(fmax(fabs(p1.D - p2.D), fabs(p1.Q - p2.Q)),
+                        fmax(fabs(ip1.Alpha - ip2.Alpha), fabs(ip1.Beta - ip2.Beta)));
+        if (e > max_park) max_park = e;
+    }
+    TEST_CHECK(max_park < SC_MAX_PARK_ERR);
+
+    /*--- 耗时 (仅打印) ---*/
+    volatile float sink = 0.0f;
+    uint64_t t0 = Test_NowNs();
+    for (uint32_t r = 0; r < SC_BENCH_ROUNDS; r++) {
+        for (uint32_t i = 0; i < 65536u; i++) {
+            float theta = (float)i * (FOC_2PI / 65536.0f);
+            sink += sinf(theta) + cosf(theta);
+        }
+    }
+    uint64_t t_libm = Test_NowNs() - t0;
+
+    t0 = Test_NowNs();
+    for (uint32_t r = 0; r < SC_BENCH_ROUNDS; r++) {
+        for (uint32_t i = 0; i < 65536u; i++) {
+            float theta = (float)i * (FOC_2PI / 65536.0f);
+            FOC_SinCos(theta, &sc);
+            sink += sc.Sin + sc.Cos;
+        }
+    }
+    uint64_t t_table = Test_NowNs() - t0;
+    (void)sink;
+
+    printf("sincos max err %.2e (limit %.1e), park/invpark diff %.2e\n",
+           max_err, SC_MAX_ERR, max_park);
+    printf("sinf+cosf %.2f ns, FOC_SinCos %.2f ns per angle\n",
+           (double)t_libm / (SC_BENCH_ROUNDS * 65536.0), (double)t_table / (SC_BENCH_ROUNDS * 65536.0));
+    return Test_Result("test_sincos");
+}
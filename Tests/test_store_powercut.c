@@ -0,0 +1,158 @@
+/**
+ * @file    test_store_powercut.c
+ * @brief   参数存储掉电测试 (RAM 仿真 Flash, foc_flash_sim.c)
+ * @note    1. 连续写入跨越多次换块擦除, 重新挂载取到最新记录
+ *          2. 每次写入前注入随机位置的掉电 (编程字中途/擦除中途), 上电重新挂载后:
+ *             报告成功的写入必须保留; 读到的记录只能是新值或上一个值, 且负载完整;
+ *             从不对未擦除的字编程
+ *          3. 参数保存/加载: FOC_Param_Save 后重新 FOC_Init 恢复参数, 运行中保存被拒绝
+ *          4. 打印挂载 (启动加载) 耗时
+ */
+
+#include "foc_core.h"
+#include "foc_param.h"
+#include "foc_store.h"
+#include "test_util.h"
+#include <string.h>
+
+#define ST_WORDS            100u        // 负载字数
+#define ST_VERSION          7u
+#define ST_FILL_WRITES      700u        // 约 5.5 块
+#define ST_CUTS             20000u
+#define ST_CUT_MAX_OPS      140u        // 覆盖一次写入的全部编程 + 换块擦除
+
+static uint32_t payload[ST_WORDS];
+static uint32_t rng = 1u;
+
+static uint32_t Rand_U32(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static uint8_t St_Write(FOC_Store_t *st, uint32_t x)
+{
+    payload[0] = x;
+    for (uint32_t i = 1; i < ST_WORDS; i++) payload[i] = x * 31u + i;
+    return FOC_Store_Write(st, ST_VERSION, payload, sizeof(payload));
+}
+
+/**
+ * @brief  读取最新记录的值
+ * @return 值, 0=无记录; 负载不完整时返回 0xFFFFFFFF
+ */
+static uint32_t St_Read(const FOC_Store_t *st)
+{
+    uint16_t version;
+    uint32_t len;
+    const uint32_t *p = (const uint32_t *)FOC_Store_Read(st, &version, &len);
+
+    if (p == NULL) return 0;
+    if (version != ST_VERSION || len != sizeof(payload)) return 0xFFFFFFFFu;
+    for (uint32_t i = 1; i < ST_WORDS; i++) {
+        if (p[i] != p[0] * 31u + i) return 0xFFFFFFFFu;
+    }
+    return p[0];
+}
+
+static void Test_PowerCut(void)
+{
+    const FOC_Flash_t *flash = FOC_Flash_Get();
+    const FOC_FlashSim_Stats_t *fs = FOC_FlashSim_GetStats();
+    FOC_Store_t st;
+    uint32_t cur = 0, fail = 0;
+
+    FOC_FlashSim_Reset();
+    FOC_Store_Mount(&st, flash);
+    TEST_CHECK(st.Latest == NULL && St_Read(&st) == 0);
+
+    /*--- 连续写入 ---*/
+    for (uint32_t i = 1; i <= ST_FILL_WRITES; i++) {
+        if (!St_Write(&st, i)) fail++;
+    }
+    cur = ST_FILL_WRITES;
+    FOC_Store_Mount(&st, flash);
+    printf("fill: %u writes, erases %u/%u, bank %u next slot %u\n", (unsigned)ST_FILL_WRITES,
+           (unsigned)fs->Erases[0], (unsigned)fs->Erases[1], (unsigned)st.Bank, (unsigned)st.Next);
+    TEST_CHECK(fail == 0 && St_Read(&st) == cur);
+    TEST_CHECK(fs->Erases[0] >= 2u && fs->Erases[1] >= 2u);
+
+    /*--- 掉电注入 ---*/
+    uint32_t committed = 0, rolled = 0, failed = 0, lost = 0, corrupt = 0;
+    for (uint32_t t = 0; t < ST_CUTS; t++) {
+        uint32_t next = cur + 1u;
+
+        FOC_FlashSim_PowerCut(Rand_U32() % ST_CUT_MAX_OPS);
+        uint8_t ok = St_Write(&st, next);
+        FOC_FlashSim_PowerOn();
+        FOC_Store_Mount(&st, flash);
+
+        uint32_t got = St_Read(&st);
+        if (ok && got != next) lost++;
+        if (got != next && got != cur) corrupt++;
+        if (!ok) failed++;
+        if (got == next) {
+            cur = next;
+            committed++;
+        } else {
+            rolled++;
+        }
+    }
+    printf("power cut: %u cuts, %u committed, %u rolled back, %u writes reported failed | "
+           "lost %u corrupt %u, erases %u/%u, over-programs %u\n", (unsigned)fs->PowerCuts,
+           (unsigned)committed, (unsigned)rolled, (unsigned)failed, (unsigned)lost,
+           (unsigned)corrupt, (unsigned)fs->Erases[0], (unsigned)fs->Erases[1],
+           (unsigned)fs->OverPrograms);
+    TEST_CHECK(lost == 0 && corrupt == 0);
+    TEST_CHECK(fs->OverPrograms == 0);
+    TEST_CHECK(committed > 0 && rolled > 0);
+    TEST_CHECK(fs->PowerCuts > ST_CUTS / 2u);
+
+    /*--- 挂载耗时 ---*/
+    uint64_t t0 = Test_NowNs();
+    for (uint32_t i = 0; i < 10000u; i++) FOC_Store_Mount(&st, flash);
+    printf("mount: %.2f us (host), skipped %u\n", (double)(Test_NowNs() - t0) * 1e-7,
+           (unsigned)st.Skipped);
+}
+
+static void Test_ParamReload(void)
+{
+    float v;
+
+    FOC_FlashSim_Reset();
+    memset(&g_Motor, 0, sizeof(g_Motor));
+    MotorHW_Sim_Init(&g_MotorHW[0], NULL, HW_ENCODER_ZERO_OFFSET, 1);
+    FOC_Param_Init();
+    FOC_Init(&g_Motor, 0);
+    TEST_CHECK(FOC_Param_Load(&g_Motor) == 0);
+
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ID_KP, 0.1f) == FOC_PARAM_OK);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_SPD_KP, 0.02f) == FOC_PARAM_OK);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_VOLT_LIMIT, 8.0f) == FOC_PARAM_OK);
+    TEST_CHECK(FOC_Param_Set(&g_Motor, FOC_PARAM_ENC_DIR, -1.0f) == FOC_PARAM_OK);
+    for (uint32_t i = 0; i < 1300u; i++) FOC_SimTick(&g_Motor);     // 电流零点校准 + 写入生效
+    TEST_CHECK(FOC_Param_Save() == FOC_PARAM_OK);
+
+    FOC_Start(&g_Motor);
+    TEST_CHECK(FOC_Param_Save() == FOC_PARAM_ERR_BUSY);
+    FOC_Stop(&g_Motor);
+
+    memset(&g_Motor, 0, sizeof(g_Motor));
+    FOC_Param_Init();
+    FOC_Init(&g_Motor, 0);
+    TEST_CHECK(FOC_Param_Get(&g_Motor, FOC_PARAM_ID_KP, &v) == FOC_PARAM_OK && v == 0.1f);
+    TEST_CHECK(FOC_Param_Get(&g_Motor, FOC_PARAM_SPD_KP, &v) == FOC_PARAM_OK && v == 0.02f);
+    TEST_CHECK(FOC_Param_Get(&g_Motor, FOC_PARAM_VOLT_LIMIT, &v) == FOC_PARAM_OK && v == 8.0f);
+    TEST_CHECK(FOC_Param_Get(&g_Motor, FOC_PARAM_ENC_DIR, &v) == FOC_PARAM_OK && v == -1.0f);
+    printf("param reload: id.kp %.3f spd.kp %.3f vlim %.1f dir %d\n", (double)g_Motor.PID_Id.Kp,
+           (double)g_Motor.PID_Speed.Kp, (double)g_Motor.PID_Id.OutMax, (int)g_Motor.Encoder.Direction);
+}
+
+int main(void)
+{
+    Test_PowerCut();
+    Test_ParamReload();
+    return Test_Result("test_store_powercut");
+}
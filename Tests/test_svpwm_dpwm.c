@@ -0,0 +1,100 @@
+/**
+ * @file    test_svpwm_dpwm.c
+ * @brief   断续调制 (DPWM) 每相每电周期开关次数, 以及线电压与连续调制一致
+ * @note    中心对齐 PWM: 0 < CCR < Ts 的周期内桥臂开关两次, 钳位 (CCR = 0 或 Ts) 的周期不开关;
+ *          DPWM 每相每电周期钳位 120°, 开关次数应为连续调制的 2/3 (svpwm.h)
+ */
+
+#include "svpwm.h"
+#include "foc_math.h"
+#include "motor_hw.h"
+#include "test_util.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define DP_UDC              12.0f
+#define DP_PERIODS          1200        // 每电周期 PWM 周期数 (20kHz / 16.7Hz)
+#define DP_RATIO_MIN        0.655f      // 开关次数比 (理论 2/3, 扇区边界离散化误差)
+#define DP_RATIO_MAX        0.680f
+
+static const struct {
+    SVPWM_Mode_t Mode;
+    const char *Name;
+} dp_modes[] = {
+    { SVPWM_MODE_SECTOR,   "SECTOR"  },
+    { SVPWM_MODE_MINMAX,   "MINMAX"  },
+    { SVPWM_MODE_DPWM0,    "DPWM0"   },
+    { SVPWM_MODE_DPWM1,    "DPWM1"   },
+    { SVPWM_MODE_DPWM2,    "DPWM2"   },
+    { SVPWM_MODE_DPWMMIN,  "DPWMMIN" },
+    { SVPWM_MODE_DPWMMAX,  "DPWMMAX" },
+};
+#define DP_MODE_CNT     (sizeof(dp_modes) / sizeof(dp_modes[0]))
+
+/**
+ * @brief  运行一个电周期, 统计三相平均开关次数与线电压 (CCR1-CCR2, CCR2-CCR3) 相对连续调制的最大偏差
+ */
+static float Dp_Run(SVPWM_Mode_t mode, float m, uint32_t *max_ll_diff)
+{
+    SVPWM_t sv, ref;
+    uint32_t sw = 0;
+
+    SVPWM_Init(&sv, DP_UDC, HW_PWM_PERIOD);
+    SVPWM_Init(&ref, DP_UDC, HW_PWM_PERIOD);
+    sv.Mode = mode;
+    ref.Mode = SVPWM_MODE_MINMAX;
+    *max_ll_diff = 0;
+
+    for (int32_t k = 0; k < DP_PERIODS; k++) {
+        float th = FOC_2PI * ((float)k + 0.5f) / DP_PERIODS;
+        sv.Alpha = ref.Alpha = m * (2.0f * DP_UDC / FOC_PI) * cosf(th);
+        sv.Beta = ref.Beta = m * (2.0f * DP_UDC / FOC_PI) * sinf(th);
+        SVPWM_Calc(&sv);
+        SVPWM_Calc(&ref);
+
+        const uint32_t ccr[3] = { sv.CCR1, sv.CCR2, sv.CCR3 };
+        for (int32_t p = 0; p < 3; p++) {
+            if (ccr[p] != 0u && ccr[p] != HW_PWM_PERIOD) sw += 2u;
+        }
+
+        uint32_t d12 = (uint32_t)abs(((int32_t)sv.CCR1 - (int32_t)sv.CCR2) - ((int32_t)ref.CCR1 - (int32_t)ref.CCR2));
+        uint32_t d23 = (uint32_t)abs(((int32_t)sv.CCR2 - (int32_t)sv.CCR3) - ((int32_t)ref.CCR2 - (int32_t)ref.CCR3));
+        if (d12 > *max_ll_diff) *max_ll_diff = d12;
+        if (d23 > *max_ll_diff) *max_ll_diff = d23;
+    }
+    return (float)sw / 3.0f;
+}
+
+int main(void)
+{
+    static const float test_m[] = { 0.3f, 0.6f, 0.85f };
+    uint32_t ll;
+
+    for (uint32_t i = 0; i < sizeof(test_m) / sizeof(test_m[0]); i++) {
+        float cont = Dp_Run(SVPWM_MODE_MINMAX, test_m[i], &ll);
+        printf("m = %.2f, %d PWM periods per electrical period\n", (double)test_m[i], DP_PERIODS);
+        for (uint32_t j = 0; j < DP_MODE_CNT; j++) {
+            float n = Dp_Run(dp_modes[j].Mode, test_m[i], &ll);
+            float ratio = n / cont;
+            printf("  %-8s switchings/phase %7.1f  ratio %.3f  max line-line diff %u counts\n",
+                   dp_modes[j].Name, (double)n, (double)ratio, (unsigned)ll);
+            if (dp_modes[j].Mode >= SVPWM_MODE_DPWM0) {
+                TEST_CHECK(ratio > DP_RATIO_MIN && ratio < DP_RATIO_MAX);
+            } else {
+                TEST_CHECK(fabsf(ratio - 1.0f) < 0.001f);
+            }
+            TEST_CHECK(ll <= 2u);
+        }
+    }
+
+    /* AUTO: 低调制比连续, 高调制比切换到 AutoDpwm */
+    float cont = Dp_Run(SVPWM_MODE_MINMAX, 0.4f, &ll);
+    float lo = Dp_Run(SVPWM_MODE_AUTO, 0.4f, &ll) / cont;
+    cont = Dp_Run(SVPWM_MODE_MINMAX, 0.8f, &ll);
+    float hi = Dp_Run(SVPWM_MODE_AUTO, 0.8f, &ll) / cont;
+    printf("AUTO ratio: m = 0.40 -> %.3f, m = 0.80 -> %.3f\n", (double)lo, (double)hi);
+    TEST_CHECK(fabsf(lo - 1.0f) < 0.001f);
+    TEST_CHECK(hi > DP_RATIO_MIN && hi < DP_RATIO_MAX);
+
+    return Test_Result("test_svpwm_dpwm");
+}
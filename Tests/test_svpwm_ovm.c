@@ -0,0 +1,101 @@
+/**
+ * @file    test_svpwm_ovm.c
+ * @brief   过调制策略: 输出基波调制比与 THD (相电压, 每电周期平均值)
+ * @note    一个电周期内等间隔 OVM_POINTS 个 PWM 周期, 由 CCR 求相对中性点电压,
+ *          单点 DFT 得基波, Parseval 得 THD (含全部谐波)
+ *          检查: 两区策略基波在 [0, 1] 上连续且跟随给定, m = 1 时为六步方波;
+ *                最小相位误差策略基波不超过六边形轨迹 (M_ZONE2)
+ */
+
+#include "svpwm.h"
+#include "foc_math.h"
+#include "motor_hw.h"
+#include "test_util.h"
+#include <math.h>
+
+#define OVM_UDC             12.0f
+#define OVM_POINTS          3600
+#define OVM_SWEEP_STEP      0.0025f
+#define OVM_MAX_TRACK_ERR   0.002f      // 两区策略 |m_out - m_ref| 上限 (查表插值 + CCR 量化)
+#define OVM_MAX_JUMP        0.006f      // 相邻扫描点基波变化上限 (连续性)
+
+static const char *const ovm_names[] = { "MIN_PHASE", "TWO_ZONE", "SIX_STEP" };
+
+/**
+ * @brief  给定调制比运行一个电周期, 求输出基波调制比与 THD (%)
+ */
+static void Ovm_Measure(SVPWM_Ovm_t ovm, float m, float *m_out, float *thd)
+{
+    static double v[OVM_POINTS];
+    const double v6 = 2.0 * OVM_UDC / FOC_PI;
+    double re = 0.0, im = 0.0, sq = 0.0;
+    SVPWM_t sv;
+
+    SVPWM_Init(&sv, OVM_UDC, HW_PWM_PERIOD);
+    sv.Ovm = ovm;
+    for (int32_t k = 0; k < OVM_POINTS; k++) {
+        double th = 2.0 * FOC_PI * k / OVM_POINTS;
+        sv.Alpha = (float)(m * v6 * cos(th));
+        sv.Beta = (float)(m * v6 * sin(th));
+        SVPWM_Calc(&sv);
+        double a = (double)sv.CCR1 / HW_PWM_PERIOD;
+        double b = (double)sv.CCR2 / HW_PWM_PERIOD;
+        double c = (double)sv.CCR3 / HW_PWM_PERIOD;
+        v[k] = (a - (a + b + c) / 3.0) * OVM_UDC;
+        re += v[k] * cos(th);
+        im += v[k] * sin(th);
+        sq += v[k] * v[k];
+    }
+
+    double fund = 2.0 * sqrt(re * re + im * im) / OVM_POINTS;
+    double rms2 = sq / OVM_POINTS;
+    double harm2 = rms2 - 0.5 * fund * fund;
+    *m_out = (float)(fund / v6);
+    *thd = (fund > 0.0) ? (float)(100.0 * sqrt(harm2 > 0.0 ? harm2 : 0.0) / (fund / sqrt(2.0))) : 0.0f;
+}
+
+int main(void)
+{
+    static const float report_m[] = { 0.50f, 0.85f, 0.9069f, 0.92f, 0.94f, 0.9514f,
+                                      0.96f, 0.97f, 0.98f, 0.99f, 1.00f };
+    float m_out, thd;
+
+    /*--- 报告: 各策略基波与 THD ---*/
+    printf("m_ref ");
+    for (int32_t o = 0; o < 3; o++) printf("  %9s m_out   thd%%", ovm_names[o]);
+    printf("\n");
+    for (uint32_t i = 0; i < sizeof(report_m) / sizeof(report_m[0]); i++) {
+        printf("%.4f", (double)report_m[i]);
+        for (int32_t o = 0; o < 3; o++) {
+            Ovm_Measure((SVPWM_Ovm_t)o, report_m[i], &m_out, &thd);
+            printf("       %9.4f %6.2f", (double)m_out, (double)thd);
+        }
+        printf("\n");
+    }
+
+    /*--- 两区策略: 基波跟随给定且连续, 直到六步 ---*/
+    float max_err = 0.0f, max_jump = 0.0f, last = 0.0f;
+    for (float m = 0.0f; m <= 1.0f + 1e-6f; m += OVM_SWEEP_STEP) {
+        Ovm_Measure(SVPWM_OVM_TWO_ZONE, m, &m_out, &thd);
+        float err = fabsf(m_out - m);
+        float jump = fabsf(m_out - last);
+        if (err > max_err) max_err = err;
+        if (m > 0.0f && jump > max_jump) max_jump = jump;
+        last = m_out;
+    }
+    printf("TWO_ZONE sweep 0..1 step %.4f: max |m_out - m_ref| %.4f, max step %.4f\n",
+           (double)OVM_SWEEP_STEP, (double)max_err, (double)max_jump);
+    TEST_CHECK(max_err < OVM_MAX_TRACK_ERR);
+    TEST_CHECK(max_jump < OVM_MAX_JUMP);
+
+    /* m = 1: 六步方波 (THD 理论值 31.08%) */
+    Ovm_Measure(SVPWM_OVM_TWO_ZONE, 1.0f, &m_out, &thd);
+    TEST_CHECK(fabsf(m_out - 1.0f) < 0.002f);
+    TEST_CHECK(fabsf(thd - 31.08f) < 1.0f);
+
+    /* 最小相位误差: 沿原方向缩放, 基波介于内切圆与六边形轨迹之间 */
+    Ovm_Measure(SVPWM_OVM_MIN_PHASE, 1.0f, &m_out, &thd);
+    TEST_CHECK(m_out > SVPWM_M_LINEAR - 0.002f && m_out < SVPWM_M_ZONE2);
+
+    return Test_Result("test_svpwm_ovm");
+}
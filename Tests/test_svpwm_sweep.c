@@ -0,0 +1,116 @@
+/**
+ * @file    test_svpwm_sweep.c
+ * @brief   SVPWM_CalcSector 与 SVPWM_CalcMinMax 在整个 αβ 平面上的一致性与耗时
+ * @note    直角网格覆盖 |α|,|β| ≤ 0.8 Udc (含过调制区), 另加扇区边界射线与零矢量;
+ *          线性区 (|V| ≤ Udc/√3) 内三相 CCR 差值不超过 1 计数, 过调制区只打印
+ */
+
+#include "svpwm.h"
+#include "foc_math.h"
+#include "motor_hw.h"
+#include "test_util.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define SW_UDC              12.0f
+#define SW_GRID             801         // 每轴网格点数
+#define SW_SPAN             0.8f        // 网格半宽 (× Udc)
+#define SW_RAY_POINTS       4096        // 每条扇区边界射线上的点数
+#define SW_MAX_DIFF         1u
+
+static uint32_t max_lin = 0, max_ovm = 0;
+static uint32_t n_lin = 0, n_ovm = 0;
+
+static uint32_t CcrDiff(const SVPWM_t *a, const SVPWM_t *b)
+{
+    uint32_t d1 = (uint32_t)abs((int32_t)a->CCR1 - (int32_t)b->CCR1);
+    uint32_t d2 = (uint32_t)abs((int32_t)a->CCR2 - (int32_t)b->CCR2);
+    uint32_t d3 = (uint32_t)abs((int32_t)a->CCR3 - (int32_t)b->CCR3);
+    uint32_t d = (d1 > d2) ? d1 : d2;
+    return (d > d3) ? d : d3;
+}
+
+static void Check(float alpha, float beta)
+{
+    SVPWM_t a, b;
+
+    SVPWM_Init(&a, SW_UDC, HW_PWM_PERIOD);
+    SVPWM_Init(&b, SW_UDC, HW_PWM_PERIOD);
+    a.Alpha = b.Alpha = alpha;
+    a.Beta = b.Beta = beta;
+    SVPWM_CalcSector(&a);
+    SVPWM_CalcMinMax(&b);
+
+    uint32_t d = CcrDiff(&a, &b);
+    float mag = sqrtf(alpha * alpha + beta * beta);
+    if (mag <= SW_UDC * FOC_ONE_BY_SQRT3) {
+        n_lin++;
+        if (d > max_lin) max_lin = d;
+        if (d > SW_MAX_DIFF) {
+            printf("linear-range mismatch %u at (%.4f, %.4f): %u/%u/%u vs %u/%u/%u\n", (unsigned)d,
+                   (double)alpha, (double)beta, (unsigned)a.CCR1, (unsigned)a.CCR2, (unsigned)a.CCR3,
+                   (unsigned)b.CCR1, (unsigned)b.CCR2, (unsigned)b.CCR3);
+        }
+    } else {
+        n_ovm++;
+        if (d > max_ovm) max_ovm = d;
+    }
+}
+
+int main(void)
+{
+    /*--- 直角网格 ---*/
+    for (int32_t i = 0; i < SW_GRID; i++) {
+        for (int32_t j = 0; j < SW_GRID; j++) {
+            float alpha = SW_SPAN * SW_UDC * (2.0f * (float)i / (SW_GRID - 1) - 1.0f);
+            float beta = SW_SPAN * SW_UDC * (2.0f * (float)j / (SW_GRID - 1) - 1.0f);
+            Check(alpha, beta);
+        }
+    }
+
+    /*--- 扇区边界射线 (60° 整数倍, 线性区内到六边形内切圆) ---*/
+    for (int32_t k = 0; k < 6; k++) {
+        float c = cosf((float)k * FOC_PI / 3.0f), s = sinf((float)k * FOC_PI / 3.0f);
+        for (int32_t r = 0; r <= SW_RAY_POINTS; r++) {
+            float mag = SW_UDC * FOC_ONE_BY_SQRT3 * (float)r / SW_RAY_POINTS;
+            Check(mag * c, mag * s);
+        }
+    }
+    Check(0.0f, 0.0f);
+    Check(-0.0f, 0.0f);
+
+    /*--- 耗时 (仅打印, 输入预先生成) ---*/
+    static float in_a[4096], in_b[4096];
+    SVPWM_t sv;
+    volatile uint32_t sink = 0;
+    uint64_t t_sector, t_minmax, t0;
+    for (int32_t i = 0; i < 4096; i++) {
+        in_a[i] = 6.0f * cosf((float)i * (FOC_2PI / 4096.0f));
+        in_b[i] = 6.0f * sinf((float)i * (FOC_2PI / 4096.0f));
+    }
+    SVPWM_Init(&sv, SW_UDC, HW_PWM_PERIOD);
+    t0 = Test_NowNs();
+    for (int32_t i = 0; i < 1 << 20; i++) {
+        sv.Alpha = in_a[i & 4095];
+        sv.Beta = in_b[i & 4095];
+        SVPWM_CalcSector(&sv);
+        sink += sv.CCR1;
+    }
+    t_sector = Test_NowNs() - t0;
+    t0 = Test_NowNs();
+    for (int32_t i = 0; i < 1 << 20; i++) {
+        sv.Alpha = in_a[i & 4095];
+        sv.Beta = in_b[i & 4095];
+        SVPWM_CalcMinMax(&sv);
+        sink += sv.CCR1;
+    }
+    t_minmax = Test_NowNs() - t0;
+    (void)sink;
+
+    printf("linear range: %u points, max CCR diff %u (limit %u); overmodulation: %u points, max diff %u\n",
+           (unsigned)n_lin, (unsigned)max_lin, SW_MAX_DIFF, (unsigned)n_ovm, (unsigned)max_ovm);
+    printf("per call: sector %.1f ns, minmax %.1f ns\n",
+           (double)t_sector / (1 << 20), (double)t_minmax / (1 << 20));
+    TEST_CHECK(max_lin <= SW_MAX_DIFF);
+    return Test_Result("test_svpwm_sweep");
+}
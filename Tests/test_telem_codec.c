@@ -0,0 +1,211 @@
+/**
+ * @file    test_telem_codec.c
+ * @brief   遥测编解码测试: 半精度转换、仿真数据往返精度、丢帧后续解码、链路效率
+ * @note    1. 半精度: 全部 65536 个码往返一致, 边界值与就近舍入到偶数
+ *          2. 速度模式仿真 100k 节拍, 四个通道覆盖 I16 / I16+差分 / F16 分频 / 慢变分频,
+ *             节拍号不规则递增且跨 32 位回绕, 间隔超过 255 的记录须另起一帧;
+ *             解码节拍号逐条一致, 误差不超过各编码的量化界
+ *          3. 隔帧丢弃: 收到的帧独立解码, 精度不变
+ *          4. 只发 Iq + 转速 (I16) 时, 每条记录的链路字节数 (含协议帧头与 CRC)
+ *             须不超过 VOFA JustFloat 23 通道记录 (96 字节) 的 1/5
+ */
+
+#include "foc_core.h"
+#include "foc_telem.h"
+#include "test_util.h"
+#include <math.h>
+#include <string.h>
+
+#define TC_RECORDS          100000u
+#define TC_MAX_FRAMES       (TC_RECORDS / 2u)
+#define TC_VOFA_RECORD      (23u * 4u + 4u)     // JustFloat: 23 个 float + 帧尾
+#define TC_FRAME_OVERHEAD   (PROTO_HEADER_SIZE + PROTO_CRC_SIZE)
+
+/* 测试通道: 通道号与 VOFA 数组下标一致 */
+enum { CH_IQ = 15, CH_POS = 19, CH_RPM = 21, CH_TGT = 22 };
+static const uint8_t tc_ch[4] = { CH_IQ, CH_POS, CH_RPM, CH_TGT };
+
+static float truth[TC_RECORDS][4];
+static uint32_t ticks[TC_RECORDS];
+static uint8_t frames[TC_MAX_FRAMES][TELEM_MAX_PAYLOAD];
+static uint32_t frame_len[TC_MAX_FRAMES];
+static uint32_t frame_first[TC_MAX_FRAMES + 1u];    // 每帧首条记录的下标
+static uint32_t n_frames, n_encoded;
+
+static Telem_Config_t cfg;
+static uint32_t cur;
+static uint32_t tick_err;
+static float max_err[4];
+static uint32_t bound_fail;
+
+static void Tc_Output(const uint8_t *payload, uint32_t len, void *user)
+{
+    (void)user;
+    memcpy(frames[n_frames], payload, len);
+    frame_len[n_frames] = len;
+    n_frames++;
+    frame_first[n_frames] = n_encoded;
+}
+
+/* 各编码的量化误差界 (另加单精度还原的 2 个 ulp) */
+static float Tc_Bound(uint8_t ch, float v)
+{
+    const Telem_ChannelCfg_t *c = &cfg.Ch[ch];
+
+    if (c->Format == TELEM_FMT_I16) return 0.5f * c->Scale + fabsf(v) * 2.4e-7f;
+    if (c->Format == TELEM_FMT_F16) return fabsf(v) * (1.0f / 2048.0f) + 6e-8f;
+    return 0.0f;
+}
+
+static void Tc_Record(const float *values, uint32_t sampled, uint32_t tick, void *user)
+{
+    (void)user;
+    if (tick != ticks[cur]) tick_err++;
+    for (uint32_t k = 0; k < 4u; k++) {
+        uint8_t ch = tc_ch[k];
+        if (!(sampled & (1u << ch))) continue;
+        float e = fabsf(values[ch] - truth[cur][k]);
+        if (e > max_err[k]) max_err[k] = e;
+        if (e > Tc_Bound(ch, truth[cur][k])) bound_fail++;
+    }
+    cur++;
+}
+
+/**
+ * @brief  编码全部记录
+ */
+static void Tc_EncodeAll(Telem_Encoder_t *enc)
+{
+    float v[TELEM_MAX_CH];
+
+    memset(v, 0, sizeof(v));
+    n_frames = 0;
+    n_encoded = 0;
+    frame_first[0] = 0;
+    Telem_EncoderInit(enc, &cfg, Tc_Output, NULL);
+    for (uint32_t i = 0; i < TC_RECORDS; i++) {
+        for (uint32_t k = 0; k < 4u; k++) v[tc_ch[k]] = truth[i][k];
+        Telem_Encode(enc, ticks[i], v);
+        n_encoded++;
+    }
+    Telem_Flush(enc);
+}
+
+/**
+ * @brief  解码每 step 帧中的一帧, 返回解码记录数
+ */
+static uint32_t Tc_DecodeEvery(Telem_Decoder_t *dec, uint32_t step)
+{
+    uint32_t records = 0;
+
+    Telem_DecoderInit(dec, &cfg);
+    tick_err = 0;
+    bound_fail = 0;
+    memset(max_err, 0, sizeof(max_err));
+    for (uint32_t f = 0; f < n_frames; f += step) {
+        cur = frame_first[f];
+        records += Telem_Decode(dec, frames[f], frame_len[f], Tc_Record, NULL);
+        TEST_CHECK(cur == frame_first[f + 1u]);
+    }
+    return records;
+}
+
+static void Test_Half(void)
+{
+    uint32_t bad = 0;
+
+    for (uint32_t h = 0; h < 65536u; h++) {
+        float f = Telem_HalfToFloat((uint16_t)h);
+        if (f != f) continue;                       // NaN 不要求保持负载
+        if (Telem_FloatToHalf(f) != h) bad++;
+    }
+    TEST_CHECK(bad == 0);
+    TEST_CHECK(Telem_FloatToHalf(1.0f) == 0x3C00u);
+    TEST_CHECK(Telem_FloatToHalf(-2.0f) == 0xC000u);
+    TEST_CHECK(Telem_FloatToHalf(65504.0f) == 0x7BFFu);
+    TEST_CHECK(Telem_FloatToHalf(65520.0f) == 0x7C00u);                 // 溢出为无穷
+    TEST_CHECK(Telem_FloatToHalf(ldexpf(1.0f, -24)) == 0x0001u);        // 最小非规格化数
+    TEST_CHECK(Telem_FloatToHalf(1.0f + ldexpf(1.0f, -11)) == 0x3C00u); // 正中间, 舍入到偶数
+    TEST_CHECK(Telem_FloatToHalf(1.0f + 3.0f * ldexpf(1.0f, -11)) == 0x3C02u);
+}
+
+int main(void)
+{
+    Telem_Encoder_t enc;
+    Telem_Decoder_t dec;
+    uint32_t rng = 1u;
+
+    Test_Half();
+
+    /*--- 仿真数据 ---*/
+    MotorHW_Sim_Init(&g_MotorHW[0], NULL, HW_ENCODER_ZERO_OFFSET, 1);
+    FOC_Init(&g_Motor, 0);
+    FOC_Start(&g_Motor);
+    FOC_SetMode(&g_Motor, FOC_MODE_SPEED);
+    FOC_SetTargetSpeed(&g_Motor, 1500.0f);
+    for (uint32_t i = 0; i < TC_RECORDS; i++) {
+        if (i == TC_RECORDS / 2u) FOC_SetTargetSpeed(&g_Motor, -800.0f);
+        FOC_SimTick(&g_Motor);
+        truth[i][0] = g_Motor.ActualIq;
+        truth[i][1] = g_Motor.PosCtrl.CurrentPos;
+        truth[i][2] = g_Motor.ActualRPM;
+        truth[i][3] = g_Motor.TargetRPM;
+
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        ticks[i] = (i == 0) ? 0xFFFFF000u : ticks[i - 1] + ((i % 997u == 0) ? 400u : 1u + rng % 3u);
+    }
+
+    /*--- 往返精度 ---*/
+    Telem_DefaultConfig(&cfg);
+    cfg.Id = 7;
+    cfg.Mask = (1u << CH_IQ) | (1u << CH_POS) | (1u << CH_RPM) | (1u << CH_TGT);
+    cfg.Ch[CH_IQ].Format = TELEM_FMT_I16;
+    cfg.Ch[CH_IQ].Scale = 0.001f;
+    cfg.Ch[CH_RPM].Format = TELEM_FMT_I16;
+    cfg.Ch[CH_RPM].Scale = 0.1f;
+    cfg.Ch[CH_RPM].Delta = 1;
+    cfg.Ch[CH_POS].Format = TELEM_FMT_F16;
+    cfg.Ch[CH_POS].Div = 4;
+    cfg.Ch[CH_TGT].Format = TELEM_FMT_I16;
+    cfg.Ch[CH_TGT].Scale = 1.0f;
+    cfg.Ch[CH_TGT].Delta = 1;
+    cfg.Ch[CH_TGT].Div = 20;
+
+    Tc_EncodeAll(&enc);
+    uint32_t records = Tc_DecodeEvery(&dec, 1u);
+    printf("round trip: %u records, %u samples, %u frames, %.2f B/record | "
+           "max err iq %.4f pos %.4f rpm %.3f tgt %.2f\n", (unsigned)records, (unsigned)dec.Samples,
+           (unsigned)enc.Frames, (double)enc.Bytes / enc.Records, (double)max_err[0],
+           (double)max_err[1], (double)max_err[2], (double)max_err[3]);
+    TEST_CHECK(records == TC_RECORDS && dec.Records == TC_RECORDS);
+    TEST_CHECK(dec.Samples == enc.Samples && dec.Frames == enc.Frames);
+    TEST_CHECK(dec.Errors == 0 && dec.CfgMismatch == 0);
+    TEST_CHECK(tick_err == 0 && bound_fail == 0);
+    TEST_CHECK(enc.Frames > TC_RECORDS / 997u);         // 大间隔处均已另起一帧
+
+    /*--- 隔帧丢弃 ---*/
+    records = Tc_DecodeEvery(&dec, 2u);
+    printf("drop half:  %u records from %u of %u frames, errors %u\n", (unsigned)records,
+           (unsigned)dec.Frames, (unsigned)n_frames, (unsigned)dec.Errors);
+    TEST_CHECK(dec.Errors == 0 && tick_err == 0 && bound_fail == 0);
+    TEST_CHECK(dec.Frames == (n_frames + 1u) / 2u);
+
+    /*--- 配置号不符的帧被拒绝 ---*/
+    Telem_DecoderInit(&dec, &cfg);
+    dec.Cfg.Id = 8;
+    TEST_CHECK(Telem_Decode(&dec, frames[0], frame_len[0], NULL, NULL) == 0);
+    TEST_CHECK(dec.CfgMismatch == 1);
+
+    /*--- 链路效率: 只发 Iq + 转速 ---*/
+    cfg.Mask = (1u << CH_IQ) | (1u << CH_RPM);
+    cfg.Ch[CH_RPM].Delta = 0;
+    Tc_EncodeAll(&enc);
+    float wire = (float)(enc.Bytes + TC_FRAME_OVERHEAD * enc.Frames) / (float)enc.Records;
+    printf("iq+rpm i16: %.2f wire B/record vs VOFA %u B/record -> %.1fx samples/s on the same link\n",
+           (double)wire, (unsigned)TC_VOFA_RECORD, (double)(TC_VOFA_RECORD / wire));
+    TEST_CHECK(TC_VOFA_RECORD >= 5.0f * wire);
+
+    return Test_Result("test_telem_codec");
+}
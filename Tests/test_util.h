@@ -0,0 +1,41 @@
+/**
+ * @file    test_util.h
+ * @brief   主机测试公共工具: 计时与检查
+ * @note    检查失败只计数并打印位置, 由 main 根据 Test_Failures 返回非零;
+ *          耗时数据只打印, 不作为通过条件 (主机与目标差异大)
+ */
+
+#ifndef __TEST_UTIL_H
+#define __TEST_UTIL_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+static uint32_t Test_Failures = 0;
+
+/* 检查条件, 失败时打印表达式与位置 */
+#define TEST_CHECK(cond)    do { if (!(cond)) { Test_Failures++; \
+                                 printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+/**
+ * @brief  单调时钟 (ns)
+ */
+static inline uint64_t Test_NowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief  打印结论并给出进程返回值
+ */
+static inline int Test_Result(const char *name)
+{
+    printf("%s: %s\n", name, Test_Failures ? "FAIL" : "ok");
+    return Test_Failures ? 1 : 0;
+}
+
+#endif /* __TEST_UTIL_H */
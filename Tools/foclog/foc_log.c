@@ -0,0 +1,345 @@
+/**
+ * @file    foc_log.c
+ * @brief   分块二进制采集日志实现
+ */
+
+#define _FILE_OFFSET_BITS 64
+
+#include "foc_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  记录占用字节数 (数据补齐到 8 字节, 记录头保持对齐)
+ */
+static inline uint32_t Log_RowSize(uint32_t len)
+{
+    return (uint32_t)sizeof(FOC_LogRow_t) + ((len + 7u) & ~7u);
+}
+
+/**
+ * @brief  块头是否完整可用
+ * @param  remain: 块头起点到文件末尾的字节数
+ */
+static int Log_ChunkValid(const FOC_LogChunk_t *c, uint64_t remain)
+{
+    if (c->Magic != FOC_LOG_CHUNK_MAGIC) return 0;
+    if (c->Size > remain) return 0;
+    if (c->Size < sizeof(FOC_LogChunk_t) + (uint64_t)c->IndexCnt * sizeof(FOC_LogIndex_t)) return 0;
+    return 1;
+}
+
+/**
+ * @brief  块记录区起点
+ */
+static inline const uint8_t *Log_ChunkRows(const FOC_LogChunk_t *c)
+{
+    return (const uint8_t *)c + sizeof(FOC_LogChunk_t) + c->IndexCnt * sizeof(FOC_LogIndex_t);
+}
+
+/**
+ * @brief  块内索引
+ */
+static inline const FOC_LogIndex_t *Log_ChunkIndex(const FOC_LogChunk_t *c)
+{
+    return (const FOC_LogIndex_t *)((const uint8_t *)c + sizeof(FOC_LogChunk_t));
+}
+
+/**
+ * @brief  打开已有文件: 校验文件头, 截掉末尾不完整的块
+ * @return 0=成功, -1=不是日志文件
+ */
+static int Log_Recover(FOC_LogWriter_t *w, int fd, uint64_t size)
+{
+    FOC_LogFileHeader_t hdr;
+    FOC_LogChunk_t chunk;
+    uint64_t pos = sizeof(hdr);
+
+    if (pread(fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr)) return -1;
+    if (memcmp(hdr.Magic, FOC_LOG_MAGIC, sizeof(hdr.Magic)) != 0) return -1;
+    w->CtrlHz = hdr.CtrlHz;
+
+    while (pos + sizeof(chunk) <= size) {
+        if (pread(fd, &chunk, sizeof(chunk), (off_t)pos) != (ssize_t)sizeof(chunk)) break;
+        if (!Log_ChunkValid(&chunk, size - pos)) break;
+        w->BaseTick = chunk.LastTick + 1u;
+        pos += chunk.Size;
+    }
+    if (pos < size && ftruncate(fd, (off_t)pos) != 0) return -1;
+    return 0;
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  CRC32 (IEEE 802.3, 反射多项式 0xEDB88320)
+ */
+uint32_t FOC_Log_Crc32(uint32_t crc, const void *data, uint64_t len)
+{
+    static uint32_t table[256];
+    const uint8_t *p = data;
+
+    if (table[1] == 0) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            table[i] = c;
+        }
+    }
+
+    crc = ~crc;
+    while (len--) crc = table[(crc ^ *p++) & 0xFFu] ^ (crc >> 8);
+    return ~crc;
+}
+
+/**
+ * @brief  打开日志写入
+ */
+int FOC_Log_Open(FOC_LogWriter_t *w, const char *path, uint32_t ctrl_hz)
+{
+    struct stat st;
+    int fd;
+
+    memset(w, 0, sizeof(*w));
+    w->CtrlHz = ctrl_hz;
+
+    fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return -1;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    if (st.st_size > 0) {
+        if (Log_Recover(w, fd, (uint64_t)st.st_size) != 0) {
+            close(fd);
+            return -1;
+        }
+    } else {
+        FOC_LogFileHeader_t hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.Magic, FOC_LOG_MAGIC, sizeof(hdr.Magic));
+        hdr.Version = FOC_LOG_VERSION;
+        hdr.CtrlHz = ctrl_hz;
+        hdr.Created = (uint64_t)time(NULL);
+        if (write(fd, &hdr, sizeof(hdr)) != (ssize_t)sizeof(hdr)) {
+            close(fd);
+            return -1;
+        }
+    }
+
+    w->File = fdopen(fd, "r+b");
+    w->Rows = malloc(FOC_LOG_CHUNK_SIZE);
+    if (w->File == NULL || w->Rows == NULL) {
+        if (w->File != NULL) fclose(w->File); else close(fd);
+        free(w->Rows);
+        return -1;
+    }
+    fseeko(w->File, 0, SEEK_END);
+    return 0;
+}
+
+/**
+ * @brief  追加一条记录
+ */
+int FOC_Log_Append(FOC_LogWriter_t *w, uint8_t kind, uint8_t type, uint32_t mask,
+                   uint64_t tick, const void *data, uint32_t len)
+{
+    FOC_LogRow_t row;
+    uint32_t size = Log_RowSize(len);
+
+    if (len > FOC_LOG_MAX_DATA) return -1;
+    if (w->Used + size > FOC_LOG_CHUNK_SIZE && FOC_Log_Flush(w) != 0) return -1;
+
+    /* 每 FOC_LOG_INDEX_STRIDE 条建一个索引项 */
+    if (w->Chunk.Rows % FOC_LOG_INDEX_STRIDE == 0) {
+        FOC_LogIndex_t *idx = &w->Index[w->Chunk.IndexCnt++];
+        idx->Tick = tick;
+        idx->Offset = w->Used;
+        idx->Row = w->Chunk.Rows;
+    }
+    if (w->Chunk.Rows == 0) w->Chunk.FirstTick = tick;
+    w->Chunk.LastTick = tick;
+    w->Chunk.Rows++;
+
+    row.Kind = kind;
+    row.Type = type;
+    row.Len = (uint16_t)len;
+    row.Mask = mask;
+    row.Tick = tick;
+    memcpy(&w->Rows[w->Used], &row, sizeof(row));
+    if (len > 0) memcpy(&w->Rows[w->Used + sizeof(row)], data, len);
+    memset(&w->Rows[w->Used + sizeof(row) + len], 0, size - sizeof(row) - len);
+    w->Used += size;
+    w->TotalRows++;
+    return 0;
+}
+
+/**
+ * @brief  写出当前块
+ */
+int FOC_Log_Flush(FOC_LogWriter_t *w)
+{
+    uint32_t index_bytes = w->Chunk.IndexCnt * (uint32_t)sizeof(FOC_LogIndex_t);
+    int ok = 1;
+
+    if (w->Chunk.Rows == 0) return 0;
+
+    w->Chunk.Magic = FOC_LOG_CHUNK_MAGIC;
+    w->Chunk.Size = (uint32_t)sizeof(FOC_LogChunk_t) + index_bytes + w->Used;
+    w->Chunk.Crc32 = FOC_Log_Crc32(FOC_Log_Crc32(0, w->Index, index_bytes), w->Rows, w->Used);
+
+    ok &= fwrite(&w->Chunk, sizeof(w->Chunk), 1, w->File) == 1;
+    ok &= fwrite(w->Index, index_bytes, 1, w->File) == 1;
+    ok &= fwrite(w->Rows, w->Used, 1, w->File) == 1;
+    ok &= fflush(w->File) == 0;
+
+    w->Bytes += w->Chunk.Size;
+    w->Chunks++;
+    memset(&w->Chunk, 0, sizeof(w->Chunk));
+    w->Used = 0;
+    return ok ? 0 : -1;
+}
+
+/**
+ * @brief  写出并关闭
+ */
+int FOC_Log_Close(FOC_LogWriter_t *w)
+{
+    int ret = FOC_Log_Flush(w);
+
+    if (fclose(w->File) != 0) ret = -1;
+    free(w->Rows);
+    w->File = NULL;
+    w->Rows = NULL;
+    return ret;
+}
+
+/**
+ * @brief  映射日志读取
+ */
+int FOC_Log_Map(FOC_LogReader_t *r, const char *path, int verify)
+{
+    struct stat st;
+    uint64_t pos = sizeof(FOC_LogFileHeader_t);
+    uint32_t cap = 0;
+    int fd;
+
+    memset(r, 0, sizeof(*r));
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(FOC_LogFileHeader_t)) {
+        close(fd);
+        return -1;
+    }
+
+    r->MapSize = (uint64_t)st.st_size;
+    void *base = mmap(NULL, (size_t)r->MapSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return -1;
+
+    r->Base = base;
+    r->Header = (const FOC_LogFileHeader_t *)base;
+    if (memcmp(r->Header->Magic, FOC_LOG_MAGIC, sizeof(r->Header->Magic)) != 0) {
+        FOC_Log_Unmap(r);
+        return -1;
+    }
+
+    /* 只遍历块头 */
+    while (pos + sizeof(FOC_LogChunk_t) <= r->MapSize) {
+        const FOC_LogChunk_t *c = (const FOC_LogChunk_t *)(r->Base + pos);
+
+        if (!Log_ChunkValid(c, r->MapSize - pos)) break;
+        if (verify && FOC_Log_Crc32(0, Log_ChunkIndex(c), c->Size - sizeof(*c)) != c->Crc32) break;
+
+        if (r->ChunkCnt == cap) {
+            cap = cap ? cap * 2u : 64u;
+            const FOC_LogChunk_t **t = realloc(r->Chunks, cap * sizeof(*t));
+            if (t == NULL) break;
+            r->Chunks = t;
+        }
+        r->Chunks[r->ChunkCnt++] = c;
+        r->Rows += c->Rows;
+        pos += c->Size;
+    }
+    r->Size = pos;
+    return 0;
+}
+
+/**
+ * @brief  解除映射
+ */
+void FOC_Log_Unmap(FOC_LogReader_t *r)
+{
+    if (r->Base != NULL) munmap((void *)r->Base, (size_t)r->MapSize);
+    free(r->Chunks);
+    memset(r, 0, sizeof(*r));
+}
+
+/**
+ * @brief  按节拍号定位
+ */
+int FOC_Log_Seek(const FOC_LogReader_t *r, uint64_t tick, FOC_LogCursor_t *c)
+{
+    uint32_t lo = 0, hi = r->ChunkCnt;
+
+    /* 第一个 LastTick >= tick 的块 */
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2u;
+        if (r->Chunks[mid]->LastTick < tick) lo = mid + 1u; else hi = mid;
+    }
+    if (lo >= r->ChunkCnt) return -1;
+
+    const FOC_LogChunk_t *chunk = r->Chunks[lo];
+    const FOC_LogIndex_t *idx = Log_ChunkIndex(chunk);
+    uint32_t a = 0, b = chunk->IndexCnt;
+
+    /* 最后一个 Tick < tick 的索引项, 从该处顺序扫描 */
+    while (a < b) {
+        uint32_t mid = a + (b - a) / 2u;
+        if (idx[mid].Tick < tick) a = mid + 1u; else b = mid;
+    }
+    c->Chunk = lo;
+    c->Offset = (a > 0) ? idx[a - 1].Offset : 0;
+    c->Row = (a > 0) ? idx[a - 1].Row : 0;
+
+    const uint8_t *rows = Log_ChunkRows(chunk);
+    while (c->Row < chunk->Rows) {
+        const FOC_LogRow_t *row = (const FOC_LogRow_t *)(rows + c->Offset);
+        if (row->Tick >= tick) return 0;
+        c->Offset += Log_RowSize(row->Len);
+        c->Row++;
+    }
+    return -1;
+}
+
+/**
+ * @brief  读取游标处记录并前进
+ */
+const FOC_LogRow_t *FOC_Log_Next(const FOC_LogReader_t *r, FOC_LogCursor_t *c, const void **data)
+{
+    while (c->Chunk < r->ChunkCnt && c->Row >= r->Chunks[c->Chunk]->Rows) {
+        c->Chunk++;
+        c->Offset = 0;
+        c->Row = 0;
+    }
+    if (c->Chunk >= r->ChunkCnt) return NULL;
+
+    const FOC_LogRow_t *row = (const FOC_LogRow_t *)(Log_ChunkRows(r->Chunks[c->Chunk]) + c->Offset);
+    *data = (const uint8_t *)row + sizeof(*row);
+    c->Offset += Log_RowSize(row->Len);
+    c->Row++;
+    return row;
+}
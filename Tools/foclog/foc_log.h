@@ -0,0 +1,188 @@
+/**
+ * @file    foc_log.h
+ * @brief   分块二进制采集日志 (只追加写入, 内存映射按时间定位)
+ * @note    文件布局 (小端):
+ *            [文件头 32 B][块 0][块 1]...
+ *            块 = [块头 40 B][索引 × IndexCnt][记录...]
+ *            记录 = [记录头 16 B][数据, 补齐到 8 字节]
+ *          写入端在内存中攒满一块 (或调用 FOC_Log_Flush) 后整块追加, 块头含 CRC32;
+ *          异常退出最多丢失未写出的一块, 重新打开时截掉末尾不完整的块
+ *          读取端 mmap 整个文件, 只遍历块头建立块表, 不解析记录:
+ *            按时间定位 = 块表二分 (节拍范围) → 块内索引二分 (每 FOC_LOG_INDEX_STRIDE 条一项) → 顺序扫描
+ *          节拍号为展开后的 64 位控制周期计数, 文件内单调不减, 时间 = 节拍号 / CtrlHz
+ *          使用 POSIX 文件接口 (Linux/macOS/MSYS2)
+ */
+
+#ifndef __FOC_LOG_H
+#define __FOC_LOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#define FOC_LOG_MAGIC           "FOCLOG01"
+#define FOC_LOG_CHUNK_MAGIC     0x4B4E4843u     // "CHNK"
+#define FOC_LOG_VERSION         1
+#define FOC_LOG_CHUNK_SIZE      (1u << 20)      // 块记录区容量 (字节)
+#define FOC_LOG_INDEX_STRIDE    256             // 每多少条记录一个索引项
+#define FOC_LOG_MAX_DATA        0xFFFCu         // 单条记录数据上限
+
+/* 记录类别 */
+enum {
+    FOC_LOG_VOFA = 0,           // 实时数据: float × n (Mask = 通道掩码)
+    FOC_LOG_SCOPE,              // 示波器上传: float × n ([相对触发时刻, 通道...])
+    FOC_LOG_PROTO,              // 协议帧负载原样保存 (Type = 消息类型, 遥测帧解码需对应配置)
+};
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 文件头
+ */
+typedef struct {
+    char Magic[8];              // FOC_LOG_MAGIC
+    uint32_t Version;
+    uint32_t CtrlHz;            // 控制频率 (节拍号换算时间)
+    uint64_t Created;           // 创建时间 (Unix 秒)
+    uint64_t Reserved;
+} FOC_LogFileHeader_t;
+
+/**
+ * @brief 块头
+ */
+typedef struct {
+    uint32_t Magic;             // FOC_LOG_CHUNK_MAGIC
+    uint32_t Size;              // 整块字节数 (含块头与索引)
+    uint32_t Rows;              // 记录数
+    uint32_t IndexCnt;          // 索引项数
+    uint64_t FirstTick;         // 首条记录节拍号
+    uint64_t LastTick;          // 末条记录节拍号
+    uint32_t Crc32;             // 索引与记录区的 CRC32
+    uint32_t Reserved;
+} FOC_LogChunk_t;
+
+/**
+ * @brief 块内索引项
+ */
+typedef struct {
+    uint64_t Tick;              // 该记录的节拍号
+    uint32_t Offset;            // 记录相对记录区起点的偏移
+    uint32_t Row;               // 记录序号
+} FOC_LogIndex_t;
+
+/**
+ * @brief 记录头
+ */
+typedef struct {
+    uint8_t Kind;               // FOC_LOG_xxx
+    uint8_t Type;               // 协议消息类型 (PROTO)
+    uint16_t Len;               // 数据字节数 (不含补齐)
+    uint32_t Mask;              // 通道掩码 (VOFA/SCOPE)
+    uint64_t Tick;              // 节拍号
+} FOC_LogRow_t;
+
+/**
+ * @brief 写入端
+ */
+typedef struct {
+    FILE *File;
+    uint32_t CtrlHz;
+    uint8_t *Rows;              // 当前块记录区
+    uint32_t Used;              // 当前块记录区已用字节
+    FOC_LogChunk_t Chunk;       // 当前块头
+    FOC_LogIndex_t Index[FOC_LOG_CHUNK_SIZE / sizeof(FOC_LogRow_t) / FOC_LOG_INDEX_STRIDE + 1];
+    uint64_t BaseTick;          // 追加写入时的节拍号起点 (文件末条记录节拍号 + 1, 新文件为 0)
+
+    /* 统计 */
+    uint64_t TotalRows;         // 已写入记录数
+    uint64_t Bytes;             // 已写入文件字节数
+    uint32_t Chunks;            // 已写入块数
+} FOC_LogWriter_t;
+
+/**
+ * @brief 读取端
+ */
+typedef struct {
+    const uint8_t *Base;        // 映射地址
+    uint64_t Size;              // 有效长度 (截至最后一个完整块)
+    const FOC_LogFileHeader_t *Header;
+    const FOC_LogChunk_t **Chunks;      // 块表
+    uint32_t ChunkCnt;
+    uint64_t Rows;              // 总记录数
+    uint64_t MapSize;           // 映射长度
+} FOC_LogReader_t;
+
+/**
+ * @brief 读取游标
+ */
+typedef struct {
+    uint32_t Chunk;             // 块号
+    uint32_t Offset;            // 记录区内偏移
+    uint32_t Row;               // 块内记录序号
+} FOC_LogCursor_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  打开日志写入 (文件存在时追加, 截掉末尾不完整的块)
+ * @param  ctrl_hz: 控制频率 (新建文件时写入文件头)
+ * @return 0=成功, -1=失败
+ */
+int FOC_Log_Open(FOC_LogWriter_t *w, const char *path, uint32_t ctrl_hz);
+
+/**
+ * @brief  追加一条记录 (当前块放不下时先写出)
+ * @param  tick: 节拍号 (不小于上一条; 追加到已有文件时须不小于 BaseTick)
+ * @return 0=成功, -1=写入失败或数据过长
+ */
+int FOC_Log_Append(FOC_LogWriter_t *w, uint8_t kind, uint8_t type, uint32_t mask,
+                   uint64_t tick, const void *data, uint32_t len);
+
+/**
+ * @brief  写出当前块 (无记录时不写)
+ */
+int FOC_Log_Flush(FOC_LogWriter_t *w);
+
+/**
+ * @brief  写出并关闭
+ */
+int FOC_Log_Close(FOC_LogWriter_t *w);
+
+/**
+ * @brief  映射日志读取
+ * @param  verify: 1=校验每块 CRC (遇到错误块即截止)
+ * @return 0=成功, -1=失败
+ */
+int FOC_Log_Map(FOC_LogReader_t *r, const char *path, int verify);
+
+/**
+ * @brief  解除映射
+ */
+void FOC_Log_Unmap(FOC_LogReader_t *r);
+
+/**
+ * @brief  定位到节拍号不小于 tick 的第一条记录
+ * @return 0=成功, -1=之后没有记录
+ */
+int FOC_Log_Seek(const FOC_LogReader_t *r, uint64_t tick, FOC_LogCursor_t *c);
+
+/**
+ * @brief  读取游标处记录并前进
+ * @param  data: 输出数据指针 (指向映射区)
+ * @return 记录头, NULL=已到末尾
+ */
+const FOC_LogRow_t *FOC_Log_Next(const FOC_LogReader_t *r, FOC_LogCursor_t *c, const void **data);
+
+/**
+ * @brief  CRC32 (IEEE 802.3)
+ */
+uint32_t FOC_Log_Crc32(uint32_t crc, const void *data, uint64_t len);
+
+#endif /* __FOC_LOG_H */
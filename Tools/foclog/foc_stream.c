@@ -0,0 +1,168 @@
+/**
+ * @file    foc_stream.c
+ * @brief   设备串口数据流解帧实现
+ */
+
+#include "foc_stream.h"
+#include <string.h>
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  查找帧尾 (失步时逐字节搜索)
+ * @return 帧尾之后的位置, 0=未找到
+ */
+static uint64_t Stream_FindTail(const uint8_t *p, uint64_t avail)
+{
+    const uint8_t *q = p + 3;
+    const uint8_t *end = p + avail;
+
+    /* 以帧尾最后一字节 0x7F 为锚点 */
+    while (q < end) {
+        q = memchr(q, 0x7F, (size_t)(end - q));
+        if (q == NULL) return 0;
+        if (q[-1] == 0x80 && q[-2] == 0x00 && q[-3] == 0x00) return (uint64_t)(q + 1 - p);
+        q++;
+    }
+    return 0;
+}
+
+/**
+ * @brief  解析帧边界处的一帧
+ * @param  p: 当前位置
+ * @param  avail: 可用字节数
+ * @return 消耗的字节数 (帧长或丢弃的字节), 0=需要更多数据
+ */
+static uint64_t Stream_Step(FOC_Stream_t *s, const uint8_t *p, uint64_t avail,
+                            FOC_StreamHandler_t handler, void *user)
+{
+    FOC_StreamFrame_t f;
+
+    /*--- 失步: 搜索下一个帧尾 ---*/
+    if (!s->Synced) {
+        uint64_t n = Stream_FindTail(p, avail);
+        if (n > 0) {
+            s->Synced = 1;
+            s->SkippedBytes += n;
+            return n;
+        }
+        if (avail <= 3) return 0;
+        s->SkippedBytes += avail - 3;               // 保留可能是帧尾前缀的 3 字节
+        return avail - 3;
+    }
+
+    /*--- 协议帧 ---*/
+    if (p[0] == PROTO_SYNC) {
+        if (avail < 2) return 0;
+        if (p[1] <= PROTO_MAX_PAYLOAD) {
+            uint32_t size = PROTO_HEADER_SIZE + p[1] + PROTO_CRC_SIZE;
+            if (avail < size) return 0;
+            if (Proto_Crc16(0xFFFF, &p[1], 3u + p[1]) == Proto_GetU16(&p[size - PROTO_CRC_SIZE])) {
+                f.Kind = FOC_STREAM_PROTO;
+                f.Count = 0;
+                f.Values = NULL;
+                f.Proto.Len = p[1];
+                f.Proto.Type = p[2];
+                f.Proto.Seq = p[3];
+                f.Proto.Payload = &p[PROTO_HEADER_SIZE];
+                s->ProtoFrames++;
+                handler(&f, user);
+                return size;
+            }
+        }
+        /* 校验不通过: 可能是以 0xA5 开头的浮点数, 按 JustFloat 继续 */
+    }
+
+    /*--- JustFloat: 4 字节对齐查找帧尾 ---*/
+    uint32_t k = 0;
+    for (;;) {
+        if (4u * k + 4u > avail) return 0;
+        if (Proto_GetU32(&p[4u * k]) == FOC_STREAM_TAIL) break;
+        if (++k > FOC_STREAM_MAX_FLOATS) {
+            s->Synced = 0;                          // 帧边界已错, 丢弃一字节后搜索帧尾
+            s->Resyncs++;
+            s->SkippedBytes++;
+            return 1;
+        }
+    }
+
+    memcpy(s->Values, p, 4u * k);
+    f.Kind = (k == FOC_LINK_VOFA_CH + 2) ? FOC_STREAM_VOFA : FOC_STREAM_SCOPE;
+    f.Count = k;
+    f.Values = s->Values;
+    memset(&f.Proto, 0, sizeof(f.Proto));
+    if (f.Kind == FOC_STREAM_VOFA) {
+        s->VofaFrames++;
+    } else {
+        s->ScopeFrames++;
+    }
+    handler(&f, user);
+    return 4u * k + 4u;
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化解帧器
+ */
+void FOC_Stream_Init(FOC_Stream_t *s)
+{
+    memset(s, 0, sizeof(*s));
+}
+
+/**
+ * @brief  解析一块数据
+ * @note   1. 拼接缓冲非空时先拼上新数据, 解析到越过拼接部分为止
+ *         2. 其余完整帧在 data 内原地解析
+ *         3. 末尾不完整的帧 (不超过一帧长) 拷入拼接缓冲
+ */
+void FOC_Stream_Feed(FOC_Stream_t *s, const uint8_t *data, uint64_t len,
+                     FOC_StreamHandler_t handler, void *user)
+{
+    uint64_t i = 0;
+    uint64_t n;
+
+    s->Bytes += len;
+
+    /*--- 1. 跨块帧 ---*/
+    if (s->CarryLen > 0) {
+        uint32_t old = s->CarryLen;
+        uint32_t total;
+        uint64_t pos = 0;
+
+        n = sizeof(s->Carry) - old;
+        if (n > len) n = len;
+        memcpy(&s->Carry[old], data, (size_t)n);
+        total = old + (uint32_t)n;
+
+        while (pos < old) {
+            uint64_t c = Stream_Step(s, &s->Carry[pos], total - pos, handler, user);
+            if (c == 0) break;
+            pos += c;
+        }
+
+        if (pos < old) {
+            /* 拼上全部新数据仍不足一帧 (拼接缓冲容量大于两帧, 不会因容量不足卡住) */
+            s->CarryLen = total - (uint32_t)pos;
+            memmove(s->Carry, &s->Carry[pos], s->CarryLen);
+            return;
+        }
+        i = pos - old;
+        s->CarryLen = 0;
+    }
+
+    /*--- 2. 原地解析 ---*/
+    while (i < len) {
+        n = Stream_Step(s, &data[i], len - i, handler, user);
+        if (n == 0) break;
+        i += n;
+    }
+
+    /*--- 3. 不完整的帧 ---*/
+    s->CarryLen = (uint32_t)(len - i);
+    memcpy(s->Carry, &data[i], s->CarryLen);
+}
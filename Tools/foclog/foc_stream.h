@@ -0,0 +1,92 @@
+/**
+ * @file    foc_stream.h
+ * @brief   设备串口数据流解帧 (上位机使用)
+ * @note    设备发送队列按整帧入队, 串口流是以下两种帧的拼接:
+ *            - JustFloat: [float × n][VOFA_TAIL = 00 00 80 7F]
+ *                实时数据 n = FOC_LINK_VOFA_CH + 2 (末尾为节拍号/帧序号), 其余为示波器上传
+ *            - 二进制协议帧: [0xA5][LEN][TYPE][SEQ][PAYLOAD][CRC16] (遥测/应答/参数)
+ *          帧边界处以 0xA5 开头且 CRC 正确的按协议帧处理, 否则按 4 字节对齐查找帧尾;
+ *          查找不到 (丢包/接在中途) 时失去同步, 逐字节搜索下一个 VOFA_TAIL 重新同步
+ *          批量解析: 每次输入的整块数据原地解析, 只有跨块的不完整帧拷贝到拼接缓冲
+ */
+
+#ifndef __FOC_STREAM_H
+#define __FOC_STREAM_H
+
+#include <stdint.h>
+#include "foc_proto.h"
+#include "foc_link.h"
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#define FOC_STREAM_TAIL             0x7F800000u     // VOFA_TAIL (小端读出的 u32)
+#define FOC_STREAM_MAX_FLOATS       32              // JustFloat 帧最多通道数 (超过视为失步)
+#define FOC_STREAM_MAX_FRAME        (FOC_STREAM_MAX_FLOATS * 4 + 4)
+
+/* 帧类别 */
+typedef enum {
+    FOC_STREAM_VOFA = 0,        // 实时数据 JustFloat
+    FOC_STREAM_SCOPE,           // 其他通道数的 JustFloat (示波器上传)
+    FOC_STREAM_PROTO,           // 二进制协议帧
+} FOC_StreamKind_t;
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 解出的一帧 (指针仅在回调内有效)
+ */
+typedef struct {
+    FOC_StreamKind_t Kind;
+    uint32_t Count;             // float 个数 (JustFloat)
+    const float *Values;        // 通道值 (JustFloat, 已对齐)
+    Proto_Frame_t Proto;        // 协议帧 (PROTO)
+} FOC_StreamFrame_t;
+
+/**
+ * @brief  帧处理回调
+ */
+typedef void (*FOC_StreamHandler_t)(const FOC_StreamFrame_t *frame, void *user);
+
+/**
+ * @brief 解帧器
+ */
+typedef struct {
+    uint8_t Carry[2 * FOC_STREAM_MAX_FRAME];    // 跨块拼接缓冲
+    uint32_t CarryLen;
+    uint8_t Synced;             // 1=当前位于帧边界
+    float Values[FOC_STREAM_MAX_FLOATS];
+
+    /* 统计 */
+    uint64_t Bytes;             // 输入字节数
+    uint64_t SkippedBytes;      // 失步丢弃的字节数
+    uint32_t VofaFrames;        // 实时数据帧数
+    uint32_t ScopeFrames;       // 示波器帧数
+    uint32_t ProtoFrames;       // 协议帧数
+    uint32_t Resyncs;           // 失步次数
+} FOC_Stream_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化解帧器 (初始为失步状态, 从第一个帧尾之后开始解帧)
+ */
+void FOC_Stream_Init(FOC_Stream_t *s);
+
+/**
+ * @brief  解析一块数据, 对每个完整帧调用回调
+ * @param  s: 解帧器
+ * @param  data: 数据
+ * @param  len: 长度 (任意, 越大批量解析效率越高)
+ * @param  handler: 帧处理回调
+ * @param  user: 回调用户参数
+ */
+void FOC_Stream_Feed(FOC_Stream_t *s, const uint8_t *data, uint64_t len,
+                     FOC_StreamHandler_t handler, void *user);
+
+#endif /* __FOC_STREAM_H */
@@ -0,0 +1,437 @@
+/**
+ * @file    foclog.c
+ * @brief   设备数据流记录/查看工具 (上位机)
+ * @note    用法:
+ *            foclog record <串口设备|文件|-> <日志> [控制频率 Hz]   记录数据流到分块日志 (Ctrl-C 结束)
+ *            foclog info <日志>                                      块/记录/时间范围概要
+ *            foclog dump <日志> [起始 s] [结束 s]                    按时间定位后输出 CSV
+ *            foclog bench [MB]                                       合成数据流解帧/写日志/定位性能
+ *          编译: 仓库根目录 CMake 目标 foclog (测试见 Tests/test_foclog.c 与 ctest foclog_bench), 或在本目录:
+ *            gcc -O2 -std=gnu99 -I../../USER foclog.c foc_stream.c foc_log.c \
+ *                ../../USER/foc_proto.c ../../USER/foc_timeline.c -o foclog
+ */
+
+#define _FILE_OFFSET_BITS 64
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include "foc_stream.h"
+#include "foc_log.h"
+#include "foc_timeline.h"
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#define FOCLOG_READ_SIZE        (64 * 1024)     // 每次读取字节数
+#define FOCLOG_FLUSH_MS         1000            // 记录时写出当前块的间隔
+#define FOCLOG_DEFAULT_HZ       20000           // 默认控制频率 (HW_PWM_FREQ_HZ)
+#define FOCLOG_STAMP_BITS       24              // VOFA 模式追加的节拍号/帧序号位宽
+
+/*============================================================================*/
+/*                              记录会话                                       */
+/*============================================================================*/
+
+/**
+ * @brief 记录会话
+ */
+typedef struct {
+    FOC_LogWriter_t Log;
+    Timeline_t Tick;            // 节拍号展开 (实时数据与遥测共用, 按 24 位回绕, 接在日志已有记录之后)
+    Timeline_t VofaSeq;         // 实时数据帧序号 (24 位)
+    Timeline_t TelemSeq;        // 遥测帧序号 (16 位)
+    int Error;                  // 写入失败
+} Record_t;
+
+static volatile sig_atomic_t foclog_stop = 0;
+
+/**
+ * @brief  单调时钟 (s)
+ */
+static double Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief  Ctrl-C: 写出当前块后退出
+ */
+static void OnSignal(int sig)
+{
+    (void)sig;
+    foclog_stop = 1;
+}
+
+/**
+ * @brief  初始化记录会话
+ */
+static void Record_Init(Record_t *rec, uint32_t ctrl_hz)
+{
+    double period = 1.0 / (double)ctrl_hz;
+
+    rec->Error = 0;
+    Timeline_Init(&rec->Tick, period, 32, FOCLOG_STAMP_BITS);
+    Timeline_Init(&rec->VofaSeq, period, FOCLOG_STAMP_BITS, 32);
+    Timeline_Init(&rec->TelemSeq, period, 16, 32);
+}
+
+/**
+ * @brief  解帧回调: 展开节拍号, 统计丢帧, 写入日志
+ */
+static void Record_Frame(const FOC_StreamFrame_t *f, void *user)
+{
+    Record_t *rec = user;
+    int ret = 0;
+
+    switch (f->Kind) {
+        case FOC_STREAM_VOFA:
+            Timeline_Frame(&rec->VofaSeq, (uint32_t)f->Values[FOC_LINK_VOFA_CH + 1]);
+            Timeline_Record(&rec->Tick, (uint32_t)f->Values[FOC_LINK_VOFA_CH]);
+            ret = FOC_Log_Append(&rec->Log, FOC_LOG_VOFA, 0, (1u << FOC_LINK_VOFA_CH) - 1u,
+                                 rec->Log.BaseTick + (uint64_t)rec->Tick.Tick, f->Values, FOC_LINK_VOFA_CH * sizeof(float));
+            break;
+
+        case FOC_STREAM_SCOPE:
+            ret = FOC_Log_Append(&rec->Log, FOC_LOG_SCOPE, 0,
+                                 (f->Count >= 32) ? 0xFFFFFFFFu : (1u << f->Count) - 1u,
+                                 rec->Log.BaseTick + (uint64_t)rec->Tick.Tick, f->Values, f->Count * sizeof(float));
+            break;
+
+        case FOC_STREAM_PROTO:
+            if (f->Proto.Type == PROTO_MSG_TELEM && f->Proto.Len >= TELEM_FRAME_HEAD) {
+                Timeline_Frame(&rec->TelemSeq, Proto_GetU16(&f->Proto.Payload[1]));
+                Timeline_Record(&rec->Tick, Proto_GetU32(&f->Proto.Payload[3]));
+            }
+            ret = FOC_Log_Append(&rec->Log, FOC_LOG_PROTO, f->Proto.Type, 0,
+                                 rec->Log.BaseTick + (uint64_t)rec->Tick.Tick, f->Proto.Payload, f->Proto.Len);
+            break;
+    }
+    if (ret != 0) rec->Error = 1;
+}
+
+/**
+ * @brief  输出解帧与丢帧统计
+ */
+static void Record_Report(const Record_t *rec, const FOC_Stream_t *s)
+{
+    printf("bytes %llu skipped %llu resyncs %u | frames: vofa %u scope %u proto %u\n",
+           (unsigned long long)s->Bytes, (unsigned long long)s->SkippedBytes, s->Resyncs,
+           s->VofaFrames, s->ScopeFrames, s->ProtoFrames);
+    printf("vofa  lost %u (%.3f%%) dup %u\n", rec->VofaSeq.LostFrames,
+           100.0 * Timeline_LossRatio(&rec->VofaSeq), rec->VofaSeq.Duplicates);
+    printf("telem lost %u (%.3f%%) dup %u\n", rec->TelemSeq.LostFrames,
+           100.0 * Timeline_LossRatio(&rec->TelemSeq), rec->TelemSeq.Duplicates);
+    if (rec->Tick.Records > 1) {
+        printf("span %.3f s, record stride %u..%u ticks, resets %u\n",
+               (double)rec->Tick.Tick * rec->Tick.Period,
+               rec->Tick.MinStride, rec->Tick.MaxStride, rec->Tick.Resets);
+    }
+}
+
+/*============================================================================*/
+/*                              命令                                           */
+/*============================================================================*/
+
+/**
+ * @brief  记录数据流
+ */
+static int Cmd_Record(const char *in, const char *out, uint32_t ctrl_hz)
+{
+    static uint8_t buf[FOCLOG_READ_SIZE];
+    static FOC_Stream_t stream;
+    static Record_t rec;
+    int fd = (strcmp(in, "-") == 0) ? STDIN_FILENO : open(in, O_RDONLY | O_NOCTTY);
+
+    if (fd < 0) {
+        perror(in);
+        return 1;
+    }
+    if (isatty(fd)) {
+        /* CDC 虚拟串口: 原始模式, 波特率无意义 */
+        struct termios tio;
+        if (tcgetattr(fd, &tio) == 0) {
+            cfmakeraw(&tio);
+            tio.c_cc[VMIN] = 1;
+            tio.c_cc[VTIME] = 0;
+            tcsetattr(fd, TCSANOW, &tio);
+        }
+    }
+    if (FOC_Log_Open(&rec.Log, out, ctrl_hz) != 0) {
+        fprintf(stderr, "%s: cannot open log\n", out);
+        return 1;
+    }
+
+    FOC_Stream_Init(&stream);
+    Record_Init(&rec, rec.Log.CtrlHz);
+    signal(SIGINT, OnSignal);
+    signal(SIGTERM, OnSignal);
+
+    double last_flush = Now();
+    while (!foclog_stop && !rec.Error) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0) break;
+
+        FOC_Stream_Feed(&stream, buf, (uint64_t)n, Record_Frame, &rec);
+        if (Now() - last_flush >= FOCLOG_FLUSH_MS * 1e-3) {
+            if (FOC_Log_Flush(&rec.Log) != 0) rec.Error = 1;
+            last_flush = Now();
+        }
+    }
+
+    if (FOC_Log_Close(&rec.Log) != 0) rec.Error = 1;
+    if (fd != STDIN_FILENO) close(fd);
+
+    Record_Report(&rec, &stream);
+    printf("log: %llu rows, %u chunks, %llu bytes\n", (unsigned long long)rec.Log.TotalRows,
+           rec.Log.Chunks, (unsigned long long)rec.Log.Bytes);
+    if (rec.Error) fprintf(stderr, "%s: write error\n", out);
+    return rec.Error;
+}
+
+/**
+ * @brief  日志概要 (只读块头)
+ */
+static int Cmd_Info(const char *path)
+{
+    FOC_LogReader_t r;
+
+    if (FOC_Log_Map(&r, path, 1) != 0) {
+        fprintf(stderr, "%s: not a log file\n", path);
+        return 1;
+    }
+
+    double hz = r.Header->CtrlHz ? (double)r.Header->CtrlHz : FOCLOG_DEFAULT_HZ;
+    printf("version %u, ctrl %u Hz, %u chunks, %llu rows, %llu / %llu bytes valid\n",
+           r.Header->Version, r.Header->CtrlHz, r.ChunkCnt, (unsigned long long)r.Rows,
+           (unsigned long long)r.Size, (unsigned long long)r.MapSize);
+    if (r.ChunkCnt > 0) {
+        printf("time %.6f .. %.6f s\n", (double)r.Chunks[0]->FirstTick / hz,
+               (double)r.Chunks[r.ChunkCnt - 1]->LastTick / hz);
+    }
+    FOC_Log_Unmap(&r);
+    return 0;
+}
+
+/**
+ * @brief  按时间范围输出 CSV
+ */
+static int Cmd_Dump(const char *path, double t0, double t1)
+{
+    FOC_LogReader_t r;
+    FOC_LogCursor_t c;
+    const FOC_LogRow_t *row;
+    const void *data;
+
+    if (FOC_Log_Map(&r, path, 0) != 0) {
+        fprintf(stderr, "%s: not a log file\n", path);
+        return 1;
+    }
+
+    double hz = r.Header->CtrlHz ? (double)r.Header->CtrlHz : FOCLOG_DEFAULT_HZ;
+    if (FOC_Log_Seek(&r, (uint64_t)(t0 > 0 ? t0 * hz : 0), &c) == 0) {
+        while ((row = FOC_Log_Next(&r, &c, &data)) != NULL) {
+            double t = (double)row->Tick / hz;
+            if (t > t1) break;
+
+            printf("%.6f", t);
+            if (row->Kind == FOC_LOG_PROTO) {
+                printf(",proto,0x%02X,%u\n", row->Type, row->Len);
+                continue;
+            }
+            printf(row->Kind == FOC_LOG_VOFA ? ",vofa" : ",scope");
+            for (uint32_t i = 0; i < row->Len / sizeof(float); i++) {
+                printf(",%g", (double)((const float *)data)[i]);
+            }
+            printf("\n");
+        }
+    }
+    FOC_Log_Unmap(&r);
+    return 0;
+}
+
+/*============================================================================*/
+/*                              性能测试                                       */
+/*============================================================================*/
+
+/**
+ * @brief  合成数据流: 实时数据帧为主, 夹杂遥测帧/示波器帧与随机垃圾字节
+ * @param  frames: 输出生成的实时数据帧数
+ * @param  bursts: 输出插入的垃圾段数
+ * @return 流长度
+ */
+static uint64_t Bench_Generate(uint8_t *buf, uint64_t size, uint32_t *frames, uint32_t *bursts)
+{
+    static const uint8_t tail[4] = { 0x00, 0x00, 0x80, 0x7F };
+    uint64_t n = 0;
+    uint32_t tick = 0;
+    uint32_t seq = 0;
+    uint16_t telem_seq = 0;
+
+    *frames = 0;
+    *bursts = 0;
+    srand(1);
+
+    while (n + 256 < size) {
+        float v[FOC_LINK_VOFA_CH + 2];
+
+        tick += 1u + (uint32_t)(rand() % 3);
+        for (uint32_t c = 0; c < FOC_LINK_VOFA_CH; c++) v[c] = (float)(rand() % 20000) * 0.01f - 100.0f;
+        v[FOC_LINK_VOFA_CH] = (float)(tick & FOC_LINK_VOFA_STAMP_MASK);
+        v[FOC_LINK_VOFA_CH + 1] = (float)(seq++ & FOC_LINK_VOFA_STAMP_MASK);
+        memcpy(&buf[n], v, sizeof(v));
+        memcpy(&buf[n + sizeof(v)], tail, sizeof(tail));
+        n += sizeof(v) + sizeof(tail);
+        (*frames)++;
+
+        if (seq % 8 == 0) {
+            uint8_t payload[40] = { 0 };
+            Proto_PutU16(&payload[1], telem_seq);
+            Proto_PutU32(&payload[3], tick);
+            n += Proto_Encode(&buf[n], PROTO_MSG_TELEM, (uint8_t)telem_seq++, payload, sizeof(payload));
+        }
+        if (seq % 64 == 0) {
+            float s[5] = { 0.001f, 1.0f, 2.0f, 3.0f, 4.0f };
+            memcpy(&buf[n], s, sizeof(s));
+            memcpy(&buf[n + sizeof(s)], tail, sizeof(tail));
+            n += sizeof(s) + sizeof(tail);
+        }
+        if (seq % 1000 == 0) {
+            uint32_t len = 1u + (uint32_t)(rand() % 40);
+            for (uint32_t i = 0; i < len; i++) buf[n++] = (uint8_t)rand();
+            (*bursts)++;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief  计数回调
+ */
+static void Bench_Count(const FOC_StreamFrame_t *f, void *user)
+{
+    (*(uint64_t *)user) += f->Count;
+}
+
+/**
+ * @brief  解帧/写日志/定位性能
+ */
+static int Cmd_Bench(uint32_t mb)
+{
+    uint64_t size = (uint64_t)mb << 20;
+    uint8_t *buf = malloc(size);
+    static FOC_Stream_t stream;
+    static Record_t rec;
+    const char *path = "foclog_bench.foclog";
+    uint32_t frames, bursts;
+    uint64_t sum = 0;
+    double t;
+
+    if (buf == NULL) return 1;
+    uint64_t len = Bench_Generate(buf, size, &frames, &bursts);
+    double usb_fs = 1.216;                      // USB FS 批量传输理论上限 (MB/s)
+    printf("synthetic stream: %.1f MB, %u live frames, %u garbage bursts\n", len / 1048576.0, frames, bursts);
+
+    /* 整块解帧 */
+    FOC_Stream_Init(&stream);
+    t = Now();
+    FOC_Stream_Feed(&stream, buf, len, Bench_Count, &sum);
+    t = Now() - t;
+    printf("parse (one block)   : %7.1f MB/s (%.0fx USB FS) vofa %u scope %u proto %u resyncs %u\n",
+           len / 1048576.0 / t, len / 1e6 / t / usb_fs,
+           stream.VofaFrames, stream.ScopeFrames, stream.ProtoFrames, stream.Resyncs);
+
+    /* 按 USB 包长 64 字节输入 */
+    FOC_Stream_Init(&stream);
+    t = Now();
+    for (uint64_t i = 0; i < len; i += 64) {
+        FOC_Stream_Feed(&stream, &buf[i], (len - i < 64) ? len - i : 64, Bench_Count, &sum);
+    }
+    t = Now() - t;
+    printf("parse (64 B reads)  : %7.1f MB/s (%.0fx USB FS) vofa %u scope %u proto %u resyncs %u\n",
+           len / 1048576.0 / t, len / 1e6 / t / usb_fs,
+           stream.VofaFrames, stream.ScopeFrames, stream.ProtoFrames, stream.Resyncs);
+
+    /* 解帧 + 写日志 */
+    unlink(path);
+    if (FOC_Log_Open(&rec.Log, path, FOCLOG_DEFAULT_HZ) != 0) return 1;
+    FOC_Stream_Init(&stream);
+    Record_Init(&rec, FOCLOG_DEFAULT_HZ);
+    t = Now();
+    for (uint64_t i = 0; i < len; i += FOCLOG_READ_SIZE) {
+        uint64_t n = (len - i < FOCLOG_READ_SIZE) ? len - i : FOCLOG_READ_SIZE;
+        FOC_Stream_Feed(&stream, &buf[i], n, Record_Frame, &rec);
+    }
+    FOC_Log_Close(&rec.Log);
+    t = Now() - t;
+    printf("record (parse + log): %7.1f MB/s in, %.1f MB log\n", len / 1048576.0 / t, rec.Log.Bytes / 1048576.0);
+    Record_Report(&rec, &stream);
+
+    /* 映射 + 随机定位 */
+    FOC_LogReader_t r;
+    FOC_LogCursor_t c;
+    const void *data;
+    t = Now();
+    if (FOC_Log_Map(&r, path, 0) != 0) return 1;
+    double t_map = Now() - t;
+
+    uint64_t last = r.Chunks[r.ChunkCnt - 1]->LastTick;
+    uint32_t seeks = 100000, bad = 0;
+    t = Now();
+    for (uint32_t i = 0; i < seeks; i++) {
+        uint64_t want = ((uint64_t)rand() * (uint64_t)rand()) % (last + 1);
+        if (FOC_Log_Seek(&r, want, &c) != 0) { bad++; continue; }
+        const FOC_LogRow_t *row = FOC_Log_Next(&r, &c, &data);
+        if (row == NULL || row->Tick < want) bad++;
+    }
+    t = Now() - t;
+    printf("map %.2f ms (%u chunks, %llu rows), seek %.2f us avg, %u bad\n", t_map * 1e3, r.ChunkCnt,
+           (unsigned long long)r.Rows, t / seeks * 1e6, bad);
+
+    /* 全量顺序读 */
+    uint64_t rows = 0;
+    t = Now();
+    FOC_Log_Seek(&r, 0, &c);
+    while (FOC_Log_Next(&r, &c, &data) != NULL) rows++;
+    t = Now() - t;
+    printf("scan %llu rows in %.1f ms\n", (unsigned long long)rows, t * 1e3);
+
+    FOC_Log_Unmap(&r);
+    unlink(path);
+    free(buf);
+    return bad ? 1 : 0;
+}
+
+/*============================================================================*/
+/*                              入口                                           */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    if (argc >= 4 && strcmp(argv[1], "record") == 0) {
+        return Cmd_Record(argv[2], argv[3], (argc >= 5) ? (uint32_t)atoi(argv[4]) : FOCLOG_DEFAULT_HZ);
+    }
+    if (argc >= 3 && strcmp(argv[1], "info") == 0) {
+        return Cmd_Info(argv[2]);
+    }
+    if (argc >= 3 && strcmp(argv[1], "dump") == 0) {
+        return Cmd_Dump(argv[2], (argc >= 4) ? atof(argv[3]) : 0.0, (argc >= 5) ? atof(argv[4]) : 1e30);
+    }
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        return Cmd_Bench((argc >= 3) ? (uint32_t)atoi(argv[2]) : 256);
+    }
+
+    fprintf(stderr,
+            "usage: foclog record <dev|file|-> <log> [ctrl_hz]\n"
+            "       foclog info <log>\n"
+            "       foclog dump <log> [t0_s] [t1_s]\n"
+            "       foclog bench [MB]\n");
+    return 2;
+}
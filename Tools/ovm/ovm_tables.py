@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""
+生成 USER/svpwm.c 中两区过调制 (SVPWM_OVM_TWO_ZONE) 查表:
+  ovm_zone1_radius: 调制比 [M_LINEAR, M_ZONE2] -> 参考圆半径 / Udc
+  ovm_zone2_hold:   调制比 [M_ZONE2, 1]        -> 顶点保持角 (rad)
+
+调制比 m = 基波幅值 / (2 Udc / pi)。轨迹在一个 60 度扇区内按角度数值积分求基波,
+再按 m 等间距二分反解。
+用法: python3 Tools/ovm/ovm_tables.py                 打印 C 初始化代码
+      python3 Tools/ovm/ovm_tables.py --check svpwm.c  与源文件中的表比较 (误差 > 2e-6 返回 1)
+"""
+
+import math
+import re
+import sys
+
+SQRT3 = math.sqrt(3.0)
+SIX_STEP = 2.0 / math.pi            # 六步方波基波幅值 / Udc
+PI_BY_3 = math.pi / 3.0
+TABLE_SIZE = 33                     # 与 OVM_TABLE_SIZE 一致
+STEPS = 6000                        # 扇区内积分点数
+
+GRID = [(i + 0.5) / STEPS * PI_BY_3 for i in range(STEPS)]
+
+
+def hexagon_radius(gamma):
+    """扇区内角度 gamma 处六边形边界半径 / Udc"""
+    return (1.0 / SQRT3) / math.cos(gamma - math.pi / 6.0)
+
+
+def zone1_fundamental(radius):
+    """区I: 轨迹 = min(参考圆, 六边形), 返回调制比"""
+    return sum(min(radius, hexagon_radius(g)) for g in GRID) / STEPS / SIX_STEP
+
+
+def zone2_fundamental(hold):
+    """区II: 顶点保持角 hold, 其余角度线性拉伸到六边形上, 返回调制比"""
+    acc = 0.0
+    for g in GRID:
+        if g < hold:
+            gp = 0.0
+        elif g > PI_BY_3 - hold:
+            gp = PI_BY_3
+        else:
+            gp = (g - hold) / (PI_BY_3 - 2.0 * hold) * PI_BY_3
+        acc += hexagon_radius(gp) * math.cos(gp - g)
+    return acc / STEPS / SIX_STEP
+
+
+def bisect(f, lo, hi, target):
+    for _ in range(60):
+        mid = 0.5 * (lo + hi)
+        if f(mid) < target:
+            lo = mid
+        else:
+            hi = mid
+    return 0.5 * (lo + hi)
+
+
+def emit(name, values):
+    print("static const float %s[OVM_TABLE_SIZE] = {" % name)
+    for i in range(0, len(values), 6):
+        row = ", ".join("%.6ff" % v for v in values[i:i + 6])
+        print("    " + row + ("," if i + 6 < len(values) else ""))
+    print("};")
+
+
+def generate():
+    m_linear = math.pi / (2.0 * SQRT3)
+    m_zone2 = zone1_fundamental(2.0 / 3.0)      # 参考圆外接六边形: 轨迹恰为六边形
+
+    m1 = [m_linear + (m_zone2 - m_linear) * i / (TABLE_SIZE - 1) for i in range(TABLE_SIZE)]
+    radius = [1.0 / SQRT3] + [bisect(zone1_fundamental, 1.0 / SQRT3, 2.0 / 3.0, m)
+                              for m in m1[1:-1]] + [2.0 / 3.0]
+
+    m2 = [m_zone2 + (1.0 - m_zone2) * i / (TABLE_SIZE - 1) for i in range(TABLE_SIZE)]
+    hold = [0.0] + [bisect(zone2_fundamental, 0.0, math.pi / 6.0 - 1e-9, m)
+                    for m in m2[1:-1]] + [math.pi / 6.0]
+
+    return m_linear, m_zone2, {"ovm_zone1_radius": radius, "ovm_zone2_hold": hold}
+
+
+def check(path):
+    src = open(path, encoding="utf-8", errors="replace").read()
+    _, _, tables = generate()
+    ok = True
+    for name, values in tables.items():
+        body = re.search(name + r"\[OVM_TABLE_SIZE\]\s*=\s*\{([^}]*)\}", src)
+        if body is None:
+            print("%s: table %s not found" % (path, name))
+            return 1
+        found = [float(v.rstrip("f")) for v in re.findall(r"-?[0-9.]+f", body.group(1))]
+        err = max(abs(a - b) for a, b in zip(found, values)) if len(found) == len(values) else float("inf")
+        print("%s: %d entries, max deviation %.1e" % (name, len(found), err))
+        ok = ok and err <= 2e-6
+    return 0 if ok else 1
+
+
+def main():
+    if len(sys.argv) > 2 and sys.argv[1] == "--check":
+        return check(sys.argv[2])
+
+    m_linear, m_zone2, tables = generate()
+    print("/* SVPWM_M_LINEAR = %.7f, SVPWM_M_ZONE2 = %.7f */" % (m_linear, m_zone2))
+    emit("ovm_zone1_radius", tables["ovm_zone1_radius"])
+    print()
+    emit("ovm_zone2_hold", tables["ovm_zone2_hold"])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
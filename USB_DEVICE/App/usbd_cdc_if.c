@@ -155,6 +155,7 @@ static int8_t CDC_Init_FS(void)
   /* Set Application Buffers */
   USBD_CDC_SetTxBuffer(&hUsbDeviceFS, UserTxBufferFS, 0);
   USBD_CDC_SetRxBuffer(&hUsbDeviceFS, UserRxBufferFS);
+  VCP_Reset();
   return (USBD_OK);
   /* USER CODE END 3 */
 }
@@ -166,6 +167,7 @@ static int8_t CDC_Init_FS(void)
 static int8_t CDC_DeInit_FS(void)
 {
   /* USER CODE BEGIN 4 */
+  VCP_Reset();
   return (USBD_OK);
   /* USER CODE END 4 */
 }
@@ -262,10 +264,9 @@ static int8_t CDC_Receive_FS(uint8_t* Buf, uint32_t *Len)
 {
   /* USER CODE BEGIN 6 */
 	// ָ������д������
-	VCP_SendData(Buf, *Len); // ����
 	
-  USBD_CDC_SetRxBuffer(&hUsbDeviceFS, &Buf[0]);
-  USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+  /* 主循环原地解析后由 VCP_RxRelease 重新使能接收 */
+  VCP_RxCallback(Buf, *Len);
   return (USBD_OK);
   /* USER CODE END 6 */
 }
@@ -314,6 +315,7 @@ static int8_t CDC_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
   UNUSED(Buf);
   UNUSED(Len);
   UNUSED(epnum);
+  VCP_TxCpltCallback();
   /* USER CODE END 13 */
   return result;
 }
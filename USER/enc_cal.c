@@ -0,0 +1,229 @@
+/**
+ * @file    enc_cal.c
+ * @brief   编码器零点 / 方向 / 极对数自动校准实现
+ * @note    纯算法实现，无硬件依赖，可移植
+ */
+
+#include "enc_cal.h"
+#include "foc_math.h"
+#include <math.h>
+
+/*============================================================================*/
+/*                              常量定义                                       */
+/*============================================================================*/
+
+#define CAL_2PI                 6.2831853f
+#define CAL_SWEEP_RAD           (CAL_2PI * ENC_CAL_SWEEP_TURNS)
+
+/* 阶段 */
+enum {
+    CAL_PHASE_RAMP = 0,
+    CAL_PHASE_HOLD,
+    CAL_PHASE_FWD,              // 正扫 (测量方向与极对数)
+    CAL_PHASE_TURN,
+    CAL_PHASE_BACK,             // 反扫 (累加零点样本)
+    CAL_PHASE_TURN2,
+    CAL_PHASE_FWD2,             // 第二次正扫 (累加零点样本)
+};
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  阶段时长 (周期数)
+ */
+static uint32_t Cal_PhaseTicks(const EncCal_t *cal, uint8_t phase)
+{
+    static const float seconds[] = {
+        ENC_CAL_RAMP_S, ENC_CAL_HOLD_S, ENC_CAL_SWEEP_S, ENC_CAL_TURN_S, ENC_CAL_SWEEP_S,
+        ENC_CAL_TURN_S, ENC_CAL_SWEEP_S,
+    };
+    return (uint32_t)(seconds[phase] / cal->Dt + 0.5f);
+}
+
+/**
+ * @brief  累加一个样本: 已测得方向与极对数下的 (Pp·θm - θe)
+ * @note   Pp·raw 取模在整数域完成, 保持精度
+ */
+static void Cal_Accumulate(EncCal_t *cal, uint16_t raw)
+{
+    uint32_t mask = (uint32_t)cal->Cpr - 1u;
+    uint32_t mech = (cal->Direction > 0) ? (uint32_t)raw : (uint32_t)(cal->Cpr - raw);
+    uint32_t elec = (mech * cal->PolePairsMeas) & mask;
+    SinCos_t sc;
+
+    FOC_SinCos((float)elec * (CAL_2PI / (float)cal->Cpr) - cal->ThetaPrev, &sc);
+    cal->SumCos += sc.Cos;
+    cal->SumSin += sc.Sin;
+    cal->Samples++;
+}
+
+/**
+ * @brief  由正扫行程测得方向与极对数
+ */
+static EncCal_Status_t Cal_Measure(EncCal_t *cal)
+{
+    int32_t sweep = (int32_t)cal->Cpr * ENC_CAL_SWEEP_TURNS;
+    int32_t travel = cal->TravelFwd;
+    int32_t travel_abs = (travel < 0) ? -travel : travel;
+
+    /* 转过不足最大极对数对应行程的 1/4 视为未转动 */
+    if (travel_abs * 4 * ENC_CAL_MAX_POLE_PAIRS < sweep) {
+        return ENC_CAL_ERR_NO_MOTION;
+    }
+
+    cal->Direction = (travel > 0) ? 1 : -1;
+    int32_t pp = (sweep + travel_abs / 2) / travel_abs;
+
+    /* 行程须接近整数极对数 (偏差不超过 1/4 极对) */
+    int32_t frac = sweep - pp * travel_abs;
+    if (frac < 0) frac = -frac;
+    if (pp < 1 || pp > ENC_CAL_MAX_POLE_PAIRS || frac * 4 > travel_abs) {
+        return ENC_CAL_ERR_POLE_PAIRS;
+    }
+    cal->PolePairsMeas = (uint8_t)pp;
+    return ENC_CAL_BUSY;
+}
+
+/**
+ * @brief  由扫描数据计算结果
+ */
+static EncCal_Status_t Cal_Finish(EncCal_t *cal)
+{
+    int32_t travel = cal->TravelFwd;
+    int32_t travel_abs = (travel < 0) ? -travel : travel;
+
+    /* 反扫应回到起点 (允许 1/4 扫描行程的偏差) */
+    int32_t residue = travel + cal->TravelBack;
+    if (residue < 0) residue = -residue;
+    if (residue * 4 > travel_abs) {
+        return ENC_CAL_ERR_SLIP;
+    }
+
+    float n = (float)cal->Samples;
+    cal->Quality = sqrtf(cal->SumCos * cal->SumCos + cal->SumSin * cal->SumSin) / n;
+    if (cal->Quality < ENC_CAL_MIN_QUALITY) {
+        return ENC_CAL_ERR_SLIP;
+    }
+
+    /* θe = (θm - offset)·Pp  →  offset = mean(Pp·θm - θe) / Pp, 归一化到 [0, 2π) */
+    float offset = atan2f(cal->SumSin, cal->SumCos) / (float)cal->PolePairsMeas;
+    if (offset < 0.0f) offset += CAL_2PI;
+    cal->Offset = offset;
+
+    return ENC_CAL_DONE;
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化校准器
+ */
+void EncCal_Init(EncCal_t *cal, uint16_t cpr, float dt, float voltage)
+{
+    cal->Voltage = voltage;
+    cal->Dt = dt;
+    cal->Cpr = cpr;
+
+    cal->Status = ENC_CAL_IDLE;
+    cal->Direction = 1;
+    cal->PolePairsMeas = 0;
+    cal->Offset = 0.0f;
+    cal->Quality = 0.0f;
+}
+
+/**
+ * @brief  开始校准
+ */
+void EncCal_Start(EncCal_t *cal, uint16_t raw)
+{
+    cal->Phase = CAL_PHASE_RAMP;
+    cal->Tick = 0;
+    cal->Theta = 0.0f;
+    cal->ThetaPrev = 0.0f;
+    cal->LastRaw = raw;
+    cal->TravelFwd = 0;
+    cal->TravelBack = 0;
+    cal->SumCos = 0.0f;
+    cal->SumSin = 0.0f;
+    cal->Samples = 0;
+
+    cal->PolePairsMeas = 0;
+    cal->Quality = 0.0f;
+    cal->Status = ENC_CAL_BUSY;
+}
+
+/**
+ * @brief  校准单步
+ */
+EncCal_Status_t EncCal_Step(EncCal_t *cal, uint16_t raw, float *theta, float *vd)
+{
+    *theta = 0.0f;
+    *vd = 0.0f;
+    if (cal->Status != ENC_CAL_BUSY) return (EncCal_Status_t)cal->Status;
+
+    /* 计数增量 (跨零点按最短路径) */
+    int32_t delta = (int32_t)((uint32_t)(raw - cal->LastRaw) & ((uint32_t)cal->Cpr - 1u));
+    if (delta >= (int32_t)(cal->Cpr / 2)) delta -= cal->Cpr;
+    cal->LastRaw = raw;
+
+    /* 本次读数对应上一周期输出的角度 */
+    cal->ThetaPrev = cal->Theta;
+
+    uint32_t len = Cal_PhaseTicks(cal, cal->Phase);
+    float t = (float)cal->Tick / (float)len;
+    float v = cal->Voltage;
+
+    switch (cal->Phase) {
+        case CAL_PHASE_RAMP:
+            v = cal->Voltage * t;
+            cal->Theta = 0.0f;
+            break;
+        case CAL_PHASE_HOLD:
+            cal->Theta = 0.0f;
+            break;
+        case CAL_PHASE_FWD:
+            cal->TravelFwd += delta;
+            cal->Theta = CAL_SWEEP_RAD * t;
+            break;
+        case CAL_PHASE_TURN:
+            cal->Theta = CAL_SWEEP_RAD;
+            cal->TravelFwd += delta;        // 转子在停顿中追上指令角度, 计入正扫行程
+            break;
+        case CAL_PHASE_BACK:
+            cal->TravelBack += delta;
+            Cal_Accumulate(cal, raw);
+            cal->Theta = CAL_SWEEP_RAD * (1.0f - t);
+            break;
+        case CAL_PHASE_TURN2:
+            cal->Theta = 0.0f;
+            cal->TravelBack += delta;
+            break;
+        default:
+            Cal_Accumulate(cal, raw);
+            cal->Theta = CAL_SWEEP_RAD * t;
+            break;
+    }
+
+    if (++cal->Tick >= len) {
+        cal->Tick = 0;
+        EncCal_Status_t status = ENC_CAL_BUSY;
+        if (cal->Phase == CAL_PHASE_TURN) {
+            status = Cal_Measure(cal);
+        } else if (cal->Phase == CAL_PHASE_FWD2) {
+            status = Cal_Finish(cal);
+        }
+        if (status != ENC_CAL_BUSY) {
+            cal->Status = (uint8_t)status;
+            return status;
+        }
+        cal->Phase++;
+    }
+
+    *theta = cal->Theta;
+    *vd = v;
+    return ENC_CAL_BUSY;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file    enc_cal.h
+ * @brief   编码器零点 / 方向 / 极对数自动校准
+ * @note    纯算法实现，无硬件依赖，可移植
+ *          每个控制周期调用一次 EncCal_Step, 输入编码器原始计数, 输出开环注入的
+ *          d轴电压矢量 (幅值 + 电角度), 不阻塞中断:
+ *            1. 对准: 电角度 0 处电压斜坡升至设定值并保持, 转子 d 轴对准 α 轴
+ *            2. 正扫: 电角度匀速增加 ENC_CAL_SWEEP_TURNS 电周期, 停顿后测得方向与极对数
+ *            3. 反扫回 0, 停顿后再正扫一次, 两次扫描中累加零点样本
+ *          方向 = 正扫时编码器计数变化的符号
+ *          极对数 = 正扫电角度 / 编码器转过的机械角度 (四舍五入), 不依赖配置值;
+ *                 结果写入 EncoderData_t.PolePairs, 解码与外推均使用运行时的值
+ *          零点 = 反扫与第二次正扫中 (Pp·θm - θe) 的圆周平均 / Pp,
+ *                 负载角引起的滞后在正反扫中符号相反, 平均后抵消
+ *          编码器计数须为 2 的幂
+ */
+
+#ifndef __ENC_CAL_H
+#define __ENC_CAL_H
+
+#include <stdint.h>
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#define ENC_CAL_RAMP_S          0.10f       // 对准电压斜坡时间 (s)
+#define ENC_CAL_HOLD_S          0.15f       // 对准保持时间 (s)
+#define ENC_CAL_SWEEP_S         0.50f       // 单向扫描时间 (s)
+#define ENC_CAL_TURN_S          0.05f       // 正反扫之间停顿 (s)
+#define ENC_CAL_SWEEP_TURNS     2           // 单向扫描电周期数
+#define ENC_CAL_MIN_QUALITY     0.7f        // 圆周平均向量长度下限 (转子未跟随时偏低)
+#define ENC_CAL_MAX_POLE_PAIRS  32          // 可识别的最大极对数
+
+/* 校准状态 (Status) */
+typedef enum {
+    ENC_CAL_IDLE = 0,           // 未校准
+    ENC_CAL_BUSY,               // 校准中
+    ENC_CAL_DONE,               // 完成, 结果有效
+    ENC_CAL_ERR_NO_MOTION,      // 转子未转动 (电压过低或被卡住)
+    ENC_CAL_ERR_POLE_PAIRS,     // 正扫行程不对应整数极对数, 或超出 1 ~ ENC_CAL_MAX_POLE_PAIRS
+    ENC_CAL_ERR_SLIP,           // 转子未跟随 (反扫未回到起点或读数离散)
+} EncCal_Status_t;
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 编码器校准器
+ */
+typedef struct {
+    /* 配置 */
+    float Voltage;              // 注入电压幅值 (V)
+    float Dt;                   // 调用周期 (s)
+    uint16_t Cpr;               // 编码器每转计数 (2 的幂)
+
+    /* 过程 */
+    uint8_t Status;             // EncCal_Status_t
+    uint8_t Phase;              // 当前阶段
+    uint32_t Tick;              // 阶段内周期计数
+    float Theta;                // 本周期输出电角度 (rad)
+    float ThetaPrev;            // 上周期输出电角度 (与本周期读数对应)
+    uint16_t LastRaw;           // 上次编码器读数
+    int32_t TravelFwd;          // 正扫累计计数
+    int32_t TravelBack;         // 反扫累计计数
+    float SumCos;               // 圆周平均累加
+    float SumSin;
+    uint32_t Samples;           // 累加样本数
+
+    /* 结果 */
+    int8_t Direction;           // 编码器方向 (+1 / -1)
+    uint8_t PolePairsMeas;      // 测得极对数
+    float Offset;               // 零点偏移 (rad, 机械角)
+    float Quality;              // 圆周平均向量长度 (0~1)
+} EncCal_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化校准器
+ * @param  cal: 校准器指针
+ * @param  cpr: 编码器每转计数 (2 的幂)
+ * @param  dt: EncCal_Step 调用周期 (s)
+ * @param  voltage: 注入电压幅值 (V)
+ */
+void EncCal_Init(EncCal_t *cal, uint16_t cpr, float dt, float voltage);
+
+/**
+ * @brief  开始校准 (清除上次结果)
+ * @param  cal: 校准器指针
+ * @param  raw: 当前编码器读数
+ */
+void EncCal_Start(EncCal_t *cal, uint16_t raw);
+
+/**
+ * @brief  校准单步 (每个控制周期调用)
+ * @param  cal: 校准器指针
+ * @param  raw: 编码器读数 (上一周期锁存)
+ * @param  theta: 输出注入电角度 (rad)
+ * @param  vd: 输出注入 d轴电压 (V)
+ * @return ENC_CAL_BUSY=继续注入, 其他=已结束 (输出电压为 0)
+ */
+EncCal_Status_t EncCal_Step(EncCal_t *cal, uint16_t raw, float *theta, float *vd);
+
+#endif /* __ENC_CAL_H */
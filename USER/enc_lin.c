@@ -0,0 +1,209 @@
+/**
+ * @file    enc_lin.c
+ * @brief   编码器非线性补偿实现
+ * @note    纯算法实现，无硬件依赖，可移植
+ */
+
+#include "enc_lin.h"
+#include <math.h>
+
+/*============================================================================*/
+/*                              常量定义                                       */
+/*============================================================================*/
+
+#define LIN_2PI                 6.2831853f
+#define LIN_PI                  3.1415926f
+#define LIN_CPR                 (1u << ENC_LIN_RAW_BITS)
+#define LIN_CNT_TO_RAD          (LIN_2PI / (float)LIN_CPR)
+#define LIN_RAD_TO_CNT          ((float)LIN_CPR / LIN_2PI)
+#define LIN_SPAN_CNT            ((int32_t)LIN_CPR + 2 * (int32_t)LIN_CPR / ENC_LIN_LEAD_DIV)   // 单向扫描行程 (计数)
+#define LIN_LEAD_T              (1.0f / (float)(ENC_LIN_LEAD_DIV + 2))     // 过渡段占扫描时间比例
+
+/* 阶段 */
+enum {
+    LIN_PHASE_RAMP = 0,
+    LIN_PHASE_HOLD,
+    LIN_PHASE_FWD,
+    LIN_PHASE_TURN,
+    LIN_PHASE_BACK,
+};
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  阶段时长 (周期数)
+ */
+static uint32_t Lin_PhaseTicks(const EncLin_t *lin, uint8_t phase)
+{
+    static const float seconds[] = {
+        ENC_LIN_RAMP_S, ENC_LIN_HOLD_S, ENC_LIN_SWEEP_S, ENC_LIN_TURN_S, ENC_LIN_SWEEP_S,
+    };
+    return (uint32_t)(seconds[phase] / lin->Dt + 0.5f);
+}
+
+/**
+ * @brief  累加一个样本: 读数 - 指令角度, 按读数所在分段累加 (计数, 原始读数方向)
+ */
+static void Lin_Accumulate(EncLin_t *lin, uint16_t raw)
+{
+    float x = (float)lin->Direction * (float)raw * LIN_CNT_TO_RAD
+              - lin->ThetaPrev / (float)lin->PolePairs;
+
+    if (!lin->HasRef) {
+        lin->Ref = x;
+        lin->HasRef = 1;
+    }
+
+    float err = x - lin->Ref;
+    err -= LIN_2PI * floorf((err + LIN_PI) * (1.0f / LIN_2PI));
+
+    uint32_t seg = (uint32_t)raw >> ENC_LIN_SHIFT;
+    lin->Sum[seg] += (float)lin->Direction * err * LIN_RAD_TO_CNT;
+    lin->Cnt[seg]++;
+}
+
+/**
+ * @brief  由扫描数据生成补偿表
+ */
+static EncLin_Status_t Lin_Finish(EncLin_t *lin)
+{
+    float err[ENC_LIN_SIZE];
+    float mean = 0.0f;
+    float peak = 0.0f;
+
+    /* 正扫行程应与指令一致, 反扫应回到起点 (各允许 1/4 圈偏差) */
+    int32_t travel = lin->TravelFwd * lin->Direction;
+    int32_t residue = lin->TravelFwd + lin->TravelBack;
+    if (residue < 0) residue = -residue;
+    if ((travel - LIN_SPAN_CNT) * 4 < -(int32_t)LIN_CPR) return ENC_LIN_ERR_NO_MOTION;
+    if ((travel - LIN_SPAN_CNT) * 4 > (int32_t)LIN_CPR || residue * 4 > (int32_t)LIN_CPR) return ENC_LIN_ERR_SLIP;
+
+    for (uint32_t i = 0; i < ENC_LIN_SIZE; i++) {
+        if (lin->Cnt[i] == 0) return ENC_LIN_ERR_NO_MOTION;
+        err[i] = lin->Sum[i] / (float)lin->Cnt[i];
+        mean += err[i];
+    }
+    mean /= (float)ENC_LIN_SIZE;
+
+    for (uint32_t i = 0; i < ENC_LIN_SIZE; i++) {
+        err[i] -= mean;
+        if (fabsf(err[i]) > peak) peak = fabsf(err[i]);
+    }
+    if (peak > (float)ENC_LIN_MAX_CORR) return ENC_LIN_ERR_SLIP;
+
+    /* 分段平均值对应段中点, 段起点取相邻两段的平均; 修正量 = -误差 */
+    for (uint32_t i = 0; i < ENC_LIN_SIZE; i++) {
+        float e = 0.5f * (err[(i - 1u) & (ENC_LIN_SIZE - 1u)] + err[i]);
+        lin->Table[i] = (int16_t)lrintf(-e * (float)(1 << ENC_LIN_Q));
+    }
+    lin->Table[ENC_LIN_SIZE] = lin->Table[0];
+    lin->Peak = peak * LIN_CNT_TO_RAD;
+    lin->Valid = 1;
+
+    return ENC_LIN_DONE;
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化
+ */
+void EncLin_Init(EncLin_t *lin, uint8_t pole_pairs, float dt)
+{
+    for (uint32_t i = 0; i <= ENC_LIN_SIZE; i++) {
+        lin->Table[i] = 0;
+    }
+    lin->Valid = 0;
+    lin->Peak = 0.0f;
+
+    lin->Dt = dt;
+    lin->PolePairs = pole_pairs;
+    lin->Status = ENC_LIN_IDLE;
+}
+
+/**
+ * @brief  开始标定
+ */
+void EncLin_Start(EncLin_t *lin, uint16_t raw, int8_t direction, float voltage)
+{
+    lin->Phase = LIN_PHASE_RAMP;
+    lin->Direction = (direction < 0) ? -1 : 1;
+    lin->Voltage = voltage;
+    lin->Tick = 0;
+    lin->Theta = 0.0f;
+    lin->ThetaPrev = 0.0f;
+    lin->LastRaw = raw;
+    lin->TravelFwd = 0;
+    lin->TravelBack = 0;
+    lin->HasRef = 0;
+    for (uint32_t i = 0; i < ENC_LIN_SIZE; i++) {
+        lin->Sum[i] = 0.0f;
+        lin->Cnt[i] = 0;
+    }
+    lin->Status = ENC_LIN_BUSY;
+}
+
+/**
+ * @brief  标定单步
+ */
+EncLin_Status_t EncLin_Step(EncLin_t *lin, uint16_t raw, float *theta, float *vd)
+{
+    *theta = 0.0f;
+    *vd = 0.0f;
+    if (lin->Status != ENC_LIN_BUSY) return (EncLin_Status_t)lin->Status;
+
+    /* 计数增量 (跨零点按最短路径) */
+    int32_t delta = (int32_t)((uint32_t)(raw - lin->LastRaw) & (LIN_CPR - 1u));
+    if (delta >= (int32_t)(LIN_CPR / 2)) delta -= LIN_CPR;
+    lin->LastRaw = raw;
+
+    /* 本次读数对应上一周期输出的角度 */
+    lin->ThetaPrev = lin->Theta;
+
+    uint32_t len = Lin_PhaseTicks(lin, lin->Phase);
+    float t = (float)lin->Tick / (float)len;
+    float sweep = LIN_2PI * (float)lin->PolePairs * (float)LIN_SPAN_CNT / (float)LIN_CPR;
+    float v = lin->Voltage;
+    uint8_t steady = (t >= LIN_LEAD_T && t < 1.0f - LIN_LEAD_T);
+
+    switch (lin->Phase) {
+        case LIN_PHASE_RAMP:
+            v = lin->Voltage * t;
+            lin->Theta = 0.0f;
+            break;
+        case LIN_PHASE_HOLD:
+            lin->Theta = 0.0f;
+            break;
+        case LIN_PHASE_FWD:
+            lin->TravelFwd += delta;
+            if (steady) Lin_Accumulate(lin, raw);
+            lin->Theta = sweep * t;
+            break;
+        case LIN_PHASE_TURN:
+            lin->Theta = sweep;
+            lin->TravelFwd += delta;        // 转子在停顿中追上指令角度, 计入正扫行程
+            break;
+        default:
+            lin->TravelBack += delta;
+            if (steady) Lin_Accumulate(lin, raw);
+            lin->Theta = sweep * (1.0f - t);
+            break;
+    }
+
+    if (++lin->Tick >= len) {
+        lin->Tick = 0;
+        if (lin->Phase == LIN_PHASE_BACK) {
+            lin->Status = (uint8_t)Lin_Finish(lin);
+            return (EncLin_Status_t)lin->Status;
+        }
+        lin->Phase++;
+    }
+
+    *theta = lin->Theta;
+    *vd = v;
+    return ENC_LIN_BUSY;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file    enc_lin.h
+ * @brief   编码器非线性补偿 (磁铁偏心等周期性角度误差)
+ * @note    纯算法实现，无硬件依赖，可移植
+ *          补偿表: 按 14-bit 原始读数高 ENC_LIN_BITS 位分段, 每段起点存修正量 (计数, Q4),
+ *                  段内整数线性插值, 编码器回调中每次读数 O(1), 无浮点运算
+ *          标定: 开环注入 d轴电压矢量 (同 enc_cal), 电角度匀速正转 (1 + 2/ENC_LIN_LEAD_DIV) 圈
+ *                机械角再反转回来, 转子以恒定速度跟随指令角度, 读数与指令角度之差即为
+ *                角度误差 (含恒定的零点与负载角); 两端各 1/ENC_LIN_LEAD_DIV 圈为加减速过渡,
+ *                只取中间一整圈, 按读数分段平均后去掉均值得到修正量;
+ *                正反两次扫描的负载角符号相反, 平均后抵消
+ *          标定前须已完成方向校准 (enc_cal), 标定后建议重新校准零点
+ */
+
+#ifndef __ENC_LIN_H
+#define __ENC_LIN_H
+
+#include <stdint.h>
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#define ENC_LIN_RAW_BITS        14          // 编码器原始读数位数
+#define ENC_LIN_BITS            7           // 补偿表分段数 = 2^ENC_LIN_BITS
+#define ENC_LIN_SIZE            (1u << ENC_LIN_BITS)
+#define ENC_LIN_SHIFT           (ENC_LIN_RAW_BITS - ENC_LIN_BITS)
+#define ENC_LIN_Q               4           // 修正量小数位数
+
+#define ENC_LIN_RAMP_S          0.10f       // 对准电压斜坡时间 (s)
+#define ENC_LIN_HOLD_S          0.15f       // 对准保持时间 (s)
+#define ENC_LIN_SWEEP_S         1.25f       // 单向扫描时间 (s)
+#define ENC_LIN_LEAD_DIV        8           // 扫描两端过渡段 = 1/ENC_LIN_LEAD_DIV 圈
+#define ENC_LIN_TURN_S          0.05f       // 正反扫之间停顿 (s)
+#define ENC_LIN_MAX_CORR        (1u << (ENC_LIN_RAW_BITS - 5))  // 修正量上限 (计数, 1/32 圈)
+
+/* 标定状态 (Status) */
+typedef enum {
+    ENC_LIN_IDLE = 0,           // 未标定
+    ENC_LIN_BUSY,               // 标定中
+    ENC_LIN_DONE,               // 完成, 补偿表已更新
+    ENC_LIN_ERR_NO_MOTION,      // 转子未转满一圈 (行程不足或有分段无样本)
+    ENC_LIN_ERR_SLIP,           // 转子未跟随 (反扫未回到起点或误差过大)
+} EncLin_Status_t;
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 编码器非线性补偿
+ */
+typedef struct {
+    /* 补偿表 (标定成功或从参数存储加载后有效) */
+    int16_t Table[ENC_LIN_SIZE + 1];    // 各分段起点修正量 (计数, Q4), 末项 = 首项
+    uint8_t Valid;              // 1=补偿表有效
+    float Peak;                 // 最大修正量 (rad, 机械角)
+
+    /* 配置 */
+    float Dt;                   // 调用周期 (s)
+    uint8_t PolePairs;          // 极对数
+
+    /* 标定过程 */
+    uint8_t Status;             // EncLin_Status_t
+    uint8_t Phase;              // 当前阶段
+    int8_t Direction;           // 编码器方向 (+1 / -1)
+    float Voltage;              // 注入电压幅值 (V)
+    uint32_t Tick;              // 阶段内周期计数
+    float Theta;                // 本周期输出电角度 (rad)
+    float ThetaPrev;            // 上周期输出电角度 (与本周期读数对应)
+    uint16_t LastRaw;           // 上次编码器读数
+    int32_t TravelFwd;          // 正扫累计计数
+    int32_t TravelBack;         // 反扫累计计数
+    float Ref;                  // 首个样本的 (θm - θe/Pp), 误差以此为基准
+    uint8_t HasRef;             // 1=Ref 有效
+    float Sum[ENC_LIN_SIZE];    // 各分段误差累加 (计数)
+    uint16_t Cnt[ENC_LIN_SIZE]; // 各分段样本数
+} EncLin_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化 (补偿表清零并置为无效)
+ * @param  lin: 补偿对象指针
+ * @param  pole_pairs: 极对数
+ * @param  dt: EncLin_Step 调用周期 (s)
+ */
+void EncLin_Init(EncLin_t *lin, uint8_t pole_pairs, float dt);
+
+/**
+ * @brief  开始标定 (补偿表保持不变, 成功后才覆盖)
+ * @param  lin: 补偿对象指针
+ * @param  raw: 当前编码器原始读数 (未补偿)
+ * @param  direction: 编码器方向 (+1 / -1)
+ * @param  voltage: 注入电压幅值 (V)
+ */
+void EncLin_Start(EncLin_t *lin, uint16_t raw, int8_t direction, float voltage);
+
+/**
+ * @brief  标定单步 (每个控制周期调用)
+ * @param  lin: 补偿对象指针
+ * @param  raw: 编码器原始读数 (未补偿, 上一周期锁存)
+ * @param  theta: 输出注入电角度 (rad)
+ * @param  vd: 输出注入 d轴电压 (V)
+ * @return ENC_LIN_BUSY=继续注入, 其他=已结束 (输出电压为 0)
+ */
+EncLin_Status_t EncLin_Step(EncLin_t *lin, uint16_t raw, float *theta, float *vd);
+
+/**
+ * @brief  补偿一次读数
+ * @param  table: 补偿表 (ENC_LIN_SIZE + 1 项)
+ * @param  raw: 原始读数
+ * @return 补偿后的读数
+ */
+static inline uint16_t EncLin_Apply(const int16_t *table, uint16_t raw)
+{
+    uint32_t i = (uint32_t)raw >> ENC_LIN_SHIFT;
+    int32_t frac = (int32_t)(raw & ((1u << ENC_LIN_SHIFT) - 1u));
+    int32_t corr = table[i] + (((table[i + 1] - table[i]) * frac) >> ENC_LIN_SHIFT);
+
+    return (uint16_t)((raw + ((corr + (1 << (ENC_LIN_Q - 1))) >> ENC_LIN_Q))
+                      & ((1u << ENC_LIN_RAW_BITS) - 1u));
+}
+
+#endif /* __ENC_LIN_H */
@@ -0,0 +1,167 @@
+/**
+ * @file    foc_atomic.h
+ * @brief   无锁同步原语 (中断/主循环/外环任务之间共享数据用)
+ * @note    目标板使用 Cortex-M4 LDREX/STREX 独占访问与 DMB 屏障 (CMSIS 内联函数),
+ *          仿真 (MOTOR_HW_SIM = 1) 使用 GCC __atomic 内建函数, 可在主机多线程下验证
+ *          均不关中断; 加锁失败立即返回, 不自旋等待 (低优先级持锁者可能已被抢占)
+ */
+
+#ifndef __FOC_ATOMIC_H
+#define __FOC_ATOMIC_H
+
+#include <stdint.h>
+
+#ifndef MOTOR_HW_SIM
+#define MOTOR_HW_SIM            0
+#endif
+
+#if !MOTOR_HW_SIM
+#include "main.h"
+#endif
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+#if MOTOR_HW_SIM
+
+/**
+ * @brief  数据存储器屏障 (之前的读写先于之后的读写完成)
+ */
+static inline void FOC_Atomic_Barrier(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief  尝试获取自旋锁 (不等待)
+ * @param  lock: 锁变量, 0=空闲
+ * @return 1=获取成功, 0=已被占用
+ */
+static inline uint8_t FOC_Atomic_TryLock(volatile uint32_t *lock)
+{
+    uint32_t expected = 0;
+    return __atomic_compare_exchange_n(lock, &expected, 1u, 0,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ? 1 : 0;
+}
+
+/**
+ * @brief  释放锁
+ */
+static inline void FOC_Atomic_Unlock(volatile uint32_t *lock)
+{
+    __atomic_store_n(lock, 0u, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief  原子加一 (多个上下文共享的计数器)
+ */
+static inline void FOC_Atomic_Inc(volatile uint32_t *counter)
+{
+    __atomic_fetch_add(counter, 1u, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief  原子累加 (多个上下文共享的计数器)
+ */
+static inline void FOC_Atomic_Add(volatile uint32_t *counter, uint32_t n)
+{
+    __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief  交换 (写入新值并返回旧值, 前后均有屏障)
+ * @param  ptr: 目标变量
+ * @param  desired: 新值
+ * @return 旧值
+ */
+static inline uint32_t FOC_Atomic_Exchange(volatile uint32_t *ptr, uint32_t desired)
+{
+    return __atomic_exchange_n(ptr, desired, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief  比较并交换
+ * @param  ptr: 目标变量
+ * @param  expected: 期望的当前值
+ * @param  desired: 新值
+ * @return 1=当前值等于 expected 且已写入 desired, 0=当前值已被修改
+ */
+static inline uint8_t FOC_Atomic_CompareExchange(volatile uint32_t *ptr, uint32_t expected, uint32_t desired)
+{
+    return __atomic_compare_exchange_n(ptr, &expected, desired, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? 1 : 0;
+}
+
+#else
+
+static inline void FOC_Atomic_Barrier(void)
+{
+    __DMB();
+}
+
+static inline uint8_t FOC_Atomic_TryLock(volatile uint32_t *lock)
+{
+    /* STREX 失败说明独占期间发生了中断, 锁仍空闲则重试 */
+    do {
+        if (__LDREXW(lock) != 0) {
+            __CLREX();
+            return 0;
+        }
+    } while (__STREXW(1u, lock) != 0);
+
+    __DMB();
+    return 1;
+}
+
+static inline void FOC_Atomic_Unlock(volatile uint32_t *lock)
+{
+    __DMB();
+    *lock = 0;
+}
+
+static inline void FOC_Atomic_Inc(volatile uint32_t *counter)
+{
+    uint32_t val;
+    do {
+        val = __LDREXW(counter) + 1u;
+    } while (__STREXW(val, counter) != 0);
+}
+
+static inline void FOC_Atomic_Add(volatile uint32_t *counter, uint32_t n)
+{
+    uint32_t val;
+    do {
+        val = __LDREXW(counter) + n;
+    } while (__STREXW(val, counter) != 0);
+}
+
+static inline uint32_t FOC_Atomic_Exchange(volatile uint32_t *ptr, uint32_t desired)
+{
+    uint32_t old;
+
+    __DMB();
+    do {
+        old = __LDREXW(ptr);
+    } while (__STREXW(desired, ptr) != 0);
+
+    __DMB();
+    return old;
+}
+
+static inline uint8_t FOC_Atomic_CompareExchange(volatile uint32_t *ptr, uint32_t expected, uint32_t desired)
+{
+    do {
+        if (__LDREXW(ptr) != expected) {
+            __CLREX();
+            return 0;
+        }
+    } while (__STREXW(desired, ptr) != 0);
+
+    __DMB();
+    return 1;
+}
+
+#endif /* MOTOR_HW_SIM */
+
+#endif /* __FOC_ATOMIC_H */
@@ -0,0 +1,80 @@
+/**
+ * @file    foc_cmd.c
+ * @brief   控制命令邮箱实现
+ */
+
+#include "foc_cmd.h"
+#include "foc_atomic.h"
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化邮箱
+ */
+void FOC_Mailbox_Init(FOC_Mailbox_t *mb, const FOC_Command_t *init)
+{
+    mb->Buf[0] = *init;
+    mb->Buf[1] = *init;
+    mb->Seq = 0;
+    mb->Lock = 0;
+    mb->ReadSeq = 0;
+    mb->Busy = 0;
+    mb->Torn = 0;
+}
+
+/**
+ * @brief  发布命令
+ * @note   只写非活动缓冲, 正在被读取的最新命令不受影响;
+ *         屏障保证读端看到新序号时缓冲内容已写完
+ */
+uint8_t FOC_Mailbox_Publish(FOC_Mailbox_t *mb, uint32_t fields, const FOC_Command_t *cmd)
+{
+    if (!FOC_Atomic_TryLock(&mb->Lock)) {
+        FOC_Atomic_Inc(&mb->Busy);
+        return 0;
+    }
+
+    uint32_t seq = mb->Seq;
+    FOC_Command_t *next = &mb->Buf[(seq + 1u) & 1u];
+
+    /* 未选中的字段沿用最新命令 */
+    *next = mb->Buf[seq & 1u];
+    if (fields & FOC_CMD_MODE) next->Mode = cmd->Mode;
+    if (fields & FOC_CMD_ID)   next->TargetId = cmd->TargetId;
+    if (fields & FOC_CMD_IQ)   next->TargetIq = cmd->TargetIq;
+    if (fields & FOC_CMD_RPM)  next->TargetRPM = cmd->TargetRPM;
+    if (fields & FOC_CMD_POS)  next->TargetPosCnt = cmd->TargetPosCnt;
+
+    FOC_Atomic_Barrier();
+    mb->Seq = seq + 1u;
+
+    FOC_Atomic_Unlock(&mb->Lock);
+    return 1;
+}
+
+/**
+ * @brief  取用最新命令
+ * @note   拷贝前后序号一致即为完整命令: 下一次发布只写另一缓冲,
+ *         再下一次才会覆盖本缓冲, 而它必须等序号先变化
+ */
+uint8_t FOC_Mailbox_Fetch(FOC_Mailbox_t *mb, FOC_Command_t *out)
+{
+    for (uint32_t retry = 0; retry < FOC_CMD_READ_RETRY; retry++) {
+        uint32_t seq = mb->Seq;
+        if (seq == mb->ReadSeq) return 0;
+
+        FOC_Atomic_Barrier();
+        *out = mb->Buf[seq & 1u];
+        FOC_Atomic_Barrier();
+
+        if (mb->Seq == seq) {
+            mb->ReadSeq = seq;
+            return 1;
+        }
+        mb->Torn++;
+    }
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file    foc_cmd.h
+ * @brief   控制命令邮箱 (主循环/通信中断 → 控制中断)
+ * @note    序号计数的双缓冲: 写端在非活动缓冲中合并修改后递增序号发布,
+ *          读端按序号一次性取出完整命令, 不会读到新旧混合的目标值
+ *          - 写端: 任意上下文, LDREX/STREX 互斥, 锁被占用时立即返回失败
+ *          - 读端: 控制中断, 每周期开始时取用一次, 不等待
+ */
+
+#ifndef __FOC_CMD_H
+#define __FOC_CMD_H
+
+#include <stdint.h>
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#define FOC_CMD_READ_RETRY      2           // 读端被并发发布打断时的重试次数
+
+/* 命令字段掩码 (发布时只更新选中的字段, 其余沿用上一条命令) */
+#define FOC_CMD_MODE            (1u << 0)   // 控制模式
+#define FOC_CMD_ID              (1u << 1)   // d轴目标电流
+#define FOC_CMD_IQ              (1u << 2)   // q轴目标电流
+#define FOC_CMD_RPM             (1u << 3)   // 目标转速
+#define FOC_CMD_POS             (1u << 4)   // 目标位置
+#define FOC_CMD_ALL             0x1Fu
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 控制命令 (一组同时生效的目标值)
+ */
+typedef struct {
+    uint8_t Mode;               // 控制模式 (FOC_Mode_t)
+    float TargetId;             // d轴目标电流 (A)
+    float TargetIq;             // q轴目标电流 (A)
+    float TargetRPM;            // 目标转速 (RPM)
+    int64_t TargetPosCnt;       // 目标位置 (编码器计数, 累计; rad 经 FOC_PosRadToCnt 换算)
+} FOC_Command_t;
+
+/**
+ * @brief 命令邮箱
+ */
+typedef struct {
+    FOC_Command_t Buf[2];       // 双缓冲, 最新命令位于 Buf[Seq & 1]
+    volatile uint32_t Seq;      // 已发布命令数
+    volatile uint32_t Lock;     // 写端互斥锁
+    uint32_t ReadSeq;           // 读端已取用的序号
+    volatile uint32_t Busy;     // 发布失败次数 (锁被占用)
+    uint32_t Torn;              // 读取被并发发布打断的次数
+} FOC_Mailbox_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化邮箱
+ * @param  mb: 邮箱指针
+ * @param  init: 初始命令 (视为已取用)
+ */
+void FOC_Mailbox_Init(FOC_Mailbox_t *mb, const FOC_Command_t *init);
+
+/**
+ * @brief  发布命令 (任意上下文)
+ * @param  mb: 邮箱指针
+ * @param  fields: 更新的字段 (FOC_CMD_xxx 组合)
+ * @param  cmd: 命令 (只读取 fields 选中的字段)
+ * @return 1=已发布, 0=另一上下文正在发布 (本次丢弃, 计入 Busy)
+ */
+uint8_t FOC_Mailbox_Publish(FOC_Mailbox_t *mb, uint32_t fields, const FOC_Command_t *cmd);
+
+/**
+ * @brief  取用最新命令 (控制中断, 每周期一次)
+ * @param  mb: 邮箱指针
+ * @param  out: 命令输出
+ * @return 1=有新命令, 0=无新命令 (或连续被打断, 下一周期再取)
+ * @note   仅支持单一读端; 读取期间有新命令发布时丢弃本次读取并重试
+ *         (控制中断优先级高于所有写端, 目标板上不会发生)
+ */
+uint8_t FOC_Mailbox_Fetch(FOC_Mailbox_t *mb, FOC_Command_t *out);
+
+#endif /* __FOC_CMD_H */
@@ -4,6 +4,11 @@
  */
 
 #include "foc_core.h"
+#include "foc_perf.h"
+#include "foc_trace.h"
+#include "foc_param.h"
+#include "foc_atomic.h"
+#include <stddef.h>
 #include <math.h>
 
 /*============================================================================*/
@@ -29,6 +34,20 @@
 #define DEFAULT_MAX_ACCEL       500.0f      // rad/s²
 #define DEFAULT_MAX_JERK        50.0f       // RPM/tick
 
+/* 调制算法 */
+#define DEFAULT_SVPWM_MODE      SVPWM_MODE_SECTOR
+#define DEFAULT_AUTO_DPWM       SVPWM_MODE_DPWM1    // AUTO 模式高调制比使用的断续调制
+#define DEFAULT_SVPWM_OVM       SVPWM_OVM_MIN_PHASE
+#define DEFAULT_MAX_MOD_INDEX   1.0f        // 调制比上限 (1.0 = 六步)
+
+/* 编码器校准 */
+#define DEFAULT_ENC_CAL_VOLTAGE 0.3f        // 注入电压 (V)
+
+/* 编码器延迟补偿 (控制周期数): 编码器读数在上一周期锁存, 电流在本周期采样,
+   本周期写入的占空比在下一 PWM 周期生效 (中点再晚半个周期) */
+#define DEFAULT_ENC_DELAY_PARK  1.0f
+#define DEFAULT_ENC_DELAY_PWM   1.5f
+
 /* PLL 参数 */
 #define DEFAULT_PLL_KP          200.0f
 #define DEFAULT_PLL_KI          40000.0f
@@ -38,15 +57,22 @@
 #define SPEED_LOOP_DT           0.001f      // 1ms
 #define POS_LOOP_DT             0.001f      // 1ms
 
+/* 外环任务每 HW_SPEED_LOOP_DIV 个控制周期运行一次, 位置环在任务内再分频 */
+#define POS_LOOP_TASK_DIV       (HW_POS_LOOP_DIV / HW_SPEED_LOOP_DIV)
+
 /* 常量 */
-#define _2PI                    6.2831853f
 #define RAD_S_TO_RPM            9.5492965855f
 
+#if FOC_USE_FIXED_POINT
+/* 定点流水线: 电流满量程 (±2048 LSB) */
+#define FIXED_CURRENT_FS        (2048.0f * HW_CURRENT_SCALE)
+#endif
+
 /*============================================================================*/
 /*                              全局电机实例                                   */
 /*============================================================================*/
 
-Motor_t g_Motor = { .State = MOTOR_STATE_IDLE, .Mode = FOC_MODE_IDLE };
+Motor_t g_Motors[HW_AXIS_COUNT];
 
 /*============================================================================*/
 /*                              内部函数                                       */
@@ -60,11 +86,10 @@ static void PosController_Init(PosController_t *pos)
     PID_Init(&pos->PID, DEFAULT_POS_KP, DEFAULT_POS_KI, 0.0f, 
              DEFAULT_MAX_RPM, -DEFAULT_MAX_RPM);
     
-    pos->TargetPos = 0.0f;
+    pos->TargetCnt = 0;
+    pos->CurrentCnt = 0;
+    pos->LastTargetCnt = 0;
     pos->CurrentPos = 0.0f;
-    pos->LastTargetPos = 0.0f;
-    pos->TotalTurns = 0;
-    pos->LastTheta = 0.0f;
     pos->MaxRPM = DEFAULT_MAX_RPM;
     pos->MaxAccel = DEFAULT_MAX_ACCEL;
     pos->MaxJerk = DEFAULT_MAX_JERK;
@@ -72,23 +97,15 @@ static void PosController_Init(PosController_t *pos)
 }
 
 /**
- * @brief  位置环传感器更新 (多圈累计)
+ * @brief  位置环传感器更新
+ * @param  pos_cnt: 多圈累计位置 (计数, 编码器解码时在控制中断中累加)
+ * @param  target_cnt: 目标位置 (计数)
  */
-static void PosController_UpdateSensor(PosController_t *pos, float mech_theta)
+static void PosController_UpdateSensor(PosController_t *pos, int64_t pos_cnt, int64_t target_cnt)
 {
-    float delta = mech_theta - pos->LastTheta;
-    
-    /* 检测跨零点 */
-    if (delta < -5.0f) {
-        pos->TotalTurns++;
-    } 
-    else if (delta > 5.0f) {
-        pos->TotalTurns--;
-    }
-    
-    /* 计算累计位置 */
-    pos->CurrentPos = (float)pos->TotalTurns * _2PI + mech_theta;
-    pos->LastTheta = mech_theta;
+    pos->CurrentCnt = pos_cnt;
+    pos->TargetCnt = target_cnt;
+    pos->CurrentPos = FOC_PosCntToRad(pos_cnt);
 }
 
 /**
@@ -96,13 +113,13 @@ static void PosController_UpdateSensor(PosController_t *pos, float mech_theta)
  */
 static float PosController_Calc(PosController_t *pos)
 {
-    /* 前馈速度 */
-    float delta_target = pos->TargetPos - pos->LastTargetPos;
+    /* 前馈速度 (计数差在整数域求出, 只把小量换算为浮点) */
+    float delta_target = FOC_PosCntToRad(pos->TargetCnt - pos->LastTargetCnt);
     float ff_velocity_rpm = (delta_target / POS_LOOP_DT) * RAD_S_TO_RPM;
-    pos->LastTargetPos = pos->TargetPos;
+    pos->LastTargetCnt = pos->TargetCnt;
     
     /* 位置误差 */
-    float error = pos->TargetPos - pos->CurrentPos;
+    float error = FOC_PosCntToRad(pos->TargetCnt - pos->CurrentCnt);
     float sign = (error > 0.0f) ? 1.0f : -1.0f;
     float abs_err = fabsf(error);
     
@@ -136,6 +153,45 @@ static float PosController_Calc(PosController_t *pos)
     return final_rpm;
 }
 
+/**
+ * @brief  发布电流给定 (外环任务 → 控制中断)
+ * @note   写非活动缓冲, 屏障后再翻转下标 (防止编译器/CPU 把字段写入移到下标之后);
+ *         读端取下标后同样加屏障, 读到的是完整的一组
+ */
+static void Outer_PublishRef(Motor_t *motor, uint32_t seq, float iq)
+{
+    uint8_t next = motor->CurRefIdx ^ 1u;
+    
+    motor->CurRef[next].Seq = seq;
+    motor->CurRef[next].Iq = iq;
+    FOC_Atomic_Barrier();
+    motor->CurRefIdx = next;
+}
+
+/**
+ * @brief  发布反馈快照并挂起外环任务 (控制中断 → 外环任务)
+ * @note   字段写入与下标翻转之间加屏障 (同 Outer_PublishRef);
+ *         外环任务在 1ms 内只会读到同一个缓冲, 超时由 OuterOverrun 记录
+ */
+static void Outer_PublishFeedback(Motor_t *motor)
+{
+    uint8_t next = motor->OuterFbIdx ^ 1u;
+    
+    motor->OuterFb[next].Seq = ++motor->OuterSeq;
+    motor->OuterFb[next].PosCnt = motor->Encoder.PosCnt;
+    motor->OuterFb[next].TargetPosCnt = motor->TargetPosCnt;
+    motor->OuterFb[next].SpeedRPM = motor->ActualRPM;
+    motor->OuterFb[next].Mode = motor->Mode;
+    FOC_Atomic_Barrier();
+    motor->OuterFbIdx = next;
+    
+    if (motor->OuterPending) {
+        motor->OuterOverrun++;
+    }
+    motor->OuterPending = 1;
+    MotorHW_PendOuterTask();
+}
+
 /*============================================================================*/
 /*                              公开接口                                       */
 /*============================================================================*/
@@ -143,14 +199,25 @@ static float PosController_Calc(PosController_t *pos)
 /**
  * @brief  初始化电机对象
  */
-void FOC_Init(Motor_t *motor)
+void FOC_Init(Motor_t *motor, uint8_t axis)
 {
     /* 清零所有数据 */
     motor->State = MOTOR_STATE_IDLE;
     motor->Mode = FOC_MODE_IDLE;
     
-    /* 初始化编码器方向 */
+    /* 绑定硬件描述符 */
+    motor->Axis = axis;
+    motor->HW = &g_MotorHW[axis];
+    
+    /* 初始化编码器方向与零点 */
     motor->Encoder.Direction = 1;
+    motor->Encoder.PolePairs = HW_MOTOR_POLE_PAIRS;
+    MotorHW_SetEncoderOffset(&motor->Encoder, HW_ENCODER_ZERO_OFFSET);
+    EncCal_Init(&motor->EncCal, HW_ENCODER_CPR, CONTROL_DT, DEFAULT_ENC_CAL_VOLTAGE);
+    EncLin_Init(&motor->EncLin, HW_MOTOR_POLE_PAIRS, CONTROL_DT);
+    motor->Encoder.Lin = NULL;
+    motor->EncDelayPark = DEFAULT_ENC_DELAY_PARK;
+    motor->EncDelayPwm = DEFAULT_ENC_DELAY_PWM;
     
     /* 初始化电源参数 */
     motor->Vdc = 12.0f;
@@ -162,6 +229,14 @@ void FOC_Init(Motor_t *motor)
     PID_Init(&motor->PID_Iq, DEFAULT_IQ_KP, DEFAULT_IQ_KI, 0.0f,
              DEFAULT_CURRENT_LIMIT, -DEFAULT_CURRENT_LIMIT);
     
+#if FOC_USE_FIXED_POINT
+    /* 定点电流环增益由浮点参数换算 (运行中经参数表修改时由 FOC_Fixed_UpdateGains 同步) */
+    FOC_Fixed_Init(&motor->Fixed, &motor->PID_Id, &motor->PID_Iq,
+                   FIXED_CURRENT_FS, motor->Vdc);
+    FOC_Fixed_SetExtrap(&motor->Fixed, motor->Encoder.PolePairs, CONTROL_DT,
+                        motor->EncDelayPark, motor->EncDelayPwm);
+#endif
+    
     /* 初始化速度环 */
     PID_Init(&motor->PID_Speed, DEFAULT_SPD_KP, DEFAULT_SPD_KI, 0.0f,
              DEFAULT_SPEED_LIMIT, -DEFAULT_SPEED_LIMIT);
@@ -175,54 +250,185 @@ void FOC_Init(Motor_t *motor)
     /* 初始化 SVPWM */
     motor->SVPWM.Ts = motor->PwmPeriod;
     motor->SVPWM.Udc = motor->Vdc;
+    motor->SVPWM.Mode = DEFAULT_SVPWM_MODE;
+    motor->SVPWM.AutoDpwm = DEFAULT_AUTO_DPWM;
+    motor->SVPWM.Ovm = DEFAULT_SVPWM_OVM;
+    motor->SVPWM.MaxModIndex = DEFAULT_MAX_MOD_INDEX;
+    motor->SVPWM.SixStep = 0;
     
     /* 初始化分频计数 */
     motor->SpeedLoopCnt = 0;
     motor->PosLoopCnt = 0;
     
+    /* 初始化外环交接 */
+    motor->OuterFbIdx = 0;
+    motor->CurRefIdx = 0;
+    motor->OuterPending = 0;
+    motor->OuterSeq = 0;
+    motor->OuterModeSeq = 0;
+    motor->OuterMode = FOC_MODE_IDLE;
+    motor->OuterOverrun = 0;
+    Outer_PublishRef(motor, 0, 0.0f);
+    
+    /* 初始化命令邮箱 */
+    FOC_Command_t cmd = { (uint8_t)FOC_MODE_IDLE, 0.0f, 0.0f, 0.0f, 0 };
+    FOC_Mailbox_Init(&motor->Cmd, &cmd);
+    motor->StopLatch = 0;
+    
+    /* 加载已保存的参数与标定 (覆盖上面的默认值) */
+    FOC_Param_Load(motor);
+    
     /* 初始化硬件层 */
-    MotorHW_Init();
+    MotorHW_Init(motor->HW);
+}
+
+/**
+ * @brief  发布控制命令
+ */
+uint8_t FOC_SetCommand(Motor_t *motor, uint32_t fields, const FOC_Command_t *cmd)
+{
+    return FOC_Mailbox_Publish(&motor->Cmd, fields, cmd);
 }
 
 /**
  * @brief  设置控制模式
  */
-void FOC_SetMode(Motor_t *motor, FOC_Mode_t mode)
+uint8_t FOC_SetMode(Motor_t *motor, FOC_Mode_t mode)
 {
-    if (motor->State == MOTOR_STATE_RUNNING) {
-        /* 切换模式时复位控制器 */
-        PID_Reset(&motor->PID_Id);
-        PID_Reset(&motor->PID_Iq);
-        PID_Reset(&motor->PID_Speed);
-        PID_Reset(&motor->PosCtrl.PID);
-    }
-    motor->Mode = mode;
+    FOC_Command_t cmd;
+    cmd.Mode = (uint8_t)mode;
+    return FOC_Mailbox_Publish(&motor->Cmd, FOC_CMD_MODE, &cmd);
 }
 
 /**
  * @brief  设置目标电流
  */
-void FOC_SetTargetCurrent(Motor_t *motor, float id, float iq)
+uint8_t FOC_SetTargetCurrent(Motor_t *motor, float id, float iq)
 {
-    motor->TargetId = id;
-    motor->TargetIq = iq;
+    FOC_Command_t cmd;
+    cmd.TargetId = id;
+    cmd.TargetIq = iq;
+    return FOC_Mailbox_Publish(&motor->Cmd, FOC_CMD_ID | FOC_CMD_IQ, &cmd);
 }
 
 /**
  * @brief  设置目标转速
  */
-void FOC_SetTargetSpeed(Motor_t *motor, float rpm)
+uint8_t FOC_SetTargetSpeed(Motor_t *motor, float rpm)
 {
-    motor->TargetRPM = rpm;
+    FOC_Command_t cmd;
+    cmd.TargetRPM = rpm;
+    return FOC_Mailbox_Publish(&motor->Cmd, FOC_CMD_RPM, &cmd);
 }
 
 /**
  * @brief  设置目标位置
  */
-void FOC_SetTargetPosition(Motor_t *motor, float pos_rad)
+uint8_t FOC_SetTargetPosition(Motor_t *motor, float pos_rad)
 {
-    motor->TargetPos = pos_rad;
-    motor->PosCtrl.TargetPos = pos_rad;
+    return FOC_SetTargetPositionCnt(motor, FOC_PosRadToCnt(pos_rad));
+}
+
+/**
+ * @brief  设置目标位置 (编码器计数)
+ */
+uint8_t FOC_SetTargetPositionCnt(Motor_t *motor, int64_t pos_cnt)
+{
+    FOC_Command_t cmd;
+    cmd.TargetPosCnt = pos_cnt;
+    return FOC_Mailbox_Publish(&motor->Cmd, FOC_CMD_POS, &cmd);
+}
+
+/**
+ * @brief  切换控制模式并复位电流环
+ */
+void FOC_ApplyMode(Motor_t *motor, FOC_Mode_t mode)
+{
+    PID_Reset(&motor->PID_Id);
+    PID_Reset(&motor->PID_Iq);
+#if FOC_USE_FIXED_POINT
+    PI_Q15_Reset(&motor->Fixed.PI_D);
+    PI_Q15_Reset(&motor->Fixed.PI_Q);
+#endif
+    
+    /* 电流给定须由新模式下发布的反馈快照计算, 此前的作废 */
+    motor->OuterModeSeq = motor->OuterSeq;
+    motor->Mode = mode;
+}
+
+/**
+ * @brief  停机锁存置位时强制空闲模式
+ */
+static inline void Cmd_HoldStop(Motor_t *motor)
+{
+    if (motor->StopLatch && motor->Mode != FOC_MODE_IDLE) {
+        FOC_ApplyMode(motor, FOC_MODE_IDLE);
+    }
+}
+
+/**
+ * @brief  取用命令邮箱中的最新命令
+ */
+void FOC_ProcessCommand(Motor_t *motor)
+{
+    FOC_Command_t cmd;
+    
+    /* 控制周期边界: 电流环/PLL 参数写入在此生效 */
+    FOC_Param_Apply(motor, FOC_PARAM_CTX_CURRENT);
+    
+    Cmd_HoldStop(motor);
+    if (!FOC_Mailbox_Fetch(&motor->Cmd, &cmd)) return;
+    
+    /* 停机后才完成的发布 (写端在停机前被打断) 可能仍带运行模式, 锁存期间一律视为空闲 */
+    if (motor->StopLatch) {
+        cmd.Mode = (uint8_t)FOC_MODE_IDLE;
+    }
+    
+    if ((FOC_Mode_t)cmd.Mode != motor->Mode) {
+        FOC_ApplyMode(motor, (FOC_Mode_t)cmd.Mode);
+    }
+    
+    /* 由外环给出的目标值在对应模式下不被命令覆盖 */
+    motor->TargetId = cmd.TargetId;
+    if (motor->Mode != FOC_MODE_SPEED && motor->Mode != FOC_MODE_POSITION) {
+        motor->TargetIq = cmd.TargetIq;
+    }
+    if (motor->Mode != FOC_MODE_POSITION) {
+        motor->TargetRPM = cmd.TargetRPM;
+    }
+    motor->TargetPosCnt = cmd.TargetPosCnt;
+    motor->TargetPos = FOC_PosCntToRad(cmd.TargetPosCnt);
+}
+
+/**
+ * @brief  设置 PWM 调制算法
+ */
+uint8_t FOC_SetPwmMode(Motor_t *motor, SVPWM_Mode_t mode)
+{
+#if FOC_USE_FIXED_POINT
+    /* SVPWM_Q15 只有连续调制 */
+    if (mode != SVPWM_MODE_SECTOR && mode != SVPWM_MODE_MINMAX) return 0;
+#endif
+    motor->SVPWM.Mode = mode;
+    return 1;
+}
+
+/**
+ * @brief  设置过调制策略
+ */
+uint8_t FOC_SetOvermodulation(Motor_t *motor, SVPWM_Ovm_t ovm, float max_mod_index)
+{
+#if FOC_USE_FIXED_POINT
+    /* SVPWM_Q15 只有六边形等比缩放 */
+    if (ovm != SVPWM_OVM_MIN_PHASE) return 0;
+#endif
+    if (max_mod_index < SVPWM_M_LINEAR) max_mod_index = SVPWM_M_LINEAR;
+    if (max_mod_index > 1.0f) max_mod_index = 1.0f;
+    
+    motor->SVPWM.SixStep = 0;
+    motor->SVPWM.MaxModIndex = max_mod_index;
+    motor->SVPWM.Ovm = ovm;
+    return 1;
 }
 
 /**
@@ -231,9 +437,103 @@ void FOC_SetTargetPosition(Motor_t *motor, float pos_rad)
 uint8_t FOC_CalibrateCurrentOffset(Motor_t *motor)
 {
     uint32_t adc_u, adc_v, adc_w;
-    MotorHW_GetCurrentADC(&adc_u, &adc_v, &adc_w);
+    MotorHW_GetCurrentADC(motor->HW, &adc_u, &adc_v, &adc_w);
+    
+#if FOC_USE_FIXED_POINT
+    if (MotorHW_CalibrateCurrentOffset(motor->HW, &motor->CurOffset, adc_u, adc_v, adc_w)) {
+        FOC_Fixed_SetOffset(&motor->Fixed, motor->CurOffset.OffsetU, motor->CurOffset.OffsetV);
+        return 1;
+    }
+    return 0;
+#else
+    return MotorHW_CalibrateCurrentOffset(motor->HW, &motor->CurOffset, adc_u, adc_v, adc_w);
+#endif
+}
+
+/**
+ * @brief  开始编码器校准
+ */
+uint8_t FOC_StartEncoderCalib(Motor_t *motor)
+{
+    if (motor->State != MOTOR_STATE_IDLE) return 0;
+    
+    EncCal_Start(&motor->EncCal, motor->Encoder.RawAngle);
+    MotorHW_EnableDriver(motor->HW);
+    
+    /* 校准器就绪后再切换状态, 控制中断看到新状态时读到的是完整的初始值 */
+    FOC_Atomic_Barrier();
+    motor->State = MOTOR_STATE_CALIBRATING;
+    return 1;
+}
+
+/**
+ * @brief  开始编码器非线性补偿标定
+ */
+uint8_t FOC_StartEncoderLin(Motor_t *motor)
+{
+    if (motor->State != MOTOR_STATE_IDLE) return 0;
+    
+    /* 标定使用未补偿的读数 */
+    motor->Encoder.Lin = NULL;
+    EncLin_Start(&motor->EncLin, motor->Encoder.RawAngle, motor->Encoder.Direction,
+                 motor->EncCal.Voltage);
+    MotorHW_EnableDriver(motor->HW);
+    
+    FOC_Atomic_Barrier();
+    motor->State = MOTOR_STATE_CALIBRATING;
+    return 1;
+}
+
+/**
+ * @brief  编码器校准单步
+ */
+void FOC_CalibrateEncoder(Motor_t *motor)
+{
+    float theta, vd;
+    uint8_t busy;
+    
+    if (motor->EncLin.Status == ENC_LIN_BUSY) {
+        busy = (EncLin_Step(&motor->EncLin, motor->Encoder.RawAngle, &theta, &vd) == ENC_LIN_BUSY);
+        if (!busy) {
+            /* 成功时为新表, 失败时恢复原有的表 */
+            motor->Encoder.Lin = motor->EncLin.Valid ? motor->EncLin.Table : NULL;
+        }
+    } else {
+        EncCal_Status_t status = EncCal_Step(&motor->EncCal, motor->Encoder.RawAngle, &theta, &vd);
+        busy = (status == ENC_CAL_BUSY);
+        if (status == ENC_CAL_DONE) {
+            motor->Encoder.Direction = motor->EncCal.Direction;
+            motor->Encoder.PolePairs = motor->EncCal.PolePairsMeas;
+            motor->EncLin.PolePairs = motor->EncCal.PolePairsMeas;
+            MotorHW_SetEncoderOffset(&motor->Encoder, motor->EncCal.Offset);
+#if FOC_USE_FIXED_POINT
+            FOC_Fixed_SetExtrap(&motor->Fixed, motor->Encoder.PolePairs, CONTROL_DT,
+                                motor->EncDelayPark, motor->EncDelayPwm);
+#endif
+            
+            /* 方向改变时机械角度跳变, 速度估算重新收敛 */
+            PLL_Reset(&motor->SpeedPLL);
+        }
+    }
+    
+    /* 本周期读数在下一周期使用 */
+    MotorHW_StartEncoderRead(motor->HW);
     
-    return MotorHW_CalibrateCurrentOffset(&motor->CurOffset, adc_u, adc_v, adc_w);
+    if (busy) {
+        SinCos_t sc;
+        FOC_SinCos(theta, &sc);
+        
+        motor->SVPWM.Alpha = vd * sc.Cos;
+        motor->SVPWM.Beta = vd * sc.Sin;
+        motor->SVPWM.Udc = motor->Vdc;
+        motor->SVPWM.Ts = motor->PwmPeriod;
+        SVPWM_Calc(&motor->SVPWM);
+        MotorHW_SetPWM(motor->HW, motor->SVPWM.CCR1, motor->SVPWM.CCR2, motor->SVPWM.CCR3);
+        return;
+    }
+    
+    MotorHW_SetPWMBrake(motor->HW);
+    motor->State = MOTOR_STATE_IDLE;
 }
 
 /**
@@ -241,7 +541,7 @@ uint8_t FOC_CalibrateCurrentOffset(Motor_t *motor)
  */
 void FOC_EncoderCallback(Motor_t *motor)
 {
-    MotorHW_ProcessEncoderData(&motor->Encoder);
+    MotorHW_ProcessEncoderData(motor->HW, &motor->Encoder);
 }
 
 /**
@@ -250,58 +550,118 @@ void FOC_EncoderCallback(Motor_t *motor)
 void FOC_ControlLoop(Motor_t *motor)
 {
     /* 调试引脚置高 */
-    MotorHW_DebugPin(1);
+    MotorHW_DebugPin(motor->HW, 1);
+    FOC_PERF_BEGIN(t_total);
+    FOC_PERF_BEGIN(t_stage);
+    
+    /* 停机锁存: 不经 FOC_ProcessCommand 调用 (录制回放) 或本周期内急停时同样生效 */
+    Cmd_HoldStop(motor);
+    
+#if FOC_USE_FIXED_POINT
+    FOC_Fixed_t *fx = &motor->Fixed;
+    int32_t sin_q15, cos_q15;
     
+    /*--- 1. 电流采样 (ADC 码值直接转 Q15) ---*/
+    uint32_t adc_u, adc_v, adc_w;
+    MotorHW_GetCurrentADC(motor->HW, &adc_u, &adc_v, &adc_w);
+    FOC_Fixed_Sample(fx, adc_u, adc_v);
+#else
     /*--- 1. 电流采样 ---*/
-    MotorHW_GetCurrents(&motor->Currents, &motor->CurOffset);
+    MotorHW_GetCurrents(motor->HW, &motor->Currents, &motor->CurOffset);
+#endif
     
     /*--- 2. 启动编码器读取 ---*/
-    MotorHW_StartEncoderRead();
-    
+    MotorHW_StartEncoderRead(motor->HW);
+    FOC_PERF_LAP(FOC_PERF_SAMPLE, t_stage);
+    
+#if FOC_USE_FIXED_POINT
+    /*--- 3. Clarke 变换 (Q15) ---*/
+    Clarke_Q15(fx);
+    FOC_PERF_LAP(FOC_PERF_CLARKE, t_stage);
+    
+    /*--- 4. Park 变换 (Q15, 编码器整数相位 + 外推增量, 按 Q16 回绕) ---*/
+    /* 每周期电角度增量由上一周期 PLL 估算换算 (fx->PhaseStep), 把上一周期的编码器读数
+       外推到电流采样时刻 (Park) 和本次占空比作用中点 (逆 Park) */
+    fx->Phase = FOC_Fixed_Extrap(fx, motor->Encoder.ElecPhase, fx->DelayPark);
+    fx->PhasePwm = FOC_Fixed_Extrap(fx, motor->Encoder.ElecPhase, fx->DelayPwm);
+    SinCos_Q15(fx->Phase, &sin_q15, &cos_q15);
+    Park_Q15(fx, sin_q15, cos_q15);
+    
+    /* 其余浮点中间量只供调试输出, 由 FOC_UpdateDebugValues 按需换算 */
+    motor->ActualId = FOC_Fixed_ToAmps(fx, fx->Id);
+    motor->ActualIq = FOC_Fixed_ToAmps(fx, fx->Iq);
+    FOC_PERF_LAP(FOC_PERF_PARK, t_stage);
+#else
     /*--- 3. Clarke 变换: Iabc → Iαβ ---*/
     motor->Clarke.Ia = motor->Currents.Iu;
     motor->Clarke.Ib = motor->Currents.Iv;
     motor->Clarke.Ic = motor->Currents.Iw;
     Clarke_Calc(&motor->Clarke);
+    FOC_PERF_LAP(FOC_PERF_CLARKE, t_stage);
+    
+    /*--- 4. Park 变换: Iαβ → Idq (电角度外推到采样时刻) ---*/
+    /* 每控制周期电角度增量 (PLL 上一周期估算), 用于把上一周期的编码器读数
+       外推到电流采样时刻 (Park) 和本次占空比作用中点 (逆 Park) */
+    float theta_step = motor->SpeedPLL.SpeedEst * ((float)motor->Encoder.PolePairs * CONTROL_DT);
+    SinCos_t sc;
+    motor->Park.Theta = motor->Encoder.ElecAngle + theta_step * motor->EncDelayPark;
+    FOC_SinCos(motor->Park.Theta, &sc);
     
-    /*--- 4. Park 变换: Iαβ → Idq ---*/
     motor->Park.Alpha = motor->Clarke.Alpha;
     motor->Park.Beta = motor->Clarke.Beta;
-    motor->Park.Theta = motor->Encoder.ElecAngle;
-    Park_Calc(&motor->Park);
+    Park_CalcSinCos(&motor->Park, &sc);
     
     motor->ActualId = motor->Park.D;
     motor->ActualIq = motor->Park.Q;
+    FOC_PERF_LAP(FOC_PERF_PARK, t_stage);
+#endif
     
     /*--- 5. PLL 速度估算 ---*/
     PLL_Update(&motor->SpeedPLL, motor->Encoder.MechAngle, CONTROL_DT);
     motor->ActualRPM = motor->SpeedPLL.SpeedRPM;
+#if FOC_USE_FIXED_POINT
+    FOC_Fixed_SetSpeed(fx, motor->SpeedPLL.SpeedEst);
+#endif
+    FOC_PERF_LAP(FOC_PERF_PLL, t_stage);
+    
+    /*--- 6. 外环交接 (速度环/位置环在外环任务中执行) ---*/
+    if (motor->Mode == FOC_MODE_SPEED || motor->Mode == FOC_MODE_POSITION) {
+        const FOC_CurrentRef_t *ref = &motor->CurRef[motor->CurRefIdx];
+        FOC_Atomic_Barrier();
+        if ((int32_t)(ref->Seq - motor->OuterModeSeq) > 0) {
+            motor->TargetIq = ref->Iq;
+        }
+    }
     
-    /*--- 6. 速度环 (分频执行) ---*/
     motor->SpeedLoopCnt++;
     if (motor->SpeedLoopCnt >= HW_SPEED_LOOP_DIV) {
         motor->SpeedLoopCnt = 0;
-        
-        if (motor->Mode == FOC_MODE_SPEED || motor->Mode == FOC_MODE_POSITION) {
-            float speed_out = PI_Calc(&motor->PID_Speed, motor->TargetRPM, motor->ActualRPM);
-            motor->TargetIq = speed_out;
-        }
+        Outer_PublishFeedback(motor);
     }
     
-    /*--- 7. 位置环 (分频执行) ---*/
-    motor->PosLoopCnt++;
-    if (motor->PosLoopCnt >= HW_POS_LOOP_DIV) {
-        motor->PosLoopCnt = 0;
-        
-        PosController_UpdateSensor(&motor->PosCtrl, motor->Encoder.MechAngle);
-        motor->ActualPos = motor->PosCtrl.CurrentPos;
-        
-        if (motor->Mode == FOC_MODE_POSITION) {
-            motor->TargetRPM = PosController_Calc(&motor->PosCtrl);
-        }
+#if FOC_USE_FIXED_POINT
+    /*--- 7. 电流环 (Q15) ---*/
+    if (motor->Mode == FOC_MODE_IDLE) {
+        fx->Vd = 0;
+        fx->Vq = 0;
+    } else {
+        fx->Vd = PI_Q15_Calc(&fx->PI_D, FOC_Fixed_FromAmps(fx, motor->TargetId), fx->Id);
+        fx->Vq = PI_Q15_Calc(&fx->PI_Q, FOC_Fixed_FromAmps(fx, motor->TargetIq), fx->Iq);
     }
-    
-    /*--- 8. 电流环 ---*/
+    FOC_PERF_LAP(FOC_PERF_PI, t_stage);
+    
+    /*--- 8. 逆 Park 变换 (Q15, 电角度外推到占空比作用中点) ---*/
+    SinCos_Q15(fx->PhasePwm, &sin_q15, &cos_q15);
+    InvPark_Q15(fx, sin_q15, cos_q15);
+    FOC_PERF_LAP(FOC_PERF_INVPARK, t_stage);
+    
+    /*--- 9. SVPWM 调制 (Q15 → 定时器计数) ---*/
+    SVPWM_Q15(fx, motor->PwmPeriod);
+    motor->SVPWM.CCR1 = fx->CCR1;
+    motor->SVPWM.CCR2 = fx->CCR2;
+    motor->SVPWM.CCR3 = fx->CCR3;
+#else
+    /*--- 7. 电流环 ---*/
     float vd_out, vq_out;
     
     if (motor->Mode == FOC_MODE_IDLE) {
@@ -311,25 +671,102 @@ void FOC_ControlLoop(Motor_t *motor)
         vd_out = PI_Calc(&motor->PID_Id, motor->TargetId, motor->ActualId);
         vq_out = PI_Calc(&motor->PID_Iq, motor->TargetIq, motor->ActualIq);
     }
+    FOC_PERF_LAP(FOC_PERF_PI, t_stage);
     
-    /*--- 9. 逆 Park 变换: Vdq → Vαβ ---*/
+    /*--- 8. 逆 Park 变换: Vdq → Vαβ (电角度外推到占空比作用中点) ---*/
     motor->InvPark.D = vd_out;
     motor->InvPark.Q = vq_out;
-    motor->InvPark.Theta = motor->Encoder.ElecAngle;
-    InvPark_Calc(&motor->InvPark);
+    motor->InvPark.Theta = motor->Encoder.ElecAngle + theta_step * motor->EncDelayPwm;
+    FOC_SinCos(motor->InvPark.Theta, &sc);
+    InvPark_CalcSinCos(&motor->InvPark, &sc);
+    FOC_PERF_LAP(FOC_PERF_INVPARK, t_stage);
     
-    /*--- 10. SVPWM 调制 ---*/
+    /*--- 9. SVPWM 调制 ---*/
     motor->SVPWM.Alpha = motor->InvPark.Alpha;
     motor->SVPWM.Beta = motor->InvPark.Beta;
     motor->SVPWM.Udc = motor->Vdc;
     motor->SVPWM.Ts = motor->PwmPeriod;
     SVPWM_Calc(&motor->SVPWM);
+#endif
     
-    /*--- 11. PWM 输出 ---*/
-    MotorHW_SetPWM(motor->SVPWM.CCR1, motor->SVPWM.CCR2, motor->SVPWM.CCR3);
+    /*--- 10. PWM 输出 ---*/
+    MotorHW_SetPWM(motor->HW, motor->SVPWM.CCR1, motor->SVPWM.CCR2, motor->SVPWM.CCR3);
+    FOC_PERF_LAP(FOC_PERF_SVPWM, t_stage);
+    FOC_PERF_END(FOC_PERF_TOTAL, t_total);
     
     /* 调试引脚置低 */
-    MotorHW_DebugPin(0);
+    MotorHW_DebugPin(motor->HW, 0);
+}
+
+/**
+ * @brief  刷新调试输出用的浮点中间量
+ */
+void FOC_UpdateDebugValues(Motor_t *motor)
+{
+#if FOC_USE_FIXED_POINT
+    const FOC_Fixed_t *fx = &motor->Fixed;
+    
+    motor->Currents.Iu = FOC_Fixed_ToAmps(fx, fx->Iu);
+    motor->Currents.Iv = FOC_Fixed_ToAmps(fx, fx->Iv);
+    motor->Currents.Iw = -motor->Currents.Iu - motor->Currents.Iv;
+    motor->Clarke.Alpha = FOC_Fixed_ToAmps(fx, fx->IAlpha);
+    motor->Clarke.Beta = FOC_Fixed_ToAmps(fx, fx->IBeta);
+    
+    motor->InvPark.D = FOC_Fixed_ToVolts(fx->Vd, motor->Vdc);
+    motor->InvPark.Q = FOC_Fixed_ToVolts(fx->Vq, motor->Vdc);
+    motor->InvPark.Alpha = FOC_Fixed_ToVolts(fx->VAlpha, motor->Vdc);
+    motor->InvPark.Beta = FOC_Fixed_ToVolts(fx->VBeta, motor->Vdc);
+    motor->SVPWM.Alpha = motor->InvPark.Alpha;
+    motor->SVPWM.Beta = motor->InvPark.Beta;
+#else
+    (void)motor;
+#endif
+}
+
+/**
+ * @brief  外环任务: 速度环 + 位置环
+ */
+void FOC_OuterLoopTask(Motor_t *motor)
+{
+    if (!motor->OuterPending) return;
+    FOC_PERF_BEGIN(t_outer);
+    
+    /* 先清挂起标志再取快照: 执行期间发布的新快照会再次挂起任务 */
+    motor->OuterPending = 0;
+    uint8_t fb_idx = motor->OuterFbIdx;
+    FOC_Atomic_Barrier();
+    FOC_OuterFb_t fb = motor->OuterFb[fb_idx];
+    
+    /* 外环周期边界: 速度环/位置环参数写入在此生效 */
+    FOC_Param_Apply(motor, FOC_PARAM_CTX_OUTER);
+    
+    /* 模式切换后复位外环控制器 */
+    if (fb.Mode != motor->OuterMode) {
+        PID_Reset(&motor->PID_Speed);
+        PID_Reset(&motor->PosCtrl.PID);
+        motor->OuterMode = fb.Mode;
+    }
+    
+    /*--- 1. 速度环 ---*/
+    if (fb.Mode == FOC_MODE_SPEED || fb.Mode == FOC_MODE_POSITION) {
+        float speed_out = PI_Calc(&motor->PID_Speed, motor->TargetRPM, fb.SpeedRPM);
+        Outer_PublishRef(motor, fb.Seq, speed_out);
+    }
+    
+    /*--- 2. 位置环 (分频执行) ---*/
+    motor->PosLoopCnt++;
+    if (motor->PosLoopCnt >= POS_LOOP_TASK_DIV) {
+        motor->PosLoopCnt = 0;
+        
+        PosController_UpdateSensor(&motor->PosCtrl, fb.PosCnt, fb.TargetPosCnt);
+        motor->ActualPos = motor->PosCtrl.CurrentPos;
+        
+        if (fb.Mode == FOC_MODE_POSITION) {
+            motor->TargetRPM = PosController_Calc(&motor->PosCtrl);
+        }
+    }
+    
+    FOC_PERF_END(FOC_PERF_OUTER, t_outer);
 }
 
 /**
@@ -337,8 +774,11 @@ void FOC_ControlLoop(Motor_t *motor)
  */
 void FOC_Start(Motor_t *motor)
 {
+    if (motor->State == MOTOR_STATE_CALIBRATING) return;
+    
+    motor->StopLatch = 0;
     motor->State = MOTOR_STATE_RUNNING;
-    MotorHW_EnableDriver();
+    MotorHW_EnableDriver(motor->HW);
 }
 
 /**
@@ -347,15 +787,15 @@ void FOC_Start(Motor_t *motor)
 void FOC_Stop(Motor_t *motor)
 {
     motor->State = MOTOR_STATE_IDLE;
-    motor->Mode = FOC_MODE_IDLE;
     
-    /* 复位控制器 */
-    PID_Reset(&motor->PID_Id);
-    PID_Reset(&motor->PID_Iq);
-    PID_Reset(&motor->PID_Speed);
+    /* 先置停机锁存: 控制中断此后忽略邮箱中的运行模式, 由其切换到空闲并复位控制器;
+       再经邮箱发布空闲模式 (邮箱正被打断的写端占用时发布失败, 由锁存保证停机) */
+    motor->StopLatch = 1;
+    FOC_Atomic_Barrier();
+    FOC_SetMode(motor, FOC_MODE_IDLE);
     
     /* 设置 PWM 为 50% (刹车) */
-    MotorHW_SetPWMBrake();
+    MotorHW_SetPWMBrake(motor->HW);
 }
 
 /**
@@ -364,9 +804,54 @@ void FOC_Stop(Motor_t *motor)
 void FOC_EmergencyStop(Motor_t *motor)
 {
     motor->State = MOTOR_STATE_ERROR;
-    motor->Mode = FOC_MODE_IDLE;
+    motor->StopLatch = 1;
+    FOC_Atomic_Barrier();
+    FOC_SetMode(motor, FOC_MODE_IDLE);
+    
+#if FOC_TRACE_ENABLE
+    /* 冻结录制缓冲区, 保留故障前的输入 */
+    FOC_Trace_Stop();
+#endif
+    
+    /* 禁用驱动 (FOC_Init 之前尚未绑定硬件) */
+    if (motor->HW != 0) {
+        MotorHW_DisableDriver(motor->HW);
+        MotorHW_SetPWMBrake(motor->HW);
+    }
+}
+
+#if MOTOR_HW_SIM
+/**
+ * @brief  仿真节拍
+ */
+void FOC_SimTick(Motor_t *motor)
+{
+    /* 对象模型推进一个 PWM 周期, 锁存 ADC 采样 */
+    MotorHW_Sim_Step(motor->HW);
+    
+    /* ADC 注入转换完成中断 */
+    if (!motor->CurOffset.IsCalibrated) {
+        FOC_CalibrateCurrentOffset(motor);
+        return;
+    }
+    if (motor->State == MOTOR_STATE_CALIBRATING) {
+        FOC_CalibrateEncoder(motor);
+    } else {
+        FOC_ProcessCommand(motor);
+#if FOC_TRACE_ENABLE
+        if (motor->Axis == FOC_TRACE_AXIS) {
+            FOC_Trace_Capture(motor);
+        }
+#endif
+        FOC_ControlLoop(motor);
+    }
+    
+    /* SPI DMA 完成中断 */
+    if (MotorHW_Sim_EncoderPending(motor->HW)) {
+        FOC_EncoderCallback(motor);
+    }
     
-    /* 禁用驱动 */
-    MotorHW_DisableDriver();
-    MotorHW_SetPWMBrake();
+    /* PendSV: 外环任务 */
+    FOC_OuterLoopTask(motor);
 }
+#endif
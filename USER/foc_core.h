@@ -12,7 +12,11 @@
 #include "pid.h"
 #include "pll.h"
 #include "svpwm.h"
+#include "foc_fixed.h"
+#include "foc_cmd.h"
 #include "motor_hw.h"
+#include "enc_cal.h"
+#include "enc_lin.h"
 
 /*============================================================================*/
 /*                              配置参数                                       */
@@ -35,6 +39,27 @@ typedef enum {
     MOTOR_STATE_ERROR,          // 故障
 } Motor_State_t;
 
+/* 位置单位: 内部以编码器计数 (int64) 累计, 接口 rad ↔ 计数换算 */
+#define FOC_POS_CNT_PER_RAD     ((float)HW_ENCODER_CPR / 6.2831853f)
+#define FOC_POS_RAD_PER_CNT     (6.2831853f / (float)HW_ENCODER_CPR)
+
+/**
+ * @brief  位置 rad → 计数 (四舍五入)
+ */
+static inline int64_t FOC_PosRadToCnt(float pos_rad)
+{
+    float cnt = pos_rad * FOC_POS_CNT_PER_RAD;
+    return (int64_t)((cnt >= 0.0f) ? (cnt + 0.5f) : (cnt - 0.5f));
+}
+
+/**
+ * @brief  位置计数 → rad (仅用于显示和小量误差换算)
+ */
+static inline float FOC_PosCntToRad(int64_t pos_cnt)
+{
+    return (float)pos_cnt * FOC_POS_RAD_PER_CNT;
+}
+
 /*============================================================================*/
 /*                              电机对象结构体                                  */
 /*============================================================================*/
@@ -45,12 +70,10 @@ typedef enum {
 typedef struct {
     PID_Controller_t PID;       // PID 控制器
     
-    float TargetPos;            // 目标位置 (rad, 累计)
-    float CurrentPos;           // 当前位置 (rad, 累计)
-    float LastTargetPos;        // 上次目标位置 (前馈用)
-    
-    int32_t TotalTurns;         // 圈数累计
-    float LastTheta;            // 上次机械角度 (0~2π)
+    int64_t TargetCnt;          // 目标位置 (计数, 累计)
+    int64_t CurrentCnt;         // 当前位置 (计数, 累计)
+    int64_t LastTargetCnt;      // 上次目标位置 (前馈用)
+    float CurrentPos;           // 当前位置 (rad, 仅用于显示, 远离原点时分辨率下降)
     
     float MaxRPM;               // 最大转速限制
     float MaxAccel;             // 最大加速度限制 (rad/s²)
@@ -58,6 +81,25 @@ typedef struct {
     float LastOutputRPM;        // 上次输出 (平滑用)
 } PosController_t;
 
+/**
+ * @brief 外环反馈快照 (控制中断发布, 外环任务读取)
+ */
+typedef struct {
+    uint32_t Seq;               // 快照序号
+    int64_t PosCnt;             // 多圈累计位置 (计数)
+    int64_t TargetPosCnt;       // 目标位置 (计数)
+    float SpeedRPM;             // PLL 转速 (RPM)
+    FOC_Mode_t Mode;            // 控制模式
+} FOC_OuterFb_t;
+
+/**
+ * @brief 电流给定 (外环任务发布, 控制中断读取)
+ */
+typedef struct {
+    uint32_t Seq;               // 计算所依据的反馈快照序号 (0=非外环计算)
+    float Iq;                   // q轴目标电流 (A)
+} FOC_CurrentRef_t;
+
 /**
  * @brief 电机对象结构体 - 封装所有 FOC 相关数据
  */
@@ -66,16 +108,27 @@ typedef struct {
     Motor_State_t State;        // 电机状态
     FOC_Mode_t Mode;            // 控制模式
     
+    /*--- 硬件 ---*/
+    uint8_t Axis;               // 轴号 (g_MotorHW 下标)
+    MotorHW_t *HW;              // 硬件描述符
+    
     /*--- 硬件数据 ---*/
     EncoderData_t Encoder;      // 编码器数据
     PhaseCurrents_t Currents;   // 三相电流
     CurrentOffset_t CurOffset;  // 电流偏移
+    EncCal_t EncCal;            // 编码器校准器 (MOTOR_STATE_CALIBRATING 时由控制中断执行)
+    EncLin_t EncLin;            // 编码器非线性补偿表与标定器
+    float EncDelayPark;         // Park 电角度外推 (控制周期数, 电流采样时刻 - 编码器锁存时刻)
+    float EncDelayPwm;          // 逆 Park 电角度外推 (控制周期数, 占空比作用中点 - 编码器锁存时刻)
     
     /*--- 坐标变换 ---*/
     Clarke_t Clarke;            // Clarke 变换
     Park_t Park;                // Park 变换
     InvPark_t InvPark;          // 逆 Park 变换
     SVPWM_t SVPWM;              // SVPWM 调制
+#if FOC_USE_FIXED_POINT
+    FOC_Fixed_t Fixed;          // 定点电流环流水线
+#endif
     
     /*--- 控制器 ---*/
     PID_Controller_t PID_Id;    // d轴电流环
@@ -84,25 +137,41 @@ typedef struct {
     PosController_t  PosCtrl;   // 位置环
     PLL_t SpeedPLL;             // PLL 速度估算
     
-    /*--- 目标值 ---*/
+    /*--- 命令 ---*/
+    FOC_Mailbox_t Cmd;          // 命令邮箱 (任意上下文发布, 控制中断取用)
+    volatile uint8_t StopLatch; // 停机锁存 (FOC_Stop/急停置位, FOC_Start 清除): 置位期间控制中断保持空闲模式
+    
+    /*--- 目标值 (控制中断从命令邮箱更新) ---*/
     float TargetId;             // d轴目标电流 (A)
     float TargetIq;             // q轴目标电流 (A)
     float TargetRPM;            // 目标转速 (RPM)
-    float TargetPos;            // 目标位置 (rad)
+    int64_t TargetPosCnt;       // 目标位置 (计数, 累计)
+    float TargetPos;            // 目标位置 (rad, 仅用于显示)
     
     /*--- 反馈值 ---*/
     float ActualId;             // d轴实际电流 (A)
     float ActualIq;             // q轴实际电流 (A)
     float ActualRPM;            // 实际转速 (RPM)
-    float ActualPos;            // 实际位置 (rad)
+    float ActualPos;            // 实际位置 (rad, 仅用于显示)
     
     /*--- 电源参数 ---*/
     float Vdc;                  // 母线电压 (V)
     uint32_t PwmPeriod;         // PWM 周期 (ARR值)
     
     /*--- 分频计数 ---*/
-    uint8_t SpeedLoopCnt;       // 速度环分频计数
-    uint8_t PosLoopCnt;         // 位置环分频计数
+    uint8_t SpeedLoopCnt;       // 速度环分频计数 (控制中断)
+    uint8_t PosLoopCnt;         // 位置环分频计数 (外环任务)
+    
+    /*--- 外环任务交接 (双缓冲, 写端写非活动缓冲后翻转下标) ---*/
+    FOC_OuterFb_t OuterFb[2];           // 反馈快照 (控制中断写)
+    FOC_CurrentRef_t CurRef[2];         // 电流给定 (外环任务写)
+    volatile uint8_t OuterFbIdx;        // 最新反馈快照下标
+    volatile uint8_t CurRefIdx;         // 最新电流给定下标
+    volatile uint8_t OuterPending;      // 1=外环任务待执行
+    uint32_t OuterSeq;                  // 已发布的反馈快照数
+    uint32_t OuterModeSeq;              // 模式切换时的快照序号 (此前的电流给定作废)
+    FOC_Mode_t OuterMode;               // 外环任务上次运行时的模式
+    uint32_t OuterOverrun;              // 外环任务超时次数 (发布新快照时上一次仍未执行)
     
 } Motor_t;
 
@@ -113,37 +182,101 @@ typedef struct {
 /**
  * @brief  初始化电机对象
  * @param  motor: 电机对象指针
+ * @param  axis: 轴号 (绑定 g_MotorHW[axis] 硬件描述符)
+ * @note   先设默认参数, 再由参数存储中的保存值覆盖 (FOC_Param_Init 须先挂载存储)
  */
-void FOC_Init(Motor_t *motor);
+void FOC_Init(Motor_t *motor, uint8_t axis);
+
+/**
+ * @brief  发布控制命令 (多个目标值同时生效)
+ * @param  motor: 电机对象指针
+ * @param  fields: 更新的字段 (FOC_CMD_xxx 组合)
+ * @param  cmd: 命令
+ * @return 1=已发布, 0=邮箱正被其他上下文写入 (本次丢弃)
+ * @note   可在任意上下文调用, 下一控制周期开始时生效
+ */
+uint8_t FOC_SetCommand(Motor_t *motor, uint32_t fields, const FOC_Command_t *cmd);
 
 /**
  * @brief  设置控制模式
  * @param  motor: 电机对象指针
  * @param  mode: 控制模式
+ * @return 1=已发布, 0=邮箱忙
  */
-void FOC_SetMode(Motor_t *motor, FOC_Mode_t mode);
+uint8_t FOC_SetMode(Motor_t *motor, FOC_Mode_t mode);
 
 /**
  * @brief  设置目标电流 (电流环模式)
  * @param  motor: 电机对象指针
  * @param  id: d轴目标电流 (A)
  * @param  iq: q轴目标电流 (A)
+ * @return 1=已发布, 0=邮箱忙
  */
-void FOC_SetTargetCurrent(Motor_t *motor, float id, float iq);
+uint8_t FOC_SetTargetCurrent(Motor_t *motor, float id, float iq);
 
 /**
  * @brief  设置目标转速 (速度环模式)
  * @param  motor: 电机对象指针
  * @param  rpm: 目标转速 (RPM)
+ * @return 1=已发布, 0=邮箱忙
  */
-void FOC_SetTargetSpeed(Motor_t *motor, float rpm);
+uint8_t FOC_SetTargetSpeed(Motor_t *motor, float rpm);
 
 /**
  * @brief  设置目标位置 (位置环模式)
  * @param  motor: 电机对象指针
  * @param  pos_rad: 目标位置 (rad)
+ * @return 1=已发布, 0=邮箱忙
+ * @note   float 在 ±2^24 计数 (约 ±1000 圈) 外无法精确表示每个计数,
+ *         长行程定位请用 FOC_SetTargetPositionCnt
+ */
+uint8_t FOC_SetTargetPosition(Motor_t *motor, float pos_rad);
+
+/**
+ * @brief  设置目标位置 (位置环模式, 编码器计数)
+ * @param  motor: 电机对象指针
+ * @param  pos_cnt: 目标位置 (计数, 累计, 每圈 HW_ENCODER_CPR)
+ * @return 1=已发布, 0=邮箱忙
+ */
+uint8_t FOC_SetTargetPositionCnt(Motor_t *motor, int64_t pos_cnt);
+
+/**
+ * @brief  设置 PWM 调制算法 (运行中可切换, 下一控制周期生效)
+ * @param  motor: 电机对象指针
+ * @param  mode: 调制算法 (连续 / DPWM0/1/2/MIN/MAX / AUTO)
+ * @return 1=已设置, 0=当前构建不支持 (保持原算法)
+ * @note   FOC_USE_FIXED_POINT = 1 时 SVPWM_Q15 只实现连续调制 (最大/最小值零序注入),
+ *         仅接受 SVPWM_MODE_SECTOR / SVPWM_MODE_MINMAX (线性区两者等价)
+ */
+uint8_t FOC_SetPwmMode(Motor_t *motor, SVPWM_Mode_t mode);
+
+/**
+ * @brief  设置过调制策略
+ * @param  motor: 电机对象指针
+ * @param  ovm: 过调制策略
+ * @param  max_mod_index: 调制比上限 (SVPWM_M_LINEAR ~ 1.0, 1.0 = 允许六步)
+ * @return 1=已设置, 0=当前构建不支持 (保持原策略)
+ * @note   FOC_USE_FIXED_POINT = 1 时 SVPWM_Q15 过调制固定沿原方向缩放到六边形边界,
+ *         仅接受 SVPWM_OVM_MIN_PHASE, 且不施加 max_mod_index (相当于 1.0)
+ */
+uint8_t FOC_SetOvermodulation(Motor_t *motor, SVPWM_Ovm_t ovm, float max_mod_index);
+
+/**
+ * @brief  取用命令邮箱中的最新命令 (在 ADC 中断中 FOC_ControlLoop 之前调用)
+ * @param  motor: 电机对象指针
+ * @note   模式与目标值在同一次读取中更新, 本周期内保持不变;
+ *         停机锁存期间命令中的模式被忽略 (保持空闲), 目标值照常更新;
+ *         参数表中电流环/PLL 参数的待生效写入也在此应用
+ */
+void FOC_ProcessCommand(Motor_t *motor);
+
+/**
+ * @brief  切换控制模式并复位电流环 (仅在控制中断上下文调用)
+ * @param  motor: 电机对象指针
+ * @param  mode: 控制模式
+ * @note   由 FOC_ProcessCommand 和录制回放调用; 外环控制器由外环任务自行复位
  */
-void FOC_SetTargetPosition(Motor_t *motor, float pos_rad);
+void FOC_ApplyMode(Motor_t *motor, FOC_Mode_t mode);
 
 /**
  * @brief  FOC 主控制循环 (在 ADC 中断中调用, 20kHz)
@@ -153,14 +286,33 @@ void FOC_SetTargetPosition(Motor_t *motor, float pos_rad);
  *         2. 编码器读取
  *         3. 坐标变换 (Clarke/Park)
  *         4. 速度估算 (PLL)
- *         5. 速度环 (分频执行)
- *         6. 位置环 (分频执行)
- *         7. 电流环
- *         8. 逆变换 + SVPWM
- *         9. PWM 输出
+ *         5. 外环交接: 取用最新电流给定, 分频发布反馈快照并挂起外环任务
+ *         6. 电流环
+ *         7. 逆变换 + SVPWM
+ *         8. PWM 输出
+ *         速度环/位置环不在中断内执行, 各周期耗时一致
+ *         FOC_USE_FIXED_POINT = 1 时步骤 1/3/7/8 使用 Q15 定点流水线, 只换算 ActualId/ActualIq;
+ *         Currents / Clarke / InvPark / SVPWM.Alpha/Beta 由 FOC_UpdateDebugValues 按需换算,
+ *         Park.Theta / InvPark.Theta / SVPWM.Sector 不再更新
  */
 void FOC_ControlLoop(Motor_t *motor);
 
+/**
+ * @brief  刷新调试输出用的浮点中间量 (FOC_ControlLoop 之后, 读取这些字段之前调用)
+ * @param  motor: 电机对象指针
+ * @note   FOC_USE_FIXED_POINT = 1 时由本周期 Q15 结果换算 Currents / Clarke / InvPark /
+ *         SVPWM.Alpha/Beta, 只在输出 VOFA/示波器的轴上调用; 浮点构建下这些字段由控制循环直接更新, 为空操作
+ */
+void FOC_UpdateDebugValues(Motor_t *motor);
+
+/**
+ * @brief  外环任务: 速度环 + 位置环 (1kHz, 在 PendSV 中调用)
+ * @param  motor: 电机对象指针
+ * @note   读取控制中断发布的反馈快照, 计算结果经双缓冲交给电流环;
+ *         可被控制中断抢占, 须在下一次快照发布 (1ms) 前完成, 否则计入 OuterOverrun
+ */
+void FOC_OuterLoopTask(Motor_t *motor);
+
 /**
  * @brief  电流偏移校准处理 (在 FOC_ControlLoop 之前调用)
  * @param  motor: 电机对象指针
@@ -168,6 +320,33 @@ void FOC_ControlLoop(Motor_t *motor);
  */
 uint8_t FOC_CalibrateCurrentOffset(Motor_t *motor);
 
+/**
+ * @brief  开始编码器零点/方向/极对数校准 (主循环)
+ * @param  motor: 电机对象指针
+ * @return 1=已开始, 0=电机不在空闲状态
+ * @note   使能驱动并进入 MOTOR_STATE_CALIBRATING, 控制中断改为调用 FOC_CalibrateEncoder,
+ *         约 1.3 s 后回到空闲; 结果见 motor->EncCal.Status, 成功时已写入编码器零点与方向
+ *         (未保存, 需要时再调用 FOC_Param_Save)
+ */
+uint8_t FOC_StartEncoderCalib(Motor_t *motor);
+
+/**
+ * @brief  开始编码器非线性补偿标定 (主循环)
+ * @param  motor: 电机对象指针
+ * @return 1=已开始, 0=电机不在空闲状态
+ * @note   须先完成方向校准; 标定期间不使用补偿表, 约 2.8 s 后回到空闲,
+ *         结果见 motor->EncLin.Status, 成功时补偿表立即生效 (建议随后重新校准零点并保存)
+ */
+uint8_t FOC_StartEncoderLin(Motor_t *motor);
+
+/**
+ * @brief  编码器校准单步 (MOTOR_STATE_CALIBRATING 时代替 FOC_ControlLoop 在 ADC 中断中调用)
+ * @param  motor: 电机对象指针
+ * @note   按校准器 (零点/方向或非线性补偿) 输出的电角度开环注入 d轴电压;
+ *         结束后刹车并回到空闲状态
+ */
+void FOC_CalibrateEncoder(Motor_t *motor);
+
 /**
  * @brief  编码器数据回调 (在 SPI DMA 完成中断中调用)
  * @param  motor: 电机对象指针
@@ -177,25 +356,42 @@ void FOC_EncoderCallback(Motor_t *motor);
 /**
  * @brief  启动电机
  * @param  motor: 电机对象指针
+ * @note   编码器校准中调用无效; 清除停机锁存, 此后发布的模式命令才会生效
  */
 void FOC_Start(Motor_t *motor);
 
 /**
  * @brief  停止电机
  * @param  motor: 电机对象指针
+ * @note   置停机锁存并经邮箱发布空闲模式; 即使邮箱正被打断的写端占用、
+ *         该写端随后发布运行模式, 控制中断在 FOC_Start 之前也保持空闲
  */
 void FOC_Stop(Motor_t *motor);
 
 /**
  * @brief  急停电机
  * @param  motor: 电机对象指针
+ * @note   置停机锁存 (同 FOC_Stop) 并禁用驱动; 可在控制中断内调用, 本周期剩余部分即为空闲模式
  */
 void FOC_EmergencyStop(Motor_t *motor);
 
+#if MOTOR_HW_SIM
+/**
+ * @brief  仿真节拍: 推进对象模型一个 PWM 周期并执行一次控制中断
+ * @param  motor: 电机对象指针
+ * @note   调度顺序与硬件一致: ADC 注入完成中断 (取用命令 + 录制 + 控制循环, 或编码器校准) → SPI DMA 完成中断
+ *         → 外环任务 (若已挂起)
+ */
+void FOC_SimTick(Motor_t *motor);
+#endif
+
 /*============================================================================*/
 /*                              全局电机实例                                   */
 /*============================================================================*/
 
-extern Motor_t g_Motor;     // 全局电机对象
+extern Motor_t g_Motors[HW_AXIS_COUNT];     // 全局电机对象 (每轴一个)
+
+/* 兼容旧代码: 单轴全局电机对象 */
+#define g_Motor     g_Motors[0]
 
 #endif /* __FOC_CORE_H */
@@ -0,0 +1,311 @@
+/**
+ * @file    foc_fixed.c
+ * @brief   定点 (Q15) FOC 电流环流水线实现
+ * @note    纯算法实现，无硬件依赖，可移植
+ *          所有乘法结果不超过 32 位, 无需 64 位乘法指令 (Cortex-M0+ 可用)
+ */
+
+#include "foc_fixed.h"
+
+/*============================================================================*/
+/*                              常量定义                                       */
+/*============================================================================*/
+
+#define SIN_Q15_TABLE_SIZE      512         // 每周期点数 (2 的幂)
+#define SIN_Q15_FRAC_BITS       7           // Q16 相位中的插值位数 (65536 / 512 = 128)
+#define SIN_Q15_QUARTER         (SIN_Q15_TABLE_SIZE / 4)
+
+/* sin 表 (Q15), 末尾多一项便于插值 */
+static const int16_t sin_q15_table[SIN_Q15_TABLE_SIZE + 1] = {
+         0,    402,    804,   1206,   1608,   2009,   2410,   2811,   3212,   3612,
+      4011,   4410,   4808,   5205,   5602,   5998,   6393,   6786,   7179,   7571,
+      7962,   8351,   8739,   9126,   9512,   9896,  10278,  10659,  11039,  11417,
+     11793,  12167,  12539,  12910,  13279,  13645,  14010,  14372,  14732,  15090,
+     15446,  15800,  16151,  16499,  16846,  17189,  17530,  17869,  18204,  18537,
+     18868,  19195,  19519,  19841,  20159,  20475,  20787,  21096,  21403,  21705,
+     22005,  22301,  22594,  22884,  23170,  23452,  23731,  24007,  24279,  24547,
+     24811,  25072,  25329,  25582,  25832,  26077,  26319,  26556,  26790,  27019,
+     27245,  27466,  27683,  27896,  28105,  28310,  28510,  28706,  28898,  29085,
+     29268,  29447,  29621,  29791,  29956,  30117,  30273,  30424,  30571,  30714,
+     30852,  30985,  31113,  31237,  31356,  31470,  31580,  31685,  31785,  31880,
+     31971,  32057,  32137,  32213,  32285,  32351,  32412,  32469,  32521,  32567,
+     32609,  32646,  32678,  32705,  32728,  32745,  32757,  32765,  32767,  32765,
+     32757,  32745,  32728,  32705,  32678,  32646,  32609,  32567,  32521,  32469,
+     32412,  32351,  32285,  32213,  32137,  32057,  31971,  31880,  31785,  31685,
+     31580,  31470,  31356,  31237,  31113,  30985,  30852,  30714,  30571,  30424,
+     30273,  30117,  29956,  29791,  29621,  29447,  29268,  29085,  28898,  28706,
+     28510,  28310,  28105,  27896,  27683,  27466,  27245,  27019,  26790,  26556,
+     26319,  26077,  25832,  25582,  25329,  25072,  24811,  24547,  24279,  24007,
+     23731,  23452,  23170,  22884,  22594,  22301,  22005,  21705,  21403,  21096,
+     20787,  20475,  20159,  19841,  19519,  19195,  18868,  18537,  18204,  17869,
+     17530,  17189,  16846,  16499,  16151,  15800,  15446,  15090,  14732,  14372,
+     14010,  13645,  13279,  12910,  12539,  12167,  11793,  11417,  11039,  10659,
+     10278,   9896,   9512,   9126,   8739,   8351,   7962,   7571,   7179,   6786,
+      6393,   5998,   5602,   5205,   4808,   4410,   4011,   3612,   3212,   2811,
+      2410,   2009,   1608,   1206,    804,    402,      0,   -402,   -804,  -1206,
+     -1608,  -2009,  -2410,  -2811,  -3212,  -3612,  -4011,  -4410,  -4808,  -5205,
+     -5602,  -5998,  -6393,  -6786,  -7179,  -7571,  -7962,  -8351,  -8739,  -9126,
+     -9512,  -9896, -10278, -10659, -11039, -11417, -11793, -12167, -12539, -12910,
+    -13279, -13645, -14010, -14372, -14732, -15090, -15446, -15800, -16151, -16499,
+    -16846, -17189, -17530, -17869, -18204, -18537, -18868, -19195, -19519, -19841,
+    -20159, -20475, -20787, -21096, -21403, -21705, -22005, -22301, -22594, -22884,
+    -23170, -23452, -23731, -24007, -24279, -24547, -24811, -25072, -25329, -25582,
+    -25832, -26077, -26319, -26556, -26790, -27019, -27245, -27466, -27683, -27896,
+    -28105, -28310, -28510, -28706, -28898, -29085, -29268, -29447, -29621, -29791,
+    -29956, -30117, -30273, -30424, -30571, -30714, -30852, -30985, -31113, -31237,
+    -31356, -31470, -31580, -31685, -31785, -31880, -31971, -32057, -32137, -32213,
+    -32285, -32351, -32412, -32469, -32521, -32567, -32609, -32646, -32678, -32705,
+    -32728, -32745, -32757, -32765, -32767, -32765, -32757, -32745, -32728, -32705,
+    -32678, -32646, -32609, -32567, -32521, -32469, -32412, -32351, -32285, -32213,
+    -32137, -32057, -31971, -31880, -31785, -31685, -31580, -31470, -31356, -31237,
+    -31113, -30985, -30852, -30714, -30571, -30424, -30273, -30117, -29956, -29791,
+    -29621, -29447, -29268, -29085, -28898, -28706, -28510, -28310, -28105, -27896,
+    -27683, -27466, -27245, -27019, -26790, -26556, -26319, -26077, -25832, -25582,
+    -25329, -25072, -24811, -24547, -24279, -24007, -23731, -23452, -23170, -22884,
+    -22594, -22301, -22005, -21705, -21403, -21096, -20787, -20475, -20159, -19841,
+    -19519, -19195, -18868, -18537, -18204, -17869, -17530, -17189, -16846, -16499,
+    -16151, -15800, -15446, -15090, -14732, -14372, -14010, -13645, -13279, -12910,
+    -12539, -12167, -11793, -11417, -11039, -10659, -10278,  -9896,  -9512,  -9126,
+     -8739,  -8351,  -7962,  -7571,  -7179,  -6786,  -6393,  -5998,  -5602,  -5205,
+     -4808,  -4410,  -4011,  -3612,  -3212,  -2811,  -2410,  -2009,  -1608,  -1206,
+      -804,   -402,      0
+};
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  饱和到 Q15 范围
+ */
+static inline int32_t Sat_Q15(int32_t x)
+{
+    if (x > Q15_ONE)  return Q15_ONE;
+    if (x < -Q15_ONE) return -Q15_ONE;
+    return x;
+}
+
+/**
+ * @brief  通用限幅
+ */
+static inline int32_t Clamp_I32(int32_t x, int32_t min, int32_t max)
+{
+    if (x > max) return max;
+    if (x < min) return min;
+    return x;
+}
+
+/**
+ * @brief  浮点标幺值 → Q15 (饱和)
+ */
+static int32_t Float_ToQ15(float x)
+{
+    float q = x * 32768.0f;
+
+    if (q > (float)Q15_ONE)  return Q15_ONE;
+    if (q < (float)-Q15_ONE) return -Q15_ONE;
+    return (int32_t)((q >= 0.0f) ? (q + 0.5f) : (q - 0.5f));
+}
+
+/**
+ * @brief  由浮点 PI 参数初始化 Q15 PI
+ * @param  scale: 标幺换算系数 (current_fs / vdc)
+ * @param  vdc: 母线电压, 输出限幅换算用
+ */
+static void PI_Q15_FromFloat(PI_Q15_t *pi, const PID_Controller_t *pid, float scale, float vdc)
+{
+    pi->Kp = (int16_t)Float_ToQ15(pid->Kp * scale);
+    pi->Ki = (int16_t)Float_ToQ15(pid->Ki * scale);
+    pi->OutMax = Float_ToQ15(pid->OutMax / vdc);
+    pi->OutMin = Float_ToQ15(pid->OutMin / vdc);
+    pi->IntegralMax = Float_ToQ15(pid->IntegralMax / vdc) * 32768;
+    pi->IntegralMin = Float_ToQ15(pid->IntegralMin / vdc) * 32768;
+    pi->Integral = 0;
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  由浮点 PI 参数初始化定点流水线
+ */
+void FOC_Fixed_Init(FOC_Fixed_t *fx, const PID_Controller_t *pid_d,
+                    const PID_Controller_t *pid_q, float current_fs, float vdc)
+{
+    float scale = current_fs / vdc;
+
+    fx->CurrentFS = current_fs;
+    fx->OffsetU = 2048 << 4;
+    fx->OffsetV = 2048 << 4;
+
+    PI_Q15_FromFloat(&fx->PI_D, pid_d, scale, vdc);
+    PI_Q15_FromFloat(&fx->PI_Q, pid_q, scale, vdc);
+
+    fx->Iu = fx->Iv = 0;
+    fx->IAlpha = fx->IBeta = 0;
+    fx->Id = fx->Iq = 0;
+    fx->Vd = fx->Vq = 0;
+    fx->VAlpha = fx->VBeta = 0;
+    fx->Phase = 0;
+    fx->PhasePwm = 0;
+    fx->PhaseStep = 0;
+}
+
+/**
+ * @brief  运行中重新换算增益与限幅
+ */
+void FOC_Fixed_UpdateGains(FOC_Fixed_t *fx, const PID_Controller_t *pid_d,
+                           const PID_Controller_t *pid_q, float vdc)
+{
+    float scale = fx->CurrentFS / vdc;
+    int32_t int_d = fx->PI_D.Integral;
+    int32_t int_q = fx->PI_Q.Integral;
+
+    PI_Q15_FromFloat(&fx->PI_D, pid_d, scale, vdc);
+    PI_Q15_FromFloat(&fx->PI_Q, pid_q, scale, vdc);
+
+    fx->PI_D.Integral = Clamp_I32(int_d, fx->PI_D.IntegralMin, fx->PI_D.IntegralMax);
+    fx->PI_Q.Integral = Clamp_I32(int_q, fx->PI_Q.IntegralMin, fx->PI_Q.IntegralMax);
+}
+
+/**
+ * @brief  设置电角度外推系数
+ */
+void FOC_Fixed_SetExtrap(FOC_Fixed_t *fx, uint8_t pole_pairs, float dt,
+                         float delay_park, float delay_pwm)
+{
+    fx->StepGain = (float)pole_pairs * dt * (1048576.0f / 6.2831853f);
+    fx->DelayPark = (int32_t)(delay_park * 256.0f + 0.5f);
+    fx->DelayPwm = (int32_t)(delay_pwm * 256.0f + 0.5f);
+}
+
+/**
+ * @brief  设置 ADC 零点
+ */
+void FOC_Fixed_SetOffset(FOC_Fixed_t *fx, float offset_u, float offset_v)
+{
+    fx->OffsetU = (int32_t)(offset_u * 16.0f + 0.5f);
+    fx->OffsetV = (int32_t)(offset_v * 16.0f + 0.5f);
+}
+
+/**
+ * @brief  ADC 原始值 → 三相电流 (Q15)
+ * @note   12-bit ADC 左移 4 位, 零点以 1/16 LSB 存储, 保留校准均值的小数部分
+ */
+void FOC_Fixed_Sample(FOC_Fixed_t *fx, uint32_t adc_u, uint32_t adc_v)
+{
+    fx->Iu = Sat_Q15(((int32_t)adc_u << 4) - fx->OffsetU);
+    fx->Iv = Sat_Q15(((int32_t)adc_v << 4) - fx->OffsetV);
+}
+
+/**
+ * @brief  Clarke 变换 (Q15)
+ * @note   Alpha = Ia, Beta = (Ia + 2*Ib) / sqrt(3)
+ */
+void Clarke_Q15(FOC_Fixed_t *fx)
+{
+    fx->IAlpha = fx->Iu;
+    fx->IBeta = Sat_Q15(((fx->Iu + 2 * fx->Iv) * Q15_ONE_BY_SQRT3) >> 15);
+}
+
+/**
+ * @brief  查表计算正弦/余弦 (Q15)
+ * @note   高 9 位查表, 低 7 位线性插值
+ */
+void SinCos_Q15(uint16_t phase, int32_t *sin_q15, int32_t *cos_q15)
+{
+    uint32_t is = (uint32_t)phase >> SIN_Q15_FRAC_BITS;
+    uint32_t ic = (is + SIN_Q15_QUARTER) & (SIN_Q15_TABLE_SIZE - 1);
+    int32_t frac = (int32_t)(phase & ((1u << SIN_Q15_FRAC_BITS) - 1));
+
+    int32_t s0 = sin_q15_table[is];
+    int32_t c0 = sin_q15_table[ic];
+    *sin_q15 = s0 + (((sin_q15_table[is + 1] - s0) * frac) >> SIN_Q15_FRAC_BITS);
+    *cos_q15 = c0 + (((sin_q15_table[ic + 1] - c0) * frac) >> SIN_Q15_FRAC_BITS);
+}
+
+/**
+ * @brief  Park 变换 (Q15)
+ * @note   D =  Alpha * cos + Beta * sin
+ *         Q = -Alpha * sin + Beta * cos
+ *         每个乘积单独移位, 避免两项之和溢出 32 位
+ */
+void Park_Q15(FOC_Fixed_t *fx, int32_t sin_q15, int32_t cos_q15)
+{
+    fx->Id = Sat_Q15(((fx->IAlpha * cos_q15) >> 15) + ((fx->IBeta * sin_q15) >> 15));
+    fx->Iq = Sat_Q15(((fx->IBeta * cos_q15) >> 15) - ((fx->IAlpha * sin_q15) >> 15));
+}
+
+/**
+ * @brief  PI 控制器 (Q15)
+ * @note   误差饱和到 Q15; 积分器 Q30, 限幅后再与比例项相加
+ */
+int32_t PI_Q15_Calc(PI_Q15_t *pi, int32_t ref, int32_t fdb)
+{
+    int32_t error = Sat_Q15(ref - fdb);
+
+    /* 积分项 (带抗饱和) */
+    pi->Integral += pi->Ki * error;
+    pi->Integral = Clamp_I32(pi->Integral, pi->IntegralMin, pi->IntegralMax);
+
+    /* 输出 */
+    int32_t out = ((pi->Kp * error) >> 15) + (pi->Integral >> 15);
+    return Clamp_I32(out, pi->OutMin, pi->OutMax);
+}
+
+/**
+ * @brief  PI 控制器复位
+ */
+void PI_Q15_Reset(PI_Q15_t *pi)
+{
+    pi->Integral = 0;
+}
+
+/**
+ * @brief  逆 Park 变换 (Q15)
+ * @note   Alpha = D * cos - Q * sin
+ *         Beta  = D * sin + Q * cos
+ */
+void InvPark_Q15(FOC_Fixed_t *fx, int32_t sin_q15, int32_t cos_q15)
+{
+    fx->VAlpha = Sat_Q15(((fx->Vd * cos_q15) >> 15) - ((fx->Vq * sin_q15) >> 15));
+    fx->VBeta = Sat_Q15(((fx->Vd * sin_q15) >> 15) + ((fx->Vq * cos_q15) >> 15));
+}
+
+/**
+ * @brief  SVPWM 调制 (Q15 → 定时器计数)
+ * @note   相电压 = 逆 Clarke(Vαβ), 零序分量 = -(max + min) / 2;
+ *         线电压峰峰值超过 Udc 时整体等比缩放, 与 SVPWM_Calc 中
+ *         T1 + T2 > Ts 的处理一致
+ */
+void SVPWM_Q15(FOC_Fixed_t *fx, uint32_t ts)
+{
+    int32_t va = fx->VAlpha;
+    int32_t vb = -(fx->VAlpha >> 1) + ((fx->VBeta * Q15_SQRT3_BY_2) >> 15);
+    int32_t vc = -va - vb;
+
+    int32_t vmax = va, vmin = va;
+    if (vb > vmax) vmax = vb;
+    if (vb < vmin) vmin = vb;
+    if (vc > vmax) vmax = vc;
+    if (vc < vmin) vmin = vc;
+
+    /* 过调制: 缩放到六边形边界 */
+    int32_t span = vmax - vmin;
+    if (span > 32768) {
+        va = (va * 32768) / span;
+        vb = (vb * 32768) / span;
+        vc = (vc * 32768) / span;
+        vmax = (vmax * 32768) / span;
+        vmin = (vmin * 32768) / span;
+    }
+
+    int32_t offset = -((vmax + vmin) >> 1);
+    int32_t half = (int32_t)(ts >> 1);
+    int32_t period = (int32_t)ts;
+
+    fx->CCR1 = (uint32_t)Clamp_I32(half + (((va + offset) * period) >> 15), 0, period);
+    fx->CCR2 = (uint32_t)Clamp_I32(half + (((vb + offset) * period) >> 15), 0, period);
+    fx->CCR3 = (uint32_t)Clamp_I32(half + (((vc + offset) * period) >> 15), 0, period);
+}
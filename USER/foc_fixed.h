@@ -0,0 +1,245 @@
+/**
+ * @file    foc_fixed.h
+ * @brief   定点 (Q15) FOC 电流环流水线
+ * @note    纯算法实现，无硬件依赖，可移植
+ *          流水线各级 (采样换算/Clarke/Park/PI/逆 Park/SVPWM/角度外推) 只用 32 位整数乘法;
+ *          PLL 速度估算、电流目标换算 (FOC_Fixed_FromAmps / FOC_Fixed_SetSpeed) 与外环仍为浮点,
+ *          整机按 Cortex-M4F 设计, 无 FPU 的内核上这些运算走软浮点
+ *          与浮点版 Clarke_Calc / Park_Calc / PI_Calc / InvPark_Calc / SVPWM_Calc 一一对应
+ *
+ *          标幺化约定:
+ *          - 电流: Q15 满量程 = ±2048 ADC LSB, 即 I_q15 = (adc - offset) × 16
+ *          - 电压: Q15 满量程 = Udc
+ *          - 角度: Q16 相位, 65536 = 2π
+ *          - 输出: 定时器计数 (CCR)
+ */
+
+#ifndef __FOC_FIXED_H
+#define __FOC_FIXED_H
+
+#include <stdint.h>
+#include "pid.h"
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#ifndef FOC_USE_FIXED_POINT
+#define FOC_USE_FIXED_POINT     0           // 1=电流环使用定点流水线
+#endif
+
+#define Q15_ONE                 32767
+#define FOC_FIXED_STEP_MAX      (1 << 19)   // 每周期电角度增量上限 (Q20 圈, 半圈)
+#define Q15_ONE_BY_SQRT3        18919       // 1/sqrt(3)
+#define Q15_SQRT3_BY_2          28378       // sqrt(3)/2
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief Q15 PI 控制器
+ */
+typedef struct {
+    int16_t Kp;             // 比例增益 (Q15, 标幺值 < 1)
+    int16_t Ki;             // 积分增益 (Q15, 标幺值 < 1)
+    int32_t Integral;       // 积分累加器 (Q30)
+    int32_t IntegralMax;    // 积分上限 (Q30)
+    int32_t IntegralMin;    // 积分下限 (Q30)
+    int32_t OutMax;         // 输出上限 (Q15)
+    int32_t OutMin;         // 输出下限 (Q15)
+} PI_Q15_t;
+
+/**
+ * @brief 定点电流环流水线
+ */
+typedef struct {
+    /* 标定 */
+    int32_t OffsetU;        // U相 ADC 零点 (1/16 LSB)
+    int32_t OffsetV;        // V相 ADC 零点 (1/16 LSB)
+    float CurrentFS;        // 电流满量程 (A), 仅用于浮点调试输出
+
+    /* 控制器 */
+    PI_Q15_t PI_D;          // d轴电流环
+    PI_Q15_t PI_Q;          // q轴电流环
+
+    /* 中间量 (Q15) */
+    int32_t Iu;             // U相电流
+    int32_t Iv;             // V相电流
+    int32_t IAlpha;         // α轴电流
+    int32_t IBeta;          // β轴电流
+    int32_t Id;             // d轴电流
+    int32_t Iq;             // q轴电流
+    int32_t Vd;             // d轴电压
+    int32_t Vq;             // q轴电压
+    int32_t VAlpha;         // α轴电压
+    int32_t VBeta;          // β轴电压
+    uint16_t Phase;         // Park 电角度 (Q16)
+    uint16_t PhasePwm;      // 逆 Park 电角度 (Q16)
+
+    /* 电角度外推 (系数由 FOC_Fixed_SetExtrap 预先算好, 中断内只做整数乘移位) */
+    float StepGain;         // 机械角速度 (rad/s) → 每周期电角度增量 (Q20 圈)
+    int32_t PhaseStep;      // 每周期电角度增量 (Q20 圈, ±FOC_FIXED_STEP_MAX)
+    int32_t DelayPark;      // Park 外推周期数 (Q8)
+    int32_t DelayPwm;       // 逆 Park 外推周期数 (Q8)
+
+    /* 输出 */
+    uint32_t CCR1;
+    uint32_t CCR2;
+    uint32_t CCR3;
+} FOC_Fixed_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  由浮点 PI 参数初始化定点流水线
+ * @param  fx: 定点流水线指针
+ * @param  pid_d: d轴浮点 PI (增益单位 V/A)
+ * @param  pid_q: q轴浮点 PI
+ * @param  current_fs: 电流满量程 (A), 即 2048 LSB 对应的电流
+ * @param  vdc: 母线电压 (V)
+ * @note   标幺增益 = K × current_fs / vdc, 须小于 1
+ */
+void FOC_Fixed_Init(FOC_Fixed_t *fx, const PID_Controller_t *pid_d,
+                    const PID_Controller_t *pid_q, float current_fs, float vdc);
+
+/**
+ * @brief  运行中由浮点 PI 参数重新换算增益与限幅 (积分状态保留并按新限幅钳位)
+ * @param  fx: 定点流水线指针 (CurrentFS 沿用 FOC_Fixed_Init 的设定)
+ * @param  pid_d: d轴浮点 PI
+ * @param  pid_q: q轴浮点 PI
+ * @param  vdc: 母线电压 (V)
+ * @note   在控制中断上下文调用
+ */
+void FOC_Fixed_UpdateGains(FOC_Fixed_t *fx, const PID_Controller_t *pid_d,
+                           const PID_Controller_t *pid_q, float vdc);
+
+/**
+ * @brief  设置电角度外推系数 (初始化、极对数或外推周期数变化时调用)
+ * @param  fx: 定点流水线指针
+ * @param  pole_pairs: 极对数
+ * @param  dt: 控制周期 (s)
+ * @param  delay_park: Park 外推周期数
+ * @param  delay_pwm: 逆 Park 外推周期数
+ */
+void FOC_Fixed_SetExtrap(FOC_Fixed_t *fx, uint8_t pole_pairs, float dt,
+                         float delay_park, float delay_pwm);
+
+/**
+ * @brief  设置 ADC 零点 (电流偏移校准完成后调用)
+ * @param  fx: 定点流水线指针
+ * @param  offset_u: U相零点 (LSB)
+ * @param  offset_v: V相零点 (LSB)
+ */
+void FOC_Fixed_SetOffset(FOC_Fixed_t *fx, float offset_u, float offset_v);
+
+/**
+ * @brief  ADC 原始值 → 三相电流 (Q15)
+ */
+void FOC_Fixed_Sample(FOC_Fixed_t *fx, uint32_t adc_u, uint32_t adc_v);
+
+/**
+ * @brief  Clarke 变换 (Q15)
+ */
+void Clarke_Q15(FOC_Fixed_t *fx);
+
+/**
+ * @brief  查表计算正弦/余弦 (Q15)
+ * @param  phase: 角度 (Q16)
+ * @param  sin_q15: 输出 sin
+ * @param  cos_q15: 输出 cos
+ */
+void SinCos_Q15(uint16_t phase, int32_t *sin_q15, int32_t *cos_q15);
+
+/**
+ * @brief  Park 变换 (Q15)
+ */
+void Park_Q15(FOC_Fixed_t *fx, int32_t sin_q15, int32_t cos_q15);
+
+/**
+ * @brief  PI 控制器 (Q15, 饱和运算)
+ * @param  pi: PI 控制器指针
+ * @param  ref: 目标值 (Q15)
+ * @param  fdb: 反馈值 (Q15)
+ * @return 控制器输出 (Q15)
+ */
+int32_t PI_Q15_Calc(PI_Q15_t *pi, int32_t ref, int32_t fdb);
+
+/**
+ * @brief  PI 控制器复位
+ */
+void PI_Q15_Reset(PI_Q15_t *pi);
+
+/**
+ * @brief  逆 Park 变换 (Q15)
+ */
+void InvPark_Q15(FOC_Fixed_t *fx, int32_t sin_q15, int32_t cos_q15);
+
+/**
+ * @brief  SVPWM 调制 (Q15 → 定时器计数)
+ * @param  fx: 定点流水线指针
+ * @param  ts: PWM 周期 (ARR 值)
+ * @note   最大/最小值零序注入, 线性区与 SVPWM_Calc 等价; 过调制时按六边形等比缩放
+ *         (即 SVPWM_OVM_MIN_PHASE, 调制比上限 1.0); 不实现断续调制与其他过调制策略,
+ *         定点构建下 FOC_SetPwmMode / FOC_SetOvermodulation 拒绝这些设置
+ */
+void SVPWM_Q15(FOC_Fixed_t *fx, uint32_t ts);
+
+/**
+ * @brief  由速度估算更新每周期电角度增量 (PLL 更新后调用, 供下一周期外推)
+ * @param  omega_mech: 机械角速度 (rad/s)
+ * @note   限幅到半圈每周期 (超过即无法分辨方向), 保证外推乘法不溢出 32 位
+ */
+static inline void FOC_Fixed_SetSpeed(FOC_Fixed_t *fx, float omega_mech)
+{
+    float step = omega_mech * fx->StepGain;
+
+    if (step > (float)FOC_FIXED_STEP_MAX)  step = (float)FOC_FIXED_STEP_MAX;
+    if (step < (float)-FOC_FIXED_STEP_MAX) step = (float)-FOC_FIXED_STEP_MAX;
+    fx->PhaseStep = (int32_t)step;
+}
+
+/**
+ * @brief  电角度外推: phase + PhaseStep × delay (Q20 × Q8 → Q16, 四舍五入, 按 Q16 回绕)
+ * @param  phase: 编码器电角度 (Q16)
+ * @param  delay_q8: 外推周期数 (Q8, 不超过 4 周期), 取 fx->DelayPark / fx->DelayPwm
+ * @note   |PhaseStep| ≤ 2^19, delay ≤ 2^10, 乘积在 32 位内 (单周期 MULS)
+ */
+static inline uint16_t FOC_Fixed_Extrap(const FOC_Fixed_t *fx, uint16_t phase, int32_t delay_q8)
+{
+    return (uint16_t)(phase + ((fx->PhaseStep * delay_q8 + (1 << 11)) >> 12));
+}
+
+/**
+ * @brief  浮点电流 (A) → Q15 (饱和), 外环输出的电流目标换算用
+ */
+static inline int32_t FOC_Fixed_FromAmps(const FOC_Fixed_t *fx, float amps)
+{
+    float q = amps * (32768.0f / fx->CurrentFS);
+
+    if (q > (float)Q15_ONE)  return Q15_ONE;
+    if (q < (float)-Q15_ONE) return -Q15_ONE;
+    return (int32_t)q;
+}
+
+/**
+ * @brief  Q15 → 浮点电流 (A), 调试/遥测用
+ */
+static inline float FOC_Fixed_ToAmps(const FOC_Fixed_t *fx, int32_t i_q15)
+{
+    return (float)i_q15 * (fx->CurrentFS * (1.0f / 32768.0f));
+}
+
+/**
+ * @brief  Q15 → 浮点电压 (V), 调试/遥测用
+ * @param  v_q15: 电压 (Q15, 满量程 = Udc)
+ * @param  vdc: 母线电压 (V)
+ */
+static inline float FOC_Fixed_ToVolts(int32_t v_q15, float vdc)
+{
+    return (float)v_q15 * (vdc * (1.0f / 32768.0f));
+}
+
+#endif /* __FOC_FIXED_H */
@@ -0,0 +1,90 @@
+/**
+ * @file    foc_flash.c
+ * @brief   参数存储 Flash 驱动 (STM32F405 片上 Flash)
+ */
+
+#include "foc_flash.h"
+
+#if !MOTOR_HW_SIM
+
+#include "main.h"
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#define FLASH_BANK0_ADDR        0x080C0000u     // 扇区 10
+#define FLASH_BANK1_ADDR        0x080E0000u     // 扇区 11
+
+static const uint32_t flash_sector[FOC_FLASH_BANKS] = { FLASH_SECTOR_10, FLASH_SECTOR_11 };
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  擦除一块
+ * @note   HAL_FLASHEx_Erase 结束时已刷新指令/数据缓存
+ */
+static uint8_t Flash_Erase(uint8_t bank)
+{
+    FLASH_EraseInitTypeDef erase;
+    uint32_t error = 0;
+    HAL_StatusTypeDef status;
+
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Sector = flash_sector[bank];
+    erase.NbSectors = 1;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;     // 2.7~3.6V, 按字编程
+
+    HAL_FLASH_Unlock();
+    status = HAL_FLASHEx_Erase(&erase, &error);
+    HAL_FLASH_Lock();
+
+    return (status == HAL_OK && error == 0xFFFFFFFFu) ? 1 : 0;
+}
+
+/**
+ * @brief  按字编程
+ * @note   编程前读过的擦除态可能仍在 ART 数据缓存中, 编程后复位数据缓存
+ */
+static uint8_t Flash_Program(uint8_t bank, uint32_t offset, const uint32_t *data, uint32_t words)
+{
+    uint32_t addr = (bank == 0 ? FLASH_BANK0_ADDR : FLASH_BANK1_ADDR) + offset;
+    uint8_t ok = 1;
+
+    HAL_FLASH_Unlock();
+    for (uint32_t i = 0; i < words; i++) {
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, addr + 4u * i, data[i]) != HAL_OK) {
+            ok = 0;
+            break;
+        }
+    }
+    HAL_FLASH_Lock();
+
+    __HAL_FLASH_DATA_CACHE_DISABLE();
+    __HAL_FLASH_DATA_CACHE_RESET();
+    __HAL_FLASH_DATA_CACHE_ENABLE();
+    return ok;
+}
+
+/*============================================================================*/
+/*                              驱动实例                                       */
+/*============================================================================*/
+
+static const FOC_Flash_t flash_drv = {
+    { (const uint32_t *)FLASH_BANK0_ADDR, (const uint32_t *)FLASH_BANK1_ADDR },
+    FOC_FLASH_BANK_SIZE,
+    Flash_Erase,
+    Flash_Program,
+};
+
+/**
+ * @brief  取板级 Flash 驱动
+ */
+const FOC_Flash_t *FOC_Flash_Get(void)
+{
+    return &flash_drv;
+}
+
+#endif /* !MOTOR_HW_SIM */
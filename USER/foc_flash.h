@@ -0,0 +1,99 @@
+/**
+ * @file    foc_flash.h
+ * @brief   参数存储 Flash 驱动接口
+ * @note    参数存储 (foc_store) 只通过本接口访问 Flash, 读取直接访问映射地址:
+ *            - 目标板: STM32F405 扇区 10/11 (0x080C0000 / 0x080E0000, 各 128 KB) 作为 A/B 两块,
+ *                      工程 IROM1 大小须限制在 0xC0000 以内, 程序不得占用这两个扇区
+ *            - 仿真 (MOTOR_HW_SIM = 1): RAM 模拟, 编程只能把 1 写成 0, 可注入掉电
+ *          擦除 128 KB 扇区约 1~2 s, 期间从 Flash 取指的代码 (包括控制中断) 全部停顿,
+ *          只能在电机停止时写入
+ */
+
+#ifndef __FOC_FLASH_H
+#define __FOC_FLASH_H
+
+#include <stdint.h>
+
+#ifndef MOTOR_HW_SIM
+#define MOTOR_HW_SIM            0
+#endif
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#define FOC_FLASH_BANKS         2                   // A/B 两块
+#define FOC_FLASH_BANK_SIZE     (128u * 1024u)      // 每块字节数 (一个扇区)
+#define FOC_FLASH_ERASED        0xFFFFFFFFu         // 擦除后的字
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief Flash 驱动
+ */
+typedef struct {
+    const uint32_t *Base[FOC_FLASH_BANKS];  // 各块映射地址 (只读访问)
+    uint32_t BankSize;                      // 每块字节数
+
+    /**
+     * @brief  擦除一块
+     * @return 1=成功, 0=失败
+     */
+    uint8_t (*Erase)(uint8_t bank);
+
+    /**
+     * @brief  按字编程 (目标区域须已擦除)
+     * @param  offset: 块内字节偏移 (4 字节对齐)
+     * @return 1=成功, 0=失败
+     */
+    uint8_t (*Program)(uint8_t bank, uint32_t offset, const uint32_t *data, uint32_t words);
+} FOC_Flash_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  取板级 Flash 驱动
+ */
+const FOC_Flash_t *FOC_Flash_Get(void);
+
+#if MOTOR_HW_SIM
+
+/**
+ * @brief 仿真 Flash 统计
+ */
+typedef struct {
+    uint32_t Erases[FOC_FLASH_BANKS];   // 各块擦除次数
+    uint32_t Words;                     // 已编程字数
+    uint32_t OverPrograms;              // 对未擦除字编程的次数 (应为 0)
+    uint32_t PowerCuts;                 // 已发生的掉电次数
+} FOC_FlashSim_Stats_t;
+
+/**
+ * @brief  整片擦除并清除掉电注入与统计
+ */
+void FOC_FlashSim_Reset(void);
+
+/**
+ * @brief  注入掉电: 再执行 ops 次操作 (每编程一字或每次擦除计一次) 后掉电
+ * @note   掉电时正在编程的字只写入部分位, 正在擦除的块只擦除部分字;
+ *         掉电后所有操作失败, 直到 FOC_FlashSim_PowerOn
+ */
+void FOC_FlashSim_PowerCut(uint32_t ops);
+
+/**
+ * @brief  重新上电 (取消未触发的掉电注入)
+ */
+void FOC_FlashSim_PowerOn(void);
+
+/**
+ * @brief  读取统计
+ */
+const FOC_FlashSim_Stats_t *FOC_FlashSim_GetStats(void);
+
+#endif /* MOTOR_HW_SIM */
+
+#endif /* __FOC_FLASH_H */
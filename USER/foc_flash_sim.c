@@ -0,0 +1,164 @@
+/**
+ * @file    foc_flash_sim.c
+ * @brief   参数存储 Flash 驱动仿真后端
+ * @note    MOTOR_HW_SIM = 1 时替代 foc_flash.c, 以 RAM 模拟 A/B 两块 Flash:
+ *          擦除置全 1, 编程按位与 (只能把 1 写成 0), 可按操作计数注入掉电
+ */
+
+#include "foc_flash.h"
+
+#if MOTOR_HW_SIM
+
+#include <string.h>
+
+/*============================================================================*/
+/*                              私有变量                                       */
+/*============================================================================*/
+
+static uint32_t sim_mem[FOC_FLASH_BANKS][FOC_FLASH_BANK_SIZE / 4];
+static FOC_FlashSim_Stats_t sim_stats;
+static uint32_t sim_cut_ops = 0;            // 距掉电剩余操作数
+static uint8_t sim_cut_armed = 0;           // 1=已注入掉电
+static uint8_t sim_dead = 0;                // 1=已掉电
+static uint32_t sim_rand = 0x12345678u;     // 部分写入/擦除的伪随机位
+static uint8_t sim_ready = 0;               // 1=已初始化为擦除态
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  伪随机数 (xorshift32)
+ */
+static uint32_t Sim_Rand(void)
+{
+    sim_rand ^= sim_rand << 13;
+    sim_rand ^= sim_rand >> 17;
+    sim_rand ^= sim_rand << 5;
+    return sim_rand;
+}
+
+/**
+ * @brief  消耗一次操作
+ * @return 1=本次操作被掉电打断
+ */
+static uint8_t Sim_Tick(void)
+{
+    if (!sim_cut_armed) return 0;
+    if (sim_cut_ops > 0) {
+        sim_cut_ops--;
+        return 0;
+    }
+    sim_cut_armed = 0;
+    sim_dead = 1;
+    sim_stats.PowerCuts++;
+    return 1;
+}
+
+/**
+ * @brief  擦除一块
+ */
+static uint8_t Sim_Erase(uint8_t bank)
+{
+    if (sim_dead || bank >= FOC_FLASH_BANKS) return 0;
+
+    if (Sim_Tick()) {
+        /* 擦除被打断: 部分字已擦除 */
+        for (uint32_t i = 0; i < FOC_FLASH_BANK_SIZE / 4; i++) {
+            if (Sim_Rand() & 1u) sim_mem[bank][i] = FOC_FLASH_ERASED;
+        }
+        return 0;
+    }
+
+    memset(sim_mem[bank], 0xFF, FOC_FLASH_BANK_SIZE);
+    sim_stats.Erases[bank]++;
+    return 1;
+}
+
+/**
+ * @brief  按字编程
+ */
+static uint8_t Sim_Program(uint8_t bank, uint32_t offset, const uint32_t *data, uint32_t words)
+{
+    if (sim_dead || bank >= FOC_FLASH_BANKS || (offset & 3u)
+        || offset + 4u * words > FOC_FLASH_BANK_SIZE) return 0;
+
+    uint32_t *p = &sim_mem[bank][offset / 4];
+    for (uint32_t i = 0; i < words; i++) {
+        if (Sim_Tick()) {
+            /* 编程被打断: 只有部分位写成 0 */
+            p[i] &= data[i] | Sim_Rand();
+            return 0;
+        }
+        if (p[i] != FOC_FLASH_ERASED) sim_stats.OverPrograms++;
+        p[i] &= data[i];
+        sim_stats.Words++;
+    }
+    return 1;
+}
+
+/*============================================================================*/
+/*                              驱动实例                                       */
+/*============================================================================*/
+
+static const FOC_Flash_t flash_drv = {
+    { sim_mem[0], sim_mem[1] },
+    FOC_FLASH_BANK_SIZE,
+    Sim_Erase,
+    Sim_Program,
+};
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  取板级 Flash 驱动 (首次调用时整片擦除, 模拟出厂空片)
+ */
+const FOC_Flash_t *FOC_Flash_Get(void)
+{
+    if (!sim_ready) {
+        FOC_FlashSim_Reset();
+    }
+    return &flash_drv;
+}
+
+/**
+ * @brief  整片擦除并清除掉电注入与统计
+ */
+void FOC_FlashSim_Reset(void)
+{
+    memset(sim_mem, 0xFF, sizeof(sim_mem));
+    memset(&sim_stats, 0, sizeof(sim_stats));
+    sim_cut_armed = 0;
+    sim_dead = 0;
+    sim_ready = 1;
+}
+
+/**
+ * @brief  注入掉电
+ */
+void FOC_FlashSim_PowerCut(uint32_t ops)
+{
+    sim_cut_ops = ops;
+    sim_cut_armed = 1;
+}
+
+/**
+ * @brief  重新上电
+ */
+void FOC_FlashSim_PowerOn(void)
+{
+    sim_cut_armed = 0;
+    sim_dead = 0;
+}
+
+/**
+ * @brief  读取统计
+ */
+const FOC_FlashSim_Stats_t *FOC_FlashSim_GetStats(void)
+{
+    return &sim_stats;
+}
+
+#endif /* MOTOR_HW_SIM */
@@ -0,0 +1,502 @@
+/**
+ * @file    foc_link.c
+ * @brief   上位机命令链路实现
+ */
+
+#include "foc_link.h"
+#include "foc_core.h"
+#include "foc_scope.h"
+#include "foc_param.h"
+#include "vofa.h"
+#include "usb_vcp.h"
+
+/*============================================================================*/
+/*                              私有变量                                       */
+/*============================================================================*/
+
+static Proto_Parser_t link_parser;
+static uint8_t link_tx[PROTO_MAX_FRAME];
+
+static uint8_t link_live_enable = 1;            // 实时数据开关
+static uint16_t link_live_period = 0;           // 实时数据周期 (ms, 0=每次主循环)
+static uint32_t link_live_last = 0;             // 上次发送时刻 (ms)
+
+static Telem_Config_t link_telem_cfg;           // 暂存遥测配置 (TELEM_CHAN 修改, TELEM_APPLY 生效)
+static Telem_Encoder_t link_telem;              // 遥测编码器 (Mask=0 时发送 VOFA JustFloat)
+static uint8_t link_telem_seq = 0;              // 遥测帧计数
+static uint32_t link_telem_tick = 0;            // 上次编码的调试数据帧序号
+static FOC_LinkStats_t link_stats;              // 实时数据帧统计
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  发送一帧应答
+ * @return 1=已入队, 0=发送队列满被丢弃
+ */
+static uint8_t Link_Reply(uint8_t type, uint8_t seq, const uint8_t *payload, uint32_t len)
+{
+    uint32_t n = Proto_Encode(link_tx, type, seq, payload, len);
+    return VCP_SendData(link_tx, (uint16_t)n) ? 1 : 0;
+}
+
+/**
+ * @brief  统计一帧实时数据的发送结果
+ */
+static void Link_CountFrame(uint8_t sent)
+{
+    link_stats.Frames++;
+    if (!sent) link_stats.Dropped++;
+}
+
+/**
+ * @brief  取轴对应的电机对象
+ */
+static Motor_t *Link_Motor(uint8_t axis)
+{
+    return (axis < HW_AXIS_COUNT) ? &g_Motors[axis] : NULL;
+}
+
+/**
+ * @brief  使能/停止
+ */
+static uint8_t Link_Enable(const Proto_Frame_t *f)
+{
+    if (f->Len != 2) return PROTO_ERR_LENGTH;
+
+    Motor_t *motor = Link_Motor(f->Payload[0]);
+    if (motor == NULL) return PROTO_ERR_ARG;
+
+    if (f->Payload[1]) {
+        if (motor->State == MOTOR_STATE_CALIBRATING) return PROTO_ERR_BUSY;
+        FOC_Start(motor);
+    } else {
+        FOC_Stop(motor);
+    }
+    return PROTO_OK;
+}
+
+/**
+ * @brief  开始编码器校准
+ */
+static uint8_t Link_Calibrate(const Proto_Frame_t *f)
+{
+    if (f->Len != 1 && f->Len != 2) return PROTO_ERR_LENGTH;
+
+    Motor_t *motor = Link_Motor(f->Payload[0]);
+    uint8_t kind = (f->Len == 2) ? f->Payload[1] : 0;
+    if (motor == NULL || kind > 1) return PROTO_ERR_ARG;
+
+    uint8_t started = (kind == 0) ? FOC_StartEncoderCalib(motor) : FOC_StartEncoderLin(motor);
+    return started ? PROTO_OK : PROTO_ERR_BUSY;
+}
+
+/**
+ * @brief  设置目标值 (SET_MODE 为只带模式的 SET_TARGET)
+ */
+static uint8_t Link_SetTarget(const Proto_Frame_t *f)
+{
+    static const uint8_t float_fields[] = { FOC_CMD_ID, FOC_CMD_IQ, FOC_CMD_RPM, FOC_CMD_POS };
+    const uint8_t *p = f->Payload;
+    FOC_Command_t cmd;
+    uint8_t mask;
+    uint32_t need;
+
+    if (f->Type == PROTO_MSG_SET_MODE) {
+        if (f->Len != 2) return PROTO_ERR_LENGTH;
+        mask = FOC_CMD_MODE;
+        p += 1;
+    } else {
+        if (f->Len < 2) return PROTO_ERR_LENGTH;
+        mask = f->Payload[1];
+        p += 2;
+    }
+
+    Motor_t *motor = Link_Motor(f->Payload[0]);
+    if (motor == NULL || mask == 0 || (mask & ~FOC_CMD_ALL)) return PROTO_ERR_ARG;
+
+    /* 校验长度后再读取负载 */
+    need = (uint32_t)(p - f->Payload) + ((mask & FOC_CMD_MODE) ? 1u : 0u);
+    for (uint8_t k = 0; k < sizeof(float_fields); k++) {
+        if (mask & float_fields[k]) need += sizeof(float);
+    }
+    if (f->Len != need) return PROTO_ERR_LENGTH;
+
+    if (mask & FOC_CMD_MODE) {
+        if (*p > FOC_MODE_OPENLOOP) return PROTO_ERR_ARG;
+        cmd.Mode = *p++;
+    }
+    if (mask & FOC_CMD_ID)  { cmd.TargetId  = Proto_GetF32(p); p += 4; }
+    if (mask & FOC_CMD_IQ)  { cmd.TargetIq  = Proto_GetF32(p); p += 4; }
+    if (mask & FOC_CMD_RPM) { cmd.TargetRPM = Proto_GetF32(p); p += 4; }
+    if (mask & FOC_CMD_POS) { cmd.TargetPosCnt = FOC_PosRadToCnt(Proto_GetF32(p)); p += 4; }
+
+    return FOC_SetCommand(motor, mask, &cmd) ? PROTO_OK : PROTO_ERR_BUSY;
+}
+
+/**
+ * @brief  参数表结果转换为 ACK 状态码
+ */
+static uint8_t Link_ParamStatus(FOC_ParamStatus_t status)
+{
+    switch (status) {
+        case FOC_PARAM_OK:          return PROTO_OK;
+        case FOC_PARAM_ERR_BUSY:    return PROTO_ERR_BUSY;
+        case FOC_PARAM_ERR_FLASH:   return PROTO_ERR_FLASH;
+        default:                    return PROTO_ERR_ARG;
+    }
+}
+
+/**
+ * @brief  读取参数 (成功时直接回复 PARAM)
+ */
+static uint8_t Link_GetParam(const Proto_Frame_t *f)
+{
+    uint8_t out[7];
+    float value;
+
+    if (f->Len != 3) return PROTO_ERR_LENGTH;
+
+    Motor_t *motor = Link_Motor(f->Payload[0]);
+    uint16_t id = Proto_GetU16(&f->Payload[1]);
+    if (FOC_Param_Get(motor, id, &value) != FOC_PARAM_OK) return PROTO_ERR_ARG;
+
+    memcpy(out, f->Payload, 3);
+    Proto_PutF32(&out[3], value);
+    Link_Reply(PROTO_MSG_PARAM, f->Seq, out, sizeof(out));
+    return PROTO_OK;
+}
+
+/**
+ * @brief  写入参数 (校验后排队, 在参数所属的控制周期边界生效)
+ */
+static uint8_t Link_SetParam(const Proto_Frame_t *f)
+{
+    if (f->Len != 7) return PROTO_ERR_LENGTH;
+
+    Motor_t *motor = Link_Motor(f->Payload[0]);
+    uint16_t id = Proto_GetU16(&f->Payload[1]);
+    float value = Proto_GetF32(&f->Payload[3]);
+    return Link_ParamStatus(FOC_Param_Set(motor, id, value));
+}
+
+/**
+ * @brief  查询参数描述 (成功时直接回复 PARAM_INFO)
+ */
+static uint8_t Link_ParamQuery(const Proto_Frame_t *f)
+{
+    uint8_t out[PROTO_MAX_PAYLOAD];
+    uint32_t len;
+
+    if (f->Len != 2) return PROTO_ERR_LENGTH;
+
+    uint16_t id = Proto_GetU16(f->Payload);
+    const FOC_ParamDesc_t *d = FOC_Param_Desc(id);
+    if (d == NULL) return PROTO_ERR_ARG;
+
+    Proto_PutU16(&out[0], id);
+    Proto_PutU16(&out[2], FOC_PARAM_COUNT);
+    out[4] = d->Type;
+    out[5] = d->Access;
+    Proto_PutF32(&out[6], d->Min);
+    Proto_PutF32(&out[10], d->Max);
+    len = strlen(d->Name);
+    if (len > sizeof(out) - 14) len = sizeof(out) - 14;
+    memcpy(&out[14], d->Name, len);
+    Link_Reply(PROTO_MSG_PARAM_INFO, f->Seq, out, 14 + len);
+    return PROTO_OK;
+}
+
+/**
+ * @brief  订阅参数到遥测通道
+ */
+static uint8_t Link_ParamSub(const Proto_Frame_t *f)
+{
+    if (f->Len != 3) return PROTO_ERR_LENGTH;
+    return Link_ParamStatus(FOC_Param_Subscribe(f->Payload[0], Proto_GetU16(&f->Payload[1])));
+}
+
+/**
+ * @brief  实时数据控制
+ */
+static uint8_t Link_Stream(const Proto_Frame_t *f)
+{
+    if (f->Len != 3) return PROTO_ERR_LENGTH;
+
+    link_live_enable = f->Payload[0] ? 1 : 0;
+    link_live_period = Proto_GetU16(&f->Payload[1]);
+    return PROTO_OK;
+}
+
+/**
+ * @brief  示波器布防
+ */
+static uint8_t Link_ScopeArm(const Proto_Frame_t *f)
+{
+    const uint8_t *p = f->Payload;
+    FOC_ScopeConfig_t cfg;
+
+    if (f->Len < 1 || p[0] == 0 || p[0] > FOC_SCOPE_MAX_CH) return PROTO_ERR_ARG;
+    if (f->Len != 1u + p[0] + 5u + 2u + 4u) return PROTO_ERR_LENGTH;
+
+    FOC_Scope_DefaultConfig(&cfg);
+    cfg.ChannelCnt = *p++;
+    memcpy(cfg.Channels, p, cfg.ChannelCnt);
+    p += cfg.ChannelCnt;
+    cfg.Decimation = *p++;
+    cfg.Trigger = *p++;
+    cfg.TrigChannel = *p++;
+    cfg.TrigEdge = *p++;
+    cfg.AutoRearm = *p++;
+    cfg.PreTrigger = Proto_GetU16(p);
+    cfg.TrigLevel = Proto_GetF32(p + 2);
+
+    FOC_ScopeState_t state = FOC_Scope_GetState();
+    if (state != FOC_SCOPE_IDLE && state != FOC_SCOPE_DONE) return PROTO_ERR_BUSY;
+    return FOC_Scope_Arm(&cfg) ? PROTO_OK : PROTO_ERR_ARG;
+}
+
+/**
+ * @brief  暂存遥测通道配置
+ */
+static uint8_t Link_TelemChannel(const Proto_Frame_t *f)
+{
+    const uint8_t *p = f->Payload;
+
+    if (f->Len != 8) return PROTO_ERR_LENGTH;
+    if (p[0] >= VOFA_CHANNEL_CNT || p[1] > TELEM_FMT_I16 || p[2] == 0) return PROTO_ERR_ARG;
+
+    Telem_ChannelCfg_t *ch = &link_telem_cfg.Ch[p[0]];
+    float scale = Proto_GetF32(&p[4]);
+    if (p[1] == TELEM_FMT_I16 && !(scale > 0.0f)) return PROTO_ERR_ARG;
+
+    ch->Format = p[1];
+    ch->Div = p[2];
+    ch->Delta = p[3] ? 1 : 0;
+    ch->Scale = scale;
+    return PROTO_OK;
+}
+
+/**
+ * @brief  遥测帧输出
+ */
+static void Link_TelemOutput(const uint8_t *payload, uint32_t len, void *user)
+{
+    (void)user;
+    Link_CountFrame(Link_Reply(PROTO_MSG_TELEM, link_telem_seq++, payload, len));
+}
+
+/**
+ * @brief  回复实时数据统计
+ */
+static void Link_TelemStats(const Proto_Frame_t *f)
+{
+    uint8_t p[16];
+
+    Proto_PutU32(&p[0], VOFA_AcquireFrame()->Tick);
+    Proto_PutU32(&p[4], link_stats.Frames);
+    Proto_PutU32(&p[8], link_stats.Dropped);
+    Proto_PutU32(&p[12], HW_PWM_FREQ_HZ);
+    Link_Reply(PROTO_MSG_TELEM_STATS, f->Seq, p, sizeof(p));
+}
+
+/**
+ * @brief  发送 VOFA JustFloat 帧 (末尾追加节拍号与帧序号)
+ */
+static void Link_SendVofa(const VOFA_Frame_t *frame)
+{
+    float data[FOC_LINK_VOFA_CH + 2];
+
+    memcpy(data, frame->Data, FOC_LINK_VOFA_CH * sizeof(float));
+    data[FOC_LINK_VOFA_CH] = (float)(frame->Tick & FOC_LINK_VOFA_STAMP_MASK);
+    data[FOC_LINK_VOFA_CH + 1] = (float)(link_stats.Frames & FOC_LINK_VOFA_STAMP_MASK);
+    Link_CountFrame(VOFA_Send_JustFloat(data, FOC_LINK_VOFA_CH + 2));
+}
+
+/**
+ * @brief  启用暂存的遥测配置 (丢弃未发送的记录)
+ */
+static uint8_t Link_TelemApply(const Proto_Frame_t *f)
+{
+    if (f->Len != 5) return PROTO_ERR_LENGTH;
+
+    uint32_t mask = Proto_GetU32(&f->Payload[0]);
+    if (mask >> VOFA_CHANNEL_CNT) return PROTO_ERR_ARG;
+
+    link_telem_cfg.Mask = mask;
+    link_telem_cfg.Id = f->Payload[4];
+    Telem_EncoderInit(&link_telem, &link_telem_cfg, Link_TelemOutput, NULL);
+    return PROTO_OK;
+}
+
+/**
+ * @brief  实时数据是否到发送时刻
+ */
+static uint8_t Link_LiveDue(uint32_t now_ms)
+{
+    if (!link_live_enable) return 0;
+    if (link_live_period == 0) return 1;
+    if (now_ms - link_live_last < link_live_period) return 0;
+
+    link_live_last = now_ms;
+    return 1;
+}
+
+/**
+ * @brief  帧处理回调
+ */
+static void Link_Handle(const Proto_Frame_t *f, void *user)
+{
+    uint8_t status;
+    (void)user;
+
+    switch (f->Type) {
+        case PROTO_MSG_PING:
+            status = PROTO_OK;
+            break;
+        case PROTO_MSG_ENABLE:
+            status = Link_Enable(f);
+            break;
+        case PROTO_MSG_CALIBRATE:
+            status = Link_Calibrate(f);
+            break;
+        case PROTO_MSG_SET_MODE:
+        case PROTO_MSG_SET_TARGET:
+            status = Link_SetTarget(f);
+            break;
+        case PROTO_MSG_GET_PARAM:
+            status = Link_GetParam(f);
+            if (status == PROTO_OK) return;     // 已回复 PARAM
+            break;
+        case PROTO_MSG_SET_PARAM:
+            status = Link_SetParam(f);
+            break;
+        case PROTO_MSG_PARAM_QUERY:
+            status = Link_ParamQuery(f);
+            if (status == PROTO_OK) return;     // 已回复 PARAM_INFO
+            break;
+        case PROTO_MSG_PARAM_SUB:
+            status = Link_ParamSub(f);
+            break;
+        case PROTO_MSG_PARAM_SAVE:
+            status = (f->Len == 0) ? Link_ParamStatus(FOC_Param_Save()) : PROTO_ERR_LENGTH;
+            break;
+        case PROTO_MSG_STREAM:
+            status = Link_Stream(f);
+            break;
+        case PROTO_MSG_SCOPE_ARM:
+            status = Link_ScopeArm(f);
+            break;
+        case PROTO_MSG_SCOPE_STOP:
+            FOC_Scope_Stop();
+            status = PROTO_OK;
+            break;
+        case PROTO_MSG_SCOPE_FORCE:
+            FOC_Scope_ForceTrigger();
+            status = PROTO_OK;
+            break;
+        case PROTO_MSG_TELEM_CHAN:
+            status = Link_TelemChannel(f);
+            break;
+        case PROTO_MSG_TELEM_APPLY:
+            status = Link_TelemApply(f);
+            break;
+        case PROTO_MSG_TELEM_STATS:
+            if (f->Len != 0) {
+                status = PROTO_ERR_LENGTH;
+                break;
+            }
+            Link_TelemStats(f);
+            return;
+        default:
+            status = PROTO_ERR_TYPE;
+            break;
+    }
+
+    uint8_t ack[2] = { f->Type, status };
+    Link_Reply(PROTO_MSG_ACK, f->Seq, ack, sizeof(ack));
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化命令链路
+ */
+void FOC_Link_Init(void)
+{
+    Proto_ParserInit(&link_parser);
+    link_live_enable = 1;
+    link_live_period = 0;
+    link_live_last = 0;
+    
+    Telem_DefaultConfig(&link_telem_cfg);
+    Telem_EncoderInit(&link_telem, &link_telem_cfg, Link_TelemOutput, NULL);
+}
+
+/**
+ * @brief  处理已接收的命令
+ */
+void FOC_Link_Poll(void)
+{
+    const uint8_t *buf;
+    uint32_t len = VCP_RxPeek(&buf);
+
+    if (len == 0) return;
+
+    Proto_Feed(&link_parser, buf, len, Link_Handle, NULL);
+    VCP_RxRelease();
+}
+
+/**
+ * @brief  发送实时数据
+ */
+void FOC_Link_Telemetry(uint32_t now_ms)
+{
+    if (link_telem.Cfg.Mask == 0) {
+        if (Link_LiveDue(now_ms)) {
+            Link_SendVofa(VOFA_AcquireFrame());
+        }
+        return;
+    }
+
+    /* 不以队列满丢帧为代价空转编码: 放不下一帧时不采样 */
+    if (link_live_period == 0 && VCP_TxFree() < PROTO_MAX_FRAME) return;
+
+    /* 以控制周期为单位采样: 控制中断尚未发布新帧时不重复编码 */
+    const VOFA_Frame_t *frame = VOFA_AcquireFrame();
+    if (link_live_period == 0 && frame->Tick == link_telem_tick) return;
+    if (!Link_LiveDue(now_ms)) return;
+
+    link_telem_tick = frame->Tick;
+    Telem_Encode(&link_telem, frame->Tick, frame->Data);
+    if (link_live_period != 0) {
+        Telem_Flush(&link_telem);
+    }
+}
+
+/**
+ * @brief  读取解析器统计
+ */
+const Proto_Parser_t *FOC_Link_GetParser(void)
+{
+    return &link_parser;
+}
+
+/**
+ * @brief  读取实时数据帧统计
+ */
+const FOC_LinkStats_t *FOC_Link_GetStats(void)
+{
+    return &link_stats;
+}
+
+/**
+ * @brief  读取遥测编码器统计
+ */
+const Telem_Encoder_t *FOC_Link_GetTelem(void)
+{
+    return &link_telem;
+}
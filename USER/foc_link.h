@@ -0,0 +1,75 @@
+/**
+ * @file    foc_link.h
+ * @brief   上位机命令链路 (USB CDC 二进制协议分发)
+ * @note    在主循环中运行, 不占用 USB 中断:
+ *          接收包在 UserRxBufferFS 内原地解析 (foc_proto), 命令经邮箱交给控制中断,
+ *          应答经 USB 发送队列返回
+ *          主循环各步均不阻塞, 命令从到达到被控制中断取用远小于一个外环周期 (1ms)
+ */
+
+#ifndef __FOC_LINK_H
+#define __FOC_LINK_H
+
+#include <stdint.h>
+#include "foc_proto.h"
+#include "foc_telem.h"
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#define FOC_LINK_VOFA_CH            23          // VOFA 模式发送的调试通道数 (不含订阅通道)
+#define FOC_LINK_VOFA_STAMP_MASK    0xFFFFFFu   // 追加的节拍号/帧序号取低 24 位 (float 可精确表示)
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 实时数据帧统计 (VOFA 与遥测帧合计)
+ */
+typedef struct {
+    uint32_t Frames;            // 已生成的帧数 (即下一帧的帧序号)
+    uint32_t Dropped;           // 其中因发送队列满被丢弃的帧数
+} FOC_LinkStats_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化命令链路
+ */
+void FOC_Link_Init(void);
+
+/**
+ * @brief  处理已接收的命令 (主循环调用)
+ */
+void FOC_Link_Poll(void);
+
+/**
+ * @brief  发送实时数据 (主循环调用)
+ * @note   开关与周期由 PROTO_MSG_STREAM 控制; 未启用遥测通道时发送 VOFA JustFloat
+ *         (23 个调试通道 + 节拍号 + 帧序号), 启用后按 foc_telem 紧凑编码发送所选通道
+ *         每帧都带控制周期节拍号与帧序号, 上位机据此重建时间轴并统计丢帧 (foc_timeline)
+ *         周期为 0 时以发送队列空闲为节拍, 记录攒满一帧再发送; 周期非 0 时每条记录立即发送
+ * @param  now_ms: 当前时间 (ms)
+ */
+void FOC_Link_Telemetry(uint32_t now_ms);
+
+/**
+ * @brief  读取解析器统计
+ */
+const Proto_Parser_t *FOC_Link_GetParser(void);
+
+/**
+ * @brief  读取实时数据帧统计
+ */
+const FOC_LinkStats_t *FOC_Link_GetStats(void);
+
+/**
+ * @brief  读取遥测编码器统计
+ */
+const Telem_Encoder_t *FOC_Link_GetTelem(void);
+
+#endif /* __FOC_LINK_H */
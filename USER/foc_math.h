@@ -19,6 +19,8 @@
 #define FOC_SQRT3_BY_2      0.86602540378f      // sqrt(3) / 2
 #define FOC_ONE_BY_SQRT3    0.57735026919f      // 1 / sqrt(3)
 
+#define FOC_SINCOS_TABLE_SIZE   512             // 正弦表点数 (2 的幂)
+
 /*============================================================================*/
 /*                              数据结构                                       */
 /*============================================================================*/
@@ -69,6 +71,14 @@ typedef struct {
     float Beta;
 } InvPark_t;
 
+/**
+ * @brief 正弦/余弦对 (同一角度, Park 与逆 Park 共用)
+ */
+typedef struct {
+    float Sin;
+    float Cos;
+} SinCos_t;
+
 /**
  * @brief 逆 Clarke 变换结构体 (αβ → abc)
  */
@@ -111,6 +121,27 @@ void Park_Calc(Park_t *park);
  */
 void InvPark_Calc(InvPark_t *invpark);
 
+/**
+ * @brief  查表计算正弦/余弦 (一次求值, 供 Park/逆 Park 共用)
+ * @param  theta: 角度 (rad)
+ * @param  sc: 输出 sin/cos
+ */
+void FOC_SinCos(float theta, SinCos_t *sc);
+
+/**
+ * @brief  Park 变换 (使用预计算的 sin/cos, 忽略 park->Theta)
+ * @param  park: Park 结构体指针
+ * @param  sc: 转子电角度的 sin/cos
+ */
+void Park_CalcSinCos(Park_t *park, const SinCos_t *sc);
+
+/**
+ * @brief  逆 Park 变换 (使用预计算的 sin/cos, 忽略 invpark->Theta)
+ * @param  invpark: InvPark 结构体指针
+ * @param  sc: 转子电角度的 sin/cos
+ */
+void InvPark_CalcSinCos(InvPark_t *invpark, const SinCos_t *sc);
+
 /**
  * @brief  逆 Clarke 变换
  * @param  invclarke: InvClarke 结构体指针
@@ -0,0 +1,504 @@
+/**
+ * @file    foc_param.c
+ * @brief   运行时参数表实现
+ */
+
+#include "foc_param.h"
+#include "foc_atomic.h"
+#include "foc_store.h"
+#include <stddef.h>
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 一次待生效的写入
+ */
+typedef struct {
+    uint16_t Id;                // 参数号
+    float Value;                // 已校验的新值
+} Param_Write_t;
+
+/**
+ * @brief 写入队列 (单写单读环形队列)
+ */
+typedef struct {
+    Param_Write_t Buf[FOC_PARAM_QUEUE_LEN];
+    volatile uint32_t Head;     // 已写入数 (写端: 主循环)
+    volatile uint32_t Tail;     // 已生效数 (读端: 生效上下文)
+} Param_Queue_t;
+
+/**
+ * @brief 保存镜像头 (其后每轴一组 [Param_ImageAxis_t][float × ParamCount], 再其后每轴一个 Param_ImageLin_t)
+ */
+typedef struct {
+    uint16_t ParamCount;        // 保存时的参数表长度 (加载时只取双方都有的参数号)
+    uint16_t AxisCount;         // 保存时的轴数
+} Param_ImageHead_t;
+
+/**
+ * @brief 保存镜像中每轴的标定数据
+ */
+typedef struct {
+    float CurOffset[3];         // U/V/W 相电流零点 (LSB)
+    uint32_t CurValid;          // 1=电流零点已校准
+} Param_ImageAxis_t;
+
+/**
+ * @brief 保存镜像中每轴的编码器补偿表 (追加在参数之后, 旧记录中没有时不加载)
+ */
+typedef struct {
+    int16_t Table[ENC_LIN_SIZE + 1];    // 补偿表
+    uint16_t Valid;                     // 1=补偿表有效
+} Param_ImageLin_t;
+
+#define PARAM_IMAGE_STRIDE      (sizeof(Param_ImageAxis_t) + FOC_PARAM_COUNT * sizeof(float))
+#define PARAM_IMAGE_LIN         (sizeof(Param_ImageHead_t) + HW_AXIS_COUNT * PARAM_IMAGE_STRIDE)
+#define PARAM_IMAGE_SIZE        (PARAM_IMAGE_LIN + HW_AXIS_COUNT * sizeof(Param_ImageLin_t))
+
+/*============================================================================*/
+/*                              同步函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  电流环增益变化: 重新换算定点电流环
+ */
+static void Param_SyncCurrentGains(Motor_t *motor)
+{
+#if FOC_USE_FIXED_POINT
+    FOC_Fixed_UpdateGains(&motor->Fixed, &motor->PID_Id, &motor->PID_Iq, motor->Vdc);
+#else
+    (void)motor;
+#endif
+}
+
+/**
+ * @brief  积分器收回到新的积分限幅内 (限幅缩小时, 同 FOC_Fixed_UpdateGains)
+ */
+static void Param_ClampIntegral(PID_Controller_t *pid)
+{
+    if (pid->Integral > pid->IntegralMax) pid->Integral = pid->IntegralMax;
+    if (pid->Integral < pid->IntegralMin) pid->Integral = pid->IntegralMin;
+}
+
+/**
+ * @brief  电压限幅变化: d/q 轴输出与积分限幅对称同步
+ */
+static void Param_SyncVoltLimit(Motor_t *motor)
+{
+    float limit = motor->PID_Id.OutMax;
+
+    motor->PID_Id.OutMin = -limit;
+    motor->PID_Id.IntegralMax = limit;
+    motor->PID_Id.IntegralMin = -limit;
+    motor->PID_Iq.OutMax = limit;
+    motor->PID_Iq.OutMin = -limit;
+    motor->PID_Iq.IntegralMax = limit;
+    motor->PID_Iq.IntegralMin = -limit;
+    Param_ClampIntegral(&motor->PID_Id);
+    Param_ClampIntegral(&motor->PID_Iq);
+    Param_SyncCurrentGains(motor);
+}
+
+/**
+ * @brief  电流限幅变化: 速度环输出与积分限幅对称同步
+ */
+static void Param_SyncIqLimit(Motor_t *motor)
+{
+    float limit = motor->PID_Speed.OutMax;
+
+    motor->PID_Speed.OutMin = -limit;
+    motor->PID_Speed.IntegralMax = limit;
+    motor->PID_Speed.IntegralMin = -limit;
+    Param_ClampIntegral(&motor->PID_Speed);
+}
+
+/**
+ * @brief  调制比上限变化: 同 FOC_SetOvermodulation, 退出六步锁定
+ */
+static void Param_SyncModIndex(Motor_t *motor)
+{
+    motor->SVPWM.SixStep = 0;
+}
+
+/**
+ * @brief  母线电压变化: 同步 SVPWM 与定点电流环标幺
+ */
+static void Param_SyncVdc(Motor_t *motor)
+{
+    motor->SVPWM.Udc = motor->Vdc;
+    Param_SyncCurrentGains(motor);
+}
+
+/**
+ * @brief  编码器零点变化: 同步定点流水线使用的计数值
+ */
+static void Param_SyncEncOffset(Motor_t *motor)
+{
+    MotorHW_SetEncoderOffset(&motor->Encoder, motor->Encoder.ZeroOffset);
+}
+
+/**
+ * @brief  编码器方向变化: 只允许 ±1
+ */
+static void Param_SyncEncDir(Motor_t *motor)
+{
+    if (motor->Encoder.Direction >= 0) {
+        motor->Encoder.Direction = 1;
+    }
+}
+
+/**
+ * @brief  电角度外推周期数变化: 重新换算定点流水线的外推系数 (控制周期 = PWM 周期)
+ */
+static void Param_SyncEncDelay(Motor_t *motor)
+{
+#if FOC_USE_FIXED_POINT
+    FOC_Fixed_SetExtrap(&motor->Fixed, motor->Encoder.PolePairs, 1.0f / (float)HW_PWM_FREQ_HZ,
+                        motor->EncDelayPark, motor->EncDelayPwm);
+#else
+    (void)motor;
+#endif
+}
+
+/**
+ * @brief  极对数变化: 非线性标定按同一极对数扫描, 外推系数随之换算
+ */
+static void Param_SyncEncPoles(Motor_t *motor)
+{
+    motor->EncLin.PolePairs = motor->Encoder.PolePairs;
+    Param_SyncEncDelay(motor);
+}
+
+/*============================================================================*/
+/*                              参数表                                         */
+/*============================================================================*/
+
+#define PARAM_F32(name, field, ctx, min, max, sync) \
+    { name, offsetof(Motor_t, field), FOC_PARAM_F32, FOC_PARAM_RW, ctx, min, max, sync }
+#define PARAM_RO(name, field, type) \
+    { name, offsetof(Motor_t, field), type, FOC_PARAM_RO, FOC_PARAM_CTX_CURRENT, 0.0f, 0.0f, NULL }
+
+static const FOC_ParamDesc_t param_table[FOC_PARAM_COUNT] = {
+    [FOC_PARAM_ID_KP]           = PARAM_F32("id.kp",         PID_Id.Kp,          FOC_PARAM_CTX_CURRENT, 0.0f, 10.0f,       Param_SyncCurrentGains),
+    [FOC_PARAM_ID_KI]           = PARAM_F32("id.ki",         PID_Id.Ki,          FOC_PARAM_CTX_CURRENT, 0.0f, 10.0f,       Param_SyncCurrentGains),
+    [FOC_PARAM_IQ_KP]           = PARAM_F32("iq.kp",         PID_Iq.Kp,          FOC_PARAM_CTX_CURRENT, 0.0f, 10.0f,       Param_SyncCurrentGains),
+    [FOC_PARAM_IQ_KI]           = PARAM_F32("iq.ki",         PID_Iq.Ki,          FOC_PARAM_CTX_CURRENT, 0.0f, 10.0f,       Param_SyncCurrentGains),
+    [FOC_PARAM_SPD_KP]          = PARAM_F32("spd.kp",        PID_Speed.Kp,       FOC_PARAM_CTX_OUTER,   0.0f, 1.0f,        NULL),
+    [FOC_PARAM_SPD_KI]          = PARAM_F32("spd.ki",        PID_Speed.Ki,       FOC_PARAM_CTX_OUTER,   0.0f, 1.0f,        NULL),
+    [FOC_PARAM_POS_KP]          = PARAM_F32("pos.kp",        PosCtrl.PID.Kp,     FOC_PARAM_CTX_OUTER,   0.0f, 10000.0f,    NULL),
+    [FOC_PARAM_POS_KI]          = PARAM_F32("pos.ki",        PosCtrl.PID.Ki,     FOC_PARAM_CTX_OUTER,   0.0f, 10000.0f,    NULL),
+    [FOC_PARAM_POS_KD]          = PARAM_F32("pos.kd",        PosCtrl.PID.Kd,     FOC_PARAM_CTX_OUTER,   0.0f, 10000.0f,    NULL),
+    [FOC_PARAM_MAX_RPM]         = PARAM_F32("pos.max_rpm",   PosCtrl.MaxRPM,     FOC_PARAM_CTX_OUTER,   0.0f, 20000.0f,    NULL),
+    [FOC_PARAM_MAX_ACCEL]       = PARAM_F32("pos.max_accel", PosCtrl.MaxAccel,   FOC_PARAM_CTX_OUTER,   0.0f, 100000.0f,   NULL),
+    [FOC_PARAM_PLL_KP]          = PARAM_F32("pll.kp",        SpeedPLL.Kp,        FOC_PARAM_CTX_CURRENT, 0.0f, 10000.0f,    NULL),
+    [FOC_PARAM_PLL_KI]          = PARAM_F32("pll.ki",        SpeedPLL.Ki,        FOC_PARAM_CTX_CURRENT, 0.0f, 10000000.0f, NULL),
+    [FOC_PARAM_VOLT_LIMIT]      = PARAM_F32("cur.v_limit",   PID_Id.OutMax,      FOC_PARAM_CTX_CURRENT, 0.0f, 60.0f,       Param_SyncVoltLimit),
+    [FOC_PARAM_IQ_LIMIT]        = PARAM_F32("spd.iq_limit",  PID_Speed.OutMax,   FOC_PARAM_CTX_OUTER,   0.0f, 40.0f,       Param_SyncIqLimit),
+    [FOC_PARAM_MAX_JERK]        = PARAM_F32("pos.max_jerk",  PosCtrl.MaxJerk,    FOC_PARAM_CTX_OUTER,   0.0f, 20000.0f,    NULL),
+    [FOC_PARAM_MAX_MOD]         = PARAM_F32("pwm.max_mod",   SVPWM.MaxModIndex,  FOC_PARAM_CTX_CURRENT, SVPWM_M_LINEAR, 1.0f, Param_SyncModIndex),
+    [FOC_PARAM_VDC]             = PARAM_F32("vdc",           Vdc,                FOC_PARAM_CTX_CURRENT, 6.0f, 60.0f,       Param_SyncVdc),
+    [FOC_PARAM_ACT_ID]          = PARAM_RO("act.id",         ActualId,           FOC_PARAM_F32),
+    [FOC_PARAM_ACT_IQ]          = PARAM_RO("act.iq",         ActualIq,           FOC_PARAM_F32),
+    [FOC_PARAM_ACT_RPM]         = PARAM_RO("act.rpm",        ActualRPM,          FOC_PARAM_F32),
+    [FOC_PARAM_ACT_POS]         = PARAM_RO("act.pos",        ActualPos,          FOC_PARAM_F32),
+    [FOC_PARAM_MECH_ANGLE]      = PARAM_RO("enc.mech",       Encoder.MechAngle,  FOC_PARAM_F32),
+    [FOC_PARAM_ID_INTEGRAL]     = PARAM_RO("id.integral",    PID_Id.Integral,    FOC_PARAM_F32),
+    [FOC_PARAM_IQ_INTEGRAL]     = PARAM_RO("iq.integral",    PID_Iq.Integral,    FOC_PARAM_F32),
+    [FOC_PARAM_SPD_INTEGRAL]    = PARAM_RO("spd.integral",   PID_Speed.Integral, FOC_PARAM_F32),
+    [FOC_PARAM_OUTER_OVERRUN]   = PARAM_RO("outer.overrun",  OuterOverrun,       FOC_PARAM_U32),
+    [FOC_PARAM_CMD_BUSY]        = PARAM_RO("cmd.busy",       Cmd.Busy,           FOC_PARAM_U32),
+    [FOC_PARAM_ENC_OFFSET]      = PARAM_F32("enc.offset",    Encoder.ZeroOffset, FOC_PARAM_CTX_CURRENT, 0.0f, 6.2831853f,  Param_SyncEncOffset),
+    [FOC_PARAM_ENC_DIR]         = { "enc.dir", offsetof(Motor_t, Encoder.Direction), FOC_PARAM_I8, FOC_PARAM_RW,
+                                    FOC_PARAM_CTX_CURRENT, -1.0f, 1.0f, Param_SyncEncDir },
+    [FOC_PARAM_CAL_VOLTAGE]     = PARAM_F32("cal.voltage",   EncCal.Voltage,     FOC_PARAM_CTX_CURRENT, 0.05f, 5.0f,       NULL),
+    [FOC_PARAM_CAL_STATUS]      = PARAM_RO("cal.status",     EncCal.Status,      FOC_PARAM_U8),
+    [FOC_PARAM_CAL_POLES]       = PARAM_RO("cal.poles",      EncCal.PolePairsMeas, FOC_PARAM_U8),
+    [FOC_PARAM_LIN_STATUS]      = PARAM_RO("lin.status",     EncLin.Status,      FOC_PARAM_U8),
+    [FOC_PARAM_LIN_PEAK]        = PARAM_RO("lin.peak",       EncLin.Peak,        FOC_PARAM_F32),
+    [FOC_PARAM_ENC_DLY_PARK]    = PARAM_F32("enc.dly_park",  EncDelayPark,       FOC_PARAM_CTX_CURRENT, 0.0f, 4.0f,        Param_SyncEncDelay),
+    [FOC_PARAM_ENC_DLY_PWM]     = PARAM_F32("enc.dly_pwm",   EncDelayPwm,        FOC_PARAM_CTX_CURRENT, 0.0f, 4.0f,        Param_SyncEncDelay),
+    [FOC_PARAM_ENC_POLES]       = { "enc.poles", offsetof(Motor_t, Encoder.PolePairs), FOC_PARAM_U8, FOC_PARAM_RW,
+                                    FOC_PARAM_CTX_CURRENT, 1.0f, (float)ENC_CAL_MAX_POLE_PAIRS, Param_SyncEncPoles },
+};
+
+/*============================================================================*/
+/*                              私有变量                                       */
+/*============================================================================*/
+
+static Param_Queue_t param_queue[HW_AXIS_COUNT][FOC_PARAM_CTX_COUNT];
+static volatile uint16_t param_sub[FOC_PARAM_SUB_CNT];     // 订阅的参数号
+static FOC_Store_t param_store;                             // 参数存储
+static uint8_t param_mounted = 0;                           // 1=参数存储已挂载
+static uint32_t param_image[(PARAM_IMAGE_SIZE + 3) / 4];    // 保存镜像缓冲
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  按类型读取字段
+ */
+static float Param_Read(const Motor_t *motor, const FOC_ParamDesc_t *d)
+{
+    const uint8_t *p = (const uint8_t *)motor + d->Offset;
+
+    switch (d->Type) {
+        case FOC_PARAM_U32: return (float)*(const uint32_t *)p;
+        case FOC_PARAM_I32: return (float)*(const int32_t *)p;
+        case FOC_PARAM_U8:  return (float)*p;
+        case FOC_PARAM_I8:  return (float)*(const int8_t *)p;
+        default:            return *(const float *)p;
+    }
+}
+
+/**
+ * @brief  按类型写入字段 (整型四舍五入, 取值已按上下限校验)
+ */
+static void Param_Write(Motor_t *motor, const FOC_ParamDesc_t *d, float value)
+{
+    uint8_t *p = (uint8_t *)motor + d->Offset;
+
+    switch (d->Type) {
+        case FOC_PARAM_U32:
+            *(uint32_t *)p = (uint32_t)(value + 0.5f);
+            break;
+        case FOC_PARAM_I32:
+            *(int32_t *)p = (int32_t)(value >= 0.0f ? value + 0.5f : value - 0.5f);
+            break;
+        case FOC_PARAM_U8:
+            *p = (uint8_t)(value + 0.5f);
+            break;
+        case FOC_PARAM_I8:
+            *(int8_t *)p = (int8_t)(value >= 0.0f ? value + 0.5f : value - 0.5f);
+            break;
+        default:
+            *(float *)p = value;
+            break;
+    }
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  写入并同步派生量
+ */
+static void Param_Commit(Motor_t *motor, const FOC_ParamDesc_t *d, float value)
+{
+    Param_Write(motor, d, value);
+    if (d->Sync != NULL) {
+        d->Sync(motor);
+    }
+}
+
+/**
+ * @brief  初始化写入队列与订阅, 挂载参数存储
+ */
+void FOC_Param_Init(void)
+{
+    for (uint8_t axis = 0; axis < HW_AXIS_COUNT; axis++) {
+        for (uint8_t ctx = 0; ctx < FOC_PARAM_CTX_COUNT; ctx++) {
+            param_queue[axis][ctx].Head = 0;
+            param_queue[axis][ctx].Tail = 0;
+        }
+    }
+    for (uint8_t k = 0; k < FOC_PARAM_SUB_CNT; k++) {
+        param_sub[k] = FOC_PARAM_NONE;
+    }
+    
+    FOC_Store_Mount(&param_store, FOC_Flash_Get());
+    param_mounted = 1;
+}
+
+/**
+ * @brief  取参数描述
+ */
+const FOC_ParamDesc_t *FOC_Param_Desc(uint16_t id)
+{
+    return (id < FOC_PARAM_COUNT) ? &param_table[id] : NULL;
+}
+
+/**
+ * @brief  读取参数当前值
+ */
+FOC_ParamStatus_t FOC_Param_Get(const Motor_t *motor, uint16_t id, float *value)
+{
+    const FOC_ParamDesc_t *d = FOC_Param_Desc(id);
+    if (motor == NULL || d == NULL) return FOC_PARAM_ERR_ID;
+
+    *value = Param_Read(motor, d);
+    return FOC_PARAM_OK;
+}
+
+/**
+ * @brief  写入参数
+ * @note   条目写完后再递增 Head, 读端看到新 Head 时条目已完整
+ */
+FOC_ParamStatus_t FOC_Param_Set(Motor_t *motor, uint16_t id, float value)
+{
+    const FOC_ParamDesc_t *d = FOC_Param_Desc(id);
+    if (motor == NULL || d == NULL) return FOC_PARAM_ERR_ID;
+    if (d->Access != FOC_PARAM_RW) return FOC_PARAM_ERR_ACCESS;
+
+    /* 取反比较同时拒绝 NaN */
+    if (!(value >= d->Min && value <= d->Max)) return FOC_PARAM_ERR_RANGE;
+
+    Param_Queue_t *q = &param_queue[motor->Axis][d->Ctx];
+    uint32_t head = q->Head;
+    if (head - q->Tail >= FOC_PARAM_QUEUE_LEN) return FOC_PARAM_ERR_BUSY;
+
+    Param_Write_t *w = &q->Buf[head & (FOC_PARAM_QUEUE_LEN - 1)];
+    w->Id = id;
+    w->Value = value;
+    FOC_Atomic_Barrier();
+    q->Head = head + 1;
+    return FOC_PARAM_OK;
+}
+
+/**
+ * @brief  取出并应用待生效的写入
+ * @note   一次取完队列中的全部写入, 之后才释放队列空间
+ */
+void FOC_Param_Apply(Motor_t *motor, FOC_ParamCtx_t ctx)
+{
+    Param_Queue_t *q = &param_queue[motor->Axis][ctx];
+    uint32_t head = q->Head;
+    uint32_t tail = q->Tail;
+
+    if (tail == head) return;
+    FOC_Atomic_Barrier();
+
+    for (; tail != head; tail++) {
+        const Param_Write_t *w = &q->Buf[tail & (FOC_PARAM_QUEUE_LEN - 1)];
+        Param_Commit(motor, &param_table[w->Id], w->Value);
+    }
+
+    FOC_Atomic_Barrier();
+    q->Tail = head;
+}
+
+/**
+ * @brief  加载已保存的参数
+ * @note   保存值直接写入 Motor_t (控制中断尚未启动), 超出当前上下限的值忽略
+ */
+uint8_t FOC_Param_Load(Motor_t *motor)
+{
+    const Param_ImageHead_t *head;
+    uint16_t version;
+    uint32_t len;
+
+    if (!param_mounted) return 0;
+
+    head = (const Param_ImageHead_t *)FOC_Store_Read(&param_store, &version, &len);
+    if (head == NULL || version != FOC_PARAM_IMAGE_VERSION || len < sizeof(*head)) return 0;
+
+    uint32_t stride = sizeof(Param_ImageAxis_t) + head->ParamCount * sizeof(float);
+    if (motor->Axis >= head->AxisCount || len < sizeof(*head) + head->AxisCount * stride) return 0;
+
+    uint32_t lin_offset = sizeof(*head) + head->AxisCount * stride;
+    const Param_ImageAxis_t *cal = (const Param_ImageAxis_t *)((const uint8_t *)(head + 1) + motor->Axis * stride);
+    const float *values = (const float *)(cal + 1);
+    uint16_t count = (head->ParamCount < FOC_PARAM_COUNT) ? head->ParamCount : FOC_PARAM_COUNT;
+
+    for (uint16_t id = 0; id < count; id++) {
+        const FOC_ParamDesc_t *d = &param_table[id];
+        float value = values[id];
+        if (d->Access != FOC_PARAM_RW || !(value >= d->Min && value <= d->Max)) continue;
+        Param_Commit(motor, d, value);
+    }
+
+    /* 编码器补偿表 */
+    if (len >= lin_offset + head->AxisCount * sizeof(Param_ImageLin_t)) {
+        const Param_ImageLin_t *lin = (const Param_ImageLin_t *)((const uint8_t *)head + lin_offset) + motor->Axis;
+        if (lin->Valid == 1) {
+            for (uint32_t i = 0; i <= ENC_LIN_SIZE; i++) {
+                motor->EncLin.Table[i] = lin->Table[i];
+            }
+            motor->EncLin.Valid = 1;
+            motor->Encoder.Lin = motor->EncLin.Table;
+        }
+    }
+
+#if FOC_PARAM_LOAD_CUR_OFFSET
+    if (cal->CurValid) {
+        motor->CurOffset.OffsetU = cal->CurOffset[0];
+        motor->CurOffset.OffsetV = cal->CurOffset[1];
+        motor->CurOffset.OffsetW = cal->CurOffset[2];
+        motor->CurOffset.IsCalibrated = 1;
+#if FOC_USE_FIXED_POINT
+        FOC_Fixed_SetOffset(&motor->Fixed, cal->CurOffset[0], cal->CurOffset[1]);
+#endif
+    }
+#endif
+    return 1;
+}
+
+/**
+ * @brief  保存所有轴的可写参数与电流零点
+ * @note   队列中尚有未生效的写入时拒绝保存, 保存的总是电机实际使用的值
+ */
+FOC_ParamStatus_t FOC_Param_Save(void)
+{
+    Param_ImageHead_t *head = (Param_ImageHead_t *)param_image;
+
+    if (!param_mounted) return FOC_PARAM_ERR_FLASH;
+
+    for (uint8_t axis = 0; axis < HW_AXIS_COUNT; axis++) {
+        Motor_State_t state = g_Motors[axis].State;
+        if (state == MOTOR_STATE_RUNNING || state == MOTOR_STATE_CALIBRATING) return FOC_PARAM_ERR_BUSY;
+        for (uint8_t ctx = 0; ctx < FOC_PARAM_CTX_COUNT; ctx++) {
+            if (param_queue[axis][ctx].Head != param_queue[axis][ctx].Tail) return FOC_PARAM_ERR_BUSY;
+        }
+    }
+
+    head->ParamCount = FOC_PARAM_COUNT;
+    head->AxisCount = HW_AXIS_COUNT;
+    for (uint8_t axis = 0; axis < HW_AXIS_COUNT; axis++) {
+        const Motor_t *motor = &g_Motors[axis];
+        Param_ImageAxis_t *cal = (Param_ImageAxis_t *)((uint8_t *)(head + 1) + axis * PARAM_IMAGE_STRIDE);
+        float *values = (float *)(cal + 1);
+
+        cal->CurOffset[0] = motor->CurOffset.OffsetU;
+        cal->CurOffset[1] = motor->CurOffset.OffsetV;
+        cal->CurOffset[2] = motor->CurOffset.OffsetW;
+        cal->CurValid = motor->CurOffset.IsCalibrated;
+        for (uint16_t id = 0; id < FOC_PARAM_COUNT; id++) {
+            values[id] = Param_Read(motor, &param_table[id]);
+        }
+
+        Param_ImageLin_t *lin = (Param_ImageLin_t *)((uint8_t *)param_image + PARAM_IMAGE_LIN) + axis;
+        for (uint32_t i = 0; i <= ENC_LIN_SIZE; i++) {
+            lin->Table[i] = motor->EncLin.Table[i];
+        }
+        lin->Valid = motor->EncLin.Valid;
+    }
+
+    return FOC_Store_Write(&param_store, FOC_PARAM_IMAGE_VERSION, param_image, PARAM_IMAGE_SIZE)
+           ? FOC_PARAM_OK : FOC_PARAM_ERR_FLASH;
+}
+
+/**
+ * @brief  设置订阅
+ */
+FOC_ParamStatus_t FOC_Param_Subscribe(uint8_t slot, uint16_t id)
+{
+    if (slot >= FOC_PARAM_SUB_CNT) return FOC_PARAM_ERR_ID;
+    if (id != FOC_PARAM_NONE && id >= FOC_PARAM_COUNT) return FOC_PARAM_ERR_ID;
+
+    param_sub[slot] = id;
+    return FOC_PARAM_OK;
+}
+
+/**
+ * @brief  填写订阅通道
+ */
+void FOC_Param_Sample(const Motor_t *motor, float *out)
+{
+    for (uint8_t k = 0; k < FOC_PARAM_SUB_CNT; k++) {
+        uint16_t id = param_sub[k];
+        out[k] = (id < FOC_PARAM_COUNT) ? Param_Read(motor, &param_table[id]) : 0.0f;
+    }
+}
@@ -0,0 +1,201 @@
+/**
+ * @file    foc_param.h
+ * @brief   运行时参数表 (按编号读写/订阅 Motor_t 字段)
+ * @note    参数描述表为编译期常量数组, 以参数号为下标, 查找为 O(1):
+ *            名称 / Motor_t 内偏移 / 类型 / 上下限 / 读写权限 / 生效上下文 / 写入后同步函数
+ *          写入不直接修改 Motor_t: 校验后放入该轴对应上下文的写入队列,
+ *            - 电流环与 PLL 参数: 控制中断在 FOC_ProcessCommand 中 (控制周期开始时) 取出生效
+ *            - 速度环与位置环参数: 外环任务在 FOC_OuterLoopTask 开始时取出生效
+ *          同一次取出的写入在同一周期内全部生效, 控制器不会在一次计算中途看到新旧混合的参数
+ *          订阅: 最多 FOC_PARAM_SUB_CNT 个参数由控制中断填入调试数据帧的 VOFA_CH_SUB0 起各通道,
+ *                可由遥测配置 (TELEM_CHAN / TELEM_APPLY) 选中发送
+ *          保存: 电机停止时由主循环把所有可写参数, 电流零点与编码器补偿表写入参数存储 (foc_store),
+ *                FOC_Init 加载已保存的值 (按参数号对应, 新增参数保持默认值, 超出上下限的值忽略)
+ *          写端与订阅修改: 主循环 (单一写端)
+ */
+
+#ifndef __FOC_PARAM_H
+#define __FOC_PARAM_H
+
+#include <stdint.h>
+#include "foc_core.h"
+#include "vofa.h"
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#define FOC_PARAM_QUEUE_LEN     8           // 每轴每上下文待生效写入数 (2 的幂)
+#define FOC_PARAM_SUB_CNT       (VOFA_CHANNEL_CNT - VOFA_CH_SUB0)   // 订阅通道数
+#define FOC_PARAM_NONE          0xFFFFu     // 订阅槽空闲
+#define FOC_PARAM_IMAGE_VERSION 1           // 保存镜像格式版本 (布局改变时递增, 不兼容的记录不加载)
+
+#ifndef FOC_PARAM_LOAD_CUR_OFFSET
+#define FOC_PARAM_LOAD_CUR_OFFSET   0       // 1=上电使用保存的电流零点, 跳过电流偏移校准
+#endif
+
+/* 参数号 (GET/SET_PARAM, 已发布的编号不得改动, 新参数追加在末尾) */
+enum {
+    FOC_PARAM_ID_KP = 0,        // d轴电流环 Kp
+    FOC_PARAM_ID_KI,            // d轴电流环 Ki
+    FOC_PARAM_IQ_KP,            // q轴电流环 Kp
+    FOC_PARAM_IQ_KI,            // q轴电流环 Ki
+    FOC_PARAM_SPD_KP,           // 速度环 Kp
+    FOC_PARAM_SPD_KI,           // 速度环 Ki
+    FOC_PARAM_POS_KP,           // 位置环 Kp
+    FOC_PARAM_POS_KI,           // 位置环 Ki
+    FOC_PARAM_POS_KD,           // 位置环 Kd
+    FOC_PARAM_MAX_RPM,          // 位置环最大转速 (RPM)
+    FOC_PARAM_MAX_ACCEL,        // 位置环最大加速度 (rad/s²)
+    FOC_PARAM_PLL_KP,           // PLL Kp
+    FOC_PARAM_PLL_KI,           // PLL Ki
+    FOC_PARAM_VOLT_LIMIT,       // 电流环输出电压限幅 (V, d/q 轴共用, 对称)
+    FOC_PARAM_IQ_LIMIT,         // 速度环输出电流限幅 (A, 对称)
+    FOC_PARAM_MAX_JERK,         // 位置环最大跃变 (RPM/tick)
+    FOC_PARAM_MAX_MOD,          // 调制比上限 (定点构建下 SVPWM_Q15 不使用)
+    FOC_PARAM_VDC,              // 母线电压 (V)
+    FOC_PARAM_ACT_ID,           // d轴实际电流 (A, 只读)
+    FOC_PARAM_ACT_IQ,           // q轴实际电流 (A, 只读)
+    FOC_PARAM_ACT_RPM,          // 实际转速 (RPM, 只读)
+    FOC_PARAM_ACT_POS,          // 实际位置 (rad, 只读)
+    FOC_PARAM_MECH_ANGLE,       // 机械角度 (rad, 只读)
+    FOC_PARAM_ID_INTEGRAL,      // d轴电流环积分 (只读)
+    FOC_PARAM_IQ_INTEGRAL,      // q轴电流环积分 (只读)
+    FOC_PARAM_SPD_INTEGRAL,     // 速度环积分 (只读)
+    FOC_PARAM_OUTER_OVERRUN,    // 外环任务超时次数 (只读)
+    FOC_PARAM_CMD_BUSY,         // 命令邮箱发布失败次数 (只读)
+    FOC_PARAM_ENC_OFFSET,       // 编码器零点偏移 (rad)
+    FOC_PARAM_ENC_DIR,          // 编码器方向 (+1 或 -1)
+    FOC_PARAM_CAL_VOLTAGE,      // 编码器校准注入电压 (V)
+    FOC_PARAM_CAL_STATUS,       // 编码器校准状态 (EncCal_Status_t, 只读)
+    FOC_PARAM_CAL_POLES,        // 编码器校准测得极对数 (只读)
+    FOC_PARAM_LIN_STATUS,       // 编码器非线性标定状态 (EncLin_Status_t, 只读)
+    FOC_PARAM_LIN_PEAK,         // 编码器非线性最大修正量 (rad, 只读)
+    FOC_PARAM_ENC_DLY_PARK,     // Park 电角度外推 (控制周期数)
+    FOC_PARAM_ENC_DLY_PWM,      // 逆 Park 电角度外推 (控制周期数)
+    FOC_PARAM_ENC_POLES,        // 极对数 (编码器校准测得后自动更新)
+    FOC_PARAM_COUNT
+};
+
+/* 字段类型 */
+typedef enum {
+    FOC_PARAM_F32 = 0,
+    FOC_PARAM_U32,
+    FOC_PARAM_I32,
+    FOC_PARAM_U8,
+    FOC_PARAM_I8,
+} FOC_ParamType_t;
+
+/* 读写权限 */
+typedef enum {
+    FOC_PARAM_RO = 0,           // 只读
+    FOC_PARAM_RW,               // 可读写
+} FOC_ParamAccess_t;
+
+/* 写入生效的上下文 */
+typedef enum {
+    FOC_PARAM_CTX_CURRENT = 0,  // 控制中断 (FOC_ProcessCommand)
+    FOC_PARAM_CTX_OUTER,        // 外环任务 (FOC_OuterLoopTask)
+    FOC_PARAM_CTX_COUNT
+} FOC_ParamCtx_t;
+
+/* 读写结果 */
+typedef enum {
+    FOC_PARAM_OK = 0,
+    FOC_PARAM_ERR_ID,           // 轴号/参数号/订阅槽无效
+    FOC_PARAM_ERR_ACCESS,       // 只读参数
+    FOC_PARAM_ERR_RANGE,        // 超出上下限 (或 NaN)
+    FOC_PARAM_ERR_BUSY,         // 写入队列满 (上下文尚未取出上一批写入) / 保存时电机运行或校准中
+    FOC_PARAM_ERR_FLASH,        // 参数存储写入失败
+} FOC_ParamStatus_t;
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 参数描述
+ */
+typedef struct {
+    const char *Name;           // 名称 (上位机显示)
+    uint16_t Offset;            // Motor_t 内偏移
+    uint8_t Type;               // FOC_ParamType_t
+    uint8_t Access;             // FOC_ParamAccess_t
+    uint8_t Ctx;                // FOC_ParamCtx_t (只读参数无意义)
+    float Min;                  // 下限
+    float Max;                  // 上限
+    void (*Sync)(Motor_t *motor);   // 生效后同步派生量 (可为 NULL, 在生效上下文中调用)
+} FOC_ParamDesc_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化写入队列与订阅, 挂载参数存储 (FOC_Init 之前调用)
+ */
+void FOC_Param_Init(void);
+
+/**
+ * @brief  取参数描述
+ * @param  id: 参数号
+ * @return 描述, NULL=参数号无效
+ */
+const FOC_ParamDesc_t *FOC_Param_Desc(uint16_t id);
+
+/**
+ * @brief  读取参数当前值
+ * @param  motor: 电机对象指针
+ * @param  id: 参数号
+ * @param  value: 输出 (整型字段转换为 float)
+ * @return FOC_PARAM_OK / FOC_PARAM_ERR_ID
+ * @note   读取的是已生效的值, 队列中待生效的写入不可见
+ */
+FOC_ParamStatus_t FOC_Param_Get(const Motor_t *motor, uint16_t id, float *value);
+
+/**
+ * @brief  写入参数 (主循环)
+ * @param  motor: 电机对象指针
+ * @param  id: 参数号
+ * @param  value: 新值 (整型字段四舍五入)
+ * @return FOC_PARAM_OK=已排队, 在对应上下文下一次运行时生效
+ */
+FOC_ParamStatus_t FOC_Param_Set(Motor_t *motor, uint16_t id, float value);
+
+/**
+ * @brief  取出并应用待生效的写入
+ * @param  motor: 电机对象指针
+ * @param  ctx: 当前上下文 (控制中断 / 外环任务各自调用)
+ */
+void FOC_Param_Apply(Motor_t *motor, FOC_ParamCtx_t ctx);
+
+/**
+ * @brief  加载已保存的参数 (FOC_Init 中调用, 控制中断启动前)
+ * @param  motor: 电机对象指针 (按轴号取对应的保存值)
+ * @return 1=已加载, 0=无有效记录 (保持默认值)
+ */
+uint8_t FOC_Param_Load(Motor_t *motor);
+
+/**
+ * @brief  保存所有轴的可写参数, 电流零点与编码器补偿表 (主循环)
+ * @return FOC_PARAM_OK / FOC_PARAM_ERR_BUSY (有电机运行/校准中或写入未生效) / FOC_PARAM_ERR_FLASH
+ * @note   写满一块时需擦除另一块 (约 1~2 s), 期间 CPU 停顿
+ */
+FOC_ParamStatus_t FOC_Param_Save(void);
+
+/**
+ * @brief  设置订阅 (主循环)
+ * @param  slot: 订阅槽 (0 ~ FOC_PARAM_SUB_CNT-1, 对应通道 VOFA_CH_SUB0 + slot)
+ * @param  id: 参数号, FOC_PARAM_NONE=取消
+ * @return FOC_PARAM_OK / FOC_PARAM_ERR_ID
+ */
+FOC_ParamStatus_t FOC_Param_Subscribe(uint8_t slot, uint16_t id);
+
+/**
+ * @brief  填写订阅通道 (控制中断, VOFA_UpdateFromMotor 中调用)
+ * @param  motor: 电机对象指针
+ * @param  out: 输出 (FOC_PARAM_SUB_CNT 个, 空闲槽填 0)
+ */
+void FOC_Param_Sample(const Motor_t *motor, float *out);
+
+#endif /* __FOC_PARAM_H */
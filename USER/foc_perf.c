@@ -0,0 +1,317 @@
+/**
+ * @file    foc_perf.c
+ * @brief   FOC 控制循环性能剖析模块实现
+ * @note    STM32F4 DWT 周期计数器, 168MHz 下分辨率约 6ns
+ *          主机仿真 (MOTOR_HW_SIM = 1) 以 CLOCK_MONOTONIC 代替, 1 "周期" = 1ns
+ */
+
+#include "foc_perf.h"
+#include "foc_math.h"
+#include "svpwm.h"
+#include "motor_hw.h"
+#include <math.h>
+#include <string.h>
+#if MOTOR_HW_SIM
+#include <time.h>
+#else
+#include "main.h"
+#endif
+/* 与 foc_math.c 相同: ARM 目标以 CMSIS-DSP 为参考, 其他平台回退到 libm */
+#if defined(__arm__) && !defined(FOC_MATH_NO_CMSIS)
+#include "arm_math.h"
+#else
+#define arm_sin_f32(x)      sinf(x)
+#define arm_cos_f32(x)      cosf(x)
+#endif
+
+/*============================================================================*/
+/*                              私有变量                                       */
+/*============================================================================*/
+
+static FOC_PerfStat_t perf_stats[FOC_PERF_STAGE_CNT];
+static volatile uint8_t perf_reset_req = 0;
+static float perf_ns_per_cycle = 1000.0f / 168.0f;
+
+/* 基准测试输入点数 */
+#define PERF_BENCH_POINTS   1024
+#define PERF_BENCH_RADII    8           // SVPWM 基准: 线性区内的幅值档数
+
+/* 直方图量程须覆盖一个完整控制周期 (中心对齐 PWM: 2 × ARR 个周期), 否则 TOTAL 的分位数无意义 */
+typedef char perf_hist_range_check[(((FOC_PERF_HIST_BINS - 1u) << FOC_PERF_HIST_SHIFT) >= 2u * HW_PWM_PERIOD) ? 1 : -1];
+
+static const char *const perf_stage_names[FOC_PERF_STAGE_CNT] = {
+    "Sample", "Clarke", "Park", "PLL", "Outer", "PI", "InvPark", "SVPWM", "Total"
+};
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  清空所有统计
+ */
+static void Perf_Clear(void)
+{
+    memset(perf_stats, 0, sizeof(perf_stats));
+    for (uint32_t i = 0; i < FOC_PERF_STAGE_CNT; i++) {
+        perf_stats[i].Min = 0xFFFFFFFFu;
+    }
+}
+
+/**
+ * @brief  由直方图求分位数 (返回桶上沿, 不超过最大值)
+ */
+static uint32_t Perf_Percentile(const FOC_PerfStat_t *stat, uint32_t permille)
+{
+    uint32_t target = (uint32_t)(((uint64_t)stat->Count * permille + 999u) / 1000u);
+    uint32_t acc = 0;
+
+    for (uint32_t i = 0; i < FOC_PERF_HIST_BINS - 1; i++) {
+        acc += stat->Hist[i];
+        if (acc >= target) {
+            uint32_t edge = (i + 1u) << FOC_PERF_HIST_SHIFT;
+            return (edge < stat->Max) ? edge : stat->Max;
+        }
+    }
+
+    /* 落在溢出桶 */
+    return stat->Max;
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+#if MOTOR_HW_SIM
+/**
+ * @brief  主机单调时钟 (ns)
+ */
+uint32_t FOC_Perf_HostClock(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#endif
+
+/**
+ * @brief  初始化周期计数器并清空统计
+ */
+void FOC_Perf_Init(uint32_t core_clk_hz)
+{
+#if !MOTOR_HW_SIM
+    /* 使能 DWT 周期计数器 */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    if (core_clk_hz != 0) {
+        perf_ns_per_cycle = 1.0e9f / (float)core_clk_hz;
+    }
+
+    Perf_Clear();
+    perf_reset_req = 0;
+}
+
+/**
+ * @brief  请求清空统计
+ */
+void FOC_Perf_Reset(void)
+{
+    perf_reset_req = 1;
+}
+
+/**
+ * @brief  记录一次阶段耗时
+ */
+void FOC_Perf_Record(FOC_PerfStage_t stage, uint32_t cycles)
+{
+    FOC_PerfStat_t *stat = &perf_stats[stage];
+    uint32_t bin = cycles >> FOC_PERF_HIST_SHIFT;
+
+    if (bin >= FOC_PERF_HIST_BINS) bin = FOC_PERF_HIST_BINS - 1;
+
+    stat->Count++;
+    stat->Sum += cycles;
+    stat->Hist[bin]++;
+    if (cycles < stat->Min) stat->Min = cycles;
+    if (cycles > stat->Max) stat->Max = cycles;
+
+    /* 整周期结束时处理清空请求, 保证各阶段统计同步 */
+    if (stage == FOC_PERF_TOTAL && perf_reset_req) {
+        Perf_Clear();
+        perf_reset_req = 0;
+    }
+}
+
+/**
+ * @brief  生成单阶段统计报告
+ */
+void FOC_Perf_GetReport(FOC_PerfStage_t stage, FOC_PerfReport_t *report)
+{
+    const FOC_PerfStat_t *stat = &perf_stats[stage];
+
+    report->Count = stat->Count;
+    report->Overflow = stat->Hist[FOC_PERF_HIST_BINS - 1];
+    if (stat->Count == 0) {
+        report->AvgNs = 0.0f;
+        report->P50Ns = 0.0f;
+        report->P99Ns = 0.0f;
+        report->MaxNs = 0.0f;
+        return;
+    }
+
+    report->AvgNs = (float)stat->Sum / (float)stat->Count * perf_ns_per_cycle;
+    report->P50Ns = (float)Perf_Percentile(stat, 500) * perf_ns_per_cycle;
+    report->P99Ns = (float)Perf_Percentile(stat, 990) * perf_ns_per_cycle;
+    report->MaxNs = (float)stat->Max * perf_ns_per_cycle;
+}
+
+/**
+ * @brief  获取阶段名称
+ */
+const char *FOC_Perf_StageName(FOC_PerfStage_t stage)
+{
+    return (stage < FOC_PERF_STAGE_CNT) ? perf_stage_names[stage] : "?";
+}
+
+/**
+ * @brief  正弦/余弦基准测试
+ * @note   两种实现各遍历 [0, 2π) 上 PERF_BENCH_POINTS 个角度,
+ *         结果累加到 volatile 变量防止被优化
+ */
+void FOC_Perf_BenchSinCos(FOC_PerfSinCos_t *result)
+{
+    volatile float sink = 0.0f;
+    const float step = FOC_2PI / (float)PERF_BENCH_POINTS;
+    uint32_t t0, cycles;
+    SinCos_t sc;
+
+    /* CMSIS-DSP: 两次求值 */
+    t0 = FOC_Perf_Now();
+    for (uint32_t i = 0; i < PERF_BENCH_POINTS; i++) {
+        float theta = (float)i * step;
+        sink += arm_sin_f32(theta) + arm_cos_f32(theta);
+    }
+    cycles = FOC_Perf_Now() - t0;
+    result->CmsisCycles = (float)cycles / (float)PERF_BENCH_POINTS;
+
+    /* 查表: 一次求值得到 sin/cos */
+    t0 = FOC_Perf_Now();
+    for (uint32_t i = 0; i < PERF_BENCH_POINTS; i++) {
+        float theta = (float)i * step;
+        FOC_SinCos(theta, &sc);
+        sink += sc.Sin + sc.Cos;
+    }
+    cycles = FOC_Perf_Now() - t0;
+    result->TableCycles = (float)cycles / (float)PERF_BENCH_POINTS;
+
+    /* 精度 (以 CMSIS 结果为参考) */
+    result->MaxErrSin = 0.0f;
+    result->MaxErrCos = 0.0f;
+    for (uint32_t i = 0; i < PERF_BENCH_POINTS; i++) {
+        float theta = ((float)i + 0.37f) * step;    // 错开表格节点
+        FOC_SinCos(theta, &sc);
+        float es = fabsf(sc.Sin - arm_sin_f32(theta));
+        float ec = fabsf(sc.Cos - arm_cos_f32(theta));
+        if (es > result->MaxErrSin) result->MaxErrSin = es;
+        if (ec > result->MaxErrCos) result->MaxErrCos = ec;
+    }
+
+    (void)sink;
+}
+
+/**
+ * @brief  SVPWM 基准测试
+ * @note   在线性区 (|V| ≤ Udc/√3) 内按极坐标遍历 αβ 平面,
+ *         两种算法输入相同, 先计时再逐点比较 CCR
+ */
+void FOC_Perf_BenchSVPWM(FOC_PerfSVPWM_t *result)
+{
+    const float udc = 12.0f;
+    const float step = FOC_2PI / (float)PERF_BENCH_POINTS;
+    const float r_step = udc * FOC_ONE_BY_SQRT3 / (float)PERF_BENCH_RADII;
+    uint32_t t_sector = 0, t_minmax = 0, t0;
+    SVPWM_t a, b;
+    
+    SVPWM_Init(&a, udc, 4200);
+    SVPWM_Init(&b, udc, 4200);
+    result->MaxCcrDiff = 0;
+    
+    for (uint32_t r = 1; r <= PERF_BENCH_RADII; r++) {
+        float radius = (float)r * r_step;
+        for (uint32_t i = 0; i < PERF_BENCH_POINTS; i++) {
+            float theta = (float)i * step;
+            a.Alpha = b.Alpha = radius * arm_cos_f32(theta);
+            a.Beta = b.Beta = radius * arm_sin_f32(theta);
+            
+            t0 = FOC_Perf_Now();
+            SVPWM_CalcSector(&a);
+            t_sector += FOC_Perf_Now() - t0;
+            
+            t0 = FOC_Perf_Now();
+            SVPWM_CalcMinMax(&b);
+            t_minmax += FOC_Perf_Now() - t0;
+            
+            uint32_t d1 = (a.CCR1 > b.CCR1) ? (a.CCR1 - b.CCR1) : (b.CCR1 - a.CCR1);
+            uint32_t d2 = (a.CCR2 > b.CCR2) ? (a.CCR2 - b.CCR2) : (b.CCR2 - a.CCR2);
+            uint32_t d3 = (a.CCR3 > b.CCR3) ? (a.CCR3 - b.CCR3) : (b.CCR3 - a.CCR3);
+            if (d1 > result->MaxCcrDiff) result->MaxCcrDiff = d1;
+            if (d2 > result->MaxCcrDiff) result->MaxCcrDiff = d2;
+            if (d3 > result->MaxCcrDiff) result->MaxCcrDiff = d3;
+        }
+    }
+    
+    result->SectorCycles = (float)t_sector / (float)(PERF_BENCH_POINTS * PERF_BENCH_RADII);
+    result->MinMaxCycles = (float)t_minmax / (float)(PERF_BENCH_POINTS * PERF_BENCH_RADII);
+}
+
+/**
+ * @brief  编码器浮点解码 (整数相位解码之前的实现, 基准测试参考)
+ */
+static void Perf_DecodeEncoderFmodf(EncoderData_t *encoder, uint16_t raw_angle)
+{
+    float mech = (float)encoder->Direction * (float)raw_angle * (FOC_2PI / (float)HW_ENCODER_CPR);
+    mech = fmodf(mech + FOC_2PI, FOC_2PI);
+
+    encoder->RawAngle = raw_angle;
+    encoder->MechAngle = mech;
+    encoder->ElecAngle = fmodf((mech - encoder->ZeroOffset) * (float)encoder->PolePairs + FOC_2PI, FOC_2PI);
+}
+
+/**
+ * @brief  编码器解码基准测试
+ * @note   两种实现输入相同, 逐读数计时后比较电角度 (按圆周取最短差值)
+ */
+void FOC_Perf_BenchEncoder(FOC_PerfEncoder_t *result)
+{
+    uint32_t t_fmodf = 0, t_int = 0, t0;
+    EncoderData_t a = {0}, b = {0};
+
+    a.PolePairs = HW_MOTOR_POLE_PAIRS;
+    MotorHW_SetEncoderOffset(&a, HW_ENCODER_ZERO_OFFSET);
+    b = a;
+    result->MaxErrElec = 0.0f;
+
+    for (int8_t dir = -1; dir <= 1; dir += 2) {
+        a.Direction = b.Direction = dir;
+        for (uint32_t raw = 0; raw < HW_ENCODER_CPR; raw++) {
+            t0 = FOC_Perf_Now();
+            Perf_DecodeEncoderFmodf(&a, (uint16_t)raw);
+            t_fmodf += FOC_Perf_Now() - t0;
+
+            t0 = FOC_Perf_Now();
+            MotorHW_DecodeEncoder(&b, (uint16_t)raw);
+            t_int += FOC_Perf_Now() - t0;
+
+            float err = fabsf(a.ElecAngle - b.ElecAngle);
+            if (err > FOC_PI) err = FOC_2PI - err;
+            if (err > result->MaxErrElec) result->MaxErrElec = err;
+        }
+    }
+
+    result->FmodfCycles = (float)t_fmodf / (float)(2u * HW_ENCODER_CPR);
+    result->IntCycles = (float)t_int / (float)(2u * HW_ENCODER_CPR);
+}
@@ -0,0 +1,198 @@
+/**
+ * @file    foc_perf.h
+ * @brief   FOC 控制循环性能剖析模块 (DWT 周期计数)
+ * @note    按流水线阶段统计执行周期: 平均 / P50 / P99 / 最大值
+ *          FOC_PERF_ENABLE = 0 时所有打点宏展开为空, 不占用 ISR 时间
+ */
+
+#ifndef __FOC_PERF_H
+#define __FOC_PERF_H
+
+#include <stdint.h>
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#ifndef FOC_PERF_ENABLE
+#define FOC_PERF_ENABLE         0           // 1=开启剖析打点
+#endif
+
+#ifndef MOTOR_HW_SIM
+#define MOTOR_HW_SIM            0
+#endif
+
+#define FOC_PERF_HIST_BINS      256         // 直方图桶数 (最后一桶为溢出桶)
+#define FOC_PERF_HIST_SHIFT     6           // 桶宽 = 2^6 = 64 周期 (约 0.38us @ 168MHz)
+/* 量程 = 255 × 64 = 16320 周期, 覆盖一个完整控制周期 (8400 周期 @ 20kHz) 且留有一倍余量 */
+
+/* 周期计数器: 默认 Cortex-M DWT->CYCCNT, 主机仿真为单调时钟 ns 计数, 移植时可在编译选项中重定义 */
+#ifndef FOC_PERF_CYCCNT
+#if MOTOR_HW_SIM
+#define FOC_PERF_CYCCNT         FOC_Perf_HostClock()
+#else
+#define FOC_PERF_CYCCNT         (*(volatile uint32_t *)0xE0001004UL)
+#endif
+#endif
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/* 流水线阶段 (与 FOC_ControlLoop 的执行顺序一致) */
+typedef enum {
+    FOC_PERF_SAMPLE = 0,        // 电流采样 + 启动编码器读取
+    FOC_PERF_CLARKE,            // Clarke 变换
+    FOC_PERF_PARK,              // Park 变换
+    FOC_PERF_PLL,               // PLL 速度估算
+    FOC_PERF_OUTER,             // 速度环 / 位置环 (外环任务, 不计入 TOTAL)
+    FOC_PERF_PI,                // 电流环 PI
+    FOC_PERF_INVPARK,           // 逆 Park 变换
+    FOC_PERF_SVPWM,             // SVPWM 调制 + PWM 输出
+    FOC_PERF_TOTAL,             // 整个控制周期
+    FOC_PERF_STAGE_CNT
+} FOC_PerfStage_t;
+
+/**
+ * @brief 单阶段统计数据 (ISR 中累加)
+ */
+typedef struct {
+    uint32_t Count;             // 采样次数
+    uint32_t Min;               // 最小周期数
+    uint32_t Max;               // 最大周期数
+    uint64_t Sum;               // 周期数累加
+    uint32_t Hist[FOC_PERF_HIST_BINS];  // 周期数直方图
+} FOC_PerfStat_t;
+
+/**
+ * @brief 单阶段统计报告 (主循环中读取)
+ */
+typedef struct {
+    uint32_t Count;             // 采样次数
+    float AvgNs;                // 平均耗时 (ns)
+    float P50Ns;                // 中位数 (ns)
+    float P99Ns;                // 99 分位 (ns)
+    float MaxNs;                // 最大耗时 (ns)
+    uint32_t Overflow;          // 超出直方图量程的次数 (非零时落在溢出桶内的分位数以最大值代替)
+} FOC_PerfReport_t;
+
+/**
+ * @brief 正弦/余弦实现对比结果
+ */
+typedef struct {
+    float CmsisCycles;          // arm_sin_f32 + arm_cos_f32 平均周期
+    float TableCycles;          // FOC_SinCos 平均周期
+    float MaxErrSin;            // 与 CMSIS 结果的最大偏差 (sin)
+    float MaxErrCos;            // 与 CMSIS 结果的最大偏差 (cos)
+} FOC_PerfSinCos_t;
+
+/**
+ * @brief SVPWM 算法对比结果
+ */
+typedef struct {
+    float SectorCycles;         // SVPWM_CalcSector 平均周期
+    float MinMaxCycles;         // SVPWM_CalcMinMax 平均周期
+    uint32_t MaxCcrDiff;        // 线性区内两种算法 CCR 最大差值 (计数)
+} FOC_PerfSVPWM_t;
+
+/**
+ * @brief 编码器解码对比结果
+ */
+typedef struct {
+    float FmodfCycles;          // 浮点 + fmodf 解码平均周期
+    float IntCycles;            // MotorHW_DecodeEncoder (整数相位) 平均周期
+    float MaxErrElec;           // 全部读数上两种解码电角度最大偏差 (rad)
+} FOC_PerfEncoder_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化周期计数器并清空统计
+ * @param  core_clk_hz: 内核时钟频率 (Hz), 用于周期 → ns 换算 (主机仿真传 1000000000)
+ */
+void FOC_Perf_Init(uint32_t core_clk_hz);
+
+/**
+ * @brief  请求清空统计 (在下一个控制周期结束时由 ISR 执行)
+ */
+void FOC_Perf_Reset(void);
+
+/**
+ * @brief  记录一次阶段耗时
+ * @param  stage: 流水线阶段
+ * @param  cycles: 周期数
+ */
+void FOC_Perf_Record(FOC_PerfStage_t stage, uint32_t cycles);
+
+/**
+ * @brief  生成单阶段统计报告
+ * @param  stage: 流水线阶段
+ * @param  report: 报告输出指针
+ * @note   读取过程中 ISR 仍可能更新统计, 结果仅用于诊断
+ */
+void FOC_Perf_GetReport(FOC_PerfStage_t stage, FOC_PerfReport_t *report);
+
+/**
+ * @brief  获取阶段名称 (用于打印)
+ * @param  stage: 流水线阶段
+ * @return 阶段名称字符串
+ */
+const char *FOC_Perf_StageName(FOC_PerfStage_t stage);
+
+/**
+ * @brief  正弦/余弦基准测试: FOC_SinCos 对比 CMSIS-DSP (精度 + 耗时)
+ * @param  result: 结果输出指针
+ * @note   阻塞约 1ms, 须在电机停止时于主循环调用
+ */
+void FOC_Perf_BenchSinCos(FOC_PerfSinCos_t *result);
+
+/**
+ * @brief  SVPWM 基准测试: 最大/最小值零序注入对比扇区法 (一致性 + 耗时)
+ * @param  result: 结果输出指针
+ * @note   阻塞约 2ms, 须在电机停止时于主循环调用
+ */
+void FOC_Perf_BenchSVPWM(FOC_PerfSVPWM_t *result);
+
+/**
+ * @brief  编码器解码基准测试: 浮点 fmodf 取模对比整数相位回绕 (一致性 + 耗时)
+ * @param  result: 结果输出指针
+ * @note   遍历正反两个方向全部 14-bit 读数, 阻塞约 5ms, 须在电机停止时于主循环调用
+ */
+void FOC_Perf_BenchEncoder(FOC_PerfEncoder_t *result);
+
+#if MOTOR_HW_SIM
+/**
+ * @brief  主机单调时钟 (ns, 32 位回绕), 仿真构建中代替 DWT->CYCCNT
+ */
+uint32_t FOC_Perf_HostClock(void);
+#endif
+
+/**
+ * @brief  读取当前周期计数
+ */
+static inline uint32_t FOC_Perf_Now(void) {
+    return FOC_PERF_CYCCNT;
+}
+
+/*============================================================================*/
+/*                              打点宏                                         */
+/*============================================================================*/
+
+#if FOC_PERF_ENABLE
+/* 声明一个计时起点 */
+#define FOC_PERF_BEGIN(t)           uint32_t t = FOC_Perf_Now()
+/* 记录 stage 自 t 以来的耗时, 并把 t 推进到当前时刻 (分段计时) */
+#define FOC_PERF_LAP(stage, t)      do { uint32_t _now = FOC_Perf_Now(); \
+                                         FOC_Perf_Record((stage), _now - (t)); \
+                                         (t) = _now; } while (0)
+/* 记录 stage 自 t 以来的耗时 */
+#define FOC_PERF_END(stage, t)      FOC_Perf_Record((stage), FOC_Perf_Now() - (t))
+#else
+#define FOC_PERF_BEGIN(t)           ((void)0)
+#define FOC_PERF_LAP(stage, t)      ((void)0)
+#define FOC_PERF_END(stage, t)      ((void)0)
+#endif
+
+#endif /* __FOC_PERF_H */
@@ -0,0 +1,222 @@
+/**
+ * @file    foc_proto.c
+ * @brief   二进制命令协议编解码实现
+ */
+
+#include "foc_proto.h"
+
+/*============================================================================*/
+/*                              CRC 表                                         */
+/*============================================================================*/
+
+/* CRC16-CCITT 查表 (多项式 0x1021) */
+static const uint16_t crc16_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  检查以 SYNC 开头的完整帧
+ * @param  f: 帧起始 (长度已确认不小于帧长)
+ * @return 1=CRC 正确
+ */
+static uint8_t Proto_CheckFrame(const uint8_t *f)
+{
+    uint32_t body = 3u + f[1];                  // LEN + TYPE + SEQ + PAYLOAD
+    uint16_t crc = Proto_Crc16(0xFFFF, &f[1], body);
+
+    return (crc == Proto_GetU16(&f[1 + body])) ? 1 : 0;
+}
+
+/**
+ * @brief  分发一帧
+ */
+static void Proto_Dispatch(const uint8_t *f, Proto_Handler_t handler, void *user)
+{
+    Proto_Frame_t frame;
+
+    frame.Len = f[1];
+    frame.Type = f[2];
+    frame.Seq = f[3];
+    frame.Payload = &f[PROTO_HEADER_SIZE];
+    handler(&frame, user);
+}
+
+/**
+ * @brief  帧长度 (由 LEN 字段计算)
+ */
+static inline uint32_t Proto_FrameSize(uint8_t len)
+{
+    return PROTO_HEADER_SIZE + len + PROTO_CRC_SIZE;
+}
+
+/**
+ * @brief  拼接缓冲丢弃首字节后对齐到下一个 SYNC
+ */
+static void Proto_CarryResync(Proto_Parser_t *p)
+{
+    uint32_t i = 1;
+
+    while (i < p->CarryLen && p->Carry[i] != PROTO_SYNC) i++;
+    p->SkippedBytes += i;
+    memmove(p->Carry, &p->Carry[i], p->CarryLen - i);
+    p->CarryLen = (uint8_t)(p->CarryLen - i);
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  计算 CRC16-CCITT
+ */
+uint16_t Proto_Crc16(uint16_t crc, const uint8_t *data, uint32_t len)
+{
+    while (len--) {
+        crc = (uint16_t)((crc << 8) ^ crc16_table[((crc >> 8) ^ *data++) & 0xFF]);
+    }
+    return crc;
+}
+
+/**
+ * @brief  编码一帧
+ */
+uint32_t Proto_Encode(uint8_t *out, uint8_t type, uint8_t seq, const void *payload, uint32_t len)
+{
+    if (len > PROTO_MAX_PAYLOAD) return 0;
+
+    out[0] = PROTO_SYNC;
+    out[1] = (uint8_t)len;
+    out[2] = type;
+    out[3] = seq;
+    if (len > 0) memcpy(&out[PROTO_HEADER_SIZE], payload, len);
+    Proto_PutU16(&out[PROTO_HEADER_SIZE + len], Proto_Crc16(0xFFFF, &out[1], 3u + len));
+
+    return Proto_FrameSize((uint8_t)len);
+}
+
+/**
+ * @brief  初始化解析器
+ */
+void Proto_ParserInit(Proto_Parser_t *p)
+{
+    memset(p, 0, sizeof(*p));
+}
+
+/**
+ * @brief  解析一段接收数据
+ * @note   1. 拼接缓冲非空时先用新数据补齐跨包帧 (只拷贝补齐所需的字节)
+ *         2. 其余完整帧在 data 内原地校验并分发, 不拷贝
+ *         3. 末尾不完整的帧拷入拼接缓冲, 等待下一包
+ *         校验失败只丢弃 SYNC 字节, 从下一个 SYNC 重新同步, 不会跳过有效帧
+ */
+void Proto_Feed(Proto_Parser_t *p, const uint8_t *data, uint32_t len,
+                Proto_Handler_t handler, void *user)
+{
+    uint32_t i = 0;
+
+    /*--- 1. 跨包帧 ---*/
+    while (p->CarryLen > 0) {
+        if (p->Carry[0] != PROTO_SYNC || (p->CarryLen >= 2 && p->Carry[1] > PROTO_MAX_PAYLOAD)) {
+            Proto_CarryResync(p);
+            continue;
+        }
+
+        /* 先补齐 LEN 字段, 再补齐整帧 */
+        uint32_t need = (p->CarryLen < 2) ? 2 : Proto_FrameSize(p->Carry[1]);
+        if (p->CarryLen < need) {
+            if (i >= len) return;           // 等待更多数据
+            uint32_t n = need - p->CarryLen;
+            if (n > len - i) n = len - i;
+            memcpy(&p->Carry[p->CarryLen], &data[i], n);
+            p->CarryLen = (uint8_t)(p->CarryLen + n);
+            i += n;
+            continue;
+        }
+
+        if (Proto_CheckFrame(p->Carry)) {
+            p->Frames++;
+            p->CarriedFrames++;
+            Proto_Dispatch(p->Carry, handler, user);
+
+            /* 重新同步时多补齐的字节属于后续帧, 留在拼接缓冲中 */
+            p->CarryLen = (uint8_t)(p->CarryLen - need);
+            memmove(p->Carry, &p->Carry[need], p->CarryLen);
+        } else {
+            p->CrcErrors++;
+            Proto_CarryResync(p);
+        }
+    }
+
+    /*--- 2. 原地解析 ---*/
+    while (i < len) {
+        if (data[i] != PROTO_SYNC) {
+            i++;
+            p->SkippedBytes++;
+            continue;
+        }
+
+        uint32_t remain = len - i;
+        if (remain < 2) break;
+
+        uint8_t plen = data[i + 1];
+        if (plen > PROTO_MAX_PAYLOAD) {
+            i++;
+            p->SkippedBytes++;
+            continue;
+        }
+
+        uint32_t size = Proto_FrameSize(plen);
+        if (remain < size) break;
+
+        if (Proto_CheckFrame(&data[i])) {
+            p->Frames++;
+            Proto_Dispatch(&data[i], handler, user);
+            i += size;
+        } else {
+            p->CrcErrors++;
+            p->SkippedBytes++;
+            i++;
+        }
+    }
+
+    /*--- 3. 不完整的帧留待下一包 ---*/
+    if (i < len) {
+        memcpy(p->Carry, &data[i], len - i);
+        p->CarryLen = (uint8_t)(len - i);
+    }
+}
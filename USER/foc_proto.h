@@ -0,0 +1,181 @@
+/**
+ * @file    foc_proto.h
+ * @brief   二进制命令协议编解码
+ * @note    纯算法实现，无硬件依赖，固件与上位机共用同一份代码
+ *          帧格式 (小端):
+ *            [0xA5][LEN][TYPE][SEQ][PAYLOAD × LEN][CRC16 低字节][CRC16 高字节]
+ *            CRC16-CCITT (多项式 0x1021, 初值 0xFFFF) 覆盖 LEN ~ PAYLOAD
+ *          一帧不超过 64 字节 (一个 USB FS 包); 解析器优先在接收缓冲区内原地解析,
+ *          只有跨包的帧才拷贝到内部拼接缓冲
+ */
+
+#ifndef __FOC_PROTO_H
+#define __FOC_PROTO_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*============================================================================*/
+/*                              帧格式                                         */
+/*============================================================================*/
+
+#define PROTO_SYNC              0xA5
+#define PROTO_HEADER_SIZE       4           // SYNC + LEN + TYPE + SEQ
+#define PROTO_CRC_SIZE          2
+#define PROTO_MAX_FRAME         64
+#define PROTO_MAX_PAYLOAD       (PROTO_MAX_FRAME - PROTO_HEADER_SIZE - PROTO_CRC_SIZE)
+
+/*============================================================================*/
+/*                              消息定义                                       */
+/*============================================================================*/
+
+/* 消息类型 (负载字段按顺序紧密排列, 多字节字段小端) */
+enum {
+    PROTO_MSG_PING          = 0x01, // 无负载, 回复 ACK
+    PROTO_MSG_ENABLE        = 0x02, // [axis u8][enable u8]: 1=FOC_Start, 0=FOC_Stop
+    PROTO_MSG_CALIBRATE     = 0x03, // [axis u8][kind u8, 可省略]: 编码器校准 (电机须空闲), kind 0=零点/方向 1=非线性补偿,
+                                    // 结果读参数 cal.status / enc.offset / enc.dir / lin.status
+    PROTO_MSG_SET_MODE      = 0x10, // [axis u8][mode u8]
+    PROTO_MSG_SET_TARGET    = 0x11, // [axis u8][mask u8][mode u8, 有 FOC_CMD_MODE 时][f32 × 置位的 ID/IQ/RPM/POS]
+    PROTO_MSG_GET_PARAM     = 0x20, // [axis u8][id u16], 回复 PARAM
+    PROTO_MSG_PARAM         = 0x21, // [axis u8][id u16][value f32]
+    PROTO_MSG_SET_PARAM     = 0x22, // [axis u8][id u16][value f32], 下一控制周期/外环周期生效
+    PROTO_MSG_PARAM_QUERY   = 0x23, // [id u16], 回复 PARAM_INFO
+    PROTO_MSG_PARAM_INFO    = 0x24, // [id u16][count u16][type u8][access u8][min f32][max f32][name]
+    PROTO_MSG_PARAM_SUB     = 0x25, // [slot u8][id u16]: 订阅到遥测通道 VOFA_CH_SUB0 + slot, id=0xFFFF 取消
+    PROTO_MSG_PARAM_SAVE    = 0x26, // 无负载: 保存参数到 Flash (电机须停止)
+    PROTO_MSG_STREAM        = 0x30, // [enable u8][period_ms u16]: 实时数据开关与周期
+    PROTO_MSG_SCOPE_ARM     = 0x31, // [ch_cnt u8][ch u8 × ch_cnt][decim u8][trig u8][trig_ch u8]
+                                    // [edge u8][rearm u8][pre u16][level f32]
+    PROTO_MSG_SCOPE_STOP    = 0x32, // 无负载
+    PROTO_MSG_SCOPE_FORCE   = 0x33, // 无负载
+    PROTO_MSG_TELEM         = 0x40, // 设备发出: 遥测帧 (格式见 foc_telem.h), SEQ 为帧计数
+    PROTO_MSG_TELEM_CHAN    = 0x41, // [ch u8][format u8][div u8][delta u8][scale f32]: 暂存通道配置
+    PROTO_MSG_TELEM_APPLY   = 0x42, // [mask u32][id u8]: 启用暂存配置, mask=0 恢复 VOFA JustFloat
+    PROTO_MSG_TELEM_STATS   = 0x43, // 无负载, 回复 [tick u32][frames u32][dropped u32][ctrl_hz u32]
+    PROTO_MSG_ACK           = 0x7E, // [type u8][status u8], SEQ 与请求相同
+};
+
+/* ACK 状态码 */
+enum {
+    PROTO_OK = 0,               // 成功
+    PROTO_ERR_LENGTH,           // 负载长度错误
+    PROTO_ERR_ARG,              // 参数越界 (轴号/模式/参数号/取值/只读参数)
+    PROTO_ERR_BUSY,             // 当前状态不允许 (命令邮箱忙/示波器采集中/参数写入队列满/编码器校准中)
+    PROTO_ERR_TYPE,             // 未知消息类型
+    PROTO_ERR_FLASH,            // 参数存储写入失败
+};
+
+/* 参数号 (GET/SET_PARAM/PARAM_INFO/PARAM_SUB) 见 foc_param.h, 取值统一以 f32 传输 */
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 已校验的帧 (负载指向接收缓冲区或拼接缓冲, 仅在回调内有效)
+ */
+typedef struct {
+    uint8_t Type;               // 消息类型
+    uint8_t Seq;                // 序号 (应答原样返回)
+    uint8_t Len;                // 负载长度
+    const uint8_t *Payload;     // 负载
+} Proto_Frame_t;
+
+/**
+ * @brief  帧处理回调
+ */
+typedef void (*Proto_Handler_t)(const Proto_Frame_t *frame, void *user);
+
+/**
+ * @brief 流式解析器
+ */
+typedef struct {
+    uint8_t Carry[PROTO_MAX_FRAME]; // 跨包帧拼接缓冲
+    uint8_t CarryLen;           // 拼接缓冲中的字节数
+
+    /* 统计 */
+    uint32_t Frames;            // 有效帧数
+    uint32_t CarriedFrames;     // 经拼接缓冲的有效帧数
+    uint32_t CrcErrors;         // CRC 错误帧数
+    uint32_t SkippedBytes;      // 重新同步丢弃的字节数
+} Proto_Parser_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  计算 CRC16-CCITT
+ * @param  crc: 初值 (0xFFFF) 或上一段的结果
+ */
+uint16_t Proto_Crc16(uint16_t crc, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief  编码一帧
+ * @param  out: 输出缓冲 (至少 PROTO_HEADER_SIZE + len + PROTO_CRC_SIZE 字节)
+ * @param  type: 消息类型
+ * @param  seq: 序号
+ * @param  payload: 负载 (len = 0 时可为 NULL)
+ * @param  len: 负载长度 (不超过 PROTO_MAX_PAYLOAD)
+ * @return 帧长度, 0=负载过长
+ */
+uint32_t Proto_Encode(uint8_t *out, uint8_t type, uint8_t seq, const void *payload, uint32_t len);
+
+/**
+ * @brief  初始化解析器
+ */
+void Proto_ParserInit(Proto_Parser_t *p);
+
+/**
+ * @brief  解析一段接收数据, 对每个有效帧调用回调
+ * @param  p: 解析器
+ * @param  data: 接收数据 (完整的帧直接在此原地解析)
+ * @param  len: 长度
+ * @param  handler: 帧处理回调
+ * @param  user: 回调用户参数
+ */
+void Proto_Feed(Proto_Parser_t *p, const uint8_t *data, uint32_t len,
+                Proto_Handler_t handler, void *user);
+
+/*============================================================================*/
+/*                              负载读写 (小端, 允许非对齐)                      */
+/*============================================================================*/
+
+static inline uint16_t Proto_GetU16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t Proto_GetU32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline float Proto_GetF32(const uint8_t *p)
+{
+    float v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void Proto_PutU16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void Proto_PutU32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline void Proto_PutF32(uint8_t *p, float v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+#endif /* __FOC_PROTO_H */
@@ -0,0 +1,302 @@
+/**
+ * @file    foc_scope.c
+ * @brief   控制周期触发式示波器实现
+ */
+
+#include "foc_scope.h"
+#include "foc_atomic.h"
+#if MOTOR_HW_SIM
+#define SCOPE_TX_FREE()     0xFFFFFFFFu     // 主机仿真无 USB 链路, 发送队列视为总有空间
+#else
+#include "usb_vcp.h"
+#define SCOPE_TX_FREE()     VCP_TxFree()
+#endif
+#include <string.h>
+
+/*============================================================================*/
+/*                              私有变量                                       */
+/*============================================================================*/
+
+static float scope_buf[FOC_SCOPE_BUF_SIZE];     // 采样缓冲 (按样本交错存放各通道)
+static FOC_ScopeConfig_t scope_cfg;             // 当前配置 (布防后中断只读)
+static volatile uint32_t scope_state = FOC_SCOPE_IDLE;
+static volatile uint8_t scope_force_req = 0;    // 强制触发请求 (中断中处理)
+
+/* 采集 (中断写) */
+static uint32_t scope_depth;                    // 深度 (样本数)
+static uint32_t scope_wr;                       // 下一个写入位置
+static uint32_t scope_filled;                   // 布防后已写入样本数 (饱和于深度)
+static uint32_t scope_trig;                     // 触发样本位置
+static uint32_t scope_pre;                      // 有效触发前样本数
+static uint32_t scope_post;                     // 已采集触发后样本数 (含触发样本)
+static uint8_t scope_div_cnt;                   // 采样分频计数
+static uint8_t scope_first;                     // 1=布防后首个样本 (初始化边沿检测)
+
+/* 触发边沿检测 */
+static float scope_last_level;                  // 上一样本的触发通道值
+static uint32_t scope_last_cmd;                 // 上一样本的命令序号
+static Motor_State_t scope_last_motor_state;    // 上一样本的电机状态
+
+/* 上传 (主循环写) */
+static uint32_t scope_rd;                       // 已上传样本数
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  复位采集进度并布防
+ */
+static void Scope_Start(void)
+{
+    scope_depth = FOC_SCOPE_BUF_SIZE / scope_cfg.ChannelCnt;
+    scope_wr = 0;
+    scope_filled = 0;
+    scope_post = 0;
+    scope_div_cnt = 0;
+    scope_first = 1;
+    scope_force_req = 0;
+
+    FOC_Atomic_Barrier();
+    scope_state = FOC_SCOPE_ARMED;
+}
+
+/**
+ * @brief  检查触发条件 (每个样本都调用, 以更新边沿检测状态)
+ * @return 1=本样本满足触发条件
+ */
+static uint8_t Scope_CheckTrigger(const Motor_t *motor, const float *data)
+{
+    float level = data[scope_cfg.TrigChannel];
+    uint32_t cmd = motor->Cmd.ReadSeq;
+    Motor_State_t state = motor->State;
+    uint8_t hit = 0;
+
+    if (scope_first) {
+        scope_first = 0;
+    } else {
+        switch (scope_cfg.Trigger) {
+            case FOC_SCOPE_TRIG_LEVEL: {
+                uint8_t rise = (scope_last_level < scope_cfg.TrigLevel) && (level >= scope_cfg.TrigLevel);
+                uint8_t fall = (scope_last_level > scope_cfg.TrigLevel) && (level <= scope_cfg.TrigLevel);
+                if (scope_cfg.TrigEdge == FOC_SCOPE_EDGE_RISING) hit = rise;
+                else if (scope_cfg.TrigEdge == FOC_SCOPE_EDGE_FALLING) hit = fall;
+                else hit = rise || fall;
+                break;
+            }
+            case FOC_SCOPE_TRIG_SETPOINT:
+                hit = (cmd != scope_last_cmd);
+                break;
+            case FOC_SCOPE_TRIG_FAULT:
+                hit = (state == MOTOR_STATE_ERROR && scope_last_motor_state != MOTOR_STATE_ERROR);
+                break;
+            case FOC_SCOPE_TRIG_FORCE:
+            default:
+                hit = 1;
+                break;
+        }
+    }
+
+    scope_last_level = level;
+    scope_last_cmd = cmd;
+    scope_last_motor_state = state;
+    return hit;
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  获取默认配置
+ */
+void FOC_Scope_DefaultConfig(FOC_ScopeConfig_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->Channels[0] = VOFA_CH_IQ;
+    cfg->Channels[1] = VOFA_CH_IQ_REF;
+    cfg->Channels[2] = VOFA_CH_ID;
+    cfg->Channels[3] = VOFA_CH_VQ;
+    cfg->ChannelCnt = 4;
+    cfg->Decimation = 1;
+    cfg->Trigger = FOC_SCOPE_TRIG_SETPOINT;
+    cfg->TrigChannel = VOFA_CH_IQ_REF;
+    cfg->TrigEdge = FOC_SCOPE_EDGE_BOTH;
+    cfg->AutoRearm = 0;
+    cfg->PreTrigger = (FOC_SCOPE_BUF_SIZE / 4) / 4;
+    cfg->TrigLevel = 0.0f;
+}
+
+/**
+ * @brief  布防
+ */
+uint8_t FOC_Scope_Arm(const FOC_ScopeConfig_t *cfg)
+{
+    uint32_t state = scope_state;
+
+    /* 采集/上传期间中断或主循环仍在使用配置与缓冲 */
+    if (state != FOC_SCOPE_IDLE && state != FOC_SCOPE_DONE) return 0;
+
+    if (cfg->ChannelCnt == 0 || cfg->ChannelCnt > FOC_SCOPE_MAX_CH) return 0;
+    if (cfg->TrigChannel >= VOFA_CHANNEL_CNT) return 0;
+    for (uint8_t c = 0; c < cfg->ChannelCnt; c++) {
+        if (cfg->Channels[c] >= VOFA_CHANNEL_CNT) return 0;
+    }
+    if (cfg->PreTrigger >= FOC_SCOPE_BUF_SIZE / cfg->ChannelCnt) return 0;  // 至少保留触发样本
+
+    scope_cfg = *cfg;
+    if (scope_cfg.Decimation == 0) scope_cfg.Decimation = 1;
+
+    Scope_Start();
+    return 1;
+}
+
+/**
+ * @brief  停止采集/上传
+ * @note   比较交换失败说明中断刚切换了状态, 重新读取后再停止
+ */
+void FOC_Scope_Stop(void)
+{
+    for (;;) {
+        uint32_t state = scope_state;
+        if (state == FOC_SCOPE_IDLE) break;
+        if (FOC_Atomic_CompareExchange(&scope_state, state, FOC_SCOPE_IDLE)) break;
+    }
+    scope_force_req = 0;
+}
+
+/**
+ * @brief  强制触发
+ */
+void FOC_Scope_ForceTrigger(void)
+{
+    scope_force_req = 1;
+}
+
+/**
+ * @brief  读取状态
+ */
+FOC_ScopeState_t FOC_Scope_GetState(void)
+{
+    return (FOC_ScopeState_t)scope_state;
+}
+
+/**
+ * @brief  采样一个控制周期
+ */
+void FOC_Scope_Sample(const Motor_t *motor)
+{
+    uint32_t state = scope_state;
+
+    if (state != FOC_SCOPE_ARMED && state != FOC_SCOPE_TRIGGERED) return;
+
+    if (++scope_div_cnt < scope_cfg.Decimation) return;
+    scope_div_cnt = 0;
+
+    /* 写入样本 (本周期刚发布的调试数据帧) */
+    const float *data = VOFA_ProducerFrame()->Data;
+    uint32_t idx = scope_wr;
+    float *slot = &scope_buf[idx * scope_cfg.ChannelCnt];
+    for (uint8_t c = 0; c < scope_cfg.ChannelCnt; c++) {
+        slot[c] = data[scope_cfg.Channels[c]];
+    }
+    scope_wr = (idx + 1 >= scope_depth) ? 0 : idx + 1;
+
+    if (state == FOC_SCOPE_ARMED) {
+        uint8_t hit = Scope_CheckTrigger(motor, data);
+
+        if (scope_filled < scope_depth) scope_filled++;
+
+        /* 预触发区未填满时忽略触发条件 (强制触发除外) */
+        if (scope_force_req || (hit && scope_filled > scope_cfg.PreTrigger)) {
+            scope_force_req = 0;
+            scope_trig = idx;
+            scope_pre = (scope_filled - 1 < scope_cfg.PreTrigger) ? scope_filled - 1 : scope_cfg.PreTrigger;
+            scope_post = 0;
+            state = FOC_SCOPE_TRIGGERED;
+        } else {
+            return;
+        }
+    }
+
+    /* 触发后样本: 写满深度的剩余部分后冻结 (不会覆盖触发前样本) */
+    scope_post++;
+    if (scope_post >= scope_depth - scope_cfg.PreTrigger) {
+        FOC_Atomic_Barrier();
+        scope_state = FOC_SCOPE_DONE;
+    } else {
+        scope_state = state;
+    }
+}
+
+/**
+ * @brief  读取已完成采集的样本数
+ */
+uint32_t FOC_Scope_GetCapture(uint32_t *pre)
+{
+    uint32_t state = scope_state;
+
+    if (state != FOC_SCOPE_DONE && state != FOC_SCOPE_STREAMING) return 0;
+    if (pre) *pre = scope_pre;
+    return scope_pre + scope_post;
+}
+
+/**
+ * @brief  按时间顺序读取已完成采集的一个样本
+ */
+uint8_t FOC_Scope_ReadSample(uint32_t n, float *out)
+{
+    uint32_t state = scope_state;
+
+    if (state != FOC_SCOPE_DONE && state != FOC_SCOPE_STREAMING) return 0;
+    if (n >= scope_pre + scope_post) return 0;
+
+    uint32_t idx = scope_trig + scope_depth - scope_pre + n;
+    if (idx >= scope_depth) idx -= scope_depth;
+    if (idx >= scope_depth) idx -= scope_depth;
+
+    out[0] = (float)((int32_t)n - (int32_t)scope_pre) * (HW_CONTROL_PERIOD_S * (float)scope_cfg.Decimation);
+    memcpy(&out[1], &scope_buf[idx * scope_cfg.ChannelCnt], scope_cfg.ChannelCnt * sizeof(float));
+    return 1;
+}
+
+/**
+ * @brief  上传已完成的采集
+ * @note   只在发送队列放得下整帧时发送, 不会因队列满而丢帧
+ */
+uint8_t FOC_Scope_Poll(void)
+{
+    static float frame[FOC_SCOPE_MAX_CH + 1];
+    uint32_t state = scope_state;
+
+    if (state == FOC_SCOPE_DONE) {
+        scope_rd = 0;
+        scope_state = FOC_SCOPE_STREAMING;
+    } else if (state != FOC_SCOPE_STREAMING) {
+        return 0;
+    }
+
+    uint8_t nch = scope_cfg.ChannelCnt;
+    uint32_t total = scope_pre + scope_post;
+    uint32_t frame_len = (nch + 1) * sizeof(float) + 4;        // 时间 + 通道 + 帧尾
+
+    for (uint32_t n = 0; n < FOC_SCOPE_STREAM_BURST && scope_rd < total; n++) {
+        if (SCOPE_TX_FREE() < frame_len) break;
+
+        FOC_Scope_ReadSample(scope_rd, frame);
+        VOFA_Send_JustFloat(frame, nch + 1);
+        scope_rd++;
+    }
+
+    if (scope_rd < total) return 1;
+
+    /* 上传完成 (期间可能已被 FOC_Scope_Stop 取消) */
+    if (scope_state == FOC_SCOPE_STREAMING) {
+        if (scope_cfg.AutoRearm) {
+            Scope_Start();
+        } else {
+            scope_state = FOC_SCOPE_IDLE;
+        }
+    }
+    return 0;
+}
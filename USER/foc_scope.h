@@ -0,0 +1,133 @@
+/**
+ * @file    foc_scope.h
+ * @brief   控制周期触发式示波器 (片上高速采集)
+ * @note    采集: 控制中断每周期 (或按分频) 从刚发布的 VOFA 调试数据帧取所选 VOFA_CH_* 通道写入环形缓冲,
+ *                满足触发条件后再采集设定的触发后样本数即冻结, 触发前样本保留在缓冲中
+ *          上传: 主循环在采集完成后按 USB 发送队列空闲量分批发送 JustFloat 帧,
+ *                每帧为 [相对触发时刻(s), 通道0, 通道1, ...], 上传期间暂停实时数据
+ *          状态切换: 主循环只在 IDLE/DONE 下修改配置, 中断只处理 ARMED/TRIGGERED,
+ *                    停止/强制触发以请求标志交给中断处理
+ */
+
+#ifndef __FOC_SCOPE_H
+#define __FOC_SCOPE_H
+
+#include <stdint.h>
+#include "foc_core.h"
+#include "vofa.h"
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#ifndef FOC_SCOPE_ENABLE
+#define FOC_SCOPE_ENABLE        1           // 1=编译示波器
+#endif
+
+#define FOC_SCOPE_MAX_CH        8           // 最大采集通道数
+#define FOC_SCOPE_BUF_SIZE      4096        // 采样缓冲 (float 个数, 深度 = BUF_SIZE / 通道数)
+#define FOC_SCOPE_STREAM_BURST  32          // 每次 FOC_Scope_Poll 最多上传的样本数
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/* 触发源 */
+typedef enum {
+    FOC_SCOPE_TRIG_FORCE = 0,   // 预触发区填满后立即触发
+    FOC_SCOPE_TRIG_LEVEL,       // 通道越过电平
+    FOC_SCOPE_TRIG_SETPOINT,    // 收到新的目标值命令
+    FOC_SCOPE_TRIG_FAULT,       // 电机进入故障状态
+} FOC_ScopeTrig_t;
+
+/* 电平触发边沿 */
+typedef enum {
+    FOC_SCOPE_EDGE_RISING = 0,  // 上升沿
+    FOC_SCOPE_EDGE_FALLING,     // 下降沿
+    FOC_SCOPE_EDGE_BOTH,        // 双边沿
+} FOC_ScopeEdge_t;
+
+/* 示波器状态 */
+typedef enum {
+    FOC_SCOPE_IDLE = 0,         // 空闲
+    FOC_SCOPE_ARMED,            // 已布防, 采集触发前样本并等待触发
+    FOC_SCOPE_TRIGGERED,        // 已触发, 采集触发后样本
+    FOC_SCOPE_DONE,             // 采集完成, 等待上传
+    FOC_SCOPE_STREAMING,        // 上传中
+} FOC_ScopeState_t;
+
+/**
+ * @brief 采集配置
+ */
+typedef struct {
+    uint8_t Channels[FOC_SCOPE_MAX_CH]; // 采集通道 (VOFA_CH_*)
+    uint8_t ChannelCnt;         // 通道数 (1 ~ FOC_SCOPE_MAX_CH)
+    uint8_t Decimation;         // 采样分频 (1 = 每个控制周期)
+    uint8_t Trigger;            // 触发源 (FOC_ScopeTrig_t)
+    uint8_t TrigChannel;        // 电平触发通道 (VOFA_CH_*, 可不在采集通道中)
+    uint8_t TrigEdge;           // 电平触发边沿 (FOC_ScopeEdge_t)
+    uint8_t AutoRearm;          // 1=上传完成后自动重新布防
+    uint16_t PreTrigger;        // 触发前样本数 (不超过深度)
+    float TrigLevel;            // 触发电平
+} FOC_ScopeConfig_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  获取默认配置 (Iq 阶跃: 采集 Iq/Iq参考/Id/Vq, 目标值命令触发, 触发前 1/4 深度)
+ * @param  cfg: 配置结构体指针
+ */
+void FOC_Scope_DefaultConfig(FOC_ScopeConfig_t *cfg);
+
+/**
+ * @brief  布防 (主循环调用)
+ * @param  cfg: 采集配置
+ * @return 1=成功, 0=配置无效或正在采集/上传
+ */
+uint8_t FOC_Scope_Arm(const FOC_ScopeConfig_t *cfg);
+
+/**
+ * @brief  停止采集/上传并回到空闲 (采集中由下一次采样处理)
+ */
+void FOC_Scope_Stop(void);
+
+/**
+ * @brief  强制触发 (不等待预触发区填满)
+ */
+void FOC_Scope_ForceTrigger(void);
+
+/**
+ * @brief  读取状态
+ */
+FOC_ScopeState_t FOC_Scope_GetState(void);
+
+/**
+ * @brief  采样一个控制周期 (在 VOFA_UpdateFromMotor 之后调用)
+ * @param  motor: 采集轴的电机对象 (触发条件用)
+ */
+void FOC_Scope_Sample(const Motor_t *motor);
+
+/**
+ * @brief  读取已完成采集的样本数 (DONE / STREAMING 状态下有效)
+ * @param  pre: 输出触发前样本数 (触发样本的序号), 可为 NULL
+ * @return 样本总数 (触发前 + 触发后, 含触发样本), 0=无完成的采集
+ */
+uint32_t FOC_Scope_GetCapture(uint32_t *pre);
+
+/**
+ * @brief  按时间顺序读取已完成采集的一个样本 (主循环调用, 上传帧即由此组成)
+ * @param  n: 样本序号 (0 ~ 样本总数-1)
+ * @param  out: 输出 [相对触发时刻(s), 通道0, 通道1, ...], 长度 ChannelCnt + 1
+ * @return 1=成功, 0=无完成的采集或序号越界
+ */
+uint8_t FOC_Scope_ReadSample(uint32_t n, float *out);
+
+/**
+ * @brief  上传已完成的采集 (主循环调用)
+ * @return 1=上传中 (调用方应暂停实时数据), 0=无上传
+ */
+uint8_t FOC_Scope_Poll(void);
+
+#endif /* __FOC_SCOPE_H */
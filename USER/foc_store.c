@@ -0,0 +1,220 @@
+/**
+ * @file    foc_store.c
+ * @brief   掉电安全的参数记录存储实现
+ */
+
+#include "foc_store.h"
+#include <stddef.h>
+#include <string.h>
+
+/*============================================================================*/
+/*                              常量定义                                       */
+/*============================================================================*/
+
+/* CRC32 (反射多项式 0xEDB88320) 半字节查表 */
+static const uint32_t store_crc_table[16] = {
+    0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu,
+    0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+    0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu,
+    0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu,
+};
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  取槽地址
+ */
+static const FOC_StoreRecord_t *Store_Slot(const FOC_Store_t *st, uint8_t bank, uint32_t slot)
+{
+    return (const FOC_StoreRecord_t *)((const uint8_t *)st->Flash->Base[bank] + slot * FOC_STORE_SLOT_SIZE);
+}
+
+/**
+ * @brief  校验记录
+ */
+static uint8_t Store_Valid(const FOC_StoreRecord_t *r)
+{
+    uint32_t len = r->VerLen & 0xFFFFu;
+
+    if (r->Magic != FOC_STORE_MAGIC || len > FOC_STORE_MAX_PAYLOAD) return 0;
+
+    uint32_t crc = FOC_Store_Crc32(0, &r->Seq, 2 * sizeof(uint32_t));
+    crc = FOC_Store_Crc32(crc, r + 1, len);
+    return (crc == r->Crc) ? 1 : 0;
+}
+
+/**
+ * @brief  二分查找已占用槽数 (槽按顺序占用, Magic 字非擦除态即占用)
+ */
+static uint32_t Store_UsedSlots(const FOC_Store_t *st, uint8_t bank)
+{
+    uint32_t lo = 0;
+    uint32_t hi = st->SlotCnt;
+
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (Store_Slot(st, bank, mid)->Magic != FOC_FLASH_ERASED) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief  自已占用区末尾向前查找第一条有效记录
+ */
+static const FOC_StoreRecord_t *Store_LastValid(FOC_Store_t *st, uint8_t bank, uint32_t used)
+{
+    while (used > 0) {
+        const FOC_StoreRecord_t *r = Store_Slot(st, bank, --used);
+        if (Store_Valid(r)) return r;
+        st->Skipped++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief  槽是否整体处于擦除态
+ */
+static uint8_t Store_SlotErased(const FOC_Store_t *st, uint8_t bank, uint32_t slot)
+{
+    const uint32_t *p = (const uint32_t *)Store_Slot(st, bank, slot);
+
+    for (uint32_t i = 0; i < FOC_STORE_SLOT_SIZE / 4; i++) {
+        if (p[i] != FOC_FLASH_ERASED) return 0;
+    }
+    return 1;
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  CRC32
+ */
+uint32_t FOC_Store_Crc32(uint32_t crc, const void *data, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ store_crc_table[crc & 0x0Fu];
+        crc = (crc >> 4) ^ store_crc_table[crc & 0x0Fu];
+    }
+    return ~crc;
+}
+
+/**
+ * @brief  挂载存储
+ */
+void FOC_Store_Mount(FOC_Store_t *st, const FOC_Flash_t *flash)
+{
+    uint32_t used[FOC_FLASH_BANKS];
+
+    memset(st, 0, sizeof(*st));
+    st->Flash = flash;
+    st->SlotCnt = flash->BankSize / FOC_STORE_SLOT_SIZE;
+
+    for (uint8_t b = 0; b < FOC_FLASH_BANKS; b++) {
+        used[b] = Store_UsedSlots(st, b);
+        const FOC_StoreRecord_t *r = Store_LastValid(st, b, used[b]);
+        if (r != NULL && (st->Latest == NULL || (int32_t)(r->Seq - st->Seq) > 0)) {
+            st->Latest = r;
+            st->Seq = r->Seq;
+            st->Bank = b;
+        }
+    }
+
+    if (st->Latest != NULL) {
+        st->Next = used[st->Bank];
+    } else {
+        /* 空片或两块均无有效记录: 首次写入前擦除块 0 */
+        st->Bank = 0;
+        st->Next = 0;
+        st->NeedErase = 1;
+    }
+}
+
+/**
+ * @brief  读取最新记录
+ */
+const void *FOC_Store_Read(const FOC_Store_t *st, uint16_t *version, uint32_t *len)
+{
+    if (st->Latest == NULL) return NULL;
+
+    *version = (uint16_t)(st->Latest->VerLen >> 16);
+    *len = st->Latest->VerLen & 0xFFFFu;
+    return st->Latest + 1;
+}
+
+/**
+ * @brief  写入一条新记录
+ * @note   写入失败的槽不再使用; 当前块中跳过非擦除态的槽, 写满后切换到另一块
+ */
+uint8_t FOC_Store_Write(FOC_Store_t *st, uint16_t version, const void *data, uint32_t len)
+{
+    const FOC_Flash_t *flash = st->Flash;
+    uint32_t head[3];
+    uint32_t magic = FOC_STORE_MAGIC;
+    uint32_t words = len / 4;
+
+    if (flash == NULL || len > FOC_STORE_MAX_PAYLOAD) return 0;
+
+    /*--- 1. 选槽 (必要时切换并擦除另一块) ---*/
+    while (!st->NeedErase && st->Next < st->SlotCnt && !Store_SlotErased(st, st->Bank, st->Next)) {
+        st->Next++;
+    }
+    if (st->Next >= st->SlotCnt) {
+        st->Bank ^= 1;
+        st->Next = 0;
+        st->NeedErase = 1;
+    }
+    if (st->NeedErase) {
+        if (!flash->Erase(st->Bank)) {
+            st->Errors++;
+            return 0;
+        }
+        st->Erases++;
+        st->NeedErase = 0;
+    }
+
+    uint32_t offset = st->Next * FOC_STORE_SLOT_SIZE;
+    st->Next++;
+
+    /*--- 2. Magic → 负载 → 记录头 → CRC ---*/
+    head[0] = st->Seq + 1;
+    head[1] = ((uint32_t)version << 16) | len;
+    head[2] = FOC_Store_Crc32(FOC_Store_Crc32(0, head, 2 * sizeof(uint32_t)), data, len);
+
+    uint8_t ok = flash->Program(st->Bank, offset, &magic, 1);
+    if (ok && words > 0) {
+        ok = flash->Program(st->Bank, offset + sizeof(FOC_StoreRecord_t), (const uint32_t *)data, words);
+    }
+    if (ok && (len & 3u)) {
+        /* 末尾不足一字的部分补 0xFF */
+        uint32_t tail = FOC_FLASH_ERASED;
+        memcpy(&tail, (const uint8_t *)data + 4u * words, len & 3u);
+        ok = flash->Program(st->Bank, offset + sizeof(FOC_StoreRecord_t) + 4u * words, &tail, 1);
+    }
+    if (ok) {
+        ok = flash->Program(st->Bank, offset + offsetof(FOC_StoreRecord_t, Seq), head, 3);
+    }
+
+    /*--- 3. 回读校验 ---*/
+    const FOC_StoreRecord_t *r = Store_Slot(st, st->Bank, offset / FOC_STORE_SLOT_SIZE);
+    if (!ok || !Store_Valid(r) || r->Seq != head[0]) {
+        st->Errors++;
+        return 0;
+    }
+
+    st->Latest = r;
+    st->Seq = head[0];
+    st->Writes++;
+    return 1;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file    foc_store.h
+ * @brief   掉电安全的参数记录存储 (A/B 两块 Flash, 追加写入)
+ * @note    纯算法实现，无硬件依赖，经 FOC_Flash_t 驱动访问 Flash (主机上以 RAM 仿真验证)
+ *          布局: 每块划分为 FOC_STORE_SLOT_SIZE 字节的槽, 每次保存写入下一个空槽:
+ *            槽 = [Magic][Seq][Version|Len][Crc32][负载, 补齐到 4 字节]
+ *          写入顺序: Magic (标记槽已占用) → 负载 → Seq/Version/Len → Crc32,
+ *          任何时刻掉电, 未写完的记录 CRC 不通过, 加载时退回上一条有效记录
+ *          磨损均衡: 当前块写满后擦除另一块并从其首槽继续, 旧块在新块写入成功前一直有效;
+ *                    两块轮流擦除, 每次擦除前写满整块
+ *          挂载: 每块按 Magic 二分查找已占用槽数 (槽按顺序占用), 自末尾向前找第一条
+ *                CRC 正确的记录, 取两块中 Seq 较大者, 正常情况下每块只校验一条记录
+ */
+
+#ifndef __FOC_STORE_H
+#define __FOC_STORE_H
+
+#include <stdint.h>
+#include "foc_flash.h"
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#define FOC_STORE_MAGIC         0x50434F46u     // "FOCP"
+#define FOC_STORE_SLOT_SIZE     1024u           // 槽字节数 (记录头 + 负载上限)
+#define FOC_STORE_MAX_PAYLOAD   (FOC_STORE_SLOT_SIZE - sizeof(FOC_StoreRecord_t))
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 记录头 (槽起始处)
+ */
+typedef struct {
+    uint32_t Magic;             // FOC_STORE_MAGIC, 最先写入
+    uint32_t Seq;               // 记录序号 (每次保存加一)
+    uint32_t VerLen;            // 负载版本 (高 16 位) | 负载字节数 (低 16 位)
+    uint32_t Crc;               // CRC32, 覆盖 Seq / VerLen / 负载
+} FOC_StoreRecord_t;
+
+/**
+ * @brief 存储对象
+ */
+typedef struct {
+    const FOC_Flash_t *Flash;
+    uint32_t SlotCnt;           // 每块槽数
+    const FOC_StoreRecord_t *Latest;    // 最新有效记录 (NULL=无)
+    uint32_t Seq;               // 最新记录序号
+    uint8_t Bank;               // 写入块
+    uint8_t NeedErase;          // 1=写入前须先擦除写入块
+    uint32_t Next;              // 写入块中下一个空槽
+
+    /* 统计 */
+    uint32_t Skipped;           // 挂载时跳过的损坏记录数
+    uint32_t Writes;            // 成功写入次数
+    uint32_t Erases;            // 擦除次数
+    uint32_t Errors;            // 擦除/编程/校验失败次数
+} FOC_Store_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  挂载存储 (扫描两块, 定位最新有效记录与写入位置)
+ * @param  st: 存储对象
+ * @param  flash: Flash 驱动
+ */
+void FOC_Store_Mount(FOC_Store_t *st, const FOC_Flash_t *flash);
+
+/**
+ * @brief  读取最新记录
+ * @param  st: 存储对象
+ * @param  version: 输出负载版本
+ * @param  len: 输出负载字节数
+ * @return 负载 (指向 Flash 映射区), NULL=无有效记录
+ */
+const void *FOC_Store_Read(const FOC_Store_t *st, uint16_t *version, uint32_t *len);
+
+/**
+ * @brief  写入一条新记录
+ * @param  st: 存储对象
+ * @param  version: 负载版本
+ * @param  data: 负载 (4 字节对齐)
+ * @param  len: 负载字节数 (不超过 FOC_STORE_MAX_PAYLOAD)
+ * @return 1=成功 (已回读校验), 0=失败 (最新记录保持不变)
+ * @note   写满当前块时擦除另一块, 耗时与 Flash 擦除相同
+ */
+uint8_t FOC_Store_Write(FOC_Store_t *st, uint16_t version, const void *data, uint32_t len);
+
+/**
+ * @brief  CRC32 (IEEE 802.3, 半字节查表)
+ */
+uint32_t FOC_Store_Crc32(uint32_t crc, const void *data, uint32_t len);
+
+#endif /* __FOC_STORE_H */
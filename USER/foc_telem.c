@@ -0,0 +1,392 @@
+/**
+ * @file    foc_telem.c
+ * @brief   紧凑遥测编解码实现
+ */
+
+#include "foc_telem.h"
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  启用通道数
+ */
+static uint32_t Telem_ChannelCount(uint32_t mask)
+{
+    uint32_t n = 0;
+
+    while (mask) {
+        mask &= mask - 1u;
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief  通道值转编码值 (F32 位模式 / F16 位模式 / I16 整数)
+ */
+static int32_t Telem_Quantize(const Telem_ChannelCfg_t *ch, float v)
+{
+    int32_t q;
+
+    switch (ch->Format) {
+        case TELEM_FMT_F16:
+            return Telem_FloatToHalf(v);
+        case TELEM_FMT_I16: {
+            float x = v / ch->Scale;
+            if (!(x == x)) return 0;                    // NaN
+            if (x >= 32767.0f) return 32767;
+            if (x <= -32767.0f) return -32767;
+            q = (int32_t)(x + ((x >= 0.0f) ? 0.5f : -0.5f));
+            return q;
+        }
+        case TELEM_FMT_F32:
+        default:
+            memcpy(&q, &v, sizeof(q));
+            return q;
+    }
+}
+
+/**
+ * @brief  编码值转通道值
+ */
+static float Telem_Dequantize(const Telem_ChannelCfg_t *ch, int32_t q)
+{
+    float v;
+
+    switch (ch->Format) {
+        case TELEM_FMT_F16:
+            return Telem_HalfToFloat((uint16_t)q);
+        case TELEM_FMT_I16:
+            return (float)q * ch->Scale;
+        case TELEM_FMT_F32:
+        default:
+            memcpy(&v, &q, sizeof(v));
+            return v;
+    }
+}
+
+/**
+ * @brief  完整值字节数
+ */
+static inline uint32_t Telem_FullSize(const Telem_ChannelCfg_t *ch)
+{
+    return (ch->Format == TELEM_FMT_F32) ? 4u : 2u;
+}
+
+/**
+ * @brief  组一条记录
+ * @note   本帧尚未发送过的通道只用 FULL (分频通道可能在帧内首条记录之后才首次出现)
+ * @param  q: 各通道编码值 (已量化)
+ * @param  due: 本记录采样的通道掩码
+ * @param  out: 输出缓冲 (能容纳最长记录)
+ * @return 记录长度
+ */
+static uint32_t Telem_BuildRecord(const Telem_Encoder_t *enc, const int32_t *q,
+                                  uint32_t due, uint8_t *out)
+{
+    uint32_t head = (2u * Telem_ChannelCount(enc->Cfg.Mask) + 7u) / 8u;
+    uint32_t n = head;
+    uint32_t slot = 0;
+
+    memset(out, 0, head);
+
+    for (uint32_t c = 0; c < TELEM_MAX_CH; c++) {
+        if (!(enc->Cfg.Mask & (1u << c))) continue;
+
+        const Telem_ChannelCfg_t *ch = &enc->Cfg.Ch[c];
+        uint32_t code = TELEM_CODE_NONE;
+
+        if (due & (1u << c)) {
+            int32_t d = q[c] - enc->Last[c];
+            uint8_t ref = ch->Delta && (enc->FrameSent & (1u << c));
+
+            if (ref && d == 0) {
+                code = TELEM_CODE_REPEAT;
+            } else if (ref && ch->Format == TELEM_FMT_I16 && d >= -127 && d <= 127) {
+                code = TELEM_CODE_DELTA;
+                out[n++] = (uint8_t)(int8_t)d;
+            } else {
+                code = TELEM_CODE_FULL;
+                out[n++] = (uint8_t)q[c];
+                out[n++] = (uint8_t)(q[c] >> 8);
+                if (ch->Format == TELEM_FMT_F32) {
+                    out[n++] = (uint8_t)(q[c] >> 16);
+                    out[n++] = (uint8_t)(q[c] >> 24);
+                }
+            }
+        }
+
+        out[slot >> 2] |= (uint8_t)(code << ((slot & 3u) * 2u));
+        slot++;
+    }
+    return n;
+}
+
+/**
+ * @brief  解码一条记录
+ * @param  rec: 记录起始
+ * @param  len: 剩余字节数
+ * @param  sampled: 输出本记录采样的通道掩码
+ * @return 记录长度, 0=格式错误
+ */
+static uint32_t Telem_DecodeRecord(Telem_Decoder_t *dec, const uint8_t *rec, uint32_t len,
+                                   uint32_t *sampled)
+{
+    uint32_t head = (2u * Telem_ChannelCount(dec->Cfg.Mask) + 7u) / 8u;
+    uint32_t i = head;
+    uint32_t slot = 0;
+
+    *sampled = 0;
+    if (head > len) return 0;
+
+    for (uint32_t c = 0; c < TELEM_MAX_CH; c++) {
+        if (!(dec->Cfg.Mask & (1u << c))) continue;
+
+        const Telem_ChannelCfg_t *ch = &dec->Cfg.Ch[c];
+        uint32_t code = (rec[slot >> 2] >> ((slot & 3u) * 2u)) & 3u;
+        int32_t q;
+        slot++;
+
+        if (code == TELEM_CODE_NONE) continue;
+
+        if (code == TELEM_CODE_FULL) {
+            uint32_t size = Telem_FullSize(ch);
+            if (i + size > len) return 0;
+            if (size == 4) {
+                q = (int32_t)((uint32_t)rec[i] | ((uint32_t)rec[i + 1] << 8) |
+                              ((uint32_t)rec[i + 2] << 16) | ((uint32_t)rec[i + 3] << 24));
+            } else if (ch->Format == TELEM_FMT_I16) {
+                q = (int16_t)(rec[i] | (rec[i + 1] << 8));
+            } else {
+                q = (uint16_t)(rec[i] | (rec[i + 1] << 8));
+            }
+            i += size;
+        } else {
+            /* DELTA/REPEAT 只引用同一帧内已解码的值 */
+            if (!(dec->Valid & (1u << c))) return 0;
+            q = dec->Last[c];
+            if (code == TELEM_CODE_DELTA) {
+                if (i + 1 > len || ch->Format != TELEM_FMT_I16) return 0;
+                q += (int8_t)rec[i++];
+            }
+        }
+
+        dec->Last[c] = q;
+        dec->Valid |= 1u << c;
+        dec->Value[c] = Telem_Dequantize(ch, q);
+        *sampled |= 1u << c;
+        dec->Samples++;
+    }
+    return i;
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  默认配置
+ */
+void Telem_DefaultConfig(Telem_Config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    for (uint32_t c = 0; c < TELEM_MAX_CH; c++) {
+        cfg->Ch[c].Format = TELEM_FMT_F32;
+        cfg->Ch[c].Div = 1;
+        cfg->Ch[c].Scale = 1.0f;
+    }
+}
+
+/**
+ * @brief  初始化编码器
+ */
+void Telem_EncoderInit(Telem_Encoder_t *enc, const Telem_Config_t *cfg,
+                       Telem_Output_t output, void *user)
+{
+    memset(enc, 0, sizeof(*enc));
+    enc->Cfg = *cfg;
+    enc->Output = output;
+    enc->User = user;
+
+    for (uint32_t c = 0; c < TELEM_MAX_CH; c++) {
+        if (enc->Cfg.Ch[c].Div == 0) enc->Cfg.Ch[c].Div = 1;
+        if (enc->Cfg.Ch[c].Format == TELEM_FMT_I16 && enc->Cfg.Ch[c].Scale == 0.0f) {
+            enc->Cfg.Ch[c].Scale = 1.0f;
+        }
+    }
+}
+
+/**
+ * @brief  编码一条记录
+ */
+void Telem_Encode(Telem_Encoder_t *enc, uint32_t tick, const float *values)
+{
+    uint8_t rec[1 + TELEM_MAX_CH / 4 + TELEM_MAX_CH * 4];   // 最长记录: 节拍间隔 + 头部 + 全部 F32
+    int32_t q[TELEM_MAX_CH];
+    uint32_t due = 0;
+    uint32_t len;
+
+    if (enc->Cfg.Mask == 0) return;
+
+    /* 分频到期的通道 */
+    for (uint32_t c = 0; c < TELEM_MAX_CH; c++) {
+        if ((enc->Cfg.Mask & (1u << c)) && enc->DivCnt[c] == 0) {
+            due |= 1u << c;
+            q[c] = Telem_Quantize(&enc->Cfg.Ch[c], values[c]);
+        }
+    }
+
+    /* 节拍间隔一字节放不下时另起一帧 (帧头携带完整节拍号) */
+    if (enc->Len > TELEM_FRAME_HEAD && tick - enc->LastTick > TELEM_MAX_STRIDE) {
+        Telem_Flush(enc);
+    }
+
+    len = 1 + Telem_BuildRecord(enc, q, due, &rec[1]);
+    if (enc->Len > TELEM_FRAME_HEAD && enc->Len + len > TELEM_MAX_PAYLOAD) {
+        Telem_Flush(enc);
+        len = 1 + Telem_BuildRecord(enc, q, due, &rec[1]);     // 新帧: 全部使用完整值
+    }
+    if (enc->Len == 0) {
+        enc->Buf[0] = enc->Cfg.Id;
+        Proto_PutU16(&enc->Buf[1], (uint16_t)enc->Frames);
+        Proto_PutU32(&enc->Buf[3], tick);
+        enc->Len = TELEM_FRAME_HEAD;
+        enc->LastTick = tick;
+    }
+    if (enc->Len + len > TELEM_MAX_PAYLOAD) return;    // 单条记录超过一帧 (启用的 F32 通道过多)
+
+    rec[0] = (uint8_t)(tick - enc->LastTick);
+    enc->LastTick = tick;
+    memcpy(&enc->Buf[enc->Len], rec, len);
+    enc->Len += len;
+    enc->Records++;
+
+    for (uint32_t c = 0; c < TELEM_MAX_CH; c++) {
+        if (!(enc->Cfg.Mask & (1u << c))) continue;
+        if (due & (1u << c)) {
+            enc->Last[c] = q[c];
+            enc->Samples++;
+        }
+        enc->FrameSent |= due & (1u << c);
+        if (++enc->DivCnt[c] >= enc->Cfg.Ch[c].Div) enc->DivCnt[c] = 0;
+    }
+}
+
+/**
+ * @brief  输出组帧缓冲中的记录
+ */
+void Telem_Flush(Telem_Encoder_t *enc)
+{
+    if (enc->Len <= TELEM_FRAME_HEAD) return;
+
+    enc->Output(enc->Buf, enc->Len, enc->User);
+    enc->Frames++;
+    enc->Bytes += enc->Len;
+    enc->Len = 0;                                   // 下一帧重新写入帧头
+    enc->FrameSent = 0;
+}
+
+/**
+ * @brief  初始化解码器
+ */
+void Telem_DecoderInit(Telem_Decoder_t *dec, const Telem_Config_t *cfg)
+{
+    memset(dec, 0, sizeof(*dec));
+    dec->Cfg = *cfg;
+}
+
+/**
+ * @brief  解码一帧遥测负载
+ */
+uint32_t Telem_Decode(Telem_Decoder_t *dec, const uint8_t *payload, uint32_t len,
+                      Telem_Record_t cb, void *user)
+{
+    uint32_t records = 0;
+    uint32_t i = TELEM_FRAME_HEAD;
+
+    if (len < TELEM_FRAME_HEAD || dec->Cfg.Mask == 0) return 0;
+    if (payload[0] != dec->Cfg.Id) {
+        dec->CfgMismatch++;
+        return 0;
+    }
+
+    dec->Frames++;
+    dec->Valid = 0;
+    dec->Seq = Proto_GetU16(&payload[1]);
+    dec->Tick = Proto_GetU32(&payload[3]);
+
+    while (i < len) {
+        uint32_t sampled;
+        uint32_t n = (len - i > 1) ? Telem_DecodeRecord(dec, &payload[i + 1], len - i - 1, &sampled) : 0;
+
+        if (n == 0) {
+            dec->Errors++;
+            break;
+        }
+        dec->Tick += payload[i];
+        i += 1 + n;
+        records++;
+        dec->Records++;
+        if (cb != NULL) cb(dec->Value, sampled, dec->Tick, user);
+    }
+    return records;
+}
+
+/**
+ * @brief  单精度转半精度
+ */
+uint16_t Telem_FloatToHalf(float f)
+{
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+
+    uint16_t sign = (uint16_t)((x >> 16) & 0x8000u);
+    uint32_t a = x & 0x7FFFFFFFu;
+
+    if (a >= 0x7F800000u) {                         // 无穷/NaN
+        return sign | 0x7C00u | ((a > 0x7F800000u) ? 0x0200u : 0u);
+    }
+    if (a >= 0x477FF000u) return sign | 0x7C00u;    // 舍入后超过 65504
+    if (a < 0x38800000u) {                          // 半精度非规格化数
+        if (a < 0x33000000u) return sign;           // 小于最小非规格化数的一半
+        uint32_t e = a >> 23;
+        uint32_t m = (a & 0x7FFFFFu) | 0x800000u;
+        uint32_t shift = 126u - e;
+        uint32_t h = m >> shift;
+        uint32_t rem = m & ((1u << shift) - 1u);
+        uint32_t half = 1u << (shift - 1u);
+        if (rem > half || (rem == half && (h & 1u))) h++;
+        return sign | (uint16_t)h;
+    }
+
+    uint32_t h = (a - 0x38000000u) >> 13;
+    uint32_t rem = a & 0x1FFFu;
+    if (rem > 0x1000u || (rem == 0x1000u && (h & 1u))) h++;
+    return sign | (uint16_t)h;
+}
+
+/**
+ * @brief  半精度转单精度
+ */
+float Telem_HalfToFloat(uint16_t h)
+{
+    uint32_t sign = (uint32_t)(h & 0x8000u) << 16;
+    uint32_t e = (h >> 10) & 0x1Fu;
+    uint32_t m = h & 0x3FFu;
+    uint32_t x;
+    float f;
+
+    if (e == 0) {
+        f = (float)m * 5.9604645e-8f;               // m × 2^-24
+        return sign ? -f : f;
+    }
+    if (e == 31) {
+        x = sign | 0x7F800000u | (m << 13);
+    } else {
+        x = sign | ((e + 112u) << 23) | (m << 13);
+    }
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
@@ -0,0 +1,184 @@
+/**
+ * @file    foc_telem.h
+ * @brief   紧凑遥测编解码 (通道选择/分频/半精度与定标整数/差分与重复压缩)
+ * @note    纯算法实现，无硬件依赖，固件与上位机共用同一份代码
+ *          遥测帧负载 (作为 PROTO_MSG_TELEM 的负载发送):
+ *            [配置号 u8][帧序号 u16][首条记录节拍号 u32][记录 × n]
+ *          记录 = [距上条记录的节拍数 u8][头部: 每个启用通道 2 位, 按通道号升序, 低位在前][各通道数据]
+ *            帧内首条记录的节拍间隔为 0; 间隔超过 255 时另起一帧
+ *            帧序号逐帧加一 (与发送成败无关), 接收端由序号跳变统计丢帧
+ *            TELEM_CODE_NONE   本记录未采样 (分频)      无数据
+ *            TELEM_CODE_FULL   完整值                   F32=4 / F16=2 / I16=2 字节
+ *            TELEM_CODE_DELTA  与上次的差 (仅 I16)       int8 1 字节
+ *            TELEM_CODE_REPEAT 与上次相同               无数据
+ *          通道在每帧内首次出现时只用 FULL, 丢帧不影响后续帧解码
+ */
+
+#ifndef __FOC_TELEM_H
+#define __FOC_TELEM_H
+
+#include <stdint.h>
+#include "foc_proto.h"
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#define TELEM_MAX_CH            32          // 通道数上限 (启用掩码位数)
+#define TELEM_MAX_PAYLOAD       PROTO_MAX_PAYLOAD
+#define TELEM_FRAME_HEAD        7           // 配置号 + 帧序号 + 节拍号
+#define TELEM_MAX_STRIDE        255         // 帧内相邻记录的最大节拍间隔
+
+/* 通道编码 */
+enum {
+    TELEM_FMT_F32 = 0,          // 单精度浮点
+    TELEM_FMT_F16,              // 半精度浮点 (IEEE 754 binary16)
+    TELEM_FMT_I16,              // 定标 16 位整数 (值 = 整数 × Scale)
+};
+
+/* 记录头部编码 */
+enum {
+    TELEM_CODE_NONE = 0,
+    TELEM_CODE_FULL,
+    TELEM_CODE_DELTA,
+    TELEM_CODE_REPEAT,
+};
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 单通道配置
+ */
+typedef struct {
+    uint8_t Format;             // 编码 (TELEM_FMT_xxx)
+    uint8_t Div;                // 分频 (1 = 每条记录都采样)
+    uint8_t Delta;              // 1=差分/重复压缩 (慢变通道)
+    uint8_t Reserved;
+    float Scale;                // I16 的 1 LSB 对应值
+} Telem_ChannelCfg_t;
+
+/**
+ * @brief 遥测配置 (编码端与解码端须一致, 以配置号核对)
+ */
+typedef struct {
+    uint32_t Mask;              // 启用掩码 (bit n = 通道 n)
+    uint8_t Id;                 // 配置号
+    Telem_ChannelCfg_t Ch[TELEM_MAX_CH];
+} Telem_Config_t;
+
+/**
+ * @brief  帧输出回调 (编码端)
+ */
+typedef void (*Telem_Output_t)(const uint8_t *payload, uint32_t len, void *user);
+
+/**
+ * @brief  记录输出回调 (解码端)
+ * @param  values: 各通道当前值 (按通道号索引, 未启用通道无意义)
+ * @param  sampled: 本记录采样的通道掩码 (含 REPEAT)
+ * @param  tick: 本记录的控制周期节拍号
+ */
+typedef void (*Telem_Record_t)(const float *values, uint32_t sampled, uint32_t tick, void *user);
+
+/**
+ * @brief 编码器
+ */
+typedef struct {
+    Telem_Config_t Cfg;         // 当前配置
+    Telem_Output_t Output;      // 帧输出
+    void *User;
+
+    uint8_t Buf[TELEM_MAX_PAYLOAD];     // 组帧缓冲
+    uint32_t Len;               // 组帧缓冲已用字节
+    uint8_t DivCnt[TELEM_MAX_CH];       // 分频计数
+    int32_t Last[TELEM_MAX_CH]; // 上次发送的编码值
+    uint32_t FrameSent;         // 本帧已发送过完整值的通道掩码 (差分/重复只引用这些通道)
+    uint32_t LastTick;          // 本帧上一条记录的节拍号
+
+    /* 统计 */
+    uint32_t Records;           // 已编码记录数
+    uint32_t Samples;           // 已编码通道样本数
+    uint32_t Frames;            // 已输出帧数
+    uint32_t Bytes;             // 已输出负载字节数
+} Telem_Encoder_t;
+
+/**
+ * @brief 解码器
+ */
+typedef struct {
+    Telem_Config_t Cfg;         // 当前配置
+    int32_t Last[TELEM_MAX_CH]; // 上次的编码值
+    uint32_t Valid;             // 本帧内 Last 有效的通道掩码
+    float Value[TELEM_MAX_CH];  // 当前值
+    uint16_t Seq;               // 当前帧序号
+    uint32_t Tick;              // 当前记录节拍号
+
+    /* 统计 */
+    uint32_t Records;           // 已解码记录数
+    uint32_t Samples;           // 已解码通道样本数
+    uint32_t Frames;            // 已解码帧数
+    uint32_t CfgMismatch;       // 配置号不符的帧数
+    uint32_t Errors;            // 格式错误的帧数
+} Telem_Decoder_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  默认配置 (不启用任何通道, 各通道 F32 不分频)
+ */
+void Telem_DefaultConfig(Telem_Config_t *cfg);
+
+/**
+ * @brief  初始化编码器 (丢弃未输出的记录)
+ * @param  enc: 编码器
+ * @param  cfg: 配置
+ * @param  output: 帧输出回调
+ * @param  user: 回调用户参数
+ */
+void Telem_EncoderInit(Telem_Encoder_t *enc, const Telem_Config_t *cfg,
+                       Telem_Output_t output, void *user);
+
+/**
+ * @brief  编码一条记录 (组帧缓冲放不下或节拍间隔过大时先输出当前帧)
+ * @param  enc: 编码器
+ * @param  tick: 数据所属的控制周期节拍号 (须递增)
+ * @param  values: 各通道值 (按通道号索引)
+ */
+void Telem_Encode(Telem_Encoder_t *enc, uint32_t tick, const float *values);
+
+/**
+ * @brief  输出组帧缓冲中的记录 (无记录时不输出)
+ */
+void Telem_Flush(Telem_Encoder_t *enc);
+
+/**
+ * @brief  初始化解码器
+ */
+void Telem_DecoderInit(Telem_Decoder_t *dec, const Telem_Config_t *cfg);
+
+/**
+ * @brief  解码一帧遥测负载
+ * @param  dec: 解码器
+ * @param  payload: PROTO_MSG_TELEM 负载
+ * @param  len: 负载长度
+ * @param  cb: 记录回调 (可为 NULL)
+ * @param  user: 回调用户参数
+ * @return 解码的记录数, 配置号不符或格式错误时为已解码部分
+ */
+uint32_t Telem_Decode(Telem_Decoder_t *dec, const uint8_t *payload, uint32_t len,
+                      Telem_Record_t cb, void *user);
+
+/**
+ * @brief  单精度转半精度 (就近舍入到偶数, 溢出为无穷)
+ */
+uint16_t Telem_FloatToHalf(float f);
+
+/**
+ * @brief  半精度转单精度
+ */
+float Telem_HalfToFloat(uint16_t h);
+
+#endif /* __FOC_TELEM_H */
@@ -0,0 +1,96 @@
+/**
+ * @file    foc_timeline.c
+ * @brief   遥测时间轴重建与丢帧统计实现
+ */
+
+#include "foc_timeline.h"
+#include <string.h>
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  位宽转掩码
+ */
+static uint32_t Timeline_Mask(uint32_t bits)
+{
+    if (bits == 0 || bits >= 32) return 0xFFFFFFFFu;
+    return (1u << bits) - 1u;
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化时间轴
+ */
+void Timeline_Init(Timeline_t *tl, double period, uint32_t seq_bits, uint32_t tick_bits)
+{
+    memset(tl, 0, sizeof(*tl));
+    tl->Period = period;
+    tl->SeqMask = Timeline_Mask(seq_bits);
+    tl->TickMask = Timeline_Mask(tick_bits);
+    tl->MinStride = 0xFFFFFFFFu;
+}
+
+/**
+ * @brief  登记一帧
+ */
+uint32_t Timeline_Frame(Timeline_t *tl, uint32_t seq)
+{
+    uint32_t lost = 0;
+
+    seq &= tl->SeqMask;
+    tl->Frames++;
+
+    if (tl->HaveSeq) {
+        uint32_t d = (seq - tl->LastSeq) & tl->SeqMask;
+
+        if (d == 0 || d > (tl->SeqMask >> 1)) {
+            tl->Duplicates++;
+        } else {
+            lost = d - 1u;
+            tl->LostFrames += lost;
+        }
+    }
+    tl->HaveSeq = 1;
+    tl->LastSeq = seq;
+    return lost;
+}
+
+/**
+ * @brief  登记一条记录
+ */
+double Timeline_Record(Timeline_t *tl, uint32_t tick)
+{
+    tick &= tl->TickMask;
+    tl->Records++;
+
+    if (tl->HaveTick) {
+        uint32_t d = (tick - tl->LastTick) & tl->TickMask;
+
+        if (d > (tl->TickMask >> 1)) {
+            /* 回退: 设备复位, 接在上一条记录之后重新起算 */
+            tl->Resets++;
+            d = 0;
+        } else {
+            if (d < tl->MinStride) tl->MinStride = d;
+            if (d > tl->MaxStride) tl->MaxStride = d;
+        }
+        tl->Tick += d;
+    }
+    tl->HaveTick = 1;
+    tl->LastTick = tick;
+    return (double)tl->Tick * tl->Period;
+}
+
+/**
+ * @brief  丢帧率
+ */
+double Timeline_LossRatio(const Timeline_t *tl)
+{
+    uint32_t total = tl->Frames + tl->LostFrames;
+    return total ? (double)tl->LostFrames / (double)total : 0.0;
+}
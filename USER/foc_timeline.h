@@ -0,0 +1,77 @@
+/**
+ * @file    foc_timeline.h
+ * @brief   遥测时间轴重建与丢帧统计 (上位机使用)
+ * @note    纯算法实现，无硬件依赖，可直接用于上位机工具
+ *          设备每帧携带帧序号, 每条记录携带控制周期节拍号 (均可能按位宽回绕):
+ *            - 帧序号跳变 → 丢帧 (USB 发送队列满时设备端丢弃的帧也计入)
+ *            - 节拍号展开为 64 位后乘以控制周期 → 与主循环发送抖动无关的均匀时间轴
+ *          回绕判定取半个位宽: 相邻两次间隔超过半个回绕周期时视为回退 (设备复位)
+ */
+
+#ifndef __FOC_TIMELINE_H
+#define __FOC_TIMELINE_H
+
+#include <stdint.h>
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 时间轴
+ */
+typedef struct {
+    double Period;              // 控制周期 (s)
+    uint32_t SeqMask;           // 帧序号位宽掩码
+    uint32_t TickMask;          // 节拍号位宽掩码
+
+    uint8_t HaveSeq;            // 已收到过帧序号
+    uint8_t HaveTick;           // 已收到过节拍号
+    uint32_t LastSeq;           // 上一帧序号
+    uint32_t LastTick;          // 上一条记录节拍号 (原始值)
+    int64_t Tick;               // 上一条记录节拍号 (展开, 相对首条记录)
+
+    /* 统计 */
+    uint32_t Frames;            // 收到的帧数
+    uint32_t LostFrames;        // 由序号跳变推断的丢失帧数
+    uint32_t Duplicates;        // 序号重复或回退的帧数
+    uint32_t Records;           // 记录数
+    uint32_t Resets;            // 节拍号回退次数 (设备复位, 时间轴重新起算)
+    uint32_t MinStride;         // 相邻记录最小节拍间隔
+    uint32_t MaxStride;         // 相邻记录最大节拍间隔
+} Timeline_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化时间轴
+ * @param  tl: 时间轴
+ * @param  period: 控制周期 (s)
+ * @param  seq_bits: 帧序号位宽 (1~32)
+ * @param  tick_bits: 节拍号位宽 (1~32)
+ */
+void Timeline_Init(Timeline_t *tl, double period, uint32_t seq_bits, uint32_t tick_bits);
+
+/**
+ * @brief  登记一帧
+ * @param  seq: 帧序号
+ * @return 本帧之前丢失的帧数
+ */
+uint32_t Timeline_Frame(Timeline_t *tl, uint32_t seq);
+
+/**
+ * @brief  登记一条记录
+ * @param  tick: 节拍号
+ * @return 记录时刻 (s, 相对首条记录)
+ */
+double Timeline_Record(Timeline_t *tl, uint32_t tick);
+
+/**
+ * @brief  丢帧率
+ * @return 丢失帧数 / (收到帧数 + 丢失帧数)
+ */
+double Timeline_LossRatio(const Timeline_t *tl);
+
+#endif /* __FOC_TIMELINE_H */
@@ -0,0 +1,194 @@
+/**
+ * @file    foc_trace.c
+ * @brief   控制中断输入录制与回放模块实现
+ */
+
+#include "foc_trace.h"
+#include <string.h>
+
+/*============================================================================*/
+/*                              私有变量                                       */
+/*============================================================================*/
+
+static FOC_TraceRecord_t trace_buf[FOC_TRACE_DEPTH];   // 输入记录环形缓冲
+static Motor_t trace_key[FOC_TRACE_KEYFRAMES];         // 关键帧 (电机对象快照)
+static uint32_t trace_key_no[FOC_TRACE_KEYFRAMES];     // 关键帧对应的记录序号
+static uint32_t trace_count = 0;                       // 已录制记录数
+static volatile uint8_t trace_active = 0;              // 录制中
+static volatile uint8_t trace_start_req = 0;           // 开始请求 (ISR 中处理)
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  开始录制
+ */
+void FOC_Trace_Start(void)
+{
+    trace_active = 0;
+    trace_start_req = 1;
+}
+
+/**
+ * @brief  停止录制
+ */
+void FOC_Trace_Stop(void)
+{
+    trace_start_req = 0;
+    trace_active = 0;
+}
+
+/**
+ * @brief  录制一个控制周期的输入
+ */
+void FOC_Trace_Capture(const Motor_t *motor)
+{
+    if (trace_start_req) {
+        trace_start_req = 0;
+        trace_count = 0;
+        trace_active = 1;
+    }
+    if (!trace_active) return;
+
+    /* 关键帧: 保存控制计算前的完整电机对象 */
+    if ((trace_count % FOC_TRACE_KEY_INTERVAL) == 0) {
+        uint32_t k = (trace_count / FOC_TRACE_KEY_INTERVAL) % FOC_TRACE_KEYFRAMES;
+        trace_key[k] = *motor;
+        trace_key_no[k] = trace_count;
+    }
+
+    FOC_TraceRecord_t *rec = &trace_buf[trace_count & (FOC_TRACE_DEPTH - 1)];
+    uint32_t adc_u, adc_v, adc_w;
+
+    MotorHW_GetCurrentADC(motor->HW, &adc_u, &adc_v, &adc_w);
+    rec->AdcU = (uint16_t)adc_u;
+    rec->AdcV = (uint16_t)adc_v;
+    rec->AdcW = (uint16_t)adc_w;
+    rec->EncRaw = motor->Encoder.RawAngle;
+    rec->Tick = (uint16_t)trace_count;
+    rec->Mode = (uint8_t)motor->Mode;
+    rec->Reserved = 0;
+    rec->TargetId = motor->TargetId;
+    rec->TargetIq = motor->TargetIq;
+    rec->TargetRPM = motor->TargetRPM;
+    rec->TargetPosCnt = motor->TargetPosCnt;
+
+    trace_count++;
+}
+
+/**
+ * @brief  导出录制数据
+ * @note   从仍在缓冲区内的最早关键帧开始导出
+ */
+uint32_t FOC_Trace_Export(uint8_t *buf, uint32_t size)
+{
+    if (trace_active || trace_count == 0) return 0;
+
+    /* 缓冲区内最早的记录序号 */
+    uint32_t first = (trace_count > FOC_TRACE_DEPTH) ? (trace_count - FOC_TRACE_DEPTH) : 0;
+
+    /* 选择不早于 first 的最早关键帧 */
+    int32_t key = -1;
+    for (uint32_t k = 0; k < FOC_TRACE_KEYFRAMES; k++) {
+        if (trace_key_no[k] >= first && trace_key_no[k] < trace_count &&
+            (key < 0 || trace_key_no[k] < trace_key_no[key])) {
+            key = (int32_t)k;
+        }
+    }
+    if (key < 0) return 0;
+
+    uint32_t start = trace_key_no[key];
+    uint32_t n = trace_count - start;
+    uint32_t total = sizeof(FOC_TraceHeader_t) + sizeof(Motor_t) + n * sizeof(FOC_TraceRecord_t);
+    if (size < total) return 0;
+
+    FOC_TraceHeader_t hdr;
+    hdr.Magic = FOC_TRACE_MAGIC;
+    hdr.Version = FOC_TRACE_VERSION;
+    hdr.RecordSize = sizeof(FOC_TraceRecord_t);
+    hdr.MotorSize = sizeof(Motor_t);
+    hdr.RecordCount = n;
+    hdr.StartTick = start;
+
+    memcpy(buf, &hdr, sizeof(hdr));
+    buf += sizeof(hdr);
+    memcpy(buf, &trace_key[key], sizeof(Motor_t));
+    buf += sizeof(Motor_t);
+
+    for (uint32_t i = 0; i < n; i++) {
+        memcpy(buf, &trace_buf[(start + i) & (FOC_TRACE_DEPTH - 1)], sizeof(FOC_TraceRecord_t));
+        buf += sizeof(FOC_TraceRecord_t);
+    }
+
+    return total;
+}
+
+#if MOTOR_HW_SIM
+/**
+ * @brief  回放录制数据
+ * @note   每个周期: 注入 ADC → 应用模式/目标 → 解码编码器 → FOC_ControlLoop → 外环任务
+ */
+uint32_t FOC_Trace_Replay(Motor_t *motor, const uint8_t *data, uint32_t size,
+                          FOC_TraceReplayCb_t cb, void *user)
+{
+    FOC_TraceHeader_t hdr;
+
+    if (size < sizeof(hdr)) return 0;
+    memcpy(&hdr, data, sizeof(hdr));
+
+    if (hdr.Magic != FOC_TRACE_MAGIC || hdr.Version != FOC_TRACE_VERSION ||
+        hdr.RecordSize != sizeof(FOC_TraceRecord_t) || hdr.MotorSize != sizeof(Motor_t)) {
+        return 0;
+    }
+    if (size < sizeof(hdr) + sizeof(Motor_t) + hdr.RecordCount * sizeof(FOC_TraceRecord_t)) {
+        return 0;
+    }
+
+    /* 从关键帧恢复电机对象 (保留本地硬件绑定) */
+    uint8_t axis = motor->Axis;
+    MotorHW_t *hw = motor->HW;
+    
+    data += sizeof(hdr);
+    memcpy(motor, data, sizeof(Motor_t));
+    data += sizeof(Motor_t);
+    
+    motor->Axis = axis;
+    motor->HW = hw;
+    /* 补偿表指针指向录制端的对象, 改指向本地恢复的表 (保留是否启用) */
+    if (motor->Encoder.Lin != NULL) {
+        motor->Encoder.Lin = motor->EncLin.Table;
+    }
+
+    for (uint32_t i = 0; i < hdr.RecordCount; i++) {
+        FOC_TraceRecord_t rec;
+        memcpy(&rec, data, sizeof(rec));
+        data += sizeof(rec);
+
+        MotorHW_Sim_SetADC(motor->HW, rec.AdcU, rec.AdcV, rec.AdcW);
+
+        if ((FOC_Mode_t)rec.Mode != motor->Mode) {
+            FOC_ApplyMode(motor, (FOC_Mode_t)rec.Mode);
+        }
+        motor->TargetId = rec.TargetId;
+        motor->TargetIq = rec.TargetIq;
+        motor->TargetRPM = rec.TargetRPM;
+        motor->TargetPosCnt = rec.TargetPosCnt;
+        motor->TargetPos = FOC_PosCntToRad(rec.TargetPosCnt);
+
+        /* 录制的是补偿后的读数, 解码时跳过补偿表 */
+        const int16_t *lin = motor->Encoder.Lin;
+        motor->Encoder.Lin = NULL;
+        MotorHW_DecodeEncoder(&motor->Encoder, rec.EncRaw);
+        motor->Encoder.Lin = lin;
+        FOC_ControlLoop(motor);
+        FOC_OuterLoopTask(motor);
+
+        if (cb != 0) {
+            cb(motor, i, user);
+        }
+    }
+
+    return hdr.RecordCount;
+}
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file    foc_trace.h
+ * @brief   控制中断输入录制与回放模块
+ * @note    录制: 每个控制周期记录 ADC 原始值、编码器原始值和目标值到环形缓冲区,
+ *                并周期性保存电机对象快照 (关键帧) 作为回放起点
+ *          回放: 从关键帧恢复电机对象, 逐周期注入录制输入并执行 FOC_ControlLoop,
+ *                输出与现场逐位一致 (需同一份代码编译, 且现场外环任务均在下一控制周期前完成)
+ */
+
+#ifndef __FOC_TRACE_H
+#define __FOC_TRACE_H
+
+#include <stdint.h>
+#include "foc_core.h"
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#ifndef FOC_TRACE_ENABLE
+#define FOC_TRACE_ENABLE        0           // 1=开启录制
+#endif
+
+#define FOC_TRACE_DEPTH         1024        // 环形缓冲区记录数 (2 的幂)
+#define FOC_TRACE_KEYFRAMES     4           // 关键帧数量
+#define FOC_TRACE_KEY_INTERVAL  (FOC_TRACE_DEPTH / FOC_TRACE_KEYFRAMES)
+#define FOC_TRACE_AXIS          0           // 录制的轴号 (多轴时只录制一轴)
+
+#define FOC_TRACE_MAGIC         0x54434F46u // "FOCT"
+#define FOC_TRACE_VERSION       2
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 单周期录制记录 (32 字节)
+ */
+typedef struct {
+    uint16_t AdcU;              // U相 ADC 原始值
+    uint16_t AdcV;              // V相 ADC 原始值
+    uint16_t AdcW;              // W相 ADC 原始值
+    uint16_t EncRaw;            // 本周期使用的编码器读数 (已经过非线性补偿)
+    uint16_t Tick;              // 节拍号低 16 位 (检查连续性)
+    uint8_t Mode;               // 控制模式
+    uint8_t Reserved;
+    float TargetId;             // d轴目标电流 (A)
+    float TargetIq;             // q轴目标电流 (A)
+    float TargetRPM;            // 目标转速 (RPM)
+    int64_t TargetPosCnt;       // 目标位置 (计数, 累计)
+} FOC_TraceRecord_t;
+
+/**
+ * @brief 导出数据头
+ * @note   导出格式: [Header][Motor_t 关键帧][Record × RecordCount]
+ */
+typedef struct {
+    uint32_t Magic;             // FOC_TRACE_MAGIC
+    uint16_t Version;           // FOC_TRACE_VERSION
+    uint16_t RecordSize;        // sizeof(FOC_TraceRecord_t)
+    uint32_t MotorSize;         // sizeof(Motor_t), 回放端校验同一版本
+    uint32_t RecordCount;       // 记录数
+    uint32_t StartTick;         // 首条记录的节拍号
+} FOC_TraceHeader_t;
+
+/**
+ * @brief  回放逐周期回调
+ * @param  motor: 回放中的电机对象 (本周期 FOC_ControlLoop 已执行)
+ * @param  index: 记录序号 (从 0 开始)
+ * @param  user: 用户参数
+ */
+typedef void (*FOC_TraceReplayCb_t)(const Motor_t *motor, uint32_t index, void *user);
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  开始录制 (清空缓冲区, 下一个控制周期保存首个关键帧)
+ */
+void FOC_Trace_Start(void);
+
+/**
+ * @brief  停止录制 (冻结缓冲区, 可在故障时调用)
+ */
+void FOC_Trace_Stop(void);
+
+/**
+ * @brief  录制一个控制周期的输入 (在 FOC_ProcessCommand 之后, FOC_ControlLoop 之前调用)
+ * @param  motor: 电机对象指针
+ */
+void FOC_Trace_Capture(const Motor_t *motor);
+
+/**
+ * @brief  导出录制数据 (须先停止录制)
+ * @param  buf: 输出缓冲区
+ * @param  size: 缓冲区大小 (字节)
+ * @return 写入字节数, 0=无数据或缓冲区不足
+ */
+uint32_t FOC_Trace_Export(uint8_t *buf, uint32_t size);
+
+#if MOTOR_HW_SIM
+/**
+ * @brief  回放录制数据 (仿真后端)
+ * @param  motor: 电机对象指针 (须已 FOC_Init 绑定轴, 除硬件绑定外将被关键帧覆盖,
+ *                 关键帧内的指针 (硬件描述符, 编码器补偿表) 改指向本地对象)
+ * @param  data: FOC_Trace_Export 导出的数据
+ * @param  size: 数据长度 (字节)
+ * @param  cb: 逐周期回调 (可为 NULL)
+ * @param  user: 回调用户参数
+ * @return 回放的周期数, 0=数据格式错误
+ */
+uint32_t FOC_Trace_Replay(Motor_t *motor, const uint8_t *data, uint32_t size,
+                          FOC_TraceReplayCb_t cb, void *user);
+#endif
+
+#endif /* __FOC_TRACE_H */
@@ -8,30 +8,74 @@
 #include "adc.h"
 #include "foc_core.h"
 #include "vofa.h"
+#include "foc_trace.h"
+#include "foc_scope.h"
+#include "foc_param.h"
 
 /*============================================================================*/
 /*                              ADC 注入转换完成中断                            */
 /*============================================================================*/
 
 /**
- * @brief  ADC 注入转换完成回调 (20kHz)
- * @note   这是 FOC 控制的主入口点
+ * @brief  ADC 注入转换完成回调 (每轴 20kHz)
+ * @note   这是 FOC 控制的主入口点, 按 ADC 句柄分发到对应轴
  */
 void HAL_ADCEx_InjectedConvCpltCallback(ADC_HandleTypeDef *hadc)
 {
-    if (hadc->Instance == ADC1) {
-        
-        /*--- 电流偏移校准阶段 ---*/
-        if (!g_Motor.CurOffset.IsCalibrated) {
-            FOC_CalibrateCurrentOffset(&g_Motor);
-            return;
-        }
-        
-        /*--- FOC 主控制循环 ---*/
-        FOC_ControlLoop(&g_Motor);
+    int8_t axis = MotorHW_AxisFromADC(hadc);
+    if (axis < 0) return;
+    
+    Motor_t *motor = &g_Motors[axis];
+    
+    /*--- 电流偏移校准阶段 ---*/
+    if (!motor->CurOffset.IsCalibrated) {
+        FOC_CalibrateCurrentOffset(motor);
+        return;
+    }
+    
+    /*--- 编码器校准阶段 (开环注入, 不执行电流环) ---*/
+    if (motor->State == MOTOR_STATE_CALIBRATING) {
+        FOC_CalibrateEncoder(motor);
+        return;
+    }
+    
+    /*--- 取用最新命令 (本周期目标值) ---*/
+    FOC_ProcessCommand(motor);
+    
+#if FOC_TRACE_ENABLE
+    /*--- 录制本周期输入 (回放用) ---*/
+    if (axis == FOC_TRACE_AXIS) {
+        FOC_Trace_Capture(motor);
+    }
+#endif
+    
+    /*--- FOC 主控制循环 ---*/
+    FOC_ControlLoop(motor);
+    
+    /*--- 更新 VOFA 调试数据 ---*/
+    if (axis == VOFA_AXIS) {
+        VOFA_UpdateFromMotor(motor);
         
-        /*--- 更新 VOFA 调试数据 ---*/
-        VOFA_UpdateFromMotor(&g_Motor);
+#if FOC_SCOPE_ENABLE
+        /*--- 示波器采样 (全速率) ---*/
+        FOC_Scope_Sample(motor);
+#endif
+    }
+}
+
+/*============================================================================*/
+/*                              外环任务 (PendSV)                              */
+/*============================================================================*/
+
+/**
+ * @brief  外环任务调度 (1kHz, 最低优先级)
+ * @note   由控制中断分频挂起, 依次执行已挂起轴的速度环/位置环;
+ *         执行中可被控制中断抢占, 不影响电流环时序
+ */
+void FOC_OuterLoopIRQ(void)
+{
+    for (uint8_t axis = 0; axis < HW_AXIS_COUNT; axis++) {
+        FOC_OuterLoopTask(&g_Motors[axis]);
     }
 }
 
@@ -41,47 +85,61 @@ void HAL_ADCEx_InjectedConvCpltCallback(ADC_HandleTypeDef *hadc)
 
 /**
  * @brief  从电机对象更新 VOFA 调试数据
+ * @note   填写后台帧后整帧发布, 主循环读到的各通道来自同一控制周期
  * @param  motor: 电机对象指针
  */
 void VOFA_UpdateFromMotor(Motor_t *motor)
 {
+    float *d = VOFA_BeginFrame();
+    
+    /* 定点构建下由 Q15 结果换算调试用浮点量 */
+    FOC_UpdateDebugValues(motor);
+    
     /* 输出电压 */
-    vofa_data[VOFA_CH_VD] = motor->InvPark.D;
-    vofa_data[VOFA_CH_VQ] = motor->InvPark.Q;
+    d[VOFA_CH_VD] = motor->InvPark.D;
+    d[VOFA_CH_VQ] = motor->InvPark.Q;
     
     /* 角度 */
-    vofa_data[VOFA_CH_MECH_THETA] = motor->Encoder.MechAngle;
+    d[VOFA_CH_MECH_THETA] = motor->Encoder.MechAngle;
     
     /* SVPWM */
-    vofa_data[VOFA_CH_SVPWM_ALPHA] = motor->SVPWM.Alpha;
-    vofa_data[VOFA_CH_SVPWM_BETA] = motor->SVPWM.Beta;
-    vofa_data[VOFA_CH_CCR1] = (float)motor->SVPWM.CCR1;
-    vofa_data[VOFA_CH_CCR2] = (float)motor->SVPWM.CCR2;
-    vofa_data[VOFA_CH_CCR3] = (float)motor->SVPWM.CCR3;
-    vofa_data[VOFA_CH_SECTOR] = (float)motor->SVPWM.Sector;
+    d[VOFA_CH_SVPWM_ALPHA] = motor->SVPWM.Alpha;
+    d[VOFA_CH_SVPWM_BETA] = motor->SVPWM.Beta;
+    d[VOFA_CH_CCR1] = (float)motor->SVPWM.CCR1;
+    d[VOFA_CH_CCR2] = (float)motor->SVPWM.CCR2;
+    d[VOFA_CH_CCR3] = (float)motor->SVPWM.CCR3;
+    d[VOFA_CH_SECTOR] = (float)motor->SVPWM.Sector;
     
     /* 三相电流 */
-    vofa_data[VOFA_CH_IU] = motor->Currents.Iu;
-    vofa_data[VOFA_CH_IV] = motor->Currents.Iv;
-    vofa_data[VOFA_CH_IW] = motor->Currents.Iw;
+    d[VOFA_CH_IU] = motor->Currents.Iu;
+    d[VOFA_CH_IV] = motor->Currents.Iv;
+    d[VOFA_CH_IW] = motor->Currents.Iw;
     
     /* Clarke 输出 */
-    vofa_data[VOFA_CH_I_ALPHA] = motor->Clarke.Alpha;
-    vofa_data[VOFA_CH_I_BETA] = motor->Clarke.Beta;
+    d[VOFA_CH_I_ALPHA] = motor->Clarke.Alpha;
+    d[VOFA_CH_I_BETA] = motor->Clarke.Beta;
     
     /* Park 输出 (实际电流) */
-    vofa_data[VOFA_CH_ID] = motor->ActualId;
-    vofa_data[VOFA_CH_IQ] = motor->ActualIq;
+    d[VOFA_CH_ID] = motor->ActualId;
+    d[VOFA_CH_IQ] = motor->ActualIq;
     
     /* 电流参考 */
-    vofa_data[VOFA_CH_ID_REF] = motor->TargetId;
-    vofa_data[VOFA_CH_IQ_REF] = motor->TargetIq;
+    d[VOFA_CH_ID_REF] = motor->TargetId;
+    d[VOFA_CH_IQ_REF] = motor->TargetIq;
     
     /* 位置 */
-    vofa_data[VOFA_CH_POS_TARGET] = motor->PosCtrl.TargetPos;
-    vofa_data[VOFA_CH_POS_ACTUAL] = motor->PosCtrl.CurrentPos;
+    d[VOFA_CH_POS_TARGET] = motor->TargetPos;
+    d[VOFA_CH_POS_ACTUAL] = motor->PosCtrl.CurrentPos;
     
     /* 速度 */
-    vofa_data[VOFA_CH_SPEED_ACTUAL] = motor->ActualRPM;
-    vofa_data[VOFA_CH_SPEED_TARGET] = motor->TargetRPM;
+    d[VOFA_CH_SPEED_ACTUAL] = motor->ActualRPM;
+    d[VOFA_CH_SPEED_TARGET] = motor->TargetRPM;
+    
+    /* 调试变量: 预留给临时观测, 每帧写入, 避免三缓冲轮换时发出其它周期的旧值 */
+    d[VOFA_CH_DEBUG] = 0.0f;
+    
+    /* 订阅参数 */
+    FOC_Param_Sample(motor, &d[VOFA_CH_SUB0]);
+    
+    VOFA_PublishFrame();
 }
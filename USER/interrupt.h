@@ -9,6 +9,11 @@
 #include <stdint.h>
 #include "foc_core.h"
 
+/**
+ * @brief  外环任务调度 (在 PendSV_Handler 中调用)
+ */
+void FOC_OuterLoopIRQ(void);
+
 /**
  * @brief  从电机对象更新 VOFA 调试数据
  * @param  motor: 电机对象指针
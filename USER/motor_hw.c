@@ -5,20 +5,42 @@
  */
 
 #include "motor_hw.h"
+#if !MOTOR_HW_SIM
 #include "main.h"
 #include "tim.h"
 #include "adc.h"
 #include "spi.h"
 #include "gpio.h"
+#endif
+#include "enc_lin.h"
+#include <stddef.h>
 #include <math.h>
 
 /*============================================================================*/
 /*                              私有变量                                       */
 /*============================================================================*/
 
-/* 编码器 SPI 通信缓冲区 */
-static uint16_t encoder_tx_buffer = 0x3FFF;     // 读取角度命令
-static uint16_t encoder_rx_buffer = 0;
+#if !MOTOR_HW_SIM
+/**
+ * @brief 硬件描述符表
+ * @note  增加轴时在此追加一项 (TIM8 + ADC2 + SPI3 等), 并在 CubeMX 中把
+ *        TIM8 配置为 TIM1 的从定时器、计数器初值错开半个周期
+ */
+MotorHW_t g_MotorHW[HW_AXIS_COUNT] = {
+    {
+        .Tim = &htim1,
+        .Adc = &hadc1,
+        .Spi = &hspi1,
+        .EnPort = DRV8301_EN_GATE_GPIO_Port,
+        .EnPin = DRV8301_EN_GATE_Pin,
+        .CsPort = AS5047P_NSS_GPIO_Port,
+        .CsPin = AS5047P_NSS_Pin,
+        .DbgPort = GPIOD,
+        .DbgPin = GPIO_PIN_2,
+        .EncTx = 0x3FFF,
+    },
+};
+#endif
 
 /* 电流偏移校准 */
 #define CALIBRATION_SAMPLES     1000
@@ -28,69 +50,149 @@ static uint16_t encoder_rx_buffer = 0;
 /*============================================================================*/
 
 #define TWO_PI      6.2831853f
-#define RAW_TO_RAD  (TWO_PI / 16384.0f)     // 14-bit 转弧度
+#define RAW_TO_RAD  (TWO_PI / (float)HW_ENCODER_CPR)    // 计数转弧度
+#define PHASE24_TO_RAD  (TWO_PI / 16777216.0f)          // 24-bit 相位转弧度
 
 /*============================================================================*/
 /*                              函数实现                                       */
 /*============================================================================*/
 
+#if !MOTOR_HW_SIM
+
 /**
  * @brief  硬件层初始化
  */
-void MotorHW_Init(void)
+void MotorHW_Init(MotorHW_t *hw)
 {
     /* 清除 SPI 溢出标志 */
-    __HAL_SPI_CLEAR_OVRFLAG(&hspi1);
+    __HAL_SPI_CLEAR_OVRFLAG((SPI_HandleTypeDef *)hw->Spi);
     
     /* 编码器片选拉高 (空闲) */
-    HAL_GPIO_WritePin(AS5047P_NSS_GPIO_Port, AS5047P_NSS_Pin, GPIO_PIN_SET);
+    HAL_GPIO_WritePin((GPIO_TypeDef *)hw->CsPort, hw->CsPin, GPIO_PIN_SET);
+    
+    hw->CalSum[0] = hw->CalSum[1] = hw->CalSum[2] = 0;
+    hw->CalCount = 0;
+    
+    /* 外环任务: PendSV 设为最低优先级, 可被控制中断抢占 */
+    HAL_NVIC_SetPriority(PendSV_IRQn, HW_OUTER_TASK_PRIORITY, 0);
 }
 
 /**
  * @brief  使能电机驱动
  */
-void MotorHW_EnableDriver(void)
+void MotorHW_EnableDriver(MotorHW_t *hw)
 {
-    HAL_GPIO_WritePin(DRV8301_EN_GATE_GPIO_Port, DRV8301_EN_GATE_Pin, GPIO_PIN_SET);
+    HAL_GPIO_WritePin((GPIO_TypeDef *)hw->EnPort, hw->EnPin, GPIO_PIN_SET);
 }
 
 /**
  * @brief  禁用电机驱动
  */
-void MotorHW_DisableDriver(void)
+void MotorHW_DisableDriver(MotorHW_t *hw)
 {
-    HAL_GPIO_WritePin(DRV8301_EN_GATE_GPIO_Port, DRV8301_EN_GATE_Pin, GPIO_PIN_RESET);
+    HAL_GPIO_WritePin((GPIO_TypeDef *)hw->EnPort, hw->EnPin, GPIO_PIN_RESET);
 }
 
 /**
  * @brief  设置三相 PWM 占空比
  */
-void MotorHW_SetPWM(uint32_t ccr_u, uint32_t ccr_v, uint32_t ccr_w)
+void MotorHW_SetPWM(MotorHW_t *hw, uint32_t ccr_u, uint32_t ccr_v, uint32_t ccr_w)
 {
-    TIM1->CCR1 = ccr_u;
-    TIM1->CCR2 = ccr_v;
-    TIM1->CCR3 = ccr_w;
+    TIM_TypeDef *tim = ((TIM_HandleTypeDef *)hw->Tim)->Instance;
+    
+    tim->CCR1 = ccr_u;
+    tim->CCR2 = ccr_v;
+    tim->CCR3 = ccr_w;
 }
 
 /**
  * @brief  设置所有 PWM 为 50% (刹车/停止)
  */
-void MotorHW_SetPWMBrake(void)
+void MotorHW_SetPWMBrake(MotorHW_t *hw)
 {
+    TIM_TypeDef *tim = ((TIM_HandleTypeDef *)hw->Tim)->Instance;
     uint32_t mid = HW_PWM_PERIOD / 2;
-    TIM1->CCR1 = mid;
-    TIM1->CCR2 = mid;
-    TIM1->CCR3 = mid;
+    
+    tim->CCR1 = mid;
+    tim->CCR2 = mid;
+    tim->CCR3 = mid;
 }
 
 /**
  * @brief  读取三相电流 ADC 原始值
  */
-void MotorHW_GetCurrentADC(uint32_t *adc_u, uint32_t *adc_v, uint32_t *adc_w)
+void MotorHW_GetCurrentADC(MotorHW_t *hw, uint32_t *adc_u, uint32_t *adc_v, uint32_t *adc_w)
 {
-    *adc_u = HAL_ADCEx_InjectedGetValue(&hadc1, ADC_INJECTED_RANK_1);
-    *adc_v = HAL_ADCEx_InjectedGetValue(&hadc1, ADC_INJECTED_RANK_2);
-    *adc_w = HAL_ADCEx_InjectedGetValue(&hadc1, ADC_INJECTED_RANK_3);
+    ADC_HandleTypeDef *hadc = (ADC_HandleTypeDef *)hw->Adc;
+    
+    *adc_u = HAL_ADCEx_InjectedGetValue(hadc, ADC_INJECTED_RANK_1);
+    *adc_v = HAL_ADCEx_InjectedGetValue(hadc, ADC_INJECTED_RANK_2);
+    *adc_w = HAL_ADCEx_InjectedGetValue(hadc, ADC_INJECTED_RANK_3);
+}
+
+/**
+ * @brief  启动编码器 DMA 读取
+ */
+void MotorHW_StartEncoderRead(MotorHW_t *hw)
+{
+    HAL_GPIO_WritePin((GPIO_TypeDef *)hw->CsPort, hw->CsPin, GPIO_PIN_RESET);
+    HAL_SPI_TransmitReceive_DMA((SPI_HandleTypeDef *)hw->Spi, (uint8_t*)&hw->EncTx, 
+                                 (uint8_t*)&hw->EncRx, 1);
+}
+
+/**
+ * @brief  处理编码器数据
+ */
+void MotorHW_ProcessEncoderData(MotorHW_t *hw, EncoderData_t *encoder)
+{
+    /* 拉高片选，结束传输 */
+    HAL_GPIO_WritePin((GPIO_TypeDef *)hw->CsPort, hw->CsPin, GPIO_PIN_SET);
+    
+    /* 提取 14-bit 角度值 */
+    MotorHW_DecodeEncoder(encoder, hw->EncRx & 0x3FFF);
+}
+
+/**
+ * @brief  挂起外环任务
+ */
+void MotorHW_PendOuterTask(void)
+{
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+/**
+ * @brief  调试 GPIO 设置
+ */
+void MotorHW_DebugPin(MotorHW_t *hw, uint8_t state)
+{
+    if (hw->DbgPort != 0) {
+        HAL_GPIO_WritePin((GPIO_TypeDef *)hw->DbgPort, hw->DbgPin,
+                          state ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    }
+}
+
+#endif /* !MOTOR_HW_SIM */
+
+/**
+ * @brief  按 ADC 句柄查找轴号
+ */
+int8_t MotorHW_AxisFromADC(const void *hadc)
+{
+    for (uint8_t i = 0; i < HW_AXIS_COUNT; i++) {
+        if (g_MotorHW[i].Adc == hadc) return (int8_t)i;
+    }
+    return -1;
+}
+
+/**
+ * @brief  按 SPI 句柄查找轴号
+ */
+int8_t MotorHW_AxisFromSPI(const void *hspi)
+{
+    for (uint8_t i = 0; i < HW_AXIS_COUNT; i++) {
+        if (g_MotorHW[i].Spi == hspi) return (int8_t)i;
+    }
+    return -1;
 }
 
 /**
@@ -104,10 +206,10 @@ float MotorHW_ADCToCurrent(uint32_t adc_value, float offset)
 /**
  * @brief  读取三相电流 (已转换)
  */
-void MotorHW_GetCurrents(PhaseCurrents_t *currents, const CurrentOffset_t *offset)
+void MotorHW_GetCurrents(MotorHW_t *hw, PhaseCurrents_t *currents, const CurrentOffset_t *offset)
 {
     uint32_t adc_u, adc_v, adc_w;
-    MotorHW_GetCurrentADC(&adc_u, &adc_v, &adc_w);
+    MotorHW_GetCurrentADC(hw, &adc_u, &adc_v, &adc_w);
     
     currents->Iu = MotorHW_ADCToCurrent(adc_u, offset->OffsetU);
     currents->Iv = MotorHW_ADCToCurrent(adc_v, offset->OffsetV);
@@ -116,82 +218,79 @@ void MotorHW_GetCurrents(PhaseCurrents_t *currents, const CurrentOffset_t *offse
 }
 
 /**
- * @brief  启动编码器 DMA 读取
+ * @brief  由原始角度值计算机械角度和电角度
+ * @note   机械角以 Q32 相位表示 (一圈 = 2^32), 减零点、乘极对数后的回绕
+ *         即 32 位无符号溢出; 取高 24 位转浮点, 结果严格小于 2π
  */
-void MotorHW_StartEncoderRead(void)
+void MotorHW_DecodeEncoder(EncoderData_t *encoder, uint16_t raw_angle)
 {
-    HAL_GPIO_WritePin(AS5047P_NSS_GPIO_Port, AS5047P_NSS_Pin, GPIO_PIN_RESET);
-    HAL_SPI_TransmitReceive_DMA(&hspi1, (uint8_t*)&encoder_tx_buffer, 
-                                 (uint8_t*)&encoder_rx_buffer, 1);
-}
-
-/**
- * @brief  角度归一化到 [0, 2π)
- */
-static inline float NormalizeAngle(float angle)
-{
-    return fmodf(angle + TWO_PI, TWO_PI);
+    /* 非线性补偿 (查表插值, 整数运算) */
+    if (encoder->Lin != NULL) {
+        raw_angle = EncLin_Apply(encoder->Lin, raw_angle);
+    }
+    
+    encoder->RawAngle = raw_angle;
+    
+    /* 机械角: 反向时取补数, 模 CPR */
+    uint32_t mech = ((encoder->Direction > 0) ? (uint32_t)raw_angle : (0u - (uint32_t)raw_angle))
+                    & (HW_ENCODER_CPR - 1u);
+    encoder->MechAngle = (float)mech * RAW_TO_RAD;
+    
+    /* 多圈位置: 计数增量按最短路径 (±半圈) 累加, 整数无精度损失 */
+    int32_t delta = (int32_t)((mech - encoder->MechCnt) & (HW_ENCODER_CPR - 1u));
+    if (delta >= (int32_t)(HW_ENCODER_CPR / 2u)) delta -= (int32_t)HW_ENCODER_CPR;
+    encoder->PosCnt += delta;
+    encoder->MechCnt = (uint16_t)mech;
+    
+    /* 电角度: θe = (θm - offset) * Pp, 模 2^32 */
+    uint32_t elec = ((mech << (32 - HW_ENCODER_BITS)) - encoder->ZeroOffsetPhase)
+                    * (uint32_t)encoder->PolePairs;
+    encoder->ElecPhase = (uint16_t)(elec >> 16);
+    encoder->ElecAngle = (float)(elec >> 8) * PHASE24_TO_RAD;
 }
 
 /**
- * @brief  处理编码器数据
+ * @brief  设置编码器零点偏移
  */
-void MotorHW_ProcessEncoderData(EncoderData_t *encoder)
+void MotorHW_SetEncoderOffset(EncoderData_t *encoder, float offset)
 {
-    /* 拉高片选，结束传输 */
-    HAL_GPIO_WritePin(AS5047P_NSS_GPIO_Port, AS5047P_NSS_Pin, GPIO_PIN_SET);
-    
-    /* 提取 14-bit 角度值 */
-    encoder->RawAngle = encoder_rx_buffer & 0x3FFF;
-    
-    /* 计算机械角度 */
-    encoder->MechAngle = encoder->Direction * encoder->RawAngle * RAW_TO_RAD;
-    encoder->MechAngle = NormalizeAngle(encoder->MechAngle);
-    
-    /* 计算电角度: θe = (θm - offset) * Pp */
-    encoder->ElecAngle = (encoder->MechAngle - HW_ENCODER_ZERO_OFFSET) * HW_MOTOR_POLE_PAIRS;
-    encoder->ElecAngle = NormalizeAngle(encoder->ElecAngle);
+    if (offset < 0.0f || offset >= TWO_PI) {
+        offset = fmodf(offset, TWO_PI);
+        if (offset < 0.0f) offset += TWO_PI;
+    }
+    encoder->ZeroOffset = offset;
+    /* 四舍五入后 2^32 回绕为 0 */
+    encoder->ZeroOffsetPhase = (uint32_t)(uint64_t)((double)offset * (4294967296.0 / (double)TWO_PI) + 0.5);
 }
 
 /**
  * @brief  电流偏移校准
  */
-uint8_t MotorHW_CalibrateCurrentOffset(CurrentOffset_t *offset, 
+uint8_t MotorHW_CalibrateCurrentOffset(MotorHW_t *hw, CurrentOffset_t *offset,
                                         uint32_t adc_u, uint32_t adc_v, uint32_t adc_w)
 {
-    static uint32_t sum_u = 0, sum_v = 0, sum_w = 0;
-    static uint32_t sample_count = 0;
-    
     if (offset->IsCalibrated) {
         return 1;  /* 已完成 */
     }
     
-    if (sample_count < CALIBRATION_SAMPLES) {
-        sum_u += adc_u;
-        sum_v += adc_v;
-        sum_w += adc_w;
-        sample_count++;
+    if (hw->CalCount < CALIBRATION_SAMPLES) {
+        hw->CalSum[0] += adc_u;
+        hw->CalSum[1] += adc_v;
+        hw->CalSum[2] += adc_w;
+        hw->CalCount++;
         return 0;  /* 校准中 */
     }
     else {
         /* 计算平均值作为偏移 */
-        offset->OffsetU = (float)sum_u / (float)CALIBRATION_SAMPLES;
-        offset->OffsetV = (float)sum_v / (float)CALIBRATION_SAMPLES;
-        offset->OffsetW = (float)sum_w / (float)CALIBRATION_SAMPLES;
+        offset->OffsetU = (float)hw->CalSum[0] / (float)CALIBRATION_SAMPLES;
+        offset->OffsetV = (float)hw->CalSum[1] / (float)CALIBRATION_SAMPLES;
+        offset->OffsetW = (float)hw->CalSum[2] / (float)CALIBRATION_SAMPLES;
         offset->IsCalibrated = 1;
         
         /* 重置累加器 (以备下次使用) */
-        sum_u = sum_v = sum_w = 0;
-        sample_count = 0;
+        hw->CalSum[0] = hw->CalSum[1] = hw->CalSum[2] = 0;
+        hw->CalCount = 0;
         
         return 1;  /* 校准完成 */
     }
 }
-
-/**
- * @brief  调试 GPIO 设置
- */
-void MotorHW_DebugPin(uint8_t state)
-{
-    HAL_GPIO_WritePin(GPIOD, GPIO_PIN_2, state ? GPIO_PIN_SET : GPIO_PIN_RESET);
-}
@@ -9,6 +9,19 @@
 
 #include <stdint.h>
 
+/*============================================================================*/
+/*                              后端选择                                       */
+/*============================================================================*/
+
+/* 1=使用 motor_hw_sim.c 仿真后端 (电机对象模型替代真实硬件), 0=STM32 硬件 */
+#ifndef MOTOR_HW_SIM
+#define MOTOR_HW_SIM            0
+#endif
+
+#if MOTOR_HW_SIM
+#include "motor_sim.h"
+#endif
+
 /*============================================================================*/
 /*                              硬件配置参数                                   */
 /*============================================================================*/
@@ -28,15 +41,24 @@
 #define HW_CURRENT_SCALE        (HW_ADC_VREF / (HW_OPAMP_GAIN * HW_SHUNT_RESISTANCE * HW_ADC_RESOLUTION))
 
 /* 编码器配置 */
-#define HW_ENCODER_CPR          16384       // AS5047P 14-bit (每转计数)
+#define HW_ENCODER_BITS         14          // AS5047P 14-bit
+#define HW_ENCODER_CPR          (1u << HW_ENCODER_BITS)     // 每转计数
 #define HW_MOTOR_POLE_PAIRS     7           // 电机极对数
-#define HW_ENCODER_ZERO_OFFSET  0.386563f   // 零点偏移 (rad)
+#define HW_ENCODER_ZERO_OFFSET  0.386563f   // 零点偏移默认值 (rad, 参数存储中有校准值时被覆盖)
+
+/* 轴数 (每轴一组 PWM 定时器 + 注入 ADC + 编码器 SPI, 见 g_MotorHW 描述符表) */
+#ifndef HW_AXIS_COUNT
+#define HW_AXIS_COUNT           1
+#endif
 
 /* 采样周期 */
 #define HW_CONTROL_PERIOD_S     0.00005f    // 控制周期 (50us = 20kHz)
 #define HW_SPEED_LOOP_DIV       20          // 速度环分频 (1kHz)
 #define HW_POS_LOOP_DIV         20          // 位置环分频 (1kHz)
 
+/* 外环任务 (速度环/位置环) 运行在最低优先级的 PendSV 中 */
+#define HW_OUTER_TASK_PRIORITY  15          // NVIC 抢占优先级 (低于 ADC/SPI/DMA)
+
 /*============================================================================*/
 /*                              数据结构                                       */
 /*============================================================================*/
@@ -54,10 +76,17 @@ typedef struct {
  * @brief 编码器数据结构体
  */
 typedef struct {
-    uint16_t RawAngle;      // 原始角度值 (0~16383)
+    uint16_t RawAngle;      // 原始角度值 (0~16383, 已经非线性补偿)
     float MechAngle;        // 机械角度 (rad, 0~2π)
     float ElecAngle;        // 电角度 (rad, 0~2π)
+    float ZeroOffset;       // 零点偏移 (rad, 0~2π)
+    uint32_t ZeroOffsetPhase;   // 零点偏移 (Q32 相位, 机械角)
+    uint16_t ElecPhase;     // 电角度 (Q16 相位, 定点流水线 / 查表 sincos 直接使用)
+    uint16_t MechCnt;       // 机械角度 (计数, 已按方向换算)
+    int64_t PosCnt;         // 多圈累计位置 (计数, 按相邻读数最短路径累加)
     int8_t Direction;       // 方向 (+1 或 -1)
+    uint8_t PolePairs;      // 极对数 (上电为 HW_MOTOR_POLE_PAIRS, 编码器校准测得或参数设置后更新)
+    const int16_t *Lin;     // 非线性补偿表 (enc_lin, NULL=不补偿)
 } EncoderData_t;
 
 /**
@@ -70,45 +99,107 @@ typedef struct {
     uint8_t IsCalibrated;   // 校准完成标志
 } CurrentOffset_t;
 
+/**
+ * @brief 每轴硬件描述符 (外设配置 + 驱动层运行状态)
+ * @note  外设句柄以 void* 保存, 本头文件不依赖 STM32 HAL;
+ *        多轴时各轴 PWM 定时器错开半个周期启动, 控制中断交替执行
+ */
+typedef struct {
+    /* 外设配置 */
+    void *Tim;              // PWM 定时器 (TIM_HandleTypeDef *)
+    void *Adc;              // 电流采样 ADC, 注入组 Rank1~3 = U/V/W (ADC_HandleTypeDef *)
+    void *Spi;              // 编码器 SPI (SPI_HandleTypeDef *)
+    void *EnPort;           // 驱动使能 EN_GATE 端口 (GPIO_TypeDef *)
+    uint16_t EnPin;         // 驱动使能引脚
+    void *CsPort;           // 编码器片选端口 (GPIO_TypeDef *)
+    uint16_t CsPin;         // 编码器片选引脚
+    void *DbgPort;          // 调试引脚端口 (NULL=不使用)
+    uint16_t DbgPin;        // 调试引脚
+    
+    /* 编码器 SPI 缓冲区 (DMA 访问) */
+    uint16_t EncTx;         // 读取角度命令
+    uint16_t EncRx;         // 接收数据
+    
+    /* 电流偏移校准累加器 */
+    uint32_t CalSum[3];     // U/V/W 累加值
+    uint32_t CalCount;      // 已累加次数
+    
+#if MOTOR_HW_SIM
+    /* 仿真后端状态 */
+    MotorSim_t Plant;       // 电机对象模型
+    uint32_t SimCCR[3];     // PWM 比较寄存器映像
+    uint32_t SimADC[3];     // ADC 采样映像
+    float SimEncOffset;     // 编码器安装偏移 (rad)
+    int8_t SimEncDir;       // 编码器安装方向
+    float SimEncErrAmp[2];  // 编码器角度误差 1/2 次谐波幅值 (rad, 磁铁偏心 / 倾斜)
+    float SimEncErrPhase[2];    // 编码器角度误差 1/2 次谐波相位 (rad)
+    uint16_t SimEncLatch;   // 锁存的编码器读数
+    uint8_t SimEncPending;  // 编码器读取进行中
+#endif
+} MotorHW_t;
+
+/* 硬件描述符表 (motor_hw.c / motor_hw_sim.c 中定义) */
+extern MotorHW_t g_MotorHW[HW_AXIS_COUNT];
+
 /*============================================================================*/
 /*                              函数接口                                       */
 /*============================================================================*/
 
 /**
  * @brief  硬件层初始化
+ * @param  hw: 硬件描述符指针
+ */
+void MotorHW_Init(MotorHW_t *hw);
+
+/**
+ * @brief  按 ADC 句柄查找轴号 (ADC 注入完成中断分发用)
+ * @param  hadc: ADC 句柄
+ * @return 轴号, -1=不属于任何轴
+ */
+int8_t MotorHW_AxisFromADC(const void *hadc);
+
+/**
+ * @brief  按 SPI 句柄查找轴号 (SPI DMA 完成中断分发用)
+ * @param  hspi: SPI 句柄
+ * @return 轴号, -1=不属于任何轴
  */
-void MotorHW_Init(void);
+int8_t MotorHW_AxisFromSPI(const void *hspi);
 
 /**
  * @brief  使能电机驱动 (DRV8301 EN_GATE)
+ * @param  hw: 硬件描述符指针
  */
-void MotorHW_EnableDriver(void);
+void MotorHW_EnableDriver(MotorHW_t *hw);
 
 /**
  * @brief  禁用电机驱动
+ * @param  hw: 硬件描述符指针
  */
-void MotorHW_DisableDriver(void);
+void MotorHW_DisableDriver(MotorHW_t *hw);
 
 /**
  * @brief  设置三相 PWM 占空比
+ * @param  hw: 硬件描述符指针
  * @param  ccr_u: U相 CCR值 (0 ~ HW_PWM_PERIOD)
  * @param  ccr_v: V相 CCR值
  * @param  ccr_w: W相 CCR值
  */
-void MotorHW_SetPWM(uint32_t ccr_u, uint32_t ccr_v, uint32_t ccr_w);
+void MotorHW_SetPWM(MotorHW_t *hw, uint32_t ccr_u, uint32_t ccr_v, uint32_t ccr_w);
 
 /**
  * @brief  设置所有 PWM 为 50% (刹车/停止)
+ * @param  hw: 硬件描述符指针
  */
-void MotorHW_SetPWMBrake(void);
+void MotorHW_SetPWMBrake(MotorHW_t *hw);
 
 /**
  * @brief  读取三相电流 ADC 原始值
+ * @param  hw: 硬件描述符指针
  * @param  adc_u: U相 ADC 值指针
  * @param  adc_v: V相 ADC 值指针
  * @param  adc_w: W相 ADC 值指针
  */
-void MotorHW_GetCurrentADC(uint32_t *adc_u, uint32_t *adc_v, uint32_t *adc_w);
+void MotorHW_GetCurrentADC(MotorHW_t *hw, uint32_t *adc_u, uint32_t *adc_v, uint32_t *adc_w);
 
 /**
  * @brief  将 ADC 值转换为电流 (A)
@@ -120,37 +211,120 @@ float MotorHW_ADCToCurrent(uint32_t adc_value, float offset);
 
 /**
  * @brief  读取三相电流 (已转换)
+ * @param  hw: 硬件描述符指针
  * @param  currents: 电流结构体指针
  * @param  offset: 偏移校准数据指针
  */
-void MotorHW_GetCurrents(PhaseCurrents_t *currents, const CurrentOffset_t *offset);
+void MotorHW_GetCurrents(MotorHW_t *hw, PhaseCurrents_t *currents, const CurrentOffset_t *offset);
 
 /**
  * @brief  启动编码器 DMA 读取
+ * @param  hw: 硬件描述符指针
  */
-void MotorHW_StartEncoderRead(void);
+void MotorHW_StartEncoderRead(MotorHW_t *hw);
 
 /**
  * @brief  处理编码器数据 (在 SPI DMA 回调中调用)
+ * @param  hw: 硬件描述符指针
+ * @param  encoder: 编码器数据结构体指针
+ */
+void MotorHW_ProcessEncoderData(MotorHW_t *hw, EncoderData_t *encoder);
+
+/**
+ * @brief  由原始角度值计算机械角度、电角度和多圈位置 (与硬件无关)
+ * @note   整数相位域运算, 回绕由无符号溢出完成, 无 fmodf;
+ *         多圈位置要求相邻两次调用间转过不足半圈
  * @param  encoder: 编码器数据结构体指针
+ * @param  raw_angle: 14-bit 原始角度值
  */
-void MotorHW_ProcessEncoderData(EncoderData_t *encoder);
+void MotorHW_DecodeEncoder(EncoderData_t *encoder, uint16_t raw_angle);
+
+/**
+ * @brief  设置编码器零点偏移 (同时换算为 Q32 相位)
+ * @param  encoder: 编码器数据结构体指针
+ * @param  offset: 零点偏移 (rad)
+ */
+void MotorHW_SetEncoderOffset(EncoderData_t *encoder, float offset);
 
 /**
  * @brief  电流偏移校准 (累加一次采样)
+ * @param  hw: 硬件描述符指针 (保存累加器)
  * @param  offset: 偏移结构体指针
  * @param  adc_u: U相 ADC 值
  * @param  adc_v: V相 ADC 值
  * @param  adc_w: W相 ADC 值
  * @return 1=校准完成, 0=校准中
  */
-uint8_t MotorHW_CalibrateCurrentOffset(CurrentOffset_t *offset, 
+uint8_t MotorHW_CalibrateCurrentOffset(MotorHW_t *hw, CurrentOffset_t *offset,
                                         uint32_t adc_u, uint32_t adc_v, uint32_t adc_w);
 
+/**
+ * @brief  挂起外环任务 (触发 PendSV, 控制中断返回后执行)
+ * @note   仿真中无操作, 由 FOC_SimTick 在控制中断之后直接调度
+ */
+void MotorHW_PendOuterTask(void);
+
 /**
  * @brief  调试 GPIO 设置 (用于测量中断时间)
+ * @param  hw: 硬件描述符指针
  * @param  state: 1=高电平, 0=低电平
  */
-void MotorHW_DebugPin(uint8_t state);
+void MotorHW_DebugPin(MotorHW_t *hw, uint8_t state);
+
+/*============================================================================*/
+/*                              仿真后端接口                                   */
+/*============================================================================*/
+
+#if MOTOR_HW_SIM
+
+/**
+ * @brief  初始化仿真后端
+ * @param  hw: 硬件描述符指针
+ * @param  params: 电机参数 (NULL 则使用默认参数)
+ * @param  enc_offset: 编码器安装偏移 (rad), 即电角度零点处的编码器机械角度读数
+ * @param  enc_dir: 编码器安装方向 (+1 或 -1)
+ */
+void MotorHW_Sim_Init(MotorHW_t *hw, const MotorSim_Params_t *params, float enc_offset, int8_t enc_dir);
+
+/**
+ * @brief  设置编码器角度误差 (模拟磁铁偏心)
+ * @param  hw: 硬件描述符指针
+ * @param  harmonic: 谐波次数 (1 或 2, 每转周期数)
+ * @param  amp: 幅值 (rad, 机械角)
+ * @param  phase: 相位 (rad)
+ * @note   读数 = 方向 × (转子角 + 偏移) + Σ amp·sin(harmonic·转子角 + phase)
+ */
+void MotorHW_Sim_SetEncoderError(MotorHW_t *hw, uint8_t harmonic, float amp, float phase);
+
+/**
+ * @brief  获取仿真电机对象模型
+ * @param  hw: 硬件描述符指针
+ * @return 仿真模型指针 (可直接修改负载转矩等输入)
+ */
+MotorSim_t *MotorHW_Sim_GetPlant(MotorHW_t *hw);
+
+/**
+ * @brief  推进对象模型一个 PWM 周期并锁存 ADC 采样
+ * @param  hw: 硬件描述符指针
+ */
+void MotorHW_Sim_Step(MotorHW_t *hw);
+
+/**
+ * @brief  查询是否有待完成的编码器读取 (对应 SPI DMA 完成中断)
+ * @param  hw: 硬件描述符指针
+ * @return 1=有, 0=无
+ */
+uint8_t MotorHW_Sim_EncoderPending(MotorHW_t *hw);
+
+/**
+ * @brief  直接注入 ADC 采样值 (录制回放用, 覆盖对象模型输出)
+ * @param  hw: 硬件描述符指针
+ * @param  adc_u: U相 ADC 值
+ * @param  adc_v: V相 ADC 值
+ * @param  adc_w: W相 ADC 值
+ */
+void MotorHW_Sim_SetADC(MotorHW_t *hw, uint32_t adc_u, uint32_t adc_v, uint32_t adc_w);
+
+#endif /* MOTOR_HW_SIM */
 
 #endif /* __MOTOR_HW_H */
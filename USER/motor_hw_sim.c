@@ -0,0 +1,228 @@
+/**
+ * @file    motor_hw_sim.c
+ * @brief   电机硬件抽象层 (HAL) 仿真后端
+ * @note    MOTOR_HW_SIM = 1 时替代 motor_hw.c 中的硬件相关函数,
+ *          PWM/ADC/编码器接口全部由 motor_sim 电机对象模型驱动,
+ *          可在无硬件环境下运行完整 FOC 闭环
+ */
+
+#include "motor_hw.h"
+
+#if MOTOR_HW_SIM
+
+#include <math.h>
+
+/*============================================================================*/
+/*                              常量定义                                       */
+/*============================================================================*/
+
+#define SIM_2PI             6.28318530718f
+#define SIM_ADC_MID         2048.0f         // 双向电流采样零点
+#define SIM_ADC_MAX         4095.0f
+
+/*============================================================================*/
+/*                              硬件描述符表                                   */
+/*============================================================================*/
+
+/* 仿真中外设句柄仅作为轴标识 (指向各自描述符), 由 MotorHW_Sim_Init 设置 */
+MotorHW_t g_MotorHW[HW_AXIS_COUNT];
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  电流 → ADC 码值 (含量化与饱和)
+ */
+static uint32_t Sim_CurrentToADC(float current)
+{
+    float code = SIM_ADC_MID + current / HW_CURRENT_SCALE + 0.5f;
+
+    if (code < 0.0f) code = 0.0f;
+    if (code > SIM_ADC_MAX) code = SIM_ADC_MAX;
+    return (uint32_t)code;
+}
+
+/**
+ * @brief  转子机械角度 → 编码器 14-bit 读数
+ */
+static uint16_t Sim_EncoderRaw(const MotorHW_t *hw)
+{
+    float theta = hw->Plant.ThetaMech;
+    float angle = (float)hw->SimEncDir * (theta + hw->SimEncOffset)
+                + hw->SimEncErrAmp[0] * sinf(theta + hw->SimEncErrPhase[0])
+                + hw->SimEncErrAmp[1] * sinf(2.0f * theta + hw->SimEncErrPhase[1]);
+    angle -= SIM_2PI * floorf(angle * (1.0f / SIM_2PI));
+
+    return (uint16_t)((uint32_t)(angle * ((float)HW_ENCODER_CPR / SIM_2PI) + 0.5f)
+                      & (HW_ENCODER_CPR - 1));
+}
+
+/*============================================================================*/
+/*                              仿真后端接口                                   */
+/*============================================================================*/
+
+/**
+ * @brief  初始化仿真后端
+ */
+void MotorHW_Sim_Init(MotorHW_t *hw, const MotorSim_Params_t *params, float enc_offset, int8_t enc_dir)
+{
+    MotorSim_Init(&hw->Plant, params);
+
+    hw->Tim = hw->Adc = hw->Spi = hw;
+    hw->EncTx = 0x3FFF;
+
+    hw->SimEncOffset = enc_offset;
+    hw->SimEncDir = (enc_dir < 0) ? -1 : 1;
+    hw->SimEncErrAmp[0] = hw->SimEncErrAmp[1] = 0.0f;
+    hw->SimEncErrPhase[0] = hw->SimEncErrPhase[1] = 0.0f;
+    hw->SimEncPending = 0;
+
+    hw->SimCCR[0] = hw->SimCCR[1] = hw->SimCCR[2] = HW_PWM_PERIOD / 2;
+    hw->SimADC[0] = hw->SimADC[1] = hw->SimADC[2] = (uint32_t)SIM_ADC_MID;
+}
+
+/**
+ * @brief  设置编码器角度误差
+ */
+void MotorHW_Sim_SetEncoderError(MotorHW_t *hw, uint8_t harmonic, float amp, float phase)
+{
+    if (harmonic < 1 || harmonic > 2) return;
+
+    hw->SimEncErrAmp[harmonic - 1] = amp;
+    hw->SimEncErrPhase[harmonic - 1] = phase;
+}
+
+/**
+ * @brief  获取仿真电机对象模型
+ */
+MotorSim_t *MotorHW_Sim_GetPlant(MotorHW_t *hw)
+{
+    return &hw->Plant;
+}
+
+/**
+ * @brief  推进对象模型一个 PWM 周期并锁存 ADC 采样
+ * @note   本周期使用上一次 MotorHW_SetPWM 写入的占空比 (对应 TIM1 预装载)
+ */
+void MotorHW_Sim_Step(MotorHW_t *hw)
+{
+    MotorSim_SetPWM(&hw->Plant, hw->SimCCR[0], hw->SimCCR[1], hw->SimCCR[2], HW_PWM_PERIOD);
+    MotorSim_Step(&hw->Plant, HW_CONTROL_PERIOD_S);
+
+    hw->SimADC[0] = Sim_CurrentToADC(hw->Plant.Iu);
+    hw->SimADC[1] = Sim_CurrentToADC(hw->Plant.Iv);
+    hw->SimADC[2] = Sim_CurrentToADC(hw->Plant.Iw);
+}
+
+/**
+ * @brief  查询是否有待完成的编码器读取
+ */
+uint8_t MotorHW_Sim_EncoderPending(MotorHW_t *hw)
+{
+    return hw->SimEncPending;
+}
+
+/**
+ * @brief  直接注入 ADC 采样值
+ */
+void MotorHW_Sim_SetADC(MotorHW_t *hw, uint32_t adc_u, uint32_t adc_v, uint32_t adc_w)
+{
+    hw->SimADC[0] = adc_u;
+    hw->SimADC[1] = adc_v;
+    hw->SimADC[2] = adc_w;
+}
+
+/*============================================================================*/
+/*                              硬件接口实现                                   */
+/*============================================================================*/
+
+/**
+ * @brief  硬件层初始化
+ */
+void MotorHW_Init(MotorHW_t *hw)
+{
+    hw->SimEncPending = 0;
+    hw->CalSum[0] = hw->CalSum[1] = hw->CalSum[2] = 0;
+    hw->CalCount = 0;
+}
+
+/**
+ * @brief  使能电机驱动
+ */
+void MotorHW_EnableDriver(MotorHW_t *hw)
+{
+    hw->Plant.Enabled = 1;
+}
+
+/**
+ * @brief  禁用电机驱动
+ */
+void MotorHW_DisableDriver(MotorHW_t *hw)
+{
+    hw->Plant.Enabled = 0;
+}
+
+/**
+ * @brief  设置三相 PWM 占空比
+ */
+void MotorHW_SetPWM(MotorHW_t *hw, uint32_t ccr_u, uint32_t ccr_v, uint32_t ccr_w)
+{
+    hw->SimCCR[0] = ccr_u;
+    hw->SimCCR[1] = ccr_v;
+    hw->SimCCR[2] = ccr_w;
+}
+
+/**
+ * @brief  设置所有 PWM 为 50% (刹车/停止)
+ */
+void MotorHW_SetPWMBrake(MotorHW_t *hw)
+{
+    hw->SimCCR[0] = hw->SimCCR[1] = hw->SimCCR[2] = HW_PWM_PERIOD / 2;
+}
+
+/**
+ * @brief  读取三相电流 ADC 原始值
+ */
+void MotorHW_GetCurrentADC(MotorHW_t *hw, uint32_t *adc_u, uint32_t *adc_v, uint32_t *adc_w)
+{
+    *adc_u = hw->SimADC[0];
+    *adc_v = hw->SimADC[1];
+    *adc_w = hw->SimADC[2];
+}
+
+/**
+ * @brief  启动编码器读取 (锁存当前转子角度)
+ */
+void MotorHW_StartEncoderRead(MotorHW_t *hw)
+{
+    hw->SimEncLatch = Sim_EncoderRaw(hw);
+    hw->SimEncPending = 1;
+}
+
+/**
+ * @brief  处理编码器数据
+ */
+void MotorHW_ProcessEncoderData(MotorHW_t *hw, EncoderData_t *encoder)
+{
+    hw->SimEncPending = 0;
+    MotorHW_DecodeEncoder(encoder, hw->SimEncLatch);
+}
+
+/**
+ * @brief  挂起外环任务 (仿真中由 FOC_SimTick 调度, 无操作)
+ */
+void MotorHW_PendOuterTask(void)
+{
+}
+
+/**
+ * @brief  调试 GPIO 设置 (仿真中无操作)
+ */
+void MotorHW_DebugPin(MotorHW_t *hw, uint8_t state)
+{
+    (void)hw;
+    (void)state;
+}
+
+#endif /* MOTOR_HW_SIM */
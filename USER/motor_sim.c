@@ -0,0 +1,210 @@
+/**
+ * @file    motor_sim.c
+ * @brief   PMSM 电机 + 逆变器离散时间仿真模型实现
+ * @note    纯算法实现，无硬件依赖，可移植
+ */
+
+#include "motor_sim.h"
+#include <math.h>
+
+/*============================================================================*/
+/*                              常量定义                                       */
+/*============================================================================*/
+
+#define SIM_2PI             6.28318530718f
+#define SIM_SQRT3_BY_2      0.86602540378f
+#define SIM_ONE_BY_SQRT3    0.57735026919f
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  符号函数
+ */
+static inline float Sign(float x)
+{
+    return (x > 0.0f) ? 1.0f : ((x < 0.0f) ? -1.0f : 0.0f);
+}
+
+/**
+ * @brief  更新三相电流输出 (dq → abc, 等幅值变换)
+ */
+static void Sim_UpdatePhaseCurrents(MotorSim_t *sim, float sin_e, float cos_e)
+{
+    float i_alpha = sim->Id * cos_e - sim->Iq * sin_e;
+    float i_beta  = sim->Id * sin_e + sim->Iq * cos_e;
+
+    sim->Iu = i_alpha;
+    sim->Iv = -0.5f * i_alpha + SIM_SQRT3_BY_2 * i_beta;
+    sim->Iw = -sim->Iu - sim->Iv;
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  填充默认参数
+ * @note   电流环默认增益按 Kp = L·ωc, Ki·fs = R·ωc (ωc ≈ 2π·1kHz) 整定,
+ *         据此反推 R/L 的量级
+ */
+void MotorSim_DefaultParams(MotorSim_Params_t *params)
+{
+    params->Rs = 0.045f;
+    params->Ld = 11.0e-6f;
+    params->Lq = 11.0e-6f;
+    params->Flux = 0.0025f;
+    params->PolePairs = 7;
+
+    params->Inertia = 3.0e-5f;
+    params->ViscousFriction = 1.0e-5f;
+    params->CoulombFriction = 0.002f;
+
+    params->Vdc = 12.0f;
+    params->DeadTimeRatio = 0.0f;
+
+    params->SubSteps = 4;
+}
+
+/**
+ * @brief  初始化仿真模型
+ */
+void MotorSim_Init(MotorSim_t *sim, const MotorSim_Params_t *params)
+{
+    if (params != 0) {
+        sim->P = *params;
+    } else {
+        MotorSim_DefaultParams(&sim->P);
+    }
+    if (sim->P.SubSteps == 0) sim->P.SubSteps = 1;
+
+    sim->Id = 0.0f;
+    sim->Iq = 0.0f;
+    sim->OmegaMech = 0.0f;
+    sim->ThetaMech = 0.0f;
+
+    sim->DutyU = 0.5f;
+    sim->DutyV = 0.5f;
+    sim->DutyW = 0.5f;
+    sim->LoadTorque = 0.0f;
+    sim->Enabled = 0;
+
+    sim->Iu = 0.0f;
+    sim->Iv = 0.0f;
+    sim->Iw = 0.0f;
+    sim->Torque = 0.0f;
+    sim->Vd = 0.0f;
+    sim->Vq = 0.0f;
+}
+
+/**
+ * @brief  设置三相占空比
+ * @note   中心对齐 PWM1 模式: 高电平时间 = CCR / ARR
+ */
+void MotorSim_SetPWM(MotorSim_t *sim, uint32_t ccr_u, uint32_t ccr_v,
+                     uint32_t ccr_w, uint32_t period)
+{
+    float inv = 1.0f / (float)period;
+
+    sim->DutyU = (float)ccr_u * inv;
+    sim->DutyV = (float)ccr_v * inv;
+    sim->DutyW = (float)ccr_w * inv;
+}
+
+/**
+ * @brief  推进仿真一个步长
+ * @note   电气方程 (dq):
+ *         Ld·did/dt = vd - R·id + ωe·Lq·iq
+ *         Lq·diq/dt = vq - R·iq - ωe·Ld·id - ωe·ψ
+ *         机械方程:
+ *         J·dωm/dt  = Te - TL - B·ωm - Tc·sgn(ωm)
+ *         Te = 1.5·Pp·(ψ·iq + (Ld - Lq)·id·iq)
+ */
+void MotorSim_Step(MotorSim_t *sim, float dt)
+{
+    const MotorSim_Params_t *p = &sim->P;
+    float h = dt / (float)p->SubSteps;
+    float vd_sum = 0.0f, vq_sum = 0.0f;
+
+    for (uint8_t n = 0; n < p->SubSteps; n++) {
+        float theta_e = sim->ThetaMech * (float)p->PolePairs;
+        float sin_e = sinf(theta_e);
+        float cos_e = cosf(theta_e);
+        float omega_e = sim->OmegaMech * (float)p->PolePairs;
+        float vd = 0.0f, vq = 0.0f;
+
+        Sim_UpdatePhaseCurrents(sim, sin_e, cos_e);
+
+        if (sim->Enabled) {
+            /* 逆变器: 占空比 → 桥臂电压 (死区按电流方向修正) */
+            float du = sim->DutyU - p->DeadTimeRatio * Sign(sim->Iu);
+            float dv = sim->DutyV - p->DeadTimeRatio * Sign(sim->Iv);
+            float dw = sim->DutyW - p->DeadTimeRatio * Sign(sim->Iw);
+
+            /* 减去中性点电压得到相电压, 再做 Clarke/Park */
+            float vn = (du + dv + dw) * (1.0f / 3.0f);
+            float va = (du - vn) * p->Vdc;
+            float vb = (dv - vn) * p->Vdc;
+            float vc = (dw - vn) * p->Vdc;
+
+            float v_alpha = va;
+            float v_beta  = (vb - vc) * SIM_ONE_BY_SQRT3;
+
+            vd =  v_alpha * cos_e + v_beta * sin_e;
+            vq = -v_alpha * sin_e + v_beta * cos_e;
+
+            float did = (vd - p->Rs * sim->Id + omega_e * p->Lq * sim->Iq) / p->Ld;
+            float diq = (vq - p->Rs * sim->Iq - omega_e * p->Ld * sim->Id
+                         - omega_e * p->Flux) / p->Lq;
+
+            sim->Id += did * h;
+            sim->Iq += diq * h;
+        } else {
+            /* 驱动关闭: 按高阻处理, 电流立即归零 */
+            sim->Id = 0.0f;
+            sim->Iq = 0.0f;
+        }
+
+        vd_sum += vd;
+        vq_sum += vq;
+
+        /* 机械方程 */
+        sim->Torque = 1.5f * (float)p->PolePairs
+                    * (p->Flux * sim->Iq + (p->Ld - p->Lq) * sim->Id * sim->Iq);
+
+        float drive = sim->Torque - sim->LoadTorque - p->ViscousFriction * sim->OmegaMech;
+
+        if (sim->OmegaMech == 0.0f && fabsf(drive) <= p->CoulombFriction) {
+            /* 静摩擦区: 保持静止 */
+        } else {
+            float omega_old = sim->OmegaMech;
+            float friction = p->CoulombFriction * Sign(omega_old != 0.0f ? omega_old : drive);
+
+            sim->OmegaMech += (drive - friction) / p->Inertia * h;
+
+            /* 过零时停在零点, 避免库仑摩擦引起抖动 */
+            if (omega_old * sim->OmegaMech < 0.0f) {
+                sim->OmegaMech = 0.0f;
+            }
+        }
+
+        sim->ThetaMech += sim->OmegaMech * h;
+        sim->ThetaMech -= SIM_2PI * floorf(sim->ThetaMech * (1.0f / SIM_2PI));
+    }
+
+    sim->Vd = vd_sum / (float)p->SubSteps;
+    sim->Vq = vq_sum / (float)p->SubSteps;
+
+    float theta_e = sim->ThetaMech * (float)p->PolePairs;
+    Sim_UpdatePhaseCurrents(sim, sinf(theta_e), cosf(theta_e));
+}
+
+/**
+ * @brief  获取转子电角度
+ */
+float MotorSim_GetElecAngle(const MotorSim_t *sim)
+{
+    float theta_e = sim->ThetaMech * (float)sim->P.PolePairs;
+    return theta_e - SIM_2PI * floorf(theta_e * (1.0f / SIM_2PI));
+}
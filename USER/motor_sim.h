@@ -0,0 +1,111 @@
+/**
+ * @file    motor_sim.h
+ * @brief   PMSM 电机 + 逆变器离散时间仿真模型
+ * @note    纯算法实现，无硬件依赖，可移植
+ *          dq 坐标系平均值模型: R, Ld/Lq, 磁链, 转动惯量, 粘滞/库仑摩擦, 负载转矩
+ */
+
+#ifndef __MOTOR_SIM_H
+#define __MOTOR_SIM_H
+
+#include <stdint.h>
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 电机与逆变器参数
+ */
+typedef struct {
+    /* 电气参数 */
+    float Rs;               // 相电阻 (Ω)
+    float Ld;               // d轴电感 (H)
+    float Lq;               // q轴电感 (H)
+    float Flux;             // 永磁磁链 (Wb)
+    uint8_t PolePairs;      // 极对数
+
+    /* 机械参数 */
+    float Inertia;          // 转动惯量 (kg·m²)
+    float ViscousFriction;  // 粘滞摩擦系数 (N·m·s/rad)
+    float CoulombFriction;  // 库仑摩擦 (N·m)
+
+    /* 逆变器 */
+    float Vdc;              // 母线电压 (V)
+    float DeadTimeRatio;    // 死区占 PWM 周期比例 (0=理想逆变器)
+
+    /* 积分 */
+    uint8_t SubSteps;       // 每个控制周期的积分子步数
+} MotorSim_Params_t;
+
+/**
+ * @brief 仿真模型状态
+ */
+typedef struct {
+    MotorSim_Params_t P;    // 参数
+
+    /* 状态量 */
+    float Id;               // d轴电流 (A)
+    float Iq;               // q轴电流 (A)
+    float OmegaMech;        // 机械角速度 (rad/s)
+    float ThetaMech;        // 机械角度 (rad, 0~2π)
+
+    /* 输入 */
+    float DutyU;            // U相占空比 (0~1)
+    float DutyV;            // V相占空比
+    float DutyW;            // W相占空比
+    float LoadTorque;       // 负载转矩 (N·m)
+    uint8_t Enabled;        // 逆变器使能 (0=高阻, 电流衰减为零)
+
+    /* 输出 */
+    float Iu;               // U相电流 (A)
+    float Iv;               // V相电流 (A)
+    float Iw;               // W相电流 (A)
+    float Torque;           // 电磁转矩 (N·m)
+    float Vd;               // 本周期 d轴平均电压 (V)
+    float Vq;               // 本周期 q轴平均电压 (V)
+} MotorSim_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  填充默认参数 (与本板 7 对极电机和电流环默认增益量级一致)
+ * @param  params: 参数结构体指针
+ */
+void MotorSim_DefaultParams(MotorSim_Params_t *params);
+
+/**
+ * @brief  初始化仿真模型
+ * @param  sim: 仿真模型指针
+ * @param  params: 参数 (NULL 则使用默认参数)
+ */
+void MotorSim_Init(MotorSim_t *sim, const MotorSim_Params_t *params);
+
+/**
+ * @brief  设置三相占空比 (由 CCR 值换算)
+ * @param  sim: 仿真模型指针
+ * @param  ccr_u: U相 CCR
+ * @param  ccr_v: V相 CCR
+ * @param  ccr_w: W相 CCR
+ * @param  period: PWM 周期 (ARR 值)
+ */
+void MotorSim_SetPWM(MotorSim_t *sim, uint32_t ccr_u, uint32_t ccr_v,
+                     uint32_t ccr_w, uint32_t period);
+
+/**
+ * @brief  推进仿真一个步长
+ * @param  sim: 仿真模型指针
+ * @param  dt: 步长 (s), 内部按 SubSteps 细分
+ */
+void MotorSim_Step(MotorSim_t *sim, float dt);
+
+/**
+ * @brief  获取转子电角度
+ * @param  sim: 仿真模型指针
+ * @return 电角度 (rad, 0~2π)
+ */
+float MotorSim_GetElecAngle(const MotorSim_t *sim);
+
+#endif /* __MOTOR_SIM_H */
@@ -11,11 +11,13 @@
 
 /**
  * @brief  角度归一化到 [0, 2π)
+ * @note   输入须在 [-2π, 4π) 内 (每周期角度增量 |ω·dt| < 2π 时恒成立),
+ *         两次条件加减编译为条件执行, 无循环无跳转, 耗时固定
  */
 static inline float NormalizeAngle(float angle)
 {
-    while (angle >= PLL_2PI) angle -= PLL_2PI;
-    while (angle < 0.0f)     angle += PLL_2PI;
+    angle -= (angle >= PLL_2PI) ? PLL_2PI : 0.0f;
+    angle += (angle < 0.0f) ? PLL_2PI : 0.0f;
     return angle;
 }
 
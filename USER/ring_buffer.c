@@ -0,0 +1,123 @@
+/**
+ * @file    ring_buffer.c
+ * @brief   SPSC 无锁字节环形缓冲区实现
+ */
+
+#include "ring_buffer.h"
+#include "foc_atomic.h"
+#include <string.h>
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
+
+/**
+ * @brief  拷贝进缓冲区 (处理回绕)
+ */
+static void Ring_CopyIn(RingBuffer_t *rb, uint32_t pos, const uint8_t *src, uint32_t len)
+{
+    uint32_t off = pos & (rb->Size - 1u);
+    uint32_t first = rb->Size - off;
+
+    if (first > len) first = len;
+    memcpy(&rb->Buf[off], src, first);
+    memcpy(rb->Buf, src + first, len - first);
+}
+
+/**
+ * @brief  从缓冲区拷出 (处理回绕)
+ */
+static void Ring_CopyOut(const RingBuffer_t *rb, uint32_t pos, uint8_t *dst, uint32_t len)
+{
+    uint32_t off = pos & (rb->Size - 1u);
+    uint32_t first = rb->Size - off;
+
+    if (first > len) first = len;
+    memcpy(dst, &rb->Buf[off], first);
+    memcpy(dst + first, rb->Buf, len - first);
+}
+
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化环形缓冲区
+ */
+void RingBuffer_Init(RingBuffer_t *rb, uint8_t *buf, uint32_t size, RingBuffer_Policy_t policy)
+{
+    rb->Buf = buf;
+    rb->Size = size;
+    rb->Head = 0;
+    rb->Tail = 0;
+    rb->Policy = policy;
+
+    rb->WrittenBytes = 0;
+    rb->DroppedFrames = 0;
+    rb->DroppedBytes = 0;
+    rb->HighWater = 0;
+}
+
+/**
+ * @brief  写入一帧
+ * @note   DROP_OLDEST 以比较交换推进读指针, 与消费者的推进互不覆盖;
+ *         被丢弃区域若正被消费者拷贝, 其比较交换失败后会重新读取
+ */
+uint32_t RingBuffer_Write(RingBuffer_t *rb, const uint8_t *data, uint32_t len)
+{
+    uint32_t head = rb->Head;
+
+    if (len == 0) return 0;
+
+    if (len > rb->Size || (rb->Policy == RING_DROP_NEWEST && len > rb->Size - (head - rb->Tail))) {
+        rb->DroppedFrames++;
+        rb->DroppedBytes += len;
+        return 0;
+    }
+
+    /* 丢弃最旧数据腾出空间 */
+    for (;;) {
+        uint32_t tail = rb->Tail;
+        uint32_t used = head - tail;
+        if (len <= rb->Size - used) break;
+
+        uint32_t drop = len - (rb->Size - used);
+        if (FOC_Atomic_CompareExchange(&rb->Tail, tail, tail + drop)) {
+            rb->DroppedBytes += drop;
+            break;
+        }
+    }
+
+    Ring_CopyIn(rb, head, data, len);
+    FOC_Atomic_Barrier();
+    rb->Head = head + len;
+
+    rb->WrittenBytes += len;
+    if (head + len - rb->Tail > rb->HighWater) {
+        rb->HighWater = head + len - rb->Tail;
+    }
+    return len;
+}
+
+/**
+ * @brief  取出数据
+ */
+uint32_t RingBuffer_Read(RingBuffer_t *rb, uint8_t *dst, uint32_t max)
+{
+    for (;;) {
+        uint32_t tail = rb->Tail;
+        uint32_t avail = rb->Head - tail;
+        uint32_t n = (avail < max) ? avail : max;
+
+        if (n == 0) return 0;
+        if (avail > rb->Size) continue;     // 读取期间读指针已被生产者推进
+
+        FOC_Atomic_Barrier();
+        Ring_CopyOut(rb, tail, dst, n);
+        FOC_Atomic_Barrier();
+
+        if (FOC_Atomic_CompareExchange(&rb->Tail, tail, tail + n)) {
+            return n;
+        }
+    }
+}
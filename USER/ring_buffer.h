@@ -0,0 +1,89 @@
+/**
+ * @file    ring_buffer.h
+ * @brief   单生产者/单消费者 (SPSC) 无锁字节环形缓冲区
+ * @note    纯算法实现，无硬件依赖，可移植
+ *          - 生产者: 主循环 (整帧写入, 空间不足时按策略丢弃)
+ *          - 消费者: 通信完成中断 (按需取出任意长度)
+ *          读写指针为自由运行的 32 位计数, 容量须为 2 的幂
+ */
+
+#ifndef __RING_BUFFER_H
+#define __RING_BUFFER_H
+
+#include <stdint.h>
+
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/* 空间不足时的处理策略 */
+typedef enum {
+    RING_DROP_NEWEST = 0,       // 丢弃新写入的帧 (已入队数据保持完整)
+    RING_DROP_OLDEST,           // 丢弃最旧的数据腾出空间 (保留最新数据, 可能截断旧帧)
+} RingBuffer_Policy_t;
+
+/**
+ * @brief 环形缓冲区
+ */
+typedef struct {
+    uint8_t *Buf;               // 存储区
+    uint32_t Size;              // 容量 (2 的幂)
+    volatile uint32_t Head;     // 写指针 (生产者)
+    volatile uint32_t Tail;     // 读指针 (消费者; DROP_OLDEST 时生产者也会推进)
+    RingBuffer_Policy_t Policy; // 空间不足处理策略
+
+    /* 统计 (生产者更新) */
+    uint32_t WrittenBytes;      // 已写入字节数
+    uint32_t DroppedFrames;     // 被丢弃的新帧数 (DROP_NEWEST / 超过容量)
+    uint32_t DroppedBytes;      // 被丢弃的字节数 (新帧或被覆盖的旧数据)
+    uint32_t HighWater;         // 最高水位 (字节)
+} RingBuffer_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化环形缓冲区
+ * @param  rb: 缓冲区指针
+ * @param  buf: 存储区
+ * @param  size: 容量 (字节, 2 的幂)
+ * @param  policy: 空间不足处理策略
+ */
+void RingBuffer_Init(RingBuffer_t *rb, uint8_t *buf, uint32_t size, RingBuffer_Policy_t policy);
+
+/**
+ * @brief  写入一帧 (生产者)
+ * @param  rb: 缓冲区指针
+ * @param  data: 数据
+ * @param  len: 长度
+ * @return 写入的字节数 (len 或 0, 不会只写入一部分)
+ */
+uint32_t RingBuffer_Write(RingBuffer_t *rb, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief  取出数据 (消费者)
+ * @param  rb: 缓冲区指针
+ * @param  dst: 目标缓冲
+ * @param  max: 最多取出的字节数
+ * @return 实际取出的字节数
+ */
+uint32_t RingBuffer_Read(RingBuffer_t *rb, uint8_t *dst, uint32_t max);
+
+/**
+ * @brief  当前数据量 (字节)
+ */
+static inline uint32_t RingBuffer_Level(const RingBuffer_t *rb)
+{
+    return rb->Head - rb->Tail;
+}
+
+/**
+ * @brief  当前剩余空间 (字节)
+ */
+static inline uint32_t RingBuffer_Free(const RingBuffer_t *rb)
+{
+    return rb->Size - (rb->Head - rb->Tail);
+}
+
+#endif /* __RING_BUFFER_H */
@@ -1,30 +1,60 @@
 /**
  * @file    svpwm.c
- * @brief   ???? PWM ??????
- * @note    ???????????????
+ * @brief   空间矢量 PWM 调制模块
+ * @note    纯算法实现，无硬件依赖，可移植
  */
 
 #include "svpwm.h"
+#include "foc_math.h"
+#include <math.h>
 
 /*============================================================================*/
-/*                               ????                                      */
+/*                              常量定义                                       */
 /*============================================================================*/
 
 #define SQRT3           1.73205080757f
 #define SQRT3_BY_2      0.86602540378f
+#define PI_BY_3         1.04719755120f
+#define PI_BY_6         0.52359877560f
+#define TWO_BY_PI       0.63661977237f      // 六步方波基波幅值 / Udc
+#define TWO_BY_3        0.66666666667f      // 六边形顶点半径 / Udc
+
+/* 过调制查表点数 (调制比等间距) */
+#define OVM_TABLE_SIZE  33
+
+/* 区I: 调制比 [M_LINEAR, M_ZONE2] → 参考圆半径 / Udc
+ * 轨迹 = min(半径, 六边形), 离线数值积分基波后反解 (两表均由 Tools/ovm/ovm_tables.py 生成) */
+static const float ovm_zone1_radius[OVM_TABLE_SIZE] = {
+    0.577350f, 0.578306f, 0.579331f, 0.580408f, 0.581534f, 0.582706f,
+    0.583925f, 0.585191f, 0.586504f, 0.587867f, 0.589281f, 0.590748f,
+    0.592272f, 0.593856f, 0.595503f, 0.597218f, 0.599006f, 0.600874f,
+    0.602828f, 0.604878f, 0.607034f, 0.609309f, 0.611718f, 0.614282f,
+    0.617027f, 0.619985f, 0.623205f, 0.626754f, 0.630736f, 0.635325f,
+    0.640862f, 0.648226f, 0.666667f
+};
+
+/* 区II: 调制比 [M_ZONE2, 1] → 顶点保持角 (rad), π/6 即六步 */
+static const float ovm_zone2_hold[OVM_TABLE_SIZE] = {
+    0.000000f, 0.008362f, 0.016854f, 0.025483f, 0.034256f, 0.043181f,
+    0.052267f, 0.061523f, 0.070960f, 0.080589f, 0.090423f, 0.100476f,
+    0.110765f, 0.121308f, 0.132124f, 0.143238f, 0.154677f, 0.166470f,
+    0.178656f, 0.191277f, 0.204385f, 0.218042f, 0.232326f, 0.247334f,
+    0.263191f, 0.280063f, 0.298178f, 0.317864f, 0.339624f, 0.364307f,
+    0.393566f, 0.431672f, 0.523599f
+};
 
 /*============================================================================*/
-/*                    ?????????? (????)                            */
+/*                    兼容旧代码的全局变量 (逐步废弃)                            */
 /*============================================================================*/
 
 SVPWM_t svpwm1_t = {0};
 
 /*============================================================================*/
-/*                               ????                                      */
+/*                              函数实现                                       */
 /*============================================================================*/
 
 /**
- * @brief  SVPWM ???
+ * @brief  SVPWM 初始化
  */
 void SVPWM_Init(SVPWM_t *svpwm, float udc, uint32_t ts)
 {
@@ -32,6 +62,13 @@ void SVPWM_Init(SVPWM_t *svpwm, float udc, uint32_t ts)
     svpwm->Ts = ts;
     svpwm->Alpha = 0.0f;
     svpwm->Beta = 0.0f;
+    svpwm->Mode = SVPWM_MODE_SECTOR;
+    svpwm->AutoDpwm = SVPWM_MODE_DPWM1;
+    svpwm->ActiveMode = SVPWM_MODE_SECTOR;
+    svpwm->Ovm = SVPWM_OVM_MIN_PHASE;
+    svpwm->MaxModIndex = 1.0f;
+    svpwm->ModIndex = 0.0f;
+    svpwm->SixStep = 0;
     svpwm->Sector = 0;
     svpwm->CCR1 = ts / 2;
     svpwm->CCR2 = ts / 2;
@@ -39,20 +76,18 @@ void SVPWM_Init(SVPWM_t *svpwm, float udc, uint32_t ts)
 }
 
 /**
- * @brief  SVPWM ????
- * @note   ????? SVPWM?????
+ * @brief  SVPWM 调制计算
+ * @note   标准七段式 SVPWM，中心对齐
  *         
- *         ????: A = V?, B = ?3/2V? - 1/2V?, C = -?3/2V? - 1/2V?
+ *         扇区判断: A = Vβ, B = √3/2·Vα - 1/2·Vβ, C = -√3/2·Vα - 1/2·Vβ
  *         sector = (A>0) + 2*(B>0) + 4*(C>0)
  */
-void SVPWM_Calc(SVPWM_t *svpwm)
+static void SVPWM_SectorCore(SVPWM_t *svpwm, float alpha, float beta)
 {
-    float alpha = svpwm->Alpha;
-    float beta = svpwm->Beta;
     float ts = (float)svpwm->Ts;
     float udc = svpwm->Udc;
     
-    /*--- 1. ???? ---*/
+    /*--- 1. 扇区判断 ---*/
     float A = beta;
     float B = SQRT3_BY_2 * alpha - 0.5f * beta;
     float C = -SQRT3_BY_2 * alpha - 0.5f * beta;
@@ -63,7 +98,7 @@ void SVPWM_Calc(SVPWM_t *svpwm)
     if (C > 0.0f) sector += 4;
     svpwm->Sector = sector;
     
-    /*--- 2. ?????????? ---*/
+    /*--- 2. 计算基本矢量作用时间 ---*/
     float temp = (SQRT3 * ts) / udc;
     float X = temp * beta;
     float Y = temp * (SQRT3_BY_2 * alpha + 0.5f * beta);
@@ -90,19 +125,19 @@ void SVPWM_Calc(SVPWM_t *svpwm)
     svpwm->T1 = t1;
     svpwm->T2 = t2;
     
-    /*--- 3. ????? ---*/
+    /*--- 3. 过调制处理 ---*/
     if ((t1 + t2) > ts) {
         float ratio = ts / (t1 + t2);
         t1 *= ratio;
         t2 *= ratio;
     }
     
-    /*--- 4. ???????? ---*/
+    /*--- 4. 计算三相切换时间 ---*/
     float Ta = (ts + t1 + t2) * 0.5f;
     float Tb = (ts - t1 + t2) * 0.5f;
     float Tc = (ts - t1 - t2) * 0.5f;
     
-    /*--- 5. ?????? CCR ---*/
+    /*--- 5. 按扇区分配到 CCR ---*/
     switch (sector) {
         case 3:  /* Sector 1: U > V > W */
             svpwm->CCR1 = (uint32_t)Ta;
@@ -141,3 +176,304 @@ void SVPWM_Calc(SVPWM_t *svpwm)
             break;
     }
 }
+
+/**
+ * @brief  三相中绝对值最大的一相: 正值钳位到正母线, 负值钳位到负母线
+ * @param  v: 三相电压
+ * @param  phase: 输出钳位相 (0~2)
+ * @return +1=正母线, -1=负母线
+ */
+static int8_t Dpwm_PeakPhase(const float *v, uint8_t *phase)
+{
+    uint8_t imax = 0, imin = 0;
+    
+    for (uint8_t i = 1; i < 3; i++) {
+        if (v[i] > v[imax]) imax = i;
+        if (v[i] < v[imin]) imin = i;
+    }
+    
+    if (v[imax] + v[imin] >= 0.0f) {
+        *phase = imax;
+        return 1;
+    }
+    *phase = imin;
+    return -1;
+}
+
+/**
+ * @brief  断续调制: 选择钳位相与钳位母线
+ * @note   DPWM0/DPWM2 按参考矢量旋转 ±30° 后的相电压选相, 钳位区间相对
+ *         DPWM1 超前/滞后 30°; 被选中的相在线性区内必为实际最大/最小相
+ */
+static int8_t Dpwm_Select(SVPWM_Mode_t mode, float alpha, float beta,
+                          const float *v, uint8_t *phase)
+{
+    float vr[3];
+    float ar, br;
+    
+    switch (mode) {
+        case SVPWM_MODE_DPWMMAX:
+            *phase = (v[0] >= v[1]) ? ((v[0] >= v[2]) ? 0 : 2) : ((v[1] >= v[2]) ? 1 : 2);
+            return 1;
+            
+        case SVPWM_MODE_DPWMMIN:
+            *phase = (v[0] <= v[1]) ? ((v[0] <= v[2]) ? 0 : 2) : ((v[1] <= v[2]) ? 1 : 2);
+            return -1;
+            
+        case SVPWM_MODE_DPWM0:      /* 参考矢量 +30° */
+            ar = SQRT3_BY_2 * alpha - 0.5f * beta;
+            br = 0.5f * alpha + SQRT3_BY_2 * beta;
+            break;
+            
+        case SVPWM_MODE_DPWM2:      /* 参考矢量 -30° */
+            ar = SQRT3_BY_2 * alpha + 0.5f * beta;
+            br = -0.5f * alpha + SQRT3_BY_2 * beta;
+            break;
+            
+        default:                    /* DPWM1 */
+            return Dpwm_PeakPhase(v, phase);
+    }
+    
+    vr[0] = ar;
+    vr[1] = -0.5f * ar + SQRT3_BY_2 * br;
+    vr[2] = -0.5f * ar - SQRT3_BY_2 * br;
+    return Dpwm_PeakPhase(vr, phase);
+}
+
+/**
+ * @brief  浮点计数 → CCR (限幅到 [0, Ts])
+ */
+static inline uint32_t Dpwm_ToCCR(float t, float ts)
+{
+    if (t <= 0.0f) return 0;
+    if (t >= ts) return (uint32_t)ts;
+    return (uint32_t)t;
+}
+
+/**
+ * @brief  最大/最小值零序注入调制 (内部实现)
+ * @note   与扇区法等价的连续调制 (以扇区1为例):
+ *         Ta = (Ts + T1 + T2) / 2 = Ts/2 + (Va - (Vmax + Vmin)/2) * Ts/Udc
+ *         三相统一为 CCRx = Ts/2 + (Vx - Vmid) * Ts/Udc, 无扇区分支;
+ *         最值与过调制缩放均为条件选择, 编译为 IT 块而非跳转
+ *
+ *         断续调制只改变零序分量: 选中相平移到母线 (CCR = 0 或 Ts),
+ *         其余两相随之平移, 线电压不变
+ */
+static void SVPWM_MinMaxCore(SVPWM_t *svpwm, float alpha, float beta, SVPWM_Mode_t mode)
+{
+    float ts = (float)svpwm->Ts;
+    float udc = svpwm->Udc;
+    
+    /*--- 1. 逆 Clarke: Vαβ → Vabc ---*/
+    float va = alpha;
+    float vb = -0.5f * alpha + SQRT3_BY_2 * beta;
+    float vc = -0.5f * alpha - SQRT3_BY_2 * beta;
+    
+    /*--- 2. 扇区 (仅供观测, 与扇区法编号一致) ---*/
+    float B = SQRT3_BY_2 * alpha - 0.5f * beta;
+    float C = -SQRT3_BY_2 * alpha - 0.5f * beta;
+    svpwm->Sector = (uint8_t)((beta > 0.0f) + ((B > 0.0f) << 1) + ((C > 0.0f) << 2));
+    
+    /*--- 3. 最大/最小值 ---*/
+    float vmax = (va > vb) ? va : vb;
+    float vmin = (va > vb) ? vb : va;
+    vmax = (vc > vmax) ? vc : vmax;
+    vmin = (vc < vmin) ? vc : vmin;
+    
+    /*--- 4. 零序注入 + 过调制缩放 (线电压峰峰值超过 Udc 时) ---*/
+    float span = vmax - vmin;
+    float k = ts / ((span > udc) ? span : udc);
+    float mid = 0.5f * (vmax + vmin);
+    float half = 0.5f * ts;
+    
+    /*--- 5. CCR ---*/
+    if (mode == SVPWM_MODE_MINMAX) {
+        svpwm->CCR1 = (uint32_t)(half + (va - mid) * k);
+        svpwm->CCR2 = (uint32_t)(half + (vb - mid) * k);
+        svpwm->CCR3 = (uint32_t)(half + (vc - mid) * k);
+        return;
+    }
+    
+    /*--- 6. 断续调制: 钳位相对齐到母线 ---*/
+    float v[3] = { va, vb, vc };
+    uint8_t p;
+    int8_t rail = Dpwm_Select(mode, alpha, beta, v, &p);
+    float base = (rail > 0) ? ts : 0.0f;
+    float t[3];
+    
+    for (uint8_t i = 0; i < 3; i++) {
+        t[i] = base + (v[i] - v[p]) * k;
+    }
+    t[p] = base;
+    
+    svpwm->CCR1 = Dpwm_ToCCR(t[0], ts);
+    svpwm->CCR2 = Dpwm_ToCCR(t[1], ts);
+    svpwm->CCR3 = Dpwm_ToCCR(t[2], ts);
+}
+
+/**
+ * @brief  SVPWM 调制计算: 扇区判断 + 矢量作用时间
+ */
+void SVPWM_CalcSector(SVPWM_t *svpwm)
+{
+    SVPWM_SectorCore(svpwm, svpwm->Alpha, svpwm->Beta);
+}
+
+/**
+ * @brief  SVPWM 调制计算: 最大/最小值零序注入
+ */
+void SVPWM_CalcMinMax(SVPWM_t *svpwm)
+{
+    SVPWM_MinMaxCore(svpwm, svpwm->Alpha, svpwm->Beta, SVPWM_MODE_MINMAX);
+}
+
+/*============================================================================*/
+/*                              过调制                                         */
+/*============================================================================*/
+
+/**
+ * @brief  过调制查表 (线性插值)
+ */
+static float Ovm_Lookup(const float *table, float m, float m_lo, float m_hi)
+{
+    float pos = (m - m_lo) * ((float)(OVM_TABLE_SIZE - 1) / (m_hi - m_lo));
+    
+    if (pos <= 0.0f) return table[0];
+    if (pos >= (float)(OVM_TABLE_SIZE - 1)) return table[OVM_TABLE_SIZE - 1];
+    
+    uint32_t i = (uint32_t)pos;
+    float frac = pos - (float)i;
+    return table[i] + frac * (table[i + 1] - table[i]);
+}
+
+/* 六边形顶点方向 (cos, sin)(kπ/3), k = 0 ~ 5 */
+static const float ovm_vertex[6][2] = {
+    {  1.0f,  0.0f        }, {  0.5f,  SQRT3_BY_2 }, { -0.5f,  SQRT3_BY_2 },
+    { -1.0f,  0.0f        }, { -0.5f, -SQRT3_BY_2 }, {  0.5f, -SQRT3_BY_2 }
+};
+
+/**
+ * @brief  反正切奇次多项式, |t| ≤ 1/√3 (最大误差约 1.6e-6 rad)
+ */
+static inline float Ovm_Atan(float t)
+{
+    float t2 = t * t;
+    return t * (0.99997455f + t2 * (-0.33225587f + t2 * (0.18742909f + t2 * -0.08508044f)));
+}
+
+/**
+ * @brief  顶点保持: 扇区内距顶点 hold 以内的角度吸附到顶点, 其余角度线性拉伸
+ * @note   输出放在顶点半径上, 沿六边形边的部分由调制器的等比缩放落到边界;
+ *         hold = π/6 时退化为六步方波.
+ *         扇区由 α/β 符号与 |β| 对 √3|α| 的比较得到, 扇区内角由扇区中线上的
+ *         比值多项式求得, 输出方向查 FOC_SinCos 表后按顶点方向旋转, 不调用库三角函数
+ */
+static void Ovm_HoldAngle(float *alpha, float *beta, float hold, float udc)
+{
+    /* 扇区 k: [kπ/3, (k+1)π/3), β < 0 时关于 α 轴镜像 */
+    uint32_t k = (fabsf(*beta) >= SQRT3 * fabsf(*alpha)) ? 1u : ((*alpha >= 0.0f) ? 0u : 2u);
+    if (*beta < 0.0f) k = 5u - k;
+    
+    /* 扇区局部坐标 (顶点方向为 x 轴), 再转到扇区中线: |ym / xm| ≤ 1/√3 */
+    float c = ovm_vertex[k][0];
+    float s = ovm_vertex[k][1];
+    float x = *alpha * c + *beta * s;
+    float y = *beta * c - *alpha * s;
+    float xm = x * SQRT3_BY_2 + y * 0.5f;
+    float ym = y * SQRT3_BY_2 - x * 0.5f;
+    float gamma = PI_BY_6 + Ovm_Atan(ym / xm);
+    
+    if (gamma <= hold) {
+        gamma = 0.0f;
+    } else if (gamma >= PI_BY_3 - hold) {
+        gamma = PI_BY_3;
+    } else {
+        gamma = (gamma - hold) * PI_BY_3 / (PI_BY_3 - 2.0f * hold);
+    }
+    
+    SinCos_t sc;
+    FOC_SinCos(gamma, &sc);
+    *alpha = TWO_BY_3 * udc * (sc.Cos * c - sc.Sin * s);
+    *beta = TWO_BY_3 * udc * (sc.Sin * c + sc.Cos * s);
+}
+
+/**
+ * @brief  过调制处理: 计算调制比并按策略修正参考电压
+ * @note   线性区 (m ≤ M_LINEAR) 所有策略均不修改参考电压
+ */
+static void SVPWM_Overmodulate(SVPWM_t *svpwm, float *alpha, float *beta)
+{
+    float udc = svpwm->Udc;
+    float mag = sqrtf(*alpha * *alpha + *beta * *beta);
+    float m = mag / (TWO_BY_PI * udc);
+    
+    /* 调制比上限 */
+    if (svpwm->MaxModIndex > 0.0f && m > svpwm->MaxModIndex) {
+        float k = svpwm->MaxModIndex / m;
+        *alpha *= k;
+        *beta *= k;
+        mag *= k;
+        m = svpwm->MaxModIndex;
+    }
+    svpwm->ModIndex = m;
+    
+    switch (svpwm->Ovm) {
+        case SVPWM_OVM_TWO_ZONE:
+            if (m <= SVPWM_M_LINEAR) break;
+            if (m < SVPWM_M_ZONE2) {
+                /* 区I: 放大参考圆, 超出六边形部分由调制器缩放到边界 */
+                float r = Ovm_Lookup(ovm_zone1_radius, m, SVPWM_M_LINEAR, SVPWM_M_ZONE2) * udc;
+                float k = r / mag;
+                *alpha *= k;
+                *beta *= k;
+            } else {
+                /* 区II: 顶点保持 */
+                float hold = Ovm_Lookup(ovm_zone2_hold, m, SVPWM_M_ZONE2, 1.0f);
+                Ovm_HoldAngle(alpha, beta, hold, udc);
+            }
+            break;
+            
+        case SVPWM_OVM_SIX_STEP:
+            if (svpwm->SixStep) {
+                if (m < SVPWM_SIX_STEP_EXIT) svpwm->SixStep = 0;
+            } else if (m >= SVPWM_SIX_STEP_ENTER) {
+                svpwm->SixStep = 1;
+            }
+            if (svpwm->SixStep) {
+                Ovm_HoldAngle(alpha, beta, 0.5f * PI_BY_3, udc);
+            }
+            break;
+            
+        default:    /* SVPWM_OVM_MIN_PHASE: 由调制器沿原方向缩放 */
+            break;
+    }
+}
+
+/**
+ * @brief  SVPWM 调制计算 (过调制处理后按 Mode 选择算法)
+ */
+void SVPWM_Calc(SVPWM_t *svpwm)
+{
+    float alpha = svpwm->Alpha;
+    float beta = svpwm->Beta;
+    
+    SVPWM_Overmodulate(svpwm, &alpha, &beta);
+    
+    /* AUTO: 按调制比在连续/断续调制间切换 (回差防抖) */
+    SVPWM_Mode_t mode = svpwm->Mode;
+    if (mode == SVPWM_MODE_AUTO) {
+        if (svpwm->ActiveMode == svpwm->AutoDpwm) {
+            mode = (svpwm->ModIndex < SVPWM_DPWM_EXIT) ? SVPWM_MODE_MINMAX : svpwm->AutoDpwm;
+        } else {
+            mode = (svpwm->ModIndex >= SVPWM_DPWM_ENTER) ? svpwm->AutoDpwm : SVPWM_MODE_MINMAX;
+        }
+    }
+    svpwm->ActiveMode = mode;
+    
+    if (mode == SVPWM_MODE_SECTOR) {
+        SVPWM_SectorCore(svpwm, alpha, beta);
+    } else {
+        SVPWM_MinMaxCore(svpwm, alpha, beta, mode);
+    }
+}
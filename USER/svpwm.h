@@ -13,6 +13,35 @@
 /*                              数据结构                                       */
 /*============================================================================*/
 
+/* 调制算法 (DPWM 系列每相每电周期钳位 120°, 开关次数减少 1/3) */
+typedef enum {
+    SVPWM_MODE_SECTOR = 0,      // 扇区判断 + 矢量作用时间 (默认)
+    SVPWM_MODE_MINMAX,          // 逆 Clarke + 最大/最小值零序注入 (无扇区分支)
+    SVPWM_MODE_DPWM0,           // 断续调制: 钳位区间超前相电压峰值 30°
+    SVPWM_MODE_DPWM1,           // 断续调制: 钳位区间以相电压峰值为中心
+    SVPWM_MODE_DPWM2,           // 断续调制: 钳位区间滞后 30° (电动状态电流滞后时损耗最小)
+    SVPWM_MODE_DPWMMIN,         // 断续调制: 最小相钳位到负母线
+    SVPWM_MODE_DPWMMAX,         // 断续调制: 最大相钳位到正母线
+    SVPWM_MODE_AUTO,            // 低调制比 MINMAX, 高调制比切换到 AutoDpwm (带回差)
+} SVPWM_Mode_t;
+
+/* AUTO 模式切换点 (调制比) */
+#define SVPWM_DPWM_ENTER        0.62f       // 切换到断续调制
+#define SVPWM_DPWM_EXIT         0.55f       // 切回连续调制
+
+/* 过调制策略 (调制比 m = |V| / (2Udc/π), 六步方波 m = 1) */
+typedef enum {
+    SVPWM_OVM_MIN_PHASE = 0,    // 最小相位误差: 沿原方向缩放到六边形边界 (默认)
+    SVPWM_OVM_TWO_ZONE,         // Bolognani 两区: 区I 放大幅值, 区II 顶点保持, 基波连续到六步
+    SVPWM_OVM_SIX_STEP,         // 调制比超过阈值后直接切换到六步方波 (带回差)
+} SVPWM_Ovm_t;
+
+/* 调制比分界点 */
+#define SVPWM_M_LINEAR          0.9068997f  // 线性区上限 π/(2√3)
+#define SVPWM_M_ZONE2           0.9514261f  // 区I/区II 分界 (轨迹恰为六边形)
+#define SVPWM_SIX_STEP_ENTER    0.97f       // 进入六步的调制比
+#define SVPWM_SIX_STEP_EXIT     0.94f       // 退出六步的调制比
+
 /**
  * @brief SVPWM 调制结构体
  */
@@ -24,14 +53,21 @@ typedef struct {
     /* 输入: 系统参数 */
     float Udc;              // 直流母线电压 (V)
     uint32_t Ts;            // PWM 周期 (ARR 值)
+    SVPWM_Mode_t Mode;      // 调制算法
+    SVPWM_Mode_t AutoDpwm;  // AUTO 模式下高调制比使用的断续调制
+    SVPWM_Ovm_t Ovm;        // 过调制策略
+    float MaxModIndex;      // 调制比上限 (0~1, 0 表示不限制)
     
     /* 输出: 扇区和 CCR 值 */
     uint8_t Sector;         // 当前扇区 (1~6)
+    uint8_t SixStep;        // 六步状态 (SVPWM_OVM_SIX_STEP)
+    float ModIndex;         // 调制比 (限幅后的请求值)
+    SVPWM_Mode_t ActiveMode;    // 本周期实际使用的调制算法
     uint32_t CCR1;          // U相 CCR
     uint32_t CCR2;          // V相 CCR
     uint32_t CCR3;          // W相 CCR
     
-    /* 内部: 矢量作用时间 */
+    /* 内部: 矢量作用时间 (仅 SVPWM_MODE_SECTOR 更新) */
     float T1;               // 矢量1作用时间
     float T2;               // 矢量2作用时间
 } SVPWM_t;
@@ -41,13 +77,27 @@ typedef struct {
 /*============================================================================*/
 
 /**
- * @brief  SVPWM 调制计算
+ * @brief  SVPWM 调制计算 (过调制处理后按 Mode 选择算法)
  * @param  svpwm: SVPWM 结构体指针
- * @note   输入: Alpha, Beta, Udc, Ts
- *         输出: Sector, CCR1, CCR2, CCR3
+ * @note   输入: Alpha, Beta, Udc, Ts, Mode, Ovm, MaxModIndex
+ *         输出: Sector, CCR1, CCR2, CCR3, ModIndex
  */
 void SVPWM_Calc(SVPWM_t *svpwm);
 
+/**
+ * @brief  SVPWM 调制计算: 扇区判断 + 矢量作用时间
+ * @param  svpwm: SVPWM 结构体指针
+ */
+void SVPWM_CalcSector(SVPWM_t *svpwm);
+
+/**
+ * @brief  SVPWM 调制计算: 最大/最小值零序注入 (连续调制)
+ * @param  svpwm: SVPWM 结构体指针
+ * @note   线性区内占空比与 SVPWM_CalcSector 相同 (仅浮点舍入差异, ≤1 计数),
+ *         过调制时同样按六边形等比缩放; 不更新 T1/T2
+ */
+void SVPWM_CalcMinMax(SVPWM_t *svpwm);
+
 /**
  * @brief  SVPWM 初始化
  * @param  svpwm: SVPWM 结构体指针
@@ -1,34 +1,205 @@
+/**
+ * @file    usb_vcp.c
+ * @brief   USB 虚拟串口 (CDC) 非阻塞收发实现
+ */
+
 #include "usb_vcp.h"
 #include "usb_device.h"
+#include "foc_atomic.h"
 #include <stdarg.h>
+#include <stdio.h>
 #include <string.h>
 
 extern USBD_HandleTypeDef hUsbDeviceFS;
 
-static uint8_t tx_buffer[256];
+/*============================================================================*/
+/*                              私有变量                                       */
+/*============================================================================*/
 
-void VCP_Init(void) {
-    
-}
+static uint8_t tx_ring_buf[VCP_TX_RING_SIZE];
+static uint8_t tx_xfer_buf[VCP_TX_XFER_SIZE];   // 正在发送的数据 (传输完成前不可改写)
+static uint8_t tx_fmt_buf[256];                 // VCP_Printf 格式化缓冲
+static RingBuffer_t tx_ring;
+
+static volatile uint8_t tx_busy = 0;            // 1=端点传输中, 完成中断负责续传
+static volatile uint32_t tx_sent_bytes = 0;     // 主循环与完成中断都会启动传输, 原子累加
+static volatile uint32_t tx_transfers = 0;
+
+static uint8_t *rx_buf;                         // 待处理的接收数据 (指向 UserRxBufferFS)
+static volatile uint32_t rx_len = 0;            // 待处理字节数, 非 0 时 OUT 端点保持 NAK
+
+/*============================================================================*/
+/*                              内部函数                                       */
+/*============================================================================*/
 
-void VCP_SendData(uint8_t* data, uint16_t length) {
-    while(hUsbDeviceFS.dev_state != USBD_STATE_CONFIGURED) {
-        HAL_Delay(1);
+/**
+ * @brief  从队列取数据启动一次 IN 传输 (消费者)
+ * @note   传输进行期间入队的帧在下一次传输中合并发送, 短包只出现在队列排空时
+ */
+static void VCP_StartTransfer(void)
+{
+    uint32_t level = RingBuffer_Level(&tx_ring);
+    uint32_t len;
+
+    if (level == 0 || hUsbDeviceFS.dev_state != USBD_STATE_CONFIGURED) {
+        tx_busy = 0;
+        return;
     }
-    
-    while(CDC_Transmit_FS(data, length) != USBD_OK) {
-        HAL_Delay(1);
+
+    /* VCP_TX_XFER_SIZE 为包长整数倍: 积压时每次传输均为满包 */
+    len = (level < VCP_TX_XFER_SIZE) ? level : VCP_TX_XFER_SIZE;
+
+    len = RingBuffer_Read(&tx_ring, tx_xfer_buf, len);
+    if (len == 0) {
+        tx_busy = 0;
+        return;
+    }
+
+    USBD_CDC_SetTxBuffer(&hUsbDeviceFS, tx_xfer_buf, (uint16_t)len);
+    if (USBD_CDC_TransmitPacket(&hUsbDeviceFS) != USBD_OK) {
+        tx_busy = 0;
+        return;
     }
+
+    FOC_Atomic_Add(&tx_sent_bytes, len);
+    FOC_Atomic_Inc(&tx_transfers);
 }
 
-void VCP_Printf(const char* format, ...) {
+/*============================================================================*/
+/*                              函数实现                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化发送队列
+ */
+void VCP_Init(void)
+{
+    RingBuffer_Init(&tx_ring, tx_ring_buf, VCP_TX_RING_SIZE, VCP_TX_POLICY);
+    tx_busy = 0;
+    tx_sent_bytes = 0;
+    tx_transfers = 0;
+}
+
+/**
+ * @brief  发送数据 (非阻塞)
+ * @note   先入队再检查发送中标志: 完成中断若在入队前判定队列为空并清除标志,
+ *         这里会看到空闲并重新启动传输; 若在入队后运行, 则由它发出本帧
+ */
+uint16_t VCP_SendData(const uint8_t *data, uint16_t length)
+{
+    uint16_t n = (uint16_t)RingBuffer_Write(&tx_ring, data, length);
+
+    if (!tx_busy) {
+        tx_busy = 1;
+        VCP_StartTransfer();
+    }
+    return n;
+}
+
+/**
+ * @brief  格式化输出
+ */
+void VCP_Printf(const char *format, ...)
+{
     va_list args;
     va_start(args, format);
-    uint16_t len = vsnprintf((char*)tx_buffer, sizeof(tx_buffer), format, args);
+    int len = vsnprintf((char *)tx_fmt_buf, sizeof(tx_fmt_buf), format, args);
     va_end(args);
-    VCP_SendData(tx_buffer, len);
+
+    if (len <= 0) return;
+    if (len >= (int)sizeof(tx_fmt_buf)) len = sizeof(tx_fmt_buf) - 1;     // 截断
+    VCP_SendData(tx_fmt_buf, (uint16_t)len);
 }
 
-uint8_t VCP_IsConnected(void) {
+/**
+ * @brief  查询 USB 是否已枚举
+ */
+uint8_t VCP_IsConnected(void)
+{
     return (hUsbDeviceFS.dev_state == USBD_STATE_CONFIGURED);
 }
+
+/**
+ * @brief  查询发送队列剩余空间
+ */
+uint32_t VCP_TxFree(void)
+{
+    return RingBuffer_Free(&tx_ring);
+}
+
+/**
+ * @brief  设置队列满时的丢弃策略
+ */
+void VCP_SetTxPolicy(RingBuffer_Policy_t policy)
+{
+    tx_ring.Policy = policy;
+}
+
+/**
+ * @brief  读取发送统计
+ */
+void VCP_GetTxStats(VCP_TxStats_t *stats)
+{
+    stats->QueuedBytes = tx_ring.WrittenBytes;
+    stats->SentBytes = tx_sent_bytes;
+    stats->Transfers = tx_transfers;
+    stats->DroppedFrames = tx_ring.DroppedFrames;
+    stats->DroppedBytes = tx_ring.DroppedBytes;
+    stats->HighWater = tx_ring.HighWater;
+}
+
+/**
+ * @brief  IN 端点发送完成回调
+ */
+void VCP_TxCpltCallback(void)
+{
+    VCP_StartTransfer();
+}
+
+/**
+ * @brief  OUT 端点接收回调
+ */
+void VCP_RxCallback(uint8_t *buf, uint32_t len)
+{
+    if (len == 0) {
+        /* 零长度包无需处理, 直接继续接收 */
+        USBD_CDC_SetRxBuffer(&hUsbDeviceFS, buf);
+        USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+        return;
+    }
+    rx_buf = buf;
+    rx_len = len;
+}
+
+/**
+ * @brief  取得待处理的接收数据
+ */
+uint32_t VCP_RxPeek(const uint8_t **buf)
+{
+    uint32_t len = rx_len;
+
+    if (len != 0) *buf = rx_buf;
+    return len;
+}
+
+/**
+ * @brief  释放接收缓冲并重新使能 OUT 端点
+ */
+void VCP_RxRelease(void)
+{
+    if (rx_len == 0) return;
+
+    rx_len = 0;
+    USBD_CDC_SetRxBuffer(&hUsbDeviceFS, rx_buf);
+    USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+}
+
+/**
+ * @brief  USB 配置完成/断开回调
+ * @note   配置完成时协议栈已自行使能 OUT 端点, 丢弃复位前的待处理数据
+ */
+void VCP_Reset(void)
+{
+    tx_busy = 0;
+    rx_len = 0;
+}
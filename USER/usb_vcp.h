@@ -1,12 +1,119 @@
+/**
+ * @file    usb_vcp.h
+ * @brief   USB 虚拟串口 (CDC) 收发接口
+ * @note    发送经 SPSC 环形缓冲区排队, 由 IN 端点发送完成中断续传, 调用方从不阻塞
+ *          - 生产者: 主循环 (VCP_SendData / VCP_Printf)
+ *          - 消费者: CDC_TransmitCplt_FS (端点空闲时由生产者启动首次传输)
+ *          接收不拷贝: CDC_Receive_FS 只登记数据包, 主循环直接读取 UserRxBufferFS,
+ *          处理完后才重新使能 OUT 端点 (其间主机收到 NAK, 自然形成流控)
+ */
+
 #ifndef __USB_VCP_H
 #define __USB_VCP_H
 
 #include "main.h"
 #include "usbd_cdc_if.h"
+#include "ring_buffer.h"
+
+/*============================================================================*/
+/*                              配置参数                                       */
+/*============================================================================*/
+
+#define VCP_TX_RING_SIZE        4096        // 发送队列容量 (2 的幂)
+#define VCP_TX_XFER_SIZE        1024        // 单次传输最大长度 (须为 64 字节包长的整数倍)
+
+#ifndef VCP_TX_POLICY
+#define VCP_TX_POLICY           RING_DROP_NEWEST    // 队列满时的丢弃策略
+#endif
 
+/*============================================================================*/
+/*                              数据结构                                       */
+/*============================================================================*/
+
+/**
+ * @brief 发送统计
+ */
+typedef struct {
+    uint32_t QueuedBytes;       // 已入队字节数
+    uint32_t SentBytes;         // 已提交端点的字节数
+    uint32_t Transfers;         // 传输次数
+    uint32_t DroppedFrames;     // 被丢弃的帧数 (队列满, 新帧)
+    uint32_t DroppedBytes;      // 被丢弃的字节数 (新帧或被覆盖的旧数据)
+    uint32_t HighWater;         // 队列最高水位 (字节)
+} VCP_TxStats_t;
+
+/*============================================================================*/
+/*                              函数接口                                       */
+/*============================================================================*/
+
+/**
+ * @brief  初始化发送队列
+ */
 void VCP_Init(void);
-void VCP_SendData(uint8_t* data, uint16_t length);
-void VCP_Printf(const char* format, ...);
+
+/**
+ * @brief  发送数据 (非阻塞, 整帧入队)
+ * @param  data: 数据
+ * @param  length: 长度
+ * @return 入队字节数 (length 或 0=被丢弃)
+ */
+uint16_t VCP_SendData(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief  格式化输出 (非阻塞)
+ */
+void VCP_Printf(const char *format, ...);
+
+/**
+ * @brief  查询 USB 是否已枚举
+ * @return 1=已连接, 0=未连接
+ */
 uint8_t VCP_IsConnected(void);
 
-#endif
+/**
+ * @brief  查询发送队列剩余空间
+ * @return 可再入队的字节数 (大于等于帧长时整帧入队不会被丢弃)
+ */
+uint32_t VCP_TxFree(void);
+
+/**
+ * @brief  设置队列满时的丢弃策略
+ */
+void VCP_SetTxPolicy(RingBuffer_Policy_t policy);
+
+/**
+ * @brief  读取发送统计
+ */
+void VCP_GetTxStats(VCP_TxStats_t *stats);
+
+/**
+ * @brief  IN 端点发送完成回调 (在 CDC_TransmitCplt_FS 中调用)
+ */
+void VCP_TxCpltCallback(void);
+
+/**
+ * @brief  OUT 端点接收回调 (在 CDC_Receive_FS 中调用, 不重新使能接收)
+ * @param  buf: 接收缓冲 (UserRxBufferFS)
+ * @param  len: 数据长度
+ */
+void VCP_RxCallback(uint8_t *buf, uint32_t len);
+
+/**
+ * @brief  取得待处理的接收数据 (主循环调用)
+ * @param  buf: 输出数据指针 (指向接收缓冲, 调用 VCP_RxRelease 前有效)
+ * @return 数据长度, 0=无数据
+ */
+uint32_t VCP_RxPeek(const uint8_t **buf);
+
+/**
+ * @brief  释放接收缓冲并重新使能 OUT 端点
+ */
+void VCP_RxRelease(void);
+
+/**
+ * @brief  USB 配置完成/断开回调 (在 CDC_Init_FS / CDC_DeInit_FS 中调用)
+ * @note   端点复位后不会再有完成中断, 须清除发送中标志和待处理的接收数据
+ */
+void VCP_Reset(void);
+
+#endif /* __USB_VCP_H */
@@ -1,10 +1,58 @@
 #include "vofa.h" 
+#include "foc_atomic.h"
+#if !MOTOR_HW_SIM
 #include "usb_vcp.h"
+#endif
+#include <string.h>
+
+#define VOFA_FRESH          0x4u    // 中间缓冲含未取用的新帧
 
 const uint8_t VOFA_TAIL[4] = {0x00, 0x00, 0x80, 0x7F};
-float vofa_data[VOFA_CHANNEL_CNT] = {0};
 
-void VOFA_Send_JustFloat(float *data_ptr, uint8_t count) {
-    VCP_SendData((uint8_t*)data_ptr, count * sizeof(float));
-    VCP_SendData((uint8_t*)VOFA_TAIL, 4);
+/* 三缓冲: 写端独占 back, 读端独占 front, 中间缓冲号经原子交换在两端之间传递 */
+static VOFA_Frame_t vofa_buf[3];
+static volatile uint32_t vofa_mid = 1;      // 中间缓冲号 | VOFA_FRESH
+static uint8_t vofa_back = 0;               // 写端正在填写的缓冲
+static uint8_t vofa_last = 2;               // 写端最近发布的缓冲
+static uint8_t vofa_front = 2;              // 读端正在读取的缓冲
+static uint32_t vofa_tick = 0;
+
+uint8_t VOFA_Send_JustFloat(const float *data_ptr, uint8_t count) {
+    static uint8_t frame[VOFA_CHANNEL_CNT * sizeof(float) + sizeof(VOFA_TAIL)];
+    
+    if (count > VOFA_CHANNEL_CNT) count = VOFA_CHANNEL_CNT;
+    
+    // 数据与帧尾拼成一帧入队, 队列满时整帧丢弃
+    memcpy(frame, data_ptr, count * sizeof(float));
+    memcpy(&frame[count * sizeof(float)], VOFA_TAIL, sizeof(VOFA_TAIL));
+#if MOTOR_HW_SIM
+    return 1;   // 主机仿真无 USB 链路, 组帧后视为已发送
+#else
+    return VCP_SendData(frame, count * sizeof(float) + sizeof(VOFA_TAIL)) ? 1 : 0;
+#endif
+}
+
+float *VOFA_BeginFrame(void) {
+    return vofa_buf[vofa_back].Data;
+}
+
+void VOFA_PublishFrame(void) {
+    vofa_buf[vofa_back].Tick = ++vofa_tick;
+    
+    // 交换前的屏障保证帧内容先于缓冲号可见
+    uint32_t old = FOC_Atomic_Exchange(&vofa_mid, vofa_back | VOFA_FRESH);
+    vofa_last = vofa_back;
+    vofa_back = (uint8_t)(old & 0x3u);
+}
+
+const VOFA_Frame_t *VOFA_ProducerFrame(void) {
+    return &vofa_buf[vofa_last];
+}
+
+const VOFA_Frame_t *VOFA_AcquireFrame(void) {
+    if (vofa_mid & VOFA_FRESH) {
+        uint32_t old = FOC_Atomic_Exchange(&vofa_mid, vofa_front);
+        vofa_front = (uint8_t)(old & 0x3u);
+    }
+    return &vofa_buf[vofa_front];
 }
@@ -1,6 +1,9 @@
 /**
  * @file    vofa.h
  * @brief   VOFA+ 调试数据发送模块
+ * @note    调试数据以三缓冲快照在控制中断与主循环之间传递:
+ *          控制中断填写后台帧后交换索引发布, 主循环只读取已发布的完整帧,
+ *          不会读到两个控制周期混合的数据; 双方均不等待, 发布只需一次原子交换
  */
 
 #ifndef __VOFA_H
@@ -13,6 +16,7 @@
 /*============================================================================*/
 
 #define VOFA_CHANNEL_CNT    30      // 最大通道数
+#define VOFA_AXIS           0       // 多轴时输出的轴号
 
 /*============================================================================*/
 /*                              通道定义                                       */
@@ -43,13 +47,20 @@ enum {
     VOFA_CH_DEBUG,              // 20: 调试变量
     VOFA_CH_SPEED_ACTUAL,       // 21: 实际转速
     VOFA_CH_SPEED_TARGET,       // 22: 目标转速
+    VOFA_CH_SUB0,               // 23~29: 订阅参数 (foc_param.h, 只经遥测发送)
 };
 
 /*============================================================================*/
 /*                              数据                                          */
 /*============================================================================*/
 
-extern float vofa_data[VOFA_CHANNEL_CNT];
+/**
+ * @brief 调试数据帧 (一个控制周期的快照)
+ */
+typedef struct {
+    uint32_t Tick;              // 发布序号 (每个控制周期加一)
+    float Data[VOFA_CHANNEL_CNT];
+} VOFA_Frame_t;
 
 /*============================================================================*/
 /*                              函数接口                                       */
@@ -59,17 +70,40 @@ extern float vofa_data[VOFA_CHANNEL_CNT];
  * @brief  发送 JustFloat 格式数据
  * @param  data_ptr: 数据指针
  * @param  count: 通道数
+ * @return 1=已入队, 0=发送队列满被丢弃
+ */
+uint8_t VOFA_Send_JustFloat(const float *data_ptr, uint8_t count);
+
+/**
+ * @brief  取得待填写的后台帧 (写端: 控制中断)
+ * @return 通道数据, 发布前一直有效; 未填写的通道保留该缓冲上次的值
+ */
+float *VOFA_BeginFrame(void);
+
+/**
+ * @brief  发布后台帧 (写端: 控制中断, 填写完成后调用)
+ */
+void VOFA_PublishFrame(void);
+
+/**
+ * @brief  写端最近发布的帧 (写端上下文内使用, 如示波器采样)
+ */
+const VOFA_Frame_t *VOFA_ProducerFrame(void);
+
+/**
+ * @brief  取得最新的完整帧 (读端: 主循环)
+ * @return 帧指针, 到下次调用前内容不变; 无新帧时返回上次的帧 (Tick 不变)
  */
-void VOFA_Send_JustFloat(float *data_ptr, uint8_t count);
+const VOFA_Frame_t *VOFA_AcquireFrame(void);
 
 /**
- * @brief  更新单个通道数据
+ * @brief  更新单个通道数据 (写端: 在 VOFA_BeginFrame 与 VOFA_PublishFrame 之间调用)
  * @param  channel: 通道号
  * @param  value: 数据值
  */
 static inline void VOFA_SetChannel(uint8_t channel, float value) {
     if (channel < VOFA_CHANNEL_CNT) {
-        vofa_data[channel] = value;
+        VOFA_BeginFrame()[channel] = value;
     }
 }
 